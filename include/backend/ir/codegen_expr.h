@@ -6,7 +6,9 @@
 #include <llvm/IR/Value.h>
 #include <llvm/IR/Module.h>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 // Forward declarations
 namespace aria {
@@ -62,6 +64,21 @@ private:
     // Helper: Get size of Aria type in bytes
     size_t getTypeSize(sema::Type* type);
     
+    // Helper: Call a function or closure by name; piped (if set) is
+    // passed before the evaluated args
+    llvm::Value* emitCall(IdentifierExpr* callee, llvm::Value* piped,
+                          const std::vector<std::shared_ptr<ASTNode>>& args);
+    
+    // Helper: Apply one pipeline stage (function name or call) to a value
+    llvm::Value* applyPipelineStage(ASTNode* stage, llvm::Value* piped);
+    
+    // Helper: Run stages [first, last) as one fused iterator pass
+    llvm::Value* emitFusedPipeline(llvm::Value* source, const std::vector<ASTNode*>& stages,
+                                   size_t first, size_t last);
+    
+    // Helper: Get or declare an aria_iter_* runtime function
+    llvm::Function* getOrDeclareIterFunction(const std::string& name);
+    
 public:
     /**
      * Constructor
@@ -102,6 +119,15 @@ public:
      */
     llvm::Value* codegenBinary(BinaryExpr* expr);
     
+    /**
+     * Generate code for a pipeline (|>, <|)
+     * x |> f(a) and f(a) <| x call f(x, a); adjacent collection stages
+     * are fused into a single lazy iterator pass
+     * @param expr Binary expression node with a pipeline operator
+     * @return LLVM value of the last stage
+     */
+    llvm::Value* codegenPipeline(BinaryExpr* expr);
+    
     /**
      * Generate code for a unary operation
      * Handles: neg, not, address, deref
@@ -6,7 +6,9 @@
 #include <llvm/IR/Value.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
 #include <map>
+#include <set>
 #include <string>
 
 // Forward declarations
@@ -26,6 +28,7 @@ namespace aria {
     class BreakStmt;
     class ContinueStmt;
     class DeferStmt;
+    class RegionStmt;
     class ExpressionStmt;
     class ASTNode;
     
@@ -57,9 +60,36 @@ struct LoopContext {
     std::string label;                         // Optional label for labeled break/continue
     llvm::BasicBlock* continue_block;         // Block to jump to for continue
     llvm::BasicBlock* break_block;            // Block to jump to for break
+    size_t defer_depth;                       // Defer scopes open outside the loop
     
-    LoopContext(const std::string& lbl, llvm::BasicBlock* cont, llvm::BasicBlock* brk)
-        : label(lbl), continue_block(cont), break_block(brk) {}
+    LoopContext(const std::string& lbl, llvm::BasicBlock* cont, llvm::BasicBlock* brk,
+                size_t depth)
+        : label(lbl), continue_block(cont), break_block(brk), defer_depth(depth) {}
+};
+
+/**
+ * Shadow stack frame of the function being generated
+ * 
+ * Created on the first gc local and sized once the whole body has been
+ * generated (see StmtCodegen::endGCRootFrame).
+ */
+struct GCRootFrame {
+    llvm::Function* func = nullptr;     // Function owning the frame (null: no rooting)
+    llvm::AllocaInst* slots = nullptr;  // Header words followed by root slots
+    unsigned num_roots = 0;
+};
+
+/**
+ * Statement scopes of the function being generated
+ * 
+ * Loops, defers and arena regions belong to one function body: a nested
+ * function or lambda starts with none and must not reach the enclosing
+ * function's (see StmtCodegen::beginFunctionScope).
+ */
+struct FunctionScope {
+    std::vector<LoopContext> loop_stack;
+    std::vector<std::vector<BlockStmt*>> defer_stack;
+    std::vector<std::string> arena_stack;
 };
 
 class StmtCodegen {
@@ -84,6 +114,9 @@ private:
     // Each scope has a vector of BlockStmt* to execute in LIFO order on exit
     std::vector<std::vector<BlockStmt*>> defer_stack;
     
+    // Hidden arena locals of the enclosing `arena { }` regions, innermost last
+    std::vector<std::string> arena_stack;
+    
     // Helper: Get LLVM type from Aria type string
     llvm::Type* getLLVMTypeFromString(const std::string& type_name);
     
@@ -96,10 +129,48 @@ private:
     // Helper: Execute all defers up to function level
     void executeFunctionDefers();
     
+    // Helper: Execute defers of every scope from the innermost down to depth
+    void executeDefersDownTo(size_t depth);
+    
+    // Helper: Check whether leaving the function runs any defer block
+    bool hasPendingDefers() const;
+    
     // Phase 4.4: Memory Model Helpers
     // Helper: Get or declare aria_gc_alloc runtime function
     llvm::Function* getOrDeclareGCAlloc();
     
+    // Helper: Get or declare aria_gc_register_type runtime function
+    llvm::Function* getOrDeclareGCRegisterType();
+    
+    // Helper: Runtime GC type ID for an LLVM type (registers its reference
+    // bitmap from a module constructor; constant 0 for pointer-free types)
+    llvm::Value* getGCTypeId(llvm::Type* type);
+    
+    // Elide write barriers proven unnecessary (ariac --elide-write-barriers)
+    bool elide_write_barriers;
+    
+    // Helper: Get or declare aria_gc_write_barrier_pre runtime function
+    llvm::Function* getOrDeclareGCWriteBarrierPre();
+    
+    // Helper: Get or declare the runtime's SATB barrier flag
+    llvm::GlobalVariable* getOrDeclareSATBActiveFlag();
+    
+    // Helper: True if obj comes from a small aria_gc_alloc with no call
+    // since (still in the nursery, so stores into it need no barrier)
+    bool isFreshGCAllocation(llvm::Value* obj);
+    
+    // Shadow stack frame for gc locals of the current function
+    GCRootFrame gc_frame;
+    
+    // Helper: Get or declare the runtime's thread-local shadow stack head
+    llvm::GlobalVariable* getOrDeclareShadowStackTop();
+    
+    // Root slots of gc locals, which serve as the locals' storage
+    std::set<llvm::Value*> gc_root_slots;
+    
+    // Stack-promoted gc locals: the alloca is the object itself
+    std::set<llvm::Value*> stack_gc_objects;
+    
     // Helper: Get or declare aria.alloc runtime function (wild memory)
     llvm::Function* getOrDeclareWildAlloc();
     
@@ -109,6 +180,11 @@ private:
     // Helper: Get or declare aria.free runtime function
     llvm::Function* getOrDeclareWildFree();
     
+    // Helper: Get or declare aria_arena_create/alloc/destroy runtime functions
+    llvm::Function* getOrDeclareArenaCreate();
+    llvm::Function* getOrDeclareArenaAlloc();
+    llvm::Function* getOrDeclareArenaDestroy();
+    
     // Phase 4.5.3: Coroutine Intrinsics for async/await
     // Helper: Get or declare @llvm.coro.id intrinsic
     llvm::Function* getCoroId();
@@ -157,6 +233,78 @@ public:
      */
     void setMonomorphizer(sema::Monomorphizer* mono);
     
+    /**
+     * Enable write barrier elision for provably fresh objects
+     * Defaults to the module's "aria.elide-write-barriers" flag
+     * @param elide True to elide barriers proven unnecessary
+     */
+    void setElideWriteBarriers(bool elide);
+    
+    /**
+     * Store a value into a field of a GC object
+     * Emits the inline SATB and card-marking barriers for pointer values
+     * @param obj GC object being written to (payload address)
+     * @param slot Address of the field within obj
+     * @param value Value to store
+     */
+    void emitGCStore(llvm::Value* obj, llvm::Value* slot, llvm::Value* value);
+    
+    /**
+     * Start generating a function body with no enclosing loops, defers
+     * or arena regions
+     * @return Scopes of the enclosing function, to pass to endFunctionScope
+     */
+    FunctionScope beginFunctionScope();
+    
+    /**
+     * Return to the enclosing function's scopes after generating a body
+     * @param enclosing Value returned by the matching beginFunctionScope
+     */
+    void endFunctionScope(FunctionScope enclosing);
+    
+    /**
+     * Start collecting gc locals for a function's shadow stack frame
+     * @param func Function being generated (nullptr disables rooting,
+     *             e.g. for coroutines whose frames outlive the call)
+     * @return Frame of the enclosing function, to pass to endGCRootFrame
+     */
+    GCRootFrame beginGCRootFrame(llvm::Function* func);
+    
+    /**
+     * Emit the frame prologue and epilogues for the current function
+     * (if it has gc locals) and return to the enclosing function's frame
+     * Call after the body is complete, with every return emitted.
+     * @param enclosing Value returned by the matching beginGCRootFrame
+     */
+    void endGCRootFrame(const GCRootFrame& enclosing);
+    
+    /**
+     * Check whether a named value is the root slot of a gc local
+     * The slot holds the object pointer, updated when a collection moves
+     * the object; load it at each use rather than caching it.
+     * @param value Value from the symbol table
+     * @return True if value is a gc root slot
+     */
+    bool isGCRootSlot(llvm::Value* value) const;
+    
+    /**
+     * Check whether a named value is a gc local promoted to the stack
+     * The alloca stands in for the heap object, so the local still
+     * evaluates to the object's address, as a root slot load would.
+     * @param value Value from the symbol table
+     * @return True if value is a stack-promoted gc object
+     */
+    bool isStackGCObject(llvm::Value* value) const;
+    
+    /**
+     * Store a gc object in the next root slot of the current frame
+     * Keeps a temporary alive (and tracked if it moves) across code that
+     * can allocate; reload it from the slot afterwards.
+     * @param obj Object pointer to root
+     * @return The slot, or nullptr if the function is not rooted
+     */
+    llvm::Value* addGCRoot(llvm::Value* obj);
+    
     /**
      * Generate code for all specialized generic functions
      * Called after all call sites are discovered
@@ -271,6 +419,13 @@ public:
      */
     void codegenDefer(DeferStmt* stmt);
     
+    /**
+     * Generate code for an arena region
+     * Creates the region's arena and defers its destruction
+     * @param stmt Region statement
+     */
+    void codegenRegion(RegionStmt* stmt);
+    
     /**
      * Generate code for an expression statement
      * Evaluates expression and discards result
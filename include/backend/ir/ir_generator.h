@@ -111,6 +111,14 @@ public:
      */
     void clearDebugLocation();
     
+    /**
+     * Elide GC write barriers proven unnecessary (stores into freshly
+     * allocated objects). Recorded as the "aria.elide-write-barriers"
+     * module flag, which statement codegen picks up.
+     * @param elide True to enable elision
+     */
+    void setElideWriteBarriers(bool elide);
+    
     /**
      * Generate LLVM IR for an AST node
      * @param node AST node to generate code for
@@ -44,6 +44,7 @@ public:
         BREAK,                // break statement
         CONTINUE,             // continue statement
         DEFER,                // defer statement (RAII cleanup)
+        REGION,               // arena { ... } region scope
         BLOCK,                // Code block: { ... }
         EXPRESSION_STMT,      // Expression as statement
         
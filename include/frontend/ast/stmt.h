@@ -19,12 +19,15 @@ public:
     bool isConst;              // const keyword
     bool isStack;              // stack keyword
     bool isGC;                 // gc keyword (explicit)
+    bool isArena;              // arena keyword (enclosing region's arena)
+    bool noEscape;             // gc object cannot outlive the call (EscapeAnalyzer)
     
     VarDeclStmt(const std::string& type, const std::string& name, 
                 ASTNodePtr init = nullptr, int line = 0, int column = 0)
         : ASTNode(NodeType::VAR_DECL, line, column),
           typeName(type), varName(name), initializer(init),
-          isWild(false), isConst(false), isStack(false), isGC(false) {}
+          isWild(false), isConst(false), isStack(false), isGC(false), isArena(false),
+          noEscape(false) {}
     
     std::string toString() const override;
 };
@@ -229,6 +232,27 @@ public:
     std::string toString() const override;
 };
 
+/**
+ * Region statement node
+ * Represents: arena { block }
+ * Creates an arena on entry; `arena` variables declared inside are
+ * bump-allocated from it, and the whole arena is released at scope exit
+ * through a defer block registered before the body's own defers.
+ */
+class RegionStmt : public ASTNode {
+public:
+    ASTNodePtr body;           // BlockStmt
+    std::string arenaName;     // Hidden local holding the AriaArena*
+    ASTNodePtr cleanup;        // BlockStmt: aria_arena_destroy(arenaName)
+    
+    RegionStmt(ASTNodePtr body, const std::string& arena, ASTNodePtr cleanup,
+               int line = 0, int column = 0)
+        : ASTNode(NodeType::REGION, line, column),
+          body(body), arenaName(arena), cleanup(cleanup) {}
+    
+    std::string toString() const override;
+};
+
 /**
  * Till loop statement node
  * Represents: till(limit, step) { body }
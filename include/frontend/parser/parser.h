@@ -19,6 +19,10 @@ private:
     size_t current;
     std::vector<std::string> errors;
     
+    // Region scopes: `arena` variables are only valid inside one
+    int regionDepth = 0;
+    int regionCount = 0;     // Numbers the hidden arena locals
+    
     // Operator precedence map (higher number = higher precedence)
     static const std::unordered_map<frontend::TokenType, int> precedence;
     
@@ -81,6 +85,7 @@ private:
     ASTNodePtr parseBreakStatement();
     ASTNodePtr parseContinueStatement();
     ASTNodePtr parseDeferStatement();
+    ASTNodePtr parseRegionStatement();
     ASTNodePtr parseTillStatement();
     ASTNodePtr parseLoopStatement();
     ASTNodePtr parseWhenStatement();
@@ -0,0 +1,104 @@
+#ifndef ARIA_SEMA_ESCAPE_ANALYZER_H
+#define ARIA_SEMA_ESCAPE_ANALYZER_H
+
+#include "frontend/ast/ast_node.h"
+#include "frontend/ast/expr.h"
+#include "frontend/ast/stmt.h"
+#include "frontend/token.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace aria {
+namespace sema {
+
+/**
+ * EscapeAnalyzer - Finds gc locals whose object cannot outlive the call
+ *
+ * A gc variable names its heap object: using the variable as a value
+ * yields the object reference. The object escapes when that reference
+ * can be observed after the function returns or by other code while
+ * it runs. Escaping uses:
+ * - Returned, passed as a call argument, awaited
+ * - Stored anywhere: assignment value, initializer of another variable,
+ *   element of an array literal
+ * - Address taken or pinned (@x, #x, $x), including of an element or
+ *   member (@x[i], #x.field)
+ * - Referenced from a lambda or nested function (captured)
+ * - A branch of a ternary whose result escapes
+ *
+ * Non-escaping uses read or write the object in place: operands of
+ * arithmetic, comparison and logical operators, conditions, assignment
+ * targets (x = v, x[i] = v, x.field = v) and index values.
+ *
+ * Declarations are tracked by name per function, so if any declaration
+ * of a shadowed name escapes, all of them do. An expression kind the
+ * analyzer does not know makes every gc local of the function escape.
+ *
+ * Results are written to VarDeclStmt::noEscape. Codegen turns such
+ * locals into allocas when their type holds no references (see
+ * StmtCodegen::codegenVarDecl).
+ */
+class EscapeAnalyzer {
+private:
+    // gc declarations of the current function, by name
+    std::unordered_map<std::string, std::vector<VarDeclStmt*>> candidates;
+    std::unordered_set<std::string> escaped;
+
+    // Inside a lambda or nested function: every reference is a capture
+    int captureDepth;
+
+    // Met a node kind the analyzer cannot see through
+    bool unknownNode;
+
+    /**
+     * Analyze a statement of the current function
+     */
+    void analyzeStatement(ASTNode* stmt);
+
+    /**
+     * Analyze an expression
+     * @param escapes The value of expr flows somewhere it can outlive
+     *        the call (argument, return value, stored value, ...)
+     */
+    void analyzeExpression(ASTNode* expr, bool escapes);
+
+    /**
+     * Analyze target op value (=, +=, ...)
+     */
+    void analyzeAssignment(ASTNode* target, frontend::TokenType op, ASTNode* value);
+
+    /**
+     * Analyze an assignment target (written in place, never escapes)
+     */
+    void analyzeTarget(ASTNode* target);
+
+    static bool isAssignmentOp(frontend::TokenType op);
+
+    /**
+     * Mark the variable at the root of an lvalue path (x, x[i], x.f)
+     */
+    void markRootEscaped(ASTNode* expr);
+
+public:
+    EscapeAnalyzer();
+
+    /**
+     * Analyze every function of a program
+     */
+    void analyze(ASTNodePtr root);
+
+    /**
+     * Analyze one function; sets noEscape on each gc local declared in
+     * its body (outside lambdas) and clears it on the others
+     *
+     * @return Number of gc locals found not to escape
+     */
+    size_t analyzeFuncDecl(FuncDeclStmt* funcDecl);
+};
+
+} // namespace sema
+} // namespace aria
+
+#endif // ARIA_SEMA_ESCAPE_ANALYZER_H
@@ -22,6 +22,7 @@ enum class TokenType {
     TOKEN_KW_WILDX,     // wildx - executable memory allocation (JIT)
     TOKEN_KW_STACK,     // stack - explicit stack allocation
     TOKEN_KW_GC,        // gc - explicit GC allocation
+    TOKEN_KW_ARENA,     // arena - region scope / region allocation
     TOKEN_KW_DEFER,     // defer - RAII-style cleanup
     
     // ========================================================================
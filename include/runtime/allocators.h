@@ -83,7 +83,8 @@ void* aria_realloc(void* ptr, size_t new_size);
  * @param size Buffer size in bytes
  * @param alignment Power of 2 alignment (0 = default, typically 8 or 16)
  * @param zero_init If true, zero-initialize the buffer
- * @return Allocated buffer, or NULL on failure
+ * @return Allocated buffer, or NULL on failure (also for alignment
+ *         above 256KB). Release with aria_free.
  * 
  * Use case: Arena allocators, I/O buffers, custom data structures
  */
@@ -110,6 +111,68 @@ char* aria_alloc_string(size_t size);
  */
 void* aria_alloc_array(size_t elem_size, size_t count);
 
+// =============================================================================
+// Arena Allocator (Region Memory)
+// =============================================================================
+
+/**
+ * Arena: bump allocator whose memory is released all at once
+ * 
+ * Allocation advances a cursor through a chunk; nothing is freed
+ * individually. Chunks start at chunk_size and double (up to 1MB) as
+ * the arena grows; requests larger than a quarter chunk get a chunk of
+ * their own. Arena memory is neither traced nor freed by the GC, and
+ * must not be passed to aria_free.
+ * 
+ * An arena is not thread-safe: use one per thread or per request.
+ * 
+ * Usage (language level, see StmtCodegen::codegenRegion):
+ *   arena {
+ *       arena Node:n = ...;    // aria_arena_alloc from the region
+ *   }                          // aria_arena_destroy via defer
+ */
+typedef struct AriaArena AriaArena;
+
+/**
+ * Create an arena
+ * 
+ * @param chunk_size Size of the first chunk (0 = 32KB). No memory is
+ *                   reserved until the first allocation.
+ * @return New arena, or NULL on failure
+ */
+AriaArena* aria_arena_create(size_t chunk_size);
+
+/**
+ * Allocate from an arena
+ * 
+ * @param size Bytes to allocate
+ * @param alignment Power of 2 alignment (0 = 16, at most 4096)
+ * @return Uninitialized memory valid until reset/destroy, or NULL on
+ *         failure (or size 0)
+ */
+void* aria_arena_alloc(AriaArena* arena, size_t size, size_t alignment);
+
+/**
+ * Release every allocation at once
+ * 
+ * Keeps the largest chunk so a steady per-request workload settles into
+ * one chunk and stops allocating chunks at all.
+ */
+void aria_arena_reset(AriaArena* arena);
+
+/**
+ * Release every allocation and the arena itself (NULL is a no-op)
+ */
+void aria_arena_destroy(AriaArena* arena);
+
+typedef struct {
+    size_t bytes_allocated;   // Requested bytes since create/reset
+    size_t bytes_reserved;    // Chunk memory held by the arena
+    size_t num_chunks;
+} ArenaStats;
+
+void aria_arena_get_stats(const AriaArena* arena, ArenaStats* stats);
+
 // =============================================================================
 // WildX Executable Memory (JIT Support)
 // =============================================================================
@@ -209,15 +272,107 @@ void aria_free_exec(WildXGuard* guard);
  */
 void* aria_exec_jit(WildXGuard* guard, void* args);
 
+// =============================================================================
+// WildX Code Pool (Batched JIT Stubs)
+// =============================================================================
+
+/**
+ * Code pool: sub-allocates many small JIT stubs from shared chunks
+ * 
+ * aria_alloc_exec costs a page, an mmap and (on seal) an mprotect per
+ * guard. A pool carves stubs out of 64KB chunks and publishes every
+ * stub written since the last seal at once:
+ * 
+ * - Dual-mapped (Linux, memfd): each chunk is mapped twice, RW for
+ *   writing and RX for executing. Sealing only flushes the I-cache;
+ *   no protection ever changes.
+ * - Single-mapped (fallback): stubs are written in place and sealing
+ *   flips the written pages of each chunk to RX with one mprotect.
+ *   Later stubs start on the next page, which is still RW.
+ * 
+ * Either way no mapping is ever writable and executable at once.
+ * A stub may only be called through exec_ptr, after
+ * aria_code_pool_seal has returned; it must not be written after that.
+ * 
+ * Pools are thread-safe.
+ * 
+ * Typical usage:
+ *   AriaCodePool* pool = aria_code_pool_create(0);
+ *   AriaCodeStub stubs[100];
+ *   for (int i = 0; i < 100; i++) {
+ *       aria_code_pool_alloc(pool, code_size[i], &stubs[i]);
+ *       memcpy(stubs[i].write_ptr, code[i], code_size[i]);
+ *   }
+ *   aria_code_pool_seal(pool);            // One flip (or none) for all
+ *   ((int64_t (*)(void))stubs[0].exec_ptr)();
+ */
+typedef struct AriaCodePool AriaCodePool;
+
+typedef struct {
+    void* write_ptr;        // Where to write the code (until sealed)
+    void* exec_ptr;         // Where to call it (after sealing)
+    size_t size;            // Requested size
+    void* chunk;            // Owning chunk (internal)
+} AriaCodeStub;
+
+/**
+ * Create a code pool
+ * 
+ * @param chunk_size Bytes per chunk, rounded to pages (0 = 64KB).
+ *                   Larger stubs get a chunk of their own.
+ * @return Pool, or NULL on failure
+ */
+AriaCodePool* aria_code_pool_create(size_t chunk_size);
+
+/**
+ * Allocate a stub (16-byte aligned, writable through write_ptr)
+ * 
+ * @return 0 on success, -1 on failure (stub is zeroed)
+ */
+int aria_code_pool_alloc(AriaCodePool* pool, size_t size, AriaCodeStub* stub);
+
+/**
+ * Make every stub allocated since the last seal executable
+ * 
+ * @return 0 on success, -1 on failure
+ */
+int aria_code_pool_seal(AriaCodePool* pool);
+
+/**
+ * Release a stub; a chunk is unmapped once all its stubs are released
+ * (stub space is not reused within a chunk). NULL/empty stubs are a no-op.
+ */
+void aria_code_pool_free(AriaCodePool* pool, AriaCodeStub* stub);
+
+/**
+ * Unmap every chunk (outstanding stubs become invalid)
+ */
+void aria_code_pool_destroy(AriaCodePool* pool);
+
+typedef struct {
+    size_t num_chunks;
+    size_t bytes_reserved;      // Chunk bytes mapped (counted once)
+    size_t bytes_used;          // Stub bytes handed out, including padding
+    size_t num_stubs;           // Live stubs
+    size_t num_seals;
+    size_t num_protect_calls;   // mprotect/VirtualProtect calls made
+    bool dual_mapped;
+} CodePoolStats;
+
+void aria_code_pool_get_stats(AriaCodePool* pool, CodePoolStats* stats);
+
 // =============================================================================
 // Memory Diagnostics
 // =============================================================================
 
 /**
  * Get allocator statistics
+ * 
+ * Wild counters are published by each thread after 64KB of churn; the
+ * calling thread's own allocations are always included.
  */
 typedef struct {
-    size_t total_wild_allocated;      // Total wild heap usage
+    size_t total_wild_allocated;      // Wild heap bytes in use (size-class rounded)
     size_t total_wildx_allocated;     // Total executable memory
     size_t num_wild_allocations;      // Active wild allocations
     size_t num_wildx_allocations;     // Active wildx allocations
@@ -227,6 +382,83 @@ typedef struct {
 
 void aria_allocator_get_stats(AllocatorStats* stats);
 
+// =============================================================================
+// Heap Profiler (Allocation Sites)
+// =============================================================================
+
+/**
+ * Sampling heap profiler
+ * 
+ * Samples both GC allocations (aria_gc_alloc) and wild allocations
+ * (aria_alloc, aria_realloc, aria_alloc_buffer, ...). On average one
+ * allocation is sampled per sample_interval bytes; the gaps are drawn
+ * from an exponential distribution so periodic allocation patterns are
+ * not aliased. Each sample records a backtrace, the size and, for GC
+ * objects, the type_id.
+ * 
+ * Samples are aggregated per allocation site (backtrace + type_id) into
+ * estimated allocated and in-use objects/bytes. A GC sample stops being
+ * in use when the collector frees the object (and follows it when it is
+ * promoted); a wild sample when it is passed to aria_free.
+ * 
+ * The profile is written in pprof's protobuf format, with "allocator"
+ * (gc/wild) and "type_id" sample labels:
+ *   go tool pprof -sample_index=alloc_space ./program heap.pb
+ *   go tool pprof -tagfocus=type_id=12 ./program heap.pb
+ * 
+ * Environment (read at startup):
+ *   ARIA_HEAPPROFILE          Start profiling, dump to this path at exit
+ *   ARIA_HEAPPROFILE_RATE     sample_interval in bytes (default: 512KB)
+ *   ARIA_HEAPPROFILE_SIGNAL   Also dump whenever this signal arrives
+ * 
+ * Cost: an unsampled allocation pays one thread-local subtraction; an
+ * aria_free pays one relaxed load while no wild sample is live. Threads
+ * notice aria_heap_profile_start within a few MB of their allocation.
+ */
+typedef struct {
+    size_t sample_interval;           // Mean bytes between samples (0 = stopped)
+    size_t num_samples;               // Samples taken since start
+    size_t num_sites;                 // Distinct allocation sites
+    size_t live_samples;              // Samples not yet freed
+    uint64_t alloc_bytes;             // Estimated bytes allocated since start
+    uint64_t inuse_bytes;             // Estimated bytes still live
+} HeapProfileStats;
+
+/**
+ * Start sampling, discarding any previous profile
+ * 
+ * @param sample_interval Mean bytes between samples (0 = 512KB)
+ * @return 0 on success, -1 if already running
+ */
+int aria_heap_profile_start(size_t sample_interval);
+
+/**
+ * Stop taking new samples
+ * 
+ * Samples already taken keep tracking frees, so a later dump still
+ * reports what is in use.
+ */
+void aria_heap_profile_stop(void);
+
+/**
+ * Write the profile in pprof protobuf format
+ * 
+ * @return 0 on success, -1 if the file could not be written
+ */
+int aria_heap_profile_dump(const char* path);
+
+/**
+ * Dump the profile to path whenever signo is delivered
+ * 
+ * The signal handler only wakes a background thread, which writes the
+ * file; allocation continues meanwhile.
+ * 
+ * @return 0 on success, -1 if the handler could not be installed
+ */
+int aria_heap_profile_dump_on_signal(int signo, const char* path);
+
+void aria_heap_profile_get_stats(HeapProfileStats* stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -335,6 +335,21 @@ void aria_asm_epilogue(Assembler* asm_ctx);
  */
 WildXGuard aria_asm_finalize(Assembler* asm_ctx);
 
+/**
+ * Finalize assembly into a code pool stub (not yet executable)
+ * 
+ * Like aria_asm_finalize, but copies the code into a stub of a shared
+ * AriaCodePool instead of a page of its own. Emit a batch of functions
+ * this way, then make all of them executable with one
+ * aria_code_pool_seal call and call them through stub->exec_ptr.
+ * 
+ * @param asm_ctx Assembler instance
+ * @param pool Code pool to allocate from
+ * @param stub Receives the stub (zeroed on error)
+ * @return 0 on success, -1 on error (see aria_asm_get_error)
+ */
+int aria_asm_finalize_to_pool(Assembler* asm_ctx, AriaCodePool* pool, AriaCodeStub* stub);
+
 /**
  * Execute JIT-compiled function with no arguments
  * 
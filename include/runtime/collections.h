@@ -1,13 +1,18 @@
 /**
  * Phase 6.2 Standard Library - Collections
  * 
- * Array utilities and functional programming operations for Aria runtime.
+ * Array utilities, hash maps/sets and functional programming operations
+ * for Aria runtime.
  * 
  * Design:
  * - Generic array wrapper with dynamic capacity
+ * - Open-addressing hash map and set (Swiss table) over the same
+ *   element-size-parameterized storage
  * - GC-integrated memory management
  * - Type-safe operations with result types
  * - Functional programming support (filter, map, reduce)
+ * - Lazy iterators that fuse filter/map/reduce chains into one pass
+ * - Chunked parallel sort, transform, filter and reduce
  */
 
 #ifndef ARIA_RUNTIME_COLLECTIONS_H
@@ -34,14 +39,14 @@ extern "C" {
  * - length: Current number of elements
  * - capacity: Allocated capacity
  * - element_size: Size of each element in bytes
- * - type_id: Type ID for GC tracking (0 for generic)
+ * - type_id: Element type ID for GC tracing (0 = no GC references)
  */
 typedef struct {
     void* data;          // Pointer to element array
     size_t length;       // Current number of elements
     size_t capacity;     // Allocated capacity
     size_t element_size; // Size of each element
-    int type_id;         // Type ID for GC (0=generic)
+    int type_id;         // Element type ID for GC (0=leaf)
 } AriaArray;
 
 // ═══════════════════════════════════════════════════════════════════════
@@ -53,7 +58,9 @@ typedef struct {
  * 
  * @param element_size Size of each element in bytes
  * @param initial_capacity Initial capacity (0 for default)
- * @param type_id Type ID for GC tracking (0 for generic)
+ * @param type_id Element type ID from aria_gc_register_type (0 if elements
+ *                hold no GC references); the element buffer is traced
+ *                with this layout repeated per element
  * @return Result containing pointer to AriaArray or error
  */
 AriaResultPtr aria_array_new(size_t element_size, size_t initial_capacity, int type_id);
@@ -225,6 +232,10 @@ AriaResultPtr aria_array_reduce(const AriaArray* array, AriaReducerFn reducer,
 /**
  * Sort array in-place using comparator function.
  * 
+ * Pattern-defeating quicksort: O(n log n) worst case, linear on sorted
+ * or reverse-sorted input. Not stable. Reentrant: the comparator and
+ * context are used only for this call, so threads may sort concurrently.
+ * 
  * @param array Array to sort
  * @param comparator Comparator function
  * @param context User-provided context (optional)
@@ -232,6 +243,23 @@ AriaResultPtr aria_array_reduce(const AriaArray* array, AriaReducerFn reducer,
  */
 AriaResultVoid aria_array_sort(AriaArray* array, AriaComparatorFn comparator, void* context);
 
+/**
+ * Sort array in-place on the shared collection worker pool.
+ * 
+ * Large arrays are split into one chunk per worker; chunks are sorted
+ * concurrently and merged pairwise. Small arrays (or a single-core
+ * machine) fall back to aria_array_sort. Not stable.
+ * 
+ * The comparator runs on several threads at once: it must be safe to
+ * call concurrently and must not allocate from the GC heap.
+ * 
+ * @param array Array to sort
+ * @param comparator Comparator function
+ * @param context User-provided context (optional)
+ * @return Result indicating success or error
+ */
+AriaResultVoid aria_array_sort_parallel(AriaArray* array, AriaComparatorFn comparator, void* context);
+
 /**
  * Reverse array elements in-place.
  * 
@@ -243,6 +271,11 @@ AriaResultVoid aria_array_reverse(AriaArray* array);
 /**
  * Remove duplicate elements from array (preserves order, keeps first occurrence).
  * 
+ * With a NULL comparator, elements are compared bytewise and found
+ * through a hash set in O(n). A comparator only defines equality, not a
+ * matching hash, so it costs O(n^2) comparisons; use aria_array_unique_by
+ * for custom equality in O(n).
+ * 
  * @param array Array to deduplicate
  * @param comparator Comparator function for equality (NULL for memcmp)
  * @param context User-provided context (optional)
@@ -250,6 +283,399 @@ AriaResultVoid aria_array_reverse(AriaArray* array);
  */
 AriaResultPtr aria_array_unique(const AriaArray* array, AriaComparatorFn comparator, void* context);
 
+// ═══════════════════════════════════════════════════════════════════════
+// Parallel Array Operations
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * Default number of elements per parallel chunk (grain_size 0).
+ */
+#define ARIA_PAR_DEFAULT_GRAIN 1024
+
+/**
+ * Combiner function type for parallel reduce.
+ *
+ * Folds a partial result into the accumulator; together with the
+ * reducer it must be associative, so that chunks can be reduced
+ * separately and combined in order.
+ *
+ * @param accumulator Pointer to accumulator value (updated in place)
+ * @param partial Pointer to the partial result of the following chunk
+ * @param context User-provided context
+ */
+typedef void (*AriaCombinerFn)(void* accumulator, const void* partial, void* context);
+
+// The parallel operations split the array into chunks of grain_size
+// elements and run them on the shared collection worker pool (see
+// aria_array_sort_parallel). Chunking depends only on the length and
+// grain_size, never on the thread count, so output order and reduction
+// order are deterministic. Callbacks run on several threads at once:
+// they must be safe to call concurrently and must not allocate from the
+// GC heap. The index passed to a callback is the element's index in
+// the source array.
+
+/**
+ * Transform/map array elements in parallel (see aria_array_transform).
+ *
+ * @param array Source array
+ * @param mapper Mapper function
+ * @param output_element_size Size of output elements
+ * @param output_type_id Type ID for output elements
+ * @param grain_size Elements per chunk (0 for ARIA_PAR_DEFAULT_GRAIN)
+ * @param context User-provided context (optional)
+ * @return Result containing new transformed array or error
+ */
+AriaResultPtr aria_array_par_transform(const AriaArray* array, AriaMapperFn mapper,
+                                       size_t output_element_size, int output_type_id,
+                                       size_t grain_size, void* context);
+
+/**
+ * Filter array elements in parallel, preserving their order.
+ *
+ * Each chunk evaluates the predicate once per element and counts its
+ * survivors; an exclusive prefix sum over the counts gives every chunk
+ * its output offset, and the chunks then copy their survivors in place.
+ *
+ * @param array Source array
+ * @param predicate Predicate function
+ * @param grain_size Elements per chunk (0 for ARIA_PAR_DEFAULT_GRAIN)
+ * @param context User-provided context (optional)
+ * @return Result containing new filtered array or error
+ */
+AriaResultPtr aria_array_par_filter(const AriaArray* array, AriaPredicateFn predicate,
+                                    size_t grain_size, void* context);
+
+/**
+ * Reduce array in parallel.
+ *
+ * Every chunk starts from a copy of identity and folds its elements in
+ * with reducer; the partial results are then combined in chunk order.
+ *
+ * @param array Source array
+ * @param reducer Reducer function
+ * @param combiner Combiner function for partial results
+ * @param identity Pointer to the identity value of the reduction
+ * @param accumulator_size Size of accumulator
+ * @param grain_size Elements per chunk (0 for ARIA_PAR_DEFAULT_GRAIN)
+ * @param context User-provided context (optional)
+ * @return Result containing pointer to final accumulator or error
+ */
+AriaResultPtr aria_array_par_reduce(const AriaArray* array, AriaReducerFn reducer,
+                                    AriaCombinerFn combiner, const void* identity,
+                                    size_t accumulator_size, size_t grain_size, void* context);
+
+// ═══════════════════════════════════════════════════════════════════════
+// Lazy Iterators
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * Maximum number of filter/transform stages on one iterator.
+ */
+#define ARIA_ITER_MAX_STAGES 8
+
+#define ARIA_ITER_STAGE_FILTER    1
+#define ARIA_ITER_STAGE_TRANSFORM 2
+
+/**
+ * One lazy adaptor stage.
+ */
+typedef struct {
+    int kind;                  // ARIA_ITER_STAGE_FILTER or ARIA_ITER_STAGE_TRANSFORM
+    AriaPredicateFn predicate; // Filter predicate
+    AriaMapperFn mapper;       // Transform mapper
+    size_t element_size;       // Size of elements leaving this stage
+    int type_id;               // Type ID of elements leaving this stage
+    void* context;             // Passed to predicate or mapper
+} AriaIterStage;
+
+/**
+ * Lazy iterator over an array: a source plus a chain of filter and
+ * transform stages that run only when a terminal operation
+ * (aria_iter_collect, aria_iter_reduce) consumes the iterator.
+ *
+ * The terminal operation makes a single pass over the source, pushing
+ * each element through every stage in turn, so a chain like
+ * filter-transform-reduce allocates no intermediate arrays. Callbacks
+ * see the same arguments as with the eager aria_array_* operations: the
+ * index passed to a stage counts the elements that reached that stage.
+ *
+ * Caller-owned (typically on the stack; the pipeline operator codegen
+ * uses an alloca). Adaptors never fail: a NULL callback or too many
+ * stages is recorded and reported by the terminal operation.
+ *
+ * Elements between stages live in untraced scratch memory: a mapper
+ * followed by further stages must not output GC references if a later
+ * callback can allocate. The last stage's output goes straight into
+ * the result.
+ */
+typedef struct {
+    AriaArray* source;         // Source array (GC reference)
+    size_t num_stages;         // Stages in use
+    size_t element_size;       // Size of elements leaving the last stage
+    int type_id;               // Type ID of elements leaving the last stage
+    int error_code;            // First adaptor error (ARIA_ERR_*), 0 if none
+    const char* error_message; // Message for error_code
+    AriaIterStage stages[ARIA_ITER_MAX_STAGES];
+} AriaIter;
+
+/**
+ * Start an iterator over array's elements.
+ *
+ * @param iter Iterator to initialize
+ * @param array Source array (NULL is reported by the terminal operation)
+ */
+void aria_iter_init(AriaIter* iter, const AriaArray* array);
+
+/**
+ * Add a lazy filter stage (see aria_array_filter).
+ *
+ * @param iter Iterator to extend
+ * @param predicate Predicate function
+ * @param context User-provided context (optional)
+ */
+void aria_iter_filter(AriaIter* iter, AriaPredicateFn predicate, void* context);
+
+/**
+ * Add a lazy transform stage (see aria_array_transform).
+ *
+ * @param iter Iterator to extend
+ * @param mapper Mapper function
+ * @param output_element_size Size of output elements
+ * @param output_type_id Type ID for output elements
+ * @param context User-provided context (optional)
+ */
+void aria_iter_transform(AriaIter* iter, AriaMapperFn mapper,
+                         size_t output_element_size, int output_type_id, void* context);
+
+/**
+ * Run the iterator into a new array.
+ *
+ * @param iter Iterator to consume
+ * @return Result containing new array of the last stage's elements or error
+ */
+AriaResultPtr aria_iter_collect(AriaIter* iter);
+
+/**
+ * Run the iterator into a reducer (see aria_array_reduce).
+ *
+ * @param iter Iterator to consume
+ * @param reducer Reducer function
+ * @param initial Pointer to initial accumulator value
+ * @param accumulator_size Size of accumulator
+ * @param context User-provided context (optional)
+ * @return Result containing pointer to final accumulator or error
+ */
+AriaResultPtr aria_iter_reduce(AriaIter* iter, AriaReducerFn reducer,
+                               const void* initial, size_t accumulator_size, void* context);
+
+// ═══════════════════════════════════════════════════════════════════════
+// Hash Map and Hash Set
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * Hash function type for hash maps and sets.
+ * 
+ * Must return equal hashes for keys that compare equal. All 64 bits
+ * are used: the low 7 select a tag byte, the rest the probe position.
+ * 
+ * @param key Pointer to key
+ * @param key_size Size of key in bytes
+ * @param context User-provided context
+ * @return 64-bit hash
+ */
+typedef uint64_t (*AriaHashFn)(const void* key, size_t key_size, void* context);
+
+/**
+ * Equality function type for hash maps and sets.
+ * 
+ * @param a Pointer to first key
+ * @param b Pointer to second key
+ * @param key_size Size of keys in bytes
+ * @param context User-provided context
+ * @return true if the keys are equal
+ */
+typedef bool (*AriaEqualsFn)(const void* a, const void* b, size_t key_size, void* context);
+
+/**
+ * Hash map with fixed-size keys and values (Swiss table).
+ * 
+ * Open addressing over a power-of-two slot array with one control byte
+ * per slot: EMPTY, DELETED, or the low 7 bits of the key's hash. A
+ * lookup scans a group of 16 control bytes (8 without SSE2) for its tag
+ * with a few vector instructions and compares keys only on tag hits, so
+ * most probes touch one cache line of control bytes and one entry.
+ * Kept at most 7/8 full.
+ * 
+ * Memory layout:
+ * - ctrl: GC-allocated control bytes (capacity + group width; the
+ *   first group is mirrored past the end so any group load is in bounds)
+ * - slots: GC-allocated entries, each the key followed by the value
+ *   (key_size + value_size bytes)
+ * - type_id: Entry type ID for GC tracing (0 = no GC references); the
+ *   slot buffer is traced with this layout repeated per entry, so it
+ *   must describe key_size + value_size bytes. Free slots are zeroed.
+ * 
+ * Pointers returned by lookups stay valid until the next insert that
+ * grows the table or the next collection that moves it.
+ */
+typedef struct {
+    uint8_t* ctrl;         // Control bytes
+    void* slots;           // Entry array
+    size_t length;         // Number of entries
+    size_t capacity;       // Slots (power of two)
+    size_t growth_left;    // Inserts into EMPTY slots before rehashing
+    size_t key_size;       // Size of each key
+    size_t value_size;     // Size of each value (0 for sets)
+    int type_id;           // Entry type ID for GC (0=leaf)
+    AriaHashFn hash;       // Key hash (aria_hash_bytes if NULL)
+    AriaEqualsFn equals;   // Key equality (memcmp if NULL)
+    void* context;         // Passed to hash and equals
+} AriaHashMap;
+
+/**
+ * Hash set: a hash map whose values are empty.
+ */
+typedef AriaHashMap AriaHashSet;
+
+/**
+ * Hash size bytes (the default AriaHashFn, usable from custom ones).
+ * 
+ * @param data Bytes to hash
+ * @param size Number of bytes
+ * @return 64-bit hash, well mixed in every bit
+ */
+uint64_t aria_hash_bytes(const void* data, size_t size);
+
+/**
+ * Create a new hash map.
+ * 
+ * @param key_size Size of each key in bytes (non-zero)
+ * @param value_size Size of each value in bytes
+ * @param initial_capacity Entries to hold without rehashing (0 for default)
+ * @param type_id Entry type ID from aria_gc_register_type (0 if entries
+ *                hold no GC references)
+ * @param hash Key hash function (NULL for aria_hash_bytes)
+ * @param equals Key equality function (NULL for memcmp)
+ * @param context User-provided context for hash and equals (optional)
+ * @return Result containing pointer to AriaHashMap or error
+ */
+AriaResultPtr aria_hashmap_new(size_t key_size, size_t value_size, size_t initial_capacity,
+                               int type_id, AriaHashFn hash, AriaEqualsFn equals, void* context);
+
+/**
+ * Get the number of entries in a hash map.
+ */
+size_t aria_hashmap_length(const AriaHashMap* map);
+
+/**
+ * Look up a key.
+ * 
+ * @param map Map to search
+ * @param key Pointer to key
+ * @return Pointer to the entry's value, or NULL if the key is absent
+ *         (for a set, a non-NULL pointer means present)
+ */
+void* aria_hashmap_get(const AriaHashMap* map, const void* key);
+
+/**
+ * Check whether a key is present.
+ */
+bool aria_hashmap_contains(const AriaHashMap* map, const void* key);
+
+/**
+ * Insert a key or overwrite its value.
+ * 
+ * @param map Map to modify
+ * @param key Pointer to key to copy
+ * @param value Pointer to value to copy (may be NULL for value_size 0;
+ *              NULL zero-fills a new entry and keeps an existing one)
+ * @return Result containing true if the key was newly inserted, or error
+ */
+AriaResultBool aria_hashmap_put(AriaHashMap* map, const void* key, const void* value);
+
+/**
+ * Remove a key.
+ * 
+ * @param map Map to modify
+ * @param key Pointer to key
+ * @return true if the key was present
+ */
+bool aria_hashmap_remove(AriaHashMap* map, const void* key);
+
+/**
+ * Remove every entry (capacity is kept).
+ */
+void aria_hashmap_clear(AriaHashMap* map);
+
+/**
+ * Make room for count entries without further rehashing.
+ * 
+ * @param map Map to modify
+ * @param count Total number of entries to hold
+ * @return Result indicating success or error
+ */
+AriaResultVoid aria_hashmap_reserve(AriaHashMap* map, size_t count);
+
+/**
+ * Iterate over entries in unspecified order.
+ * 
+ * Start with *cursor = 0. The map must not be modified while iterating.
+ * 
+ * @param map Map to iterate
+ * @param cursor Iteration state
+ * @param out_key Set to the entry's key (optional)
+ * @param out_value Set to the entry's value (optional)
+ * @return false once every entry has been visited
+ */
+bool aria_hashmap_next(const AriaHashMap* map, size_t* cursor, void** out_key, void** out_value);
+
+/**
+ * Free a hash map (only needed for Wild allocator, no-op for GC).
+ */
+void aria_hashmap_free(AriaHashMap* map);
+
+/**
+ * Create a new hash set (see aria_hashmap_new; type_id describes one
+ * element).
+ */
+AriaResultPtr aria_hashset_new(size_t element_size, size_t initial_capacity, int type_id,
+                               AriaHashFn hash, AriaEqualsFn equals, void* context);
+
+/**
+ * Add an element.
+ * 
+ * @return Result containing true if the element was not yet present, or error
+ */
+AriaResultBool aria_hashset_insert(AriaHashSet* set, const void* element);
+
+/**
+ * Check whether an element is present.
+ */
+bool aria_hashset_contains(const AriaHashSet* set, const void* element);
+
+/**
+ * Remove an element; returns true if it was present.
+ */
+bool aria_hashset_remove(AriaHashSet* set, const void* element);
+
+/**
+ * Get the number of elements in a hash set.
+ */
+size_t aria_hashset_length(const AriaHashSet* set);
+
+/**
+ * Remove duplicate elements using hash and equality functions
+ * (preserves order, keeps first occurrence, O(n)).
+ * 
+ * @param array Array to deduplicate
+ * @param hash Element hash function (NULL for aria_hash_bytes)
+ * @param equals Element equality function (NULL for memcmp)
+ * @param context User-provided context (optional)
+ * @return Result containing new deduplicated array or error
+ */
+AriaResultPtr aria_array_unique_by(const AriaArray* array, AriaHashFn hash,
+                                   AriaEqualsFn equals, void* context);
+
 #ifdef __cplusplus
 }
 #endif
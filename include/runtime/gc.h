@@ -36,18 +36,20 @@ extern "C" {
  * - pinned_bit (1): Object cannot be moved (for wild pointer safety)
  * - forwarded_bit (1): Object has been evacuated, payload is forwarding address
  * - is_nursery (1): Object is in young generation
- * - size_class (8): Allocator bucket index for fast size lookup
+ * - size_class (8): Old generation size class (0 = nursery or large object)
  * - type_id (16): Runtime type identifier for precise scanning
- * - padding (36): Reserved for future use (identity hash, thin locks)
+ * - size_words (32): Object footprint (header + payload) in 8-byte words
+ * - padding (4): Reserved for future use
  */
 typedef struct {
     uint64_t mark_bit : 1;        // Mark-sweep status
     uint64_t pinned_bit : 1;      // Address stability flag (#operator)
     uint64_t forwarded_bit : 1;   // Relocation flag (nursery evacuation)
     uint64_t is_nursery : 1;      // Generational tag
-    uint64_t size_class : 8;      // Allocator bucket (256 size classes)
+    uint64_t size_class : 8;      // Old gen size class (0 = none)
     uint64_t type_id : 16;        // Runtime type ID (65536 types)
-    uint64_t padding : 36;        // Reserved
+    uint64_t size_words : 32;     // Footprint in words (up to 32GB objects)
+    uint64_t padding : 4;         // Reserved
 } ObjHeader;
 
 // Compile-time assertion to ensure header is exactly 64 bits
@@ -121,7 +123,11 @@ void aria_gc_unpin(void* ptr);
  * manually for predictable latency or before timing-sensitive operations.
  * 
  * Semantics: Stop-the-world collection. All mutator threads are paused
- * at safepoints until the collection completes.
+ * at safepoints until the collection completes. The pause (from the
+ * safepoint request to the release of the mutators) is recorded in
+ * GCStats. With ARIA_GC_CONCURRENT_MARK, a full collection instead
+ * marks concurrently between two short pauses; the caller waits for
+ * the cycle to complete.
  */
 void aria_gc_collect(bool full_collection);
 
@@ -134,17 +140,81 @@ void aria_gc_collect(bool full_collection);
 typedef struct {
     size_t nursery_size;           // Total nursery capacity (bytes)
     size_t nursery_used;           // Current nursery utilization
-    size_t old_gen_size;           // Old generation size
+    size_t old_gen_size;           // Bytes mapped by old generation segments
     size_t old_gen_used;           // Old generation utilization
     size_t total_allocated;        // Cumulative bytes allocated
     size_t total_collected;        // Cumulative bytes reclaimed
     uint64_t num_minor_collections; // Minor GC count
     uint64_t num_major_collections; // Major GC count
     size_t num_pinned_objects;     // Currently pinned objects
+    size_t num_threads;            // Registered mutator threads
+    uint64_t last_pause_ns;        // Most recent stop-the-world pause
+    uint64_t max_pause_ns;         // Longest stop-the-world pause
+    uint64_t total_pause_ns;       // Cumulative stop-the-world time
+    size_t num_gc_threads;         // Collector workers (incl. the collecting thread)
+    bool marking_in_progress;      // Concurrent mark cycle running
+    size_t last_dirty_cards;       // Cards scanned as roots by the last minor GC
+    
+    // Per-phase wall time: evacuation (minor GC, also run first by every
+    // major GC), mark and sweep (major GC only)
+    uint64_t last_evacuate_ns;
+    uint64_t last_mark_ns;
+    uint64_t last_sweep_ns;
+    uint64_t total_evacuate_ns;
+    uint64_t total_mark_ns;
+    uint64_t total_sweep_ns;
+    
+    // Adaptive sizing inputs from the last minor GC
+    size_t last_promoted;          // Bytes promoted to the old generation
+    double last_survival_rate;     // last_promoted / nursery bytes in use
+    
+    // Stop-the-world pause distribution since aria_gc_init, within ~6%.
+    // Minor: pauses that only ran a minor GC. Major: pauses that ran,
+    // started or finished a major GC.
+    uint64_t minor_pause_p50_ns;
+    uint64_t minor_pause_p99_ns;
+    uint64_t minor_pause_p999_ns;
+    uint64_t major_pause_p50_ns;
+    uint64_t major_pause_p99_ns;
+    uint64_t major_pause_p999_ns;
+    
+    // Heap backing (see aria_gc_init flags)
+    size_t nursery_partitions;     // NUMA partitions (1 without placement)
+    bool nursery_hugetlb;          // Nursery mapped from explicit huge pages
+    
+    // Old generation compaction (ARIA_GC_COMPACT) and memory returned
+    // to the OS
+    size_t last_compacted;         // Bytes moved by the last major GC
+    size_t total_compacted;
+    uint64_t last_compact_ns;      // Evacuation and reference update time
+    size_t segments_released;      // Cumulative segments given back with MADV_DONTNEED
+    
+    // Large-object space (GCPolicy.large_object_size)
+    size_t large_objects;          // Objects in dedicated spans
+    size_t large_object_bytes;     // Bytes mapped for them
 } GCStats;
 
 void aria_gc_get_stats(GCStats* stats);
 
+/**
+ * Write recent GC events as Chrome trace-event JSON
+ * 
+ * The collector keeps the last few thousand collection phases in a ring
+ * buffer (always on). Each is written as a complete ("X") event that
+ * chrome://tracing or Perfetto can load:
+ * - "pause" slices (minor/major) on the "GC pauses" track, with the
+ *   "minor GC", "card scan" and "major GC" phases nested inside
+ * - "concurrent mark" slices on their own track, from the initial
+ *   pause to the end of remark
+ * Arguments carry promoted/freed bytes, pinned object count, dirty card
+ * count and old generation occupancy. Timestamps are microseconds since
+ * aria_gc_init, so they can be lined up with application logs.
+ * 
+ * @param path File to create or overwrite
+ * @return false if the file could not be written
+ */
+bool aria_gc_dump_trace(const char* path);
+
 // =============================================================================
 // Shadow Stack API (Root Tracking)
 // =============================================================================
@@ -159,40 +229,79 @@ void aria_gc_get_stats(GCStats* stats);
  * - Precision: Exact root identification (no conservative scanning)
  * - Safety: Roots cannot be missed due to register allocation
  * 
- * The compiler injects calls to these functions automatically.
+ * Compiled code links fixed-size frames into the chain inline (see
+ * AriaShadowFrame). The functions below serve runtime C code and other
+ * callers that cannot lay out their roots in advance; their frames
+ * join the same chain.
+ */
+
+#ifdef __cplusplus
+#define ARIA_THREAD_LOCAL thread_local
+#else
+#define ARIA_THREAD_LOCAL _Thread_local
+#endif
+
+/**
+ * AriaShadowFrame: Root frame in the caller's stack memory
+ * 
+ * A function with N gc locals reserves the header followed directly by
+ * N root slots in its own activation record, LLVM shadow-stack style:
+ * 
+ *   struct { AriaShadowFrame header; void* roots[N]; } frame;
+ *   frame.header.prev = aria_shadow_stack_top;    // Prologue
+ *   frame.header.num_roots = N;
+ *   frame.header.flags = 0;
+ *   memset(frame.roots, 0, sizeof(frame.roots));
+ *   aria_shadow_stack_top = &frame.header;
+ *   ...
+ *   frame.roots[i] = aria_gc_alloc(...);          // gc local i
+ *   ...
+ *   aria_shadow_stack_top = frame.header.prev;    // Every return
+ * 
+ * Entering and leaving a function costs a few stores and no calls. The
+ * collector walks the chain in place and rewrites root slots when it
+ * moves objects, so a root must be reloaded from its slot after any
+ * call that may collect.
+ */
+typedef struct AriaShadowFrame {
+    struct AriaShadowFrame* prev;  // Caller's frame (NULL at the bottom)
+    uint32_t num_roots;            // Root slots following the header
+    uint32_t flags;                // 0 in compiled frames (runtime use)
+} AriaShadowFrame;
+
+/**
+ * Innermost frame of the calling thread's shadow stack
  */
+extern ARIA_THREAD_LOCAL AriaShadowFrame* aria_shadow_stack_top;
 
 /**
  * Push a new shadow stack frame
  * 
- * Called at function entry for functions with GC-managed locals.
- * Allocates space for root tracking in the current activation record.
- * 
- * Compiler Injection: At function prologue
+ * Starts a frame whose roots are registered one by one with
+ * aria_shadow_stack_add_root. Frames are recycled per thread, so this
+ * does not allocate in steady state. Also a safepoint poll.
  */
 void aria_shadow_stack_push_frame(void);
 
 /**
  * Pop the current shadow stack frame
  * 
- * Called at function exit (all return paths). Discards roots for
- * the current activation record.
- * 
- * Compiler Injection: At function epilogue (all exit blocks)
+ * Must match aria_shadow_stack_push_frame; discards the roots
+ * registered since. Does nothing if the innermost frame is a compiled
+ * frame.
  */
 void aria_shadow_stack_pop_frame(void);
 
 /**
  * Register a root in the current frame
  * 
- * Called when a GC-managed variable is declared or updated.
  * The pointer address (not value) is stored in the shadow frame.
  * 
  * @param root_addr Address of the stack variable (e.g., &x)
  * 
- * Example Lowering:
- *   obj:x = ...;  // Aria source
- *   void* x = aria_gc_alloc(...);  // LLVM IR
+ * Example:
+ *   aria_shadow_stack_push_frame();
+ *   void* x = aria_gc_alloc(...);
  *   aria_shadow_stack_add_root(&x);  // Root registration
  * 
  * Note: For dyn variables (which can change type at runtime), roots
@@ -211,6 +320,103 @@ void aria_shadow_stack_add_root(void** root_addr);
  */
 void aria_shadow_stack_remove_root(void** root_addr);
 
+// =============================================================================
+// Type Layout Registry (Precise Tracing)
+// =============================================================================
+
+/**
+ * Type ID 0: objects with no GC references (byte buffers, numbers,
+ * string data). The collector never scans their payload.
+ */
+#define ARIA_GC_TYPE_LEAF ((uint16_t)0)
+
+/**
+ * Returned by aria_gc_register_type when the 16-bit ID space is exhausted.
+ * Objects allocated with it are treated as leaves.
+ */
+#define ARIA_GC_TYPE_INVALID ((uint16_t)0xFFFF)
+
+/**
+ * Register an object layout for precise tracing
+ * 
+ * @param size Instance size in bytes (multiple of 8)
+ * @param ptr_bitmap One bit per 8-byte word of the instance, LSB first:
+ *                   bit i set means the word at offset i*8 holds a GC
+ *                   reference. Length: (size / 8 + 63) / 64 words.
+ * @return Type ID to pass to aria_gc_alloc
+ * 
+ * Layouts are deduplicated: registering the same (size, bitmap) twice
+ * returns the same ID, so every module can register its own types at
+ * load time without coordinating ID assignment. A layout with no bits
+ * set is the leaf type (ARIA_GC_TYPE_LEAF).
+ * 
+ * Arrays: if an object's payload is larger than the layout size, the
+ * layout repeats across the payload. An array of N elements of a
+ * registered type is allocated with the element's type ID.
+ * 
+ * Safety: Reference slots may also hold NULL or non-GC pointers (wild
+ * memory, string literals); the tracer ignores anything outside the
+ * GC heap.
+ * 
+ * Compiler Injection: A module constructor registers the layout of
+ * every gc-allocated type with reference fields.
+ */
+uint16_t aria_gc_register_type(size_t size, const uint64_t* ptr_bitmap);
+
+// =============================================================================
+// Thread Registry and Safepoints
+// =============================================================================
+
+/**
+ * Mutator threads and stop-the-world
+ * 
+ * Every thread that touches the GC (allocation or shadow stack call) is
+ * registered automatically and gets its own shadow stack and TLAB; it is
+ * unregistered when it exits. A collection stops all registered threads
+ * before scanning roots: each thread either parks at its next safepoint
+ * poll or is already inside a blocking region.
+ * 
+ * Safepoint polls happen in aria_gc_alloc, aria_shadow_stack_push_frame
+ * and aria_gc_safepoint. Long-running loops that neither allocate nor
+ * call should poll explicitly.
+ */
+
+/**
+ * Register the calling thread with the GC
+ * 
+ * Optional: registration happens on first GC use. Calling it eagerly
+ * moves the (locked) registration cost out of the first allocation.
+ */
+void aria_gc_register_thread(void);
+
+/**
+ * Unregister the calling thread
+ * 
+ * Optional: runs automatically at thread exit. The thread must not hold
+ * GC references in its shadow stack afterwards.
+ */
+void aria_gc_unregister_thread(void);
+
+/**
+ * Safepoint poll
+ * 
+ * Parks the calling thread if a collection has been requested and
+ * returns once it has completed. A single relaxed load when no
+ * collection is pending.
+ */
+void aria_gc_safepoint(void);
+
+/**
+ * Enter/leave a blocking region
+ * 
+ * Between these calls the thread promises not to read or write GC
+ * objects, so collections may proceed without waiting for it. The
+ * runtime wraps its own blocking primitives (thread join, mutex lock,
+ * condition waits, sleep) in these calls. Regions may nest.
+ */
+void aria_gc_enter_blocking(void);
+void aria_gc_leave_blocking(void);
+
 // =============================================================================
 // Write Barrier API (Generational GC Support)
 // =============================================================================
@@ -223,21 +429,72 @@ void aria_shadow_stack_remove_root(void** root_addr);
  * reference nursery objects. This ensures that minor GCs correctly
  * identify all roots without scanning the entire old generation.
  * 
- * @param obj Address of the object being written to
+ * @param obj Address of the GC object being written to
  * @param ref Address of the reference being stored (the new value)
  * 
- * Implementation: Uses a Card Table (byte array mapping 512-byte regions).
- * If obj is in the old generation, marks the corresponding card as DIRTY.
+ * Implementation: Each old generation segment carries a card table
+ * (one byte per 512-byte region). If obj is in the old generation and
+ * ref in the nursery, the card holding obj is marked DIRTY, and the
+ * next minor GC treats the objects in that card as roots.
  * 
- * Compiler Injection:
- *   obj.field = value;  // Aria source
- *   *field_addr = value;  // LLVM store
- *   aria_gc_write_barrier(obj, value);  // Barrier
+ * Compiler Injection: ariac inlines this barrier rather than calling it
+ * (see the inline barrier protocol below). The function remains for
+ * runtime C code and other embedders.
  * 
- * Optimization: For !is_nursery(obj), the barrier is a no-op at runtime.
+ * Optimization: For nursery objects (is_nursery(obj)), the barrier is a no-op.
  */
 void aria_gc_write_barrier(void* obj, void* ref);
 
+/**
+ * Pre-write barrier: Snapshot-at-the-beginning (SATB) logging
+ * 
+ * Called before every pointer store into a GC object when the runtime
+ * was initialized with ARIA_GC_CONCURRENT_MARK. While a concurrent mark
+ * is in progress, the reference currently in *slot is recorded so the
+ * marker cannot miss an object that was reachable when marking began.
+ * Outside a marking cycle the barrier is a single flag test.
+ * 
+ * @param slot Address of the reference field about to be overwritten
+ * 
+ * Compiler Injection: ariac only calls this function when
+ * aria_gc_satb_active is set (see the inline barrier protocol below).
+ */
+void aria_gc_write_barrier_pre(void** slot);
+
+/**
+ * Inline barrier protocol
+ * 
+ * Compiled code expands each pointer store into a GC object inline,
+ * so the common case costs no call:
+ * 
+ *   if (aria_gc_satb_active)                     // Unlikely
+ *       aria_gc_write_barrier_pre(field_addr);
+ *   *field_addr = value;
+ *   header = *(uint64_t*)((char*)obj - 8);
+ *   if (!(header & ARIA_GC_HEADER_NURSERY_BIT) && value) {
+ *       cards = (uint8_t*)((uintptr_t)obj & ~(ARIA_GC_SEGMENT_SIZE - 1));
+ *       cards[((uintptr_t)obj & (ARIA_GC_SEGMENT_SIZE - 1)) >> ARIA_GC_CARD_SHIFT] =
+ *           ARIA_GC_CARD_DIRTY;
+ *       cards[0] = ARIA_GC_CARD_DIRTY;           // Segment summary
+ *   }
+ * 
+ * Unlike aria_gc_write_barrier, the inline form does not check that
+ * value is in the nursery; a card dirtied by an old-to-old store is
+ * cleaned by the next minor GC.
+ */
+#define ARIA_GC_HEADER_NURSERY_BIT (1ull << 3)   // ObjHeader.is_nursery
+#define ARIA_GC_SEGMENT_SIZE       (1ull << 18)  // Old generation segment
+#define ARIA_GC_CARD_SHIFT         9             // 512-byte cards
+#define ARIA_GC_CARD_DIRTY         1
+
+/**
+ * Nonzero while a concurrent mark is in progress
+ * 
+ * Only written by the collector while the world is stopped; compiled
+ * code reads it to decide whether to call aria_gc_write_barrier_pre.
+ */
+extern uint8_t aria_gc_satb_active;
+
 // =============================================================================
 // Internal Utilities (for testing/debugging)
 // =============================================================================
@@ -267,6 +524,48 @@ bool aria_gc_is_heap_pointer(void* ptr);
 // GC Initialization and Shutdown
 // =============================================================================
 
+/**
+ * aria_gc_init flags
+ * 
+ * ARIA_GC_CONCURRENT_MARK: Mark the old generation on a background
+ * thread while mutators run. A major GC then costs two short pauses
+ * (initial root scan and final remark/sweep) instead of one long one,
+ * at the price of the aria_gc_write_barrier_pre barrier on every
+ * reference store and some floating garbage per cycle.
+ * 
+ * ARIA_GC_HUGE_PAGES: Ask for transparent huge pages. The nursery is
+ * mapped 2MB-aligned and, like the old generation segments, advised
+ * MADV_HUGEPAGE, cutting TLB misses on multi-GB heaps. Has no effect
+ * when THP is disabled system-wide.
+ * 
+ * ARIA_GC_HUGETLB: Map the nursery from the explicit huge page pool
+ * (MAP_HUGETLB, see /proc/sys/vm/nr_hugepages). Falls back to
+ * ARIA_GC_HUGE_PAGES behaviour if the pool cannot cover it.
+ * 
+ * ARIA_GC_NUMA_LOCAL: Split the nursery into one partition per NUMA
+ * node, each placed on its node. Threads allocate from the partition
+ * of the node they run on and spill to the others only when it is
+ * full, so young objects stay in local memory. Objects promoted to the
+ * old generation are not placed.
+ * 
+ * ARIA_GC_COMPACT: Compact the old generation after each major GC
+ * sweep. Within every size class, the live objects of the sparsest
+ * segments are moved into the free slots of the densest ones and every
+ * reference to them is updated through the type layouts; the emptied
+ * segments are returned to the OS. Objects with pinned_bit set never
+ * move, so a segment holding one stays where it is (its free pages are
+ * still returned). Large objects are never moved. Keeps the footprint
+ * of long-running programs proportional to their live data, at the cost
+ * of a pass over the old generation in major pauses that move anything.
+ * In concurrent mode the remark pause runs an extra minor GC first, so
+ * no young object can hold a stale reference.
+ */
+#define ARIA_GC_CONCURRENT_MARK 0x1u
+#define ARIA_GC_HUGE_PAGES      0x2u
+#define ARIA_GC_HUGETLB         0x4u
+#define ARIA_GC_NUMA_LOCAL      0x8u
+#define ARIA_GC_COMPACT         0x10u
+
 /**
  * Initialize the garbage collector
  * 
@@ -275,10 +574,103 @@ bool aria_gc_is_heap_pointer(void* ptr);
  * 
  * @param nursery_size Initial nursery size (bytes, default: 4MB)
  * @param old_gen_threshold Major GC trigger threshold (bytes, default: 64MB)
+ * @param num_gc_threads Threads used for major GC marking and sweeping,
+ *        including the thread that triggers the collection (0 = one per
+ *        core, at most 8; 1 = serial collection)
+ * @param flags Collector mode (ARIA_GC_CONCURRENT_MARK, ARIA_GC_COMPACT)
+ *        and heap backing (ARIA_GC_HUGE_PAGES, ARIA_GC_HUGETLB,
+ *        ARIA_GC_NUMA_LOCAL), 0 for defaults
+ * 
+ * A major GC starts when the old generation reaches old_gen_threshold,
+ * and afterwards whenever it has grown by GCPolicy.major_growth_factor
+ * since the previous major GC. In concurrent mode, aria_gc_collect(true)
+ * starts a marking cycle (if none is running) and waits for it to finish.
+ * 
+ * Environment overrides (take precedence over the arguments, so a
+ * deployed program can be tuned without recompiling; sizes accept a
+ * K, M or G suffix):
+ *   ARIA_GC_NURSERY_SIZE      Initial nursery size
+ *   ARIA_GC_OLD_THRESHOLD     old_gen_threshold
+ *   ARIA_GC_THREADS           num_gc_threads
+ *   ARIA_GC_CONCURRENT        1/0: set/clear ARIA_GC_CONCURRENT_MARK
+ *   ARIA_GC_COMPACT           1/0: set/clear ARIA_GC_COMPACT
+ *   ARIA_GC_MIN_NURSERY       GCPolicy.min_nursery_size
+ *   ARIA_GC_MAX_NURSERY       GCPolicy.max_nursery_size
+ *   ARIA_GC_PAUSE_TARGET_US   GCPolicy.pause_target_ns, in microseconds
+ *   ARIA_GC_SURVIVAL_TARGET   GCPolicy.survival_target, in percent
+ *   ARIA_GC_MAJOR_GROWTH      GCPolicy.major_growth_factor
+ *   ARIA_GC_LARGE_OBJECT      GCPolicy.large_object_size
+ *   ARIA_GC_HUGE_PAGES        0: none, 1: transparent, 2: explicit (HUGETLB)
+ *   ARIA_GC_NUMA              1/0: set/clear ARIA_GC_NUMA_LOCAL
+ *   ARIA_GC_NUMA_NODES        Nursery partitions (default: online nodes)
  * 
  * This function is idempotent (safe to call multiple times).
  */
-void aria_gc_init(size_t nursery_size, size_t old_gen_threshold);
+void aria_gc_init(size_t nursery_size, size_t old_gen_threshold, size_t num_gc_threads,
+                  uint32_t flags);
+
+/**
+ * GCPolicy: Adaptive sizing parameters
+ * 
+ * After every minor GC the nursery is resized from what that collection
+ * measured:
+ * - Evacuation took longer than pause_target_ns: halve the nursery
+ *   (fewer survivors to copy per pause, more frequent pauses)
+ * - Otherwise, if more than survival_target of the nursery survived and
+ *   the pause was under half the target: double it (objects get longer
+ *   to die before being promoted, fewer collections)
+ * The nursery stays within [min_nursery_size, max_nursery_size] and is
+ * only resized when no nursery object is pinned.
+ * 
+ * Major GC: the next major collection starts once the old generation
+ * reaches major_growth_factor times its live size after the previous
+ * one (never below old_gen_threshold). In concurrent mode the trigger
+ * is lowered by what was promoted during the previous marking cycle,
+ * so a cycle has room to finish before the heap reaches that size.
+ * 
+ * Large objects: an allocation of at least large_object_size bytes
+ * skips the nursery and gets its own mmap'd span in the old generation.
+ * It is never copied (minor GC) or moved (compaction) and is freed by
+ * the major GC sweep, so bulk buffers neither fill the nursery nor cost
+ * evacuation copies. It counts toward the major GC trigger, which may
+ * run a collection before the allocation. Stores of young references
+ * into it need aria_gc_write_barrier, like any old object.
+ * 
+ * Throughput vs. pause time: a larger max_nursery_size and
+ * major_growth_factor mean fewer collections; a smaller pause_target_ns
+ * keeps minor pauses short at the cost of more of them.
+ */
+typedef struct {
+    size_t min_nursery_size;       // Lower bound (bytes, default: initial size / 4)
+    size_t max_nursery_size;       // Upper bound (bytes, default: initial size * 8)
+    uint64_t pause_target_ns;      // Minor pause goal (default: 10ms, 0 = none)
+    double survival_target;        // Survival fraction above which to grow (default: 0.1)
+    double major_growth_factor;    // Old gen growth between major GCs (default: 2.0)
+    size_t large_object_size;      // Allocate directly in the large-object space at
+                                   // this size (bytes, default: 128KB, at least
+                                   // 32KB, 0 = never)
+} GCPolicy;
+
+/**
+ * Smallest large_object_size a policy can set. Allocations below it
+ * always come from the nursery.
+ */
+#define ARIA_GC_MIN_LARGE_OBJECT_SIZE (32u * 1024)
+
+/**
+ * Read the current policy (defaults and environment overrides applied)
+ */
+void aria_gc_get_policy(GCPolicy* policy);
+
+/**
+ * Replace the adaptive sizing policy
+ * 
+ * Takes effect at the next collection. Setting min_nursery_size equal
+ * to max_nursery_size fixes the nursery size. Out-of-range values are
+ * clamped (nursery sizes to at least one nursery block, factors to
+ * >= 1, large_object_size to 0 or at least 32KB).
+ */
+void aria_gc_set_policy(const GCPolicy* policy);
 
 /**
  * Shutdown the garbage collector
@@ -7,6 +7,8 @@
  * - UTF-8 string support (basic, full Unicode handling future)
  * - Result types for error handling
  * - GC-integrated string allocation
+ * - Small strings (up to 15 bytes) stored inline, one allocation per result
+ * - Global intern table with pointer-equality comparison
  * - Common string operations (length, substring, split, etc.)
  * 
  * Note: Aria strings are UTF-8 byte arrays. For now, operations work on
@@ -30,15 +32,36 @@ extern "C" {
 // String Structure
 // ═══════════════════════════════════════════════════════════════════════
 
+/** Longest string whose bytes are stored inside the AriaString itself */
+#define ARIA_STRING_INLINE_CAPACITY 15
+
+/**
+ * Out-of-line string representation: pointer to the bytes plus length.
+ * The top byte of length holds representation flags.
+ */
+typedef struct {
+    const char* data;   // UTF-8 byte data (may or may not be null-terminated)
+    uint64_t length;    // Length in bytes (NOT characters) in the low 56 bits
+} AriaStringHeap;
+
 /**
  * Aria string structure.
  * 
  * Strings are immutable UTF-8 byte sequences with explicit length.
  * No null termination required (but may be present for C interop).
+ * 
+ * Strings of up to ARIA_STRING_INLINE_CAPACITY bytes keep their bytes
+ * in small[], zero-padded; small[15] is a tag byte holding a "small"
+ * flag and the length. Longer strings use the heap form. The tag byte
+ * overlaps the top byte of heap.length, which is zero for a plain
+ * {data, length} string, so such strings remain valid values.
+ * 
+ * Read strings through aria_string_data() and aria_string_length(),
+ * not through the fields.
  */
-typedef struct {
-    const char* data;   // UTF-8 byte data (may or may not be null-terminated)
-    int64_t length;     // Length in bytes (NOT characters)
+typedef union {
+    AriaStringHeap heap;
+    char small[16];
 } AriaString;
 
 // ═══════════════════════════════════════════════════════════════════════
@@ -71,10 +94,43 @@ AriaResultPtr aria_string_from_bytes(const char* data, int64_t length);
  */
 AriaString* aria_string_empty();
 
+/**
+ * Intern a string: return the canonical copy of its bytes.
+ * Interning equal strings returns the same pointer, and interned strings
+ * compare equal by pointer in aria_string_equals. Safe to call from any
+ * thread concurrently.
+ * 
+ * @param str String to intern
+ * @return Result containing AriaString* or error
+ * 
+ * Note: Interned strings live outside the GC heap and are never freed.
+ * Intern keys and identifiers, not unbounded data.
+ */
+AriaResultPtr aria_string_intern(AriaString str);
+
+/**
+ * Check whether a string value came from aria_string_intern.
+ * 
+ * @param str String to check
+ * @return true if str is interned
+ */
+bool aria_string_is_interned(AriaString str);
+
 // ═══════════════════════════════════════════════════════════════════════
 // String Basic Operations
 // ═══════════════════════════════════════════════════════════════════════
 
+/**
+ * Get a pointer to the bytes of a string.
+ * 
+ * @param str String to read (inline bytes live in *str itself)
+ * @return Byte data, valid while *str is; NULL if str is NULL
+ * 
+ * Note: Not null-terminated for inline strings; use aria_string_to_cstr
+ * for C interop.
+ */
+const char* aria_string_data(const AriaString* str);
+
 /**
  * Get the length of a string in bytes.
  * 
@@ -97,6 +153,9 @@ bool aria_string_is_empty(AriaString str);
  * @param a First string
  * @param b Second string
  * @return true if strings are byte-equal
+ * 
+ * Note: Two interned strings are compared by pointer; two inline
+ * strings by their 16 bytes.
  */
 bool aria_string_equals(AriaString a, AriaString b);
 
@@ -252,7 +311,9 @@ AriaResultPtr aria_string_join(const AriaArray* strings, AriaString delimiter);
 
 /**
  * Convert string to null-terminated C string.
- * Returns a GC-allocated copy with null terminator added.
+ * Out-of-line strings created by this module already end in a null
+ * terminator and are returned as-is; inline strings are copied to the
+ * GC heap.
  * 
  * @param str String to convert
  * @return Result containing char* (null-terminated) or error
@@ -5,6 +5,7 @@
 #include "frontend/ast/ast_node.h"
 #include "frontend/sema/type.h"
 #include "frontend/token.h"
+#include "runtime/collections.h"  // AriaIter layout for fused pipelines
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/BasicBlock.h>
@@ -234,11 +235,28 @@ llvm::Value* ExprCodegen::codegenIdentifier(IdentifierExpr* expr) {
     // Look up the variable in the symbol table
     auto it = named_values.find(expr->name);
     if (it == named_values.end()) {
+        // A function name evaluates to its address (e.g. a callback
+        // passed to a runtime collection function)
+        if (llvm::Function* func = module->getFunction(expr->name)) {
+            return func;
+        }
         throw std::runtime_error("Undefined variable: " + expr->name);
     }
     
     llvm::Value* var_ptr = it->second;
     
+    // A gc local lives in its shadow stack root slot: load the object
+    // pointer, which a collection since the last use may have changed
+    if (stmt_codegen && stmt_codegen->isGCRootSlot(var_ptr)) {
+        return builder.CreateLoad(llvm::PointerType::get(context, 0), var_ptr, expr->name);
+    }
+    
+    // A gc local promoted to the stack is its own object: its address,
+    // not its contents, as for the heap form above
+    if (stmt_codegen && stmt_codegen->isStackGCObject(var_ptr)) {
+        return var_ptr;
+    }
+    
     // Check if this is an alloca (stack variable) that needs loading
     // In LLVM 20+ with opaque pointers, we use the alloca's allocated type
     if (llvm::isa<llvm::AllocaInst>(var_ptr)) {
@@ -295,6 +313,11 @@ llvm::Value* ExprCodegen::codegenBinary(BinaryExpr* expr) {
         throw std::runtime_error("Null binary expression");
     }
     
+    // Pipelines are calls, not operations on two evaluated operands
+    if (expr->op.type == TokenType::TOKEN_PIPE_RIGHT || expr->op.type == TokenType::TOKEN_PIPE_LEFT) {
+        return codegenPipeline(expr);
+    }
+    
     // Generate code for left and right operands
     llvm::Value* left = codegenExpressionNode(expr->left.get(), this);
     llvm::Value* right = codegenExpressionNode(expr->right.get(), this);
@@ -579,6 +602,15 @@ llvm::Value* ExprCodegen::codegenCall(CallExpr* expr) {
         throw std::runtime_error("Function callee must be an identifier");
     }
     
+    return emitCall(callee_ident, nullptr, expr->arguments);
+}
+
+/**
+ * Call a function or closure by name
+ * piped (the left side of |>) is passed before the evaluated arguments
+ */
+llvm::Value* ExprCodegen::emitCall(IdentifierExpr* callee_ident, llvm::Value* piped,
+                                   const std::vector<ASTNodePtr>& arguments) {
     // Check if this is a direct function call or a closure call
     // Try to find a direct function first
     llvm::Function* direct_func = module->getFunction(callee_ident->name);
@@ -595,6 +627,11 @@ llvm::Value* ExprCodegen::codegenCall(CallExpr* expr) {
         // Calling convention: call method_ptr(env_ptr, explicit_args...)
         
         llvm::Value* fat_ptr_alloca = it->second;
+        if (stmt_codegen && stmt_codegen->isGCRootSlot(fat_ptr_alloca)) {
+            // gc local: the fat pointer is in the object the slot holds
+            fat_ptr_alloca = builder.CreateLoad(llvm::PointerType::get(context, 0),
+                                                fat_ptr_alloca, callee_ident->name);
+        }
         
         // Load the fat pointer struct from memory
         // Define the fat pointer struct type
@@ -617,10 +654,13 @@ llvm::Value* ExprCodegen::codegenCall(CallExpr* expr) {
         
         // Hidden first argument: env_ptr
         args.push_back(env_ptr);
+        if (piped) {
+            args.push_back(piped);
+        }
         
         // Explicit arguments
-        for (size_t i = 0; i < expr->arguments.size(); i++) {
-            llvm::Value* arg_value = codegenExpressionNode(expr->arguments[i].get(), this);
+        for (size_t i = 0; i < arguments.size(); i++) {
+            llvm::Value* arg_value = codegenExpressionNode(arguments[i].get(), this);
             if (!arg_value) {
                 throw std::runtime_error("Failed to generate code for closure argument " + std::to_string(i));
             }
@@ -675,31 +715,390 @@ llvm::Value* ExprCodegen::codegenCall(CallExpr* expr) {
         // ====================================================================
         
         // Verify argument count matches
-        if (direct_func->arg_size() != expr->arguments.size()) {
+        size_t arg_count = arguments.size() + (piped ? 1 : 0);
+        if (direct_func->arg_size() != arg_count) {
             throw std::runtime_error("Incorrect number of arguments passed to function " + 
                                     callee_ident->name + ": expected " + 
                                     std::to_string(direct_func->arg_size()) + 
-                                    ", got " + std::to_string(expr->arguments.size()));
+                                    ", got " + std::to_string(arg_count));
         }
         
         // Evaluate all arguments recursively
         std::vector<llvm::Value*> args;
-        for (size_t i = 0; i < expr->arguments.size(); i++) {
-            llvm::Value* arg_value = codegenExpressionNode(expr->arguments[i].get(), this);
+        if (piped) {
+            args.push_back(piped);
+        }
+        for (size_t i = 0; i < arguments.size(); i++) {
+            llvm::Value* arg_value = codegenExpressionNode(arguments[i].get(), this);
             if (!arg_value) {
                 throw std::runtime_error("Failed to generate code for argument " + std::to_string(i));
             }
             args.push_back(arg_value);
         }
         
-        // Generate the call instruction
-        return builder.CreateCall(direct_func, args, "calltmp");
+        // Generate the call instruction (void results cannot be named,
+        // e.g. aria_free in a defer block)
+        return builder.CreateCall(direct_func, args,
+                                  direct_func->getReturnType()->isVoidTy() ? "" : "calltmp");
         
     } else {
         throw std::runtime_error("Unknown function or closure: " + callee_ident->name);
     }
 }
 
+// ============================================================================
+// Pipeline Operators (|>, <|)
+// ============================================================================
+
+namespace {
+
+// Collection stages the pipeline codegen can fuse
+enum class PipelineStageKind { Other, Filter, Transform, Reduce };
+
+/**
+ * Flatten a pipeline into its stages in application order; returns the
+ * source. a |> f |> g parses as (a |> f) |> g, and f <| a applies f to
+ * a, so both operators nest on the data side.
+ */
+ASTNode* flattenPipeline(ASTNode* node, std::vector<ASTNode*>& stages) {
+    if (node->type == ASTNode::NodeType::BINARY_OP) {
+        BinaryExpr* binary = static_cast<BinaryExpr*>(node);
+        if (binary->op.type == TokenType::TOKEN_PIPE_RIGHT) {
+            ASTNode* source = flattenPipeline(binary->left.get(), stages);
+            stages.push_back(binary->right.get());
+            return source;
+        }
+        if (binary->op.type == TokenType::TOKEN_PIPE_LEFT) {
+            ASTNode* source = flattenPipeline(binary->right.get(), stages);
+            stages.push_back(binary->left.get());
+            return source;
+        }
+    }
+    return node;
+}
+
+/**
+ * A stage is fusable when it calls an aria_array_* collection operation
+ * with every argument but the piped array
+ */
+PipelineStageKind classifyPipelineStage(ASTNode* stage) {
+    if (stage->type != ASTNode::NodeType::CALL) {
+        return PipelineStageKind::Other;
+    }
+    CallExpr* call = static_cast<CallExpr*>(stage);
+    IdentifierExpr* callee = dynamic_cast<IdentifierExpr*>(call->callee.get());
+    if (!callee) {
+        return PipelineStageKind::Other;
+    }
+    
+    size_t args = call->arguments.size();
+    if (callee->name == "aria_array_filter" && args == 2) {
+        return PipelineStageKind::Filter;      // (predicate, context)
+    }
+    if (callee->name == "aria_array_transform" && args == 4) {
+        return PipelineStageKind::Transform;   // (mapper, size, type_id, context)
+    }
+    if (callee->name == "aria_array_reduce" && args == 4) {
+        return PipelineStageKind::Reduce;      // (reducer, initial, size, context)
+    }
+    return PipelineStageKind::Other;
+}
+
+/**
+ * A transform whose type_id argument is the literal 0 outputs leaf
+ * elements. Only those may feed further fused stages: elements between
+ * stages sit in untraced scratch memory (see AriaIter).
+ */
+bool transformOutputsLeaves(ASTNode* stage) {
+    CallExpr* call = static_cast<CallExpr*>(stage);
+    LiteralExpr* type_id = dynamic_cast<LiteralExpr*>(call->arguments[2].get());
+    return type_id && std::holds_alternative<int64_t>(type_id->value) &&
+           std::get<int64_t>(type_id->value) == 0;
+}
+
+/**
+ * Evaluating a literal or a name never allocates; anything else (a call,
+ * a lambda) may, and can move an array computed before it
+ */
+bool pipelineArgumentsMayAllocate(const std::vector<ASTNode*>& stages, size_t first, size_t last) {
+    for (size_t i = first; i < last; i++) {
+        for (const ASTNodePtr& arg : static_cast<CallExpr*>(stages[i])->arguments) {
+            if (arg->type != ASTNode::NodeType::LITERAL && arg->type != ASTNode::NodeType::IDENTIFIER) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+/**
+ * Generate code for pipelines
+ * 
+ * x |> f and f <| x call f(x); x |> f(a, b) calls f(x, a, b). Chains
+ * apply their stages left to right.
+ * 
+ * Two or more adjacent collection stages (aria_array_filter and
+ * aria_array_transform, optionally ending in aria_array_reduce) are
+ * fused: rather than each call materializing a GC array for the next,
+ * they become one AriaIter with an adaptor per stage and a single
+ * aria_iter_collect or aria_iter_reduce pass. The fused run yields the
+ * terminal's AriaResultPtr, as the last eager call would. A run holds at
+ * most ARIA_ITER_MAX_STAGES adaptors, and only transforms with a literal
+ * 0 type_id (leaf output) may be followed by another fused stage.
+ * 
+ * Example Aria code:
+ *   data |> aria_array_filter(is_even, null)
+ *        |> aria_array_transform(square, 8, 0, null)
+ *        |> aria_array_reduce(sum, @zero, 8, null)
+ * 
+ * Generated LLVM IR:
+ *   call void @aria_iter_init(ptr %iter, ptr %data)
+ *   call void @aria_iter_filter(ptr %iter, ptr @is_even, ptr null)
+ *   call void @aria_iter_transform(ptr %iter, ptr @square, i64 8, i32 0, ptr null)
+ *   call void @aria_iter_reduce(ptr sret(...) %result, ptr %iter, ptr @sum, ...)
+ */
+llvm::Value* ExprCodegen::codegenPipeline(BinaryExpr* expr) {
+    std::vector<ASTNode*> stages;
+    ASTNode* source = flattenPipeline(expr, stages);
+    
+    llvm::Value* value = codegenExpressionNode(source, this);
+    
+    // Fused runs yield an AriaResultPtr: { void* value, void* error, bool is_error }
+    llvm::Type* ptr_type = llvm::PointerType::get(context, 0);
+    llvm::StructType* result_type = llvm::StructType::get(
+        context, {ptr_type, ptr_type, llvm::Type::getInt8Ty(context)});
+    
+    size_t i = 0;
+    while (i < stages.size()) {
+        // Longest fusable run starting here, within one iterator's
+        // stage limit. A transform that may output references ends the
+        // run, collected straight into the result.
+        size_t end = i;
+        bool open = true;
+        while (open && end < stages.size() && end - i < ARIA_ITER_MAX_STAGES) {
+            PipelineStageKind kind = classifyPipelineStage(stages[end]);
+            if (kind != PipelineStageKind::Filter && kind != PipelineStageKind::Transform) {
+                break;
+            }
+            open = kind == PipelineStageKind::Filter || transformOutputsLeaves(stages[end]);
+            end++;
+        }
+        if (open && end < stages.size() &&
+            classifyPipelineStage(stages[end]) == PipelineStageKind::Reduce) {
+            end++;
+        }
+        
+        // A single stage is already a single pass, unless it continues
+        // a run split at the stage limit
+        if (end - i >= 2 || (end > i && value->getType() == result_type)) {
+            value = emitFusedPipeline(value, stages, i, end);
+            i = end;
+        } else {
+            value = applyPipelineStage(stages[i], value);
+            i++;
+        }
+    }
+    
+    return value;
+}
+
+/**
+ * Apply one pipeline stage: a function name or a call whose arguments
+ * follow the piped value
+ */
+llvm::Value* ExprCodegen::applyPipelineStage(ASTNode* stage, llvm::Value* piped) {
+    if (IdentifierExpr* ident = dynamic_cast<IdentifierExpr*>(stage)) {
+        return emitCall(ident, piped, {});
+    }
+    
+    if (stage->type == ASTNode::NodeType::CALL) {
+        CallExpr* call = static_cast<CallExpr*>(stage);
+        IdentifierExpr* callee = dynamic_cast<IdentifierExpr*>(call->callee.get());
+        if (!callee) {
+            throw std::runtime_error("Function callee must be an identifier");
+        }
+        return emitCall(callee, piped, call->arguments);
+    }
+    
+    throw std::runtime_error("Pipeline stage must be a function name or call");
+}
+
+/**
+ * Emit stages [first, last) as one lazy iterator pass
+ * 
+ * Stage arguments are evaluated before aria_iter_init, so the iterator
+ * never holds the source across an allocation; the terminal call roots
+ * the source for the duration of the pass. Arguments are evaluated after
+ * the source, though, and may allocate (a call, a lambda): the source is
+ * then kept in a root slot meanwhile and reloaded, as it may have moved.
+ */
+llvm::Value* ExprCodegen::emitFusedPipeline(llvm::Value* source, const std::vector<ASTNode*>& stages,
+                                            size_t first, size_t last) {
+    // AriaResultPtr: { void* value, void* error, bool is_error }
+    llvm::Type* ptr_type = llvm::PointerType::get(context, 0);
+    llvm::StructType* result_type = llvm::StructType::get(
+        context, {ptr_type, ptr_type, llvm::Type::getInt8Ty(context)});
+    
+    // A run split off at the stage limit continues from the previous
+    // run's result; an error there is passed through unchanged
+    llvm::Value* previous = nullptr;
+    if (source->getType() == result_type) {
+        previous = source;
+        source = builder.CreateExtractValue(previous, 0, "pipe_array");
+    }
+    if (!source->getType()->isPointerTy()) {
+        throw std::runtime_error("Fused pipeline source must be an array pointer");
+    }
+    
+    // Evaluate stage arguments, coerced to the runtime signatures
+    auto evalArg = [&](ASTNode* node, llvm::Type* type) -> llvm::Value* {
+        llvm::Value* value = codegenExpressionNode(node, this);
+        if (value->getType() == type) {
+            return value;
+        }
+        if (value->getType()->isIntegerTy() && type->isIntegerTy()) {
+            return builder.CreateSExtOrTrunc(value, type);
+        }
+        if (value->getType()->isPointerTy() && type->isPointerTy()) {
+            return builder.CreatePointerCast(value, type);
+        }
+        throw std::runtime_error("Invalid argument type in fused pipeline stage");
+    };
+    
+    llvm::Type* i32_type = llvm::Type::getInt32Ty(context);
+    llvm::Type* i64_type = llvm::Type::getInt64Ty(context);
+    
+    llvm::Value* source_root = nullptr;
+    if (stmt_codegen && pipelineArgumentsMayAllocate(stages, first, last)) {
+        source_root = stmt_codegen->addGCRoot(source);
+    }
+    
+    std::vector<std::vector<llvm::Value*>> stage_args;
+    for (size_t i = first; i < last; i++) {
+        CallExpr* call = static_cast<CallExpr*>(stages[i]);
+        const std::vector<ASTNodePtr>& args = call->arguments;
+        switch (classifyPipelineStage(stages[i])) {
+            case PipelineStageKind::Filter:
+                stage_args.push_back({evalArg(args[0].get(), ptr_type),
+                                      evalArg(args[1].get(), ptr_type)});
+                break;
+            case PipelineStageKind::Transform:
+                stage_args.push_back({evalArg(args[0].get(), ptr_type),
+                                      evalArg(args[1].get(), i64_type),
+                                      evalArg(args[2].get(), i32_type),
+                                      evalArg(args[3].get(), ptr_type)});
+                break;
+            case PipelineStageKind::Reduce:
+                stage_args.push_back({evalArg(args[0].get(), ptr_type),
+                                      evalArg(args[1].get(), ptr_type),
+                                      evalArg(args[2].get(), i64_type),
+                                      evalArg(args[3].get(), ptr_type)});
+                break;
+            case PipelineStageKind::Other:
+                throw std::runtime_error("Pipeline stage cannot be fused");
+        }
+    }
+    
+    // Iterator and result live in the entry block (the pipeline may sit in a loop)
+    llvm::Function* func = builder.GetInsertBlock()->getParent();
+    llvm::IRBuilder<> tmp_builder(&func->getEntryBlock(), func->getEntryBlock().begin());
+    llvm::AllocaInst* iter = tmp_builder.CreateAlloca(
+        llvm::ArrayType::get(llvm::Type::getInt8Ty(context), sizeof(AriaIter)), nullptr, "pipe_iter");
+    iter->setAlignment(llvm::Align(alignof(AriaIter)));
+    llvm::AllocaInst* result = tmp_builder.CreateAlloca(result_type, nullptr, "pipe_result");
+    
+    if (source_root) {
+        source = builder.CreateLoad(ptr_type, source_root, "pipe_source");
+    }
+    builder.CreateCall(getOrDeclareIterFunction("aria_iter_init"), {iter, source});
+    
+    bool reduced = false;
+    for (size_t i = first; i < last; i++) {
+        std::vector<llvm::Value*> args = {iter};
+        args.insert(args.end(), stage_args[i - first].begin(), stage_args[i - first].end());
+        
+        switch (classifyPipelineStage(stages[i])) {
+            case PipelineStageKind::Filter:
+                builder.CreateCall(getOrDeclareIterFunction("aria_iter_filter"), args);
+                break;
+            case PipelineStageKind::Transform:
+                builder.CreateCall(getOrDeclareIterFunction("aria_iter_transform"), args);
+                break;
+            default: {
+                args.insert(args.begin(), result);
+                llvm::CallInst* call = builder.CreateCall(getOrDeclareIterFunction("aria_iter_reduce"), args);
+                call->addParamAttr(0, llvm::Attribute::getWithStructRetType(context, result_type));
+                reduced = true;
+                break;
+            }
+        }
+    }
+    
+    if (!reduced) {
+        llvm::CallInst* call = builder.CreateCall(getOrDeclareIterFunction("aria_iter_collect"), {result, iter});
+        call->addParamAttr(0, llvm::Attribute::getWithStructRetType(context, result_type));
+    }
+    
+    llvm::Value* value = builder.CreateLoad(result_type, result, "pipe_value");
+    if (previous) {
+        llvm::Value* failed = builder.CreateICmpNE(
+            builder.CreateExtractValue(previous, 2),
+            llvm::ConstantInt::get(llvm::Type::getInt8Ty(context), 0), "pipe_failed");
+        value = builder.CreateSelect(failed, previous, value, "pipe_value");
+    }
+    return value;
+}
+
+/**
+ * Get or declare an aria_iter_* runtime function (see runtime/collections.h)
+ * The terminals return AriaResultPtr through an sret pointer
+ */
+llvm::Function* ExprCodegen::getOrDeclareIterFunction(const std::string& name) {
+    llvm::Function* func = module->getFunction(name);
+    if (func) {
+        return func;
+    }
+    
+    llvm::Type* void_type = llvm::Type::getVoidTy(context);
+    llvm::Type* ptr_type = llvm::PointerType::get(context, 0);
+    llvm::Type* i32_type = llvm::Type::getInt32Ty(context);
+    llvm::Type* i64_type = llvm::Type::getInt64Ty(context);
+    
+    std::vector<llvm::Type*> params;
+    bool sret = false;
+    if (name == "aria_iter_init") {
+        params = {ptr_type, ptr_type};                                 // (iter, array)
+    } else if (name == "aria_iter_filter") {
+        params = {ptr_type, ptr_type, ptr_type};                       // (iter, predicate, context)
+    } else if (name == "aria_iter_transform") {
+        params = {ptr_type, ptr_type, i64_type, i32_type, ptr_type};   // (iter, mapper, size, type_id, context)
+    } else if (name == "aria_iter_collect") {
+        params = {ptr_type, ptr_type};                                 // (sret, iter)
+        sret = true;
+    } else if (name == "aria_iter_reduce") {
+        params = {ptr_type, ptr_type, ptr_type, ptr_type, i64_type, ptr_type};  // (sret, iter, reducer, initial, size, context)
+        sret = true;
+    } else {
+        throw std::runtime_error("Unknown iterator runtime function: " + name);
+    }
+    
+    func = llvm::Function::Create(
+        llvm::FunctionType::get(void_type, params, false),
+        llvm::Function::ExternalLinkage,
+        name,
+        module
+    );
+    
+    if (sret) {
+        llvm::StructType* result_type = llvm::StructType::get(
+            context, {ptr_type, ptr_type, llvm::Type::getInt8Ty(context)});
+        func->addParamAttr(0, llvm::Attribute::getWithStructRetType(context, result_type));
+    }
+    return func;
+}
+
 /**
  * Generate code for ternary expressions (is ? :)
  * Syntax: is condition : true_value : false_value
@@ -895,12 +1294,18 @@ llvm::Value* ExprCodegen::codegenLambda(LambdaExpr* expr) {
             }
             
             llvm::Value* captured_value = it->second;
+            if (stmt_codegen && stmt_codegen->isGCRootSlot(captured_value)) {
+                // gc local: capture the object it currently holds
+                captured_value = builder.CreateLoad(llvm::PointerType::get(context, 0),
+                                                    captured_value, captured.name);
+            }
             
             // Handle capture mode
             if (captured.mode == LambdaExpr::CaptureMode::BY_VALUE) {
                 // Load value and store into environment
                 // Assuming it's an alloca
-                if (llvm::isa<llvm::AllocaInst>(captured_value)) {
+                if (llvm::isa<llvm::AllocaInst>(captured_value) &&
+                    !(stmt_codegen && stmt_codegen->isStackGCObject(captured_value))) {
                     llvm::AllocaInst* alloca = llvm::cast<llvm::AllocaInst>(captured_value);
                     llvm::Type* allocated_type = alloca->getAllocatedType();
                     llvm::Value* loaded_val = builder.CreateLoad(allocated_type, captured_value, captured.name + "_val");
@@ -1082,6 +1487,8 @@ llvm::Value* ExprCodegen::codegenLambda(LambdaExpr* expr) {
     if (expr->body && stmt_codegen) {
         // Generate code for lambda body using StmtCodegen
         BlockStmt* body_block = static_cast<BlockStmt*>(expr->body.get());
+        GCRootFrame enclosing_gc_frame = stmt_codegen->beginGCRootFrame(lambda_func);
+        FunctionScope enclosing_scope = stmt_codegen->beginFunctionScope();
         stmt_codegen->codegenBlock(body_block);
         
         // If body doesn't have a terminator, add default return
@@ -1099,6 +1506,8 @@ llvm::Value* ExprCodegen::codegenLambda(LambdaExpr* expr) {
                 }
             }
         }
+        stmt_codegen->endGCRootFrame(enclosing_gc_frame);
+        stmt_codegen->endFunctionScope(std::move(enclosing_scope));
     } else {
         // No body or no stmt_codegen - generate placeholder return
         if (return_type->isVoidTy()) {
@@ -1176,13 +1585,7 @@ llvm::Value* ExprCodegen::codegenLambda(LambdaExpr* expr) {
 //    - Implementation: Similar to ternary with null check
 //    - Will be implemented with: Phase 4.4+ (null handling)
 //
-// 4. Pipeline Operators (|>, <|)
-//    - Forward pipeline (|>): data |> func desugars to func(data)
-//    - Reverse pipeline (<|): func <| data desugars to func(data)
-//    - Requires: AST transformation during parsing (desugaring)
-//    - Will be implemented with: Phase 2+ (Parser enhancement for operator desugaring)
-//
-// 5. Range Operators (.., ...)
+// 4. Range Operators (.., ...)
 //    - Inclusive range (..): start..end includes both boundaries
 //    - Exclusive range (...): start...end excludes end
 //    - Requires: Range type implementation, iterator support
@@ -1190,7 +1593,8 @@ llvm::Value* ExprCodegen::codegenLambda(LambdaExpr* expr) {
 //
 // Note: The ternary operator (is ? :) has been implemented in Phase 4.2.6
 //       as it only requires basic control flow without additional type system
-//       features.
+//       features. The pipeline operators (|>, <|) are lowered to calls in
+//       codegenPipeline.
 //
 // ============================================================================
 
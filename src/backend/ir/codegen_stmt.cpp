@@ -5,22 +5,32 @@
 #include "frontend/ast/ast_node.h"
 #include "frontend/sema/type.h"
 #include "frontend/sema/generic_resolver.h"  // Phase 4.5.1: Generic support
+#include "frontend/sema/escape_analyzer.h"  // Stack allocation of non-escaping gc locals
+#include "runtime/gc.h"  // Inline write barrier protocol
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/IR/Intrinsics.h>  // Phase 4.5.3: Coroutine intrinsics
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/MDBuilder.h>  // Write barrier branch weights
+#include <llvm/Transforms/Utils/ModuleUtils.h>  // GC type layout constructor
 #include <stdexcept>
+#include <sstream>
 
 using namespace aria;
 using namespace aria::backend;
 using namespace aria::sema;
 
+// AriaShadowFrame header (prev, num_roots + flags) in pointer-sized words
+static constexpr uint64_t SHADOW_FRAME_HEADER_WORDS = sizeof(AriaShadowFrame) / sizeof(void*);
+
 StmtCodegen::StmtCodegen(llvm::LLVMContext& ctx, llvm::IRBuilder<>& bldr,
                          llvm::Module* mod, std::map<std::string, llvm::Value*>& values)
     : context(ctx), builder(bldr), module(mod), named_values(values), 
-      expr_codegen(nullptr), monomorphizer(nullptr) {}
+      expr_codegen(nullptr), monomorphizer(nullptr),
+      elide_write_barriers(mod->getModuleFlag("aria.elide-write-barriers") != nullptr) {}
 
 void StmtCodegen::setExprCodegen(ExprCodegen* expr_gen) {
     expr_codegen = expr_gen;
@@ -30,6 +40,10 @@ void StmtCodegen::setMonomorphizer(Monomorphizer* mono) {
     monomorphizer = mono;
 }
 
+void StmtCodegen::setElideWriteBarriers(bool elide) {
+    elide_write_barriers = elide;
+}
+
 // Helper: Get LLVM type from Aria type string
 llvm::Type* StmtCodegen::getLLVMTypeFromString(const std::string& type_name) {
     // Primitive types
@@ -70,15 +84,16 @@ llvm::Type* StmtCodegen::getLLVMType(Type* type) {
 
 /**
  * Get or declare aria_gc_alloc runtime function
- * Signature: void* aria_gc_alloc(i64 size)
+ * Signature: void* aria_gc_alloc(i64 size, i16 type_id)
  */
 llvm::Function* StmtCodegen::getOrDeclareGCAlloc() {
     llvm::Function* func = module->getFunction("aria_gc_alloc");
     if (!func) {
-        // Declare: void* aria_gc_alloc(i64 size)
+        // Declare: void* aria_gc_alloc(i64 size, i16 type_id)
         llvm::FunctionType* func_type = llvm::FunctionType::get(
             llvm::PointerType::get(llvm::Type::getInt8Ty(context), 0),  // void* return
-            {llvm::Type::getInt64Ty(context)},                          // i64 size param
+            {llvm::Type::getInt64Ty(context),                           // i64 size param
+             llvm::Type::getInt16Ty(context)},                          // i16 type_id param
             false                                                         // not vararg
         );
         func = llvm::Function::Create(
@@ -91,6 +106,463 @@ llvm::Function* StmtCodegen::getOrDeclareGCAlloc() {
     return func;
 }
 
+/**
+ * Get or declare aria_gc_register_type runtime function
+ * Signature: i16 aria_gc_register_type(i64 size, i64* ptr_bitmap)
+ */
+llvm::Function* StmtCodegen::getOrDeclareGCRegisterType() {
+    llvm::Function* func = module->getFunction("aria_gc_register_type");
+    if (!func) {
+        llvm::FunctionType* func_type = llvm::FunctionType::get(
+            llvm::Type::getInt16Ty(context),                              // i16 type_id return
+            {llvm::Type::getInt64Ty(context),                            // i64 size param
+             llvm::PointerType::get(llvm::Type::getInt64Ty(context), 0)}, // i64* bitmap param
+            false
+        );
+        func = llvm::Function::Create(
+            func_type,
+            llvm::Function::ExternalLinkage,
+            "aria_gc_register_type",
+            module
+        );
+    }
+    return func;
+}
+
+/**
+ * Set one bit per 8-byte word of `type` (placed at `offset`) that holds
+ * a pointer. Pointers at unaligned offsets cannot be GC references and
+ * are skipped.
+ */
+static void collectReferenceWords(const llvm::DataLayout& data_layout, llvm::Type* type,
+                                  uint64_t offset, std::vector<uint64_t>& bitmap) {
+    if (type->isPointerTy()) {
+        if (offset % 8 == 0) {
+            uint64_t word = offset / 8;
+            if (word / 64 >= bitmap.size()) {
+                bitmap.resize(word / 64 + 1, 0);
+            }
+            bitmap[word / 64] |= uint64_t(1) << (word % 64);
+        }
+        return;
+    }
+    
+    if (auto* struct_type = llvm::dyn_cast<llvm::StructType>(type)) {
+        const llvm::StructLayout* layout = data_layout.getStructLayout(struct_type);
+        for (unsigned i = 0; i < struct_type->getNumElements(); ++i) {
+            uint64_t field_offset = layout->getElementOffset(i);
+            collectReferenceWords(data_layout, struct_type->getElementType(i),
+                                  offset + field_offset, bitmap);
+        }
+        return;
+    }
+    
+    if (auto* array_type = llvm::dyn_cast<llvm::ArrayType>(type)) {
+        llvm::Type* elem_type = array_type->getElementType();
+        uint64_t stride = data_layout.getTypeAllocSize(elem_type);
+        for (uint64_t i = 0; i < array_type->getNumElements(); ++i) {
+            collectReferenceWords(data_layout, elem_type, offset + i * stride, bitmap);
+        }
+    }
+}
+
+/**
+ * Get the runtime GC type ID for objects of an LLVM type
+ * 
+ * Types without pointer fields are leaves (constant 0). For any other
+ * type, a module constructor registers its reference bitmap with the
+ * runtime once at load time and stores the returned ID in a global;
+ * each allocation site loads that global. IDs are assigned by the
+ * runtime, so separately compiled modules never collide.
+ * 
+ * Generated LLVM IR:
+ *   @aria.gc.typeid.16.1 = internal global i16 0
+ *   @aria.gc.bitmap.16.1 = private constant [1 x i64] [i64 1]
+ *   define internal void @aria.gc.register_types() {
+ *     %id = call i16 @aria_gc_register_type(i64 16, i64* @aria.gc.bitmap.16.1)
+ *     store i16 %id, i16* @aria.gc.typeid.16.1
+ *     ret void
+ *   }
+ */
+llvm::Value* StmtCodegen::getGCTypeId(llvm::Type* type) {
+    llvm::Type* i16_type = llvm::Type::getInt16Ty(context);
+    llvm::Type* i64_type = llvm::Type::getInt64Ty(context);
+    const llvm::DataLayout& data_layout = module->getDataLayout();
+    
+    std::vector<uint64_t> bitmap;
+    collectReferenceWords(data_layout, type, 0, bitmap);
+    if (bitmap.empty()) {
+        return llvm::ConstantInt::get(i16_type, 0);  // ARIA_GC_TYPE_LEAF
+    }
+    
+    uint64_t type_size = data_layout.getTypeAllocSize(type);
+    
+    // Name globals by layout so identical layouts share one registration
+    std::ostringstream key;
+    key << type_size;
+    for (uint64_t word : bitmap) {
+        key << "." << std::hex << word;
+    }
+    std::string id_name = "aria.gc.typeid." + key.str();
+    
+    llvm::GlobalVariable* id_global = module->getNamedGlobal(id_name);
+    if (!id_global) {
+        id_global = new llvm::GlobalVariable(
+            *module, i16_type, false, llvm::GlobalValue::InternalLinkage,
+            llvm::ConstantInt::get(i16_type, 0), id_name);
+        
+        std::vector<llvm::Constant*> words;
+        for (uint64_t word : bitmap) {
+            words.push_back(llvm::ConstantInt::get(i64_type, word));
+        }
+        llvm::ArrayType* bitmap_type = llvm::ArrayType::get(i64_type, words.size());
+        llvm::GlobalVariable* bitmap_global = new llvm::GlobalVariable(
+            *module, bitmap_type, true, llvm::GlobalValue::PrivateLinkage,
+            llvm::ConstantArray::get(bitmap_type, words), "aria.gc.bitmap." + key.str());
+        
+        // Module constructor that performs all registrations at load time
+        llvm::Function* ctor = module->getFunction("aria.gc.register_types");
+        if (!ctor) {
+            ctor = llvm::Function::Create(
+                llvm::FunctionType::get(llvm::Type::getVoidTy(context), false),
+                llvm::Function::InternalLinkage,
+                "aria.gc.register_types",
+                module
+            );
+            llvm::BasicBlock* entry = llvm::BasicBlock::Create(context, "entry", ctor);
+            llvm::ReturnInst::Create(context, entry);
+            llvm::appendToGlobalCtors(*module, ctor, 0);
+        }
+        
+        llvm::IRBuilder<> ctor_builder(ctor->getEntryBlock().getTerminator());
+        llvm::Value* bitmap_ptr = ctor_builder.CreateConstInBoundsGEP2_32(
+            bitmap_type, bitmap_global, 0, 0);
+        llvm::Value* type_id = ctor_builder.CreateCall(
+            getOrDeclareGCRegisterType(),
+            {llvm::ConstantInt::get(i64_type, type_size), bitmap_ptr},
+            "type_id");
+        ctor_builder.CreateStore(type_id, id_global);
+    }
+    
+    return builder.CreateLoad(i16_type, id_global, "gc_type_id");
+}
+
+// ============================================================================
+// Write Barriers
+// ============================================================================
+
+/**
+ * Get or declare aria_gc_write_barrier_pre runtime function
+ * Signature: void aria_gc_write_barrier_pre(i8** slot)
+ */
+llvm::Function* StmtCodegen::getOrDeclareGCWriteBarrierPre() {
+    llvm::Function* func = module->getFunction("aria_gc_write_barrier_pre");
+    if (!func) {
+        llvm::Type* i8_ptr = llvm::PointerType::get(llvm::Type::getInt8Ty(context), 0);
+        llvm::FunctionType* func_type = llvm::FunctionType::get(
+            llvm::Type::getVoidTy(context),
+            {llvm::PointerType::get(i8_ptr, 0)},  // i8** slot param
+            false
+        );
+        func = llvm::Function::Create(
+            func_type,
+            llvm::Function::ExternalLinkage,
+            "aria_gc_write_barrier_pre",
+            module
+        );
+        // Cold and rarely reached: keep the inline fast path tight
+        func->addFnAttr(llvm::Attribute::Cold);
+    }
+    return func;
+}
+
+/**
+ * Get or declare the runtime's aria_gc_satb_active flag
+ * Declaration: @aria_gc_satb_active = external global i8
+ */
+llvm::GlobalVariable* StmtCodegen::getOrDeclareSATBActiveFlag() {
+    llvm::GlobalVariable* flag = module->getNamedGlobal("aria_gc_satb_active");
+    if (!flag) {
+        flag = new llvm::GlobalVariable(
+            *module, llvm::Type::getInt8Ty(context), false,
+            llvm::GlobalValue::ExternalLinkage, nullptr, "aria_gc_satb_active");
+    }
+    return flag;
+}
+
+/**
+ * Check whether obj is a small GC object allocated in the current basic
+ * block with no call between the allocation and the insertion point
+ * 
+ * aria_gc_alloc returns a nursery object for any size below
+ * ARIA_GC_MIN_LARGE_OBJECT_SIZE; larger requests may go to the
+ * old-generation large-object space, depending on the runtime policy.
+ * Only a call can reach a safepoint where a nursery object could be
+ * promoted. Such an object needs no card mark, and no SATB logging
+ * either (objects created during a marking cycle are not part of the
+ * snapshot).
+ */
+bool StmtCodegen::isFreshGCAllocation(llvm::Value* obj) {
+    auto* alloc_call = llvm::dyn_cast<llvm::CallInst>(obj->stripPointerCasts());
+    if (!alloc_call || alloc_call->getParent() != builder.GetInsertBlock()) {
+        return false;
+    }
+    
+    llvm::Function* callee = alloc_call->getCalledFunction();
+    if (!callee || callee->getName() != "aria_gc_alloc") {
+        return false;
+    }
+    
+    auto* size = llvm::dyn_cast<llvm::ConstantInt>(alloc_call->getArgOperand(0));
+    if (!size || size->getZExtValue() >= ARIA_GC_MIN_LARGE_OBJECT_SIZE) {
+        return false;
+    }
+    
+    for (auto it = std::next(alloc_call->getIterator()); it != builder.GetInsertPoint(); ++it) {
+        if (llvm::isa<llvm::CallBase>(*it) && !llvm::isa<llvm::IntrinsicInst>(*it)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Store a value into a field of a GC object with inline write barriers
+ * 
+ * Non-pointer stores never need a barrier. For pointer stores, the SATB
+ * pre-barrier is a byte load and a not-taken branch unless a concurrent
+ * mark is in progress, and the card-marking post-barrier tests the
+ * target's header and, for old objects only, dirties its card with two
+ * byte stores (see the inline protocol in runtime/gc.h). Only the SATB
+ * logging is an out-of-line call.
+ * 
+ * With --elide-write-barriers, stores into objects proven fresh by
+ * isFreshGCAllocation are emitted as plain stores.
+ * 
+ * Generated LLVM IR:
+ *   %satb = load i8, i8* @aria_gc_satb_active
+ *   %satb.on = icmp ne i8 %satb, 0
+ *   br i1 %satb.on, label %satb.log, label %satb.done     ; unlikely
+ * satb.log:
+ *   call void @aria_gc_write_barrier_pre(i8** %slot)
+ *   br label %satb.done
+ * satb.done:
+ *   store %T* %value, %T** %field
+ *   %hdr = load i64, i64* %obj.header
+ *   %young = icmp ne i64 (and i64 %hdr, 8), 0
+ *   %null = icmp eq %T* %value, null
+ *   br i1 (or i1 %young, %null), label %card.done, label %card.mark
+ * card.mark:
+ *   store i8 1, i8* %card
+ *   store i8 1, i8* %segment.cards
+ *   br label %card.done
+ */
+void StmtCodegen::emitGCStore(llvm::Value* obj, llvm::Value* slot, llvm::Value* value) {
+    if (!value->getType()->isPointerTy() ||
+        (elide_write_barriers && isFreshGCAllocation(obj))) {
+        builder.CreateStore(value, slot);
+        return;
+    }
+    
+    llvm::Function* func = builder.GetInsertBlock()->getParent();
+    llvm::Type* i8_type = llvm::Type::getInt8Ty(context);
+    llvm::Type* i64_type = llvm::Type::getInt64Ty(context);
+    llvm::Type* i8_ptr = llvm::PointerType::get(i8_type, 0);
+    llvm::MDBuilder md_builder(context);
+    llvm::MDNode* unlikely = md_builder.createBranchWeights(1, 1000);
+    
+    // SATB pre-barrier: log the overwritten reference while marking
+    llvm::BasicBlock* satb_log = llvm::BasicBlock::Create(context, "satb.log", func);
+    llvm::BasicBlock* satb_done = llvm::BasicBlock::Create(context, "satb.done", func);
+    
+    llvm::Value* satb = builder.CreateLoad(i8_type, getOrDeclareSATBActiveFlag(), "satb");
+    llvm::Value* satb_on = builder.CreateICmpNE(satb, llvm::ConstantInt::get(i8_type, 0), "satb.on");
+    builder.CreateCondBr(satb_on, satb_log, satb_done, unlikely);
+    
+    builder.SetInsertPoint(satb_log);
+    builder.CreateCall(getOrDeclareGCWriteBarrierPre(),
+                       {builder.CreateBitCast(slot, llvm::PointerType::get(i8_ptr, 0))});
+    builder.CreateBr(satb_done);
+    
+    builder.SetInsertPoint(satb_done);
+    builder.CreateStore(value, slot);
+    
+    // Card-marking post-barrier: no-op unless obj is in the old generation
+    llvm::BasicBlock* card_mark = llvm::BasicBlock::Create(context, "card.mark", func);
+    llvm::BasicBlock* card_done = llvm::BasicBlock::Create(context, "card.done", func);
+    
+    llvm::Value* obj_addr = builder.CreatePtrToInt(obj, i64_type, "obj.addr");
+    llvm::Value* header_ptr = builder.CreateIntToPtr(
+        builder.CreateSub(obj_addr, llvm::ConstantInt::get(i64_type, 8)),
+        llvm::PointerType::get(i64_type, 0), "obj.header");
+    llvm::Value* header = builder.CreateLoad(i64_type, header_ptr, "hdr");
+    llvm::Value* young = builder.CreateICmpNE(
+        builder.CreateAnd(header, llvm::ConstantInt::get(i64_type, ARIA_GC_HEADER_NURSERY_BIT)),
+        llvm::ConstantInt::get(i64_type, 0), "young");
+    llvm::Value* is_null = builder.CreateIsNull(value, "null");
+    builder.CreateCondBr(builder.CreateOr(young, is_null), card_done, card_mark,
+                         md_builder.createBranchWeights(1000, 1));
+    
+    builder.SetInsertPoint(card_mark);
+    llvm::Value* segment_mask = llvm::ConstantInt::get(i64_type, ARIA_GC_SEGMENT_SIZE - 1);
+    llvm::Value* cards = builder.CreateIntToPtr(
+        builder.CreateAnd(obj_addr, builder.CreateNot(segment_mask)), i8_ptr, "segment.cards");
+    llvm::Value* card_index = builder.CreateLShr(
+        builder.CreateAnd(obj_addr, segment_mask), ARIA_GC_CARD_SHIFT, "card.index");
+    llvm::Value* card = builder.CreateInBoundsGEP(i8_type, cards, card_index, "card");
+    llvm::Value* dirty = llvm::ConstantInt::get(i8_type, ARIA_GC_CARD_DIRTY);
+    builder.CreateStore(dirty, card);
+    builder.CreateStore(dirty, cards);  // Segment summary card
+    builder.CreateBr(card_done);
+    
+    builder.SetInsertPoint(card_done);
+}
+
+// ============================================================================
+// Shadow Stack Frames
+// ============================================================================
+
+/**
+ * Get or declare the runtime's thread-local shadow stack head
+ * Declaration: @aria_shadow_stack_top = external thread_local global i8*
+ */
+llvm::GlobalVariable* StmtCodegen::getOrDeclareShadowStackTop() {
+    llvm::GlobalVariable* top = module->getNamedGlobal("aria_shadow_stack_top");
+    if (!top) {
+        top = new llvm::GlobalVariable(
+            *module, llvm::PointerType::get(llvm::Type::getInt8Ty(context), 0), false,
+            llvm::GlobalValue::ExternalLinkage, nullptr, "aria_shadow_stack_top",
+            nullptr, llvm::GlobalValue::GeneralDynamicTLSModel);
+    }
+    return top;
+}
+
+/**
+ * Set aside the enclosing function's statement scopes
+ * 
+ * Without this a nested function's `return` would run the enclosing
+ * function's defers, `break` could target its loops, and an `arena`
+ * local would allocate from an arena that is not in the nested frame.
+ */
+FunctionScope StmtCodegen::beginFunctionScope() {
+    FunctionScope enclosing;
+    enclosing.loop_stack.swap(loop_stack);
+    enclosing.defer_stack.swap(defer_stack);
+    enclosing.arena_stack.swap(arena_stack);
+    return enclosing;
+}
+
+void StmtCodegen::endFunctionScope(FunctionScope enclosing) {
+    loop_stack.swap(enclosing.loop_stack);
+    defer_stack.swap(enclosing.defer_stack);
+    arena_stack.swap(enclosing.arena_stack);
+}
+
+GCRootFrame StmtCodegen::beginGCRootFrame(llvm::Function* func) {
+    GCRootFrame enclosing = gc_frame;
+    gc_frame = GCRootFrame();
+    gc_frame.func = func;
+    return enclosing;
+}
+
+/**
+ * Store a gc object in the next root slot of the current frame
+ * 
+ * The frame alloca is created on first use with room for the header
+ * only; endGCRootFrame resizes it once the number of roots is known.
+ * The slot becomes the local's storage: a collection that moves the
+ * object updates the slot, so every use loads the object from it.
+ */
+llvm::Value* StmtCodegen::addGCRoot(llvm::Value* obj) {
+    if (!gc_frame.func) {
+        return nullptr;
+    }
+    
+    llvm::Type* i8_ptr = llvm::PointerType::get(llvm::Type::getInt8Ty(context), 0);
+    llvm::Type* i64_type = llvm::Type::getInt64Ty(context);
+    
+    if (!gc_frame.slots) {
+        llvm::BasicBlock& entry = gc_frame.func->getEntryBlock();
+        llvm::IRBuilder<> tmp_builder(&entry, entry.begin());
+        gc_frame.slots = tmp_builder.CreateAlloca(
+            i8_ptr, llvm::ConstantInt::get(i64_type, SHADOW_FRAME_HEADER_WORDS), "gc.frame");
+    }
+    
+    uint64_t slot_index = SHADOW_FRAME_HEADER_WORDS + gc_frame.num_roots++;
+    llvm::Value* slot = builder.CreateConstInBoundsGEP1_64(
+        i8_ptr, gc_frame.slots, slot_index, "gc.root");
+    builder.CreateStore(builder.CreateBitCast(obj, i8_ptr), slot);
+    gc_root_slots.insert(slot);
+    return slot;
+}
+
+bool StmtCodegen::isGCRootSlot(llvm::Value* value) const {
+    return gc_root_slots.count(value) != 0;
+}
+
+bool StmtCodegen::isStackGCObject(llvm::Value* value) const {
+    return stack_gc_objects.count(value) != 0;
+}
+
+/**
+ * Emit the shadow frame prologue and epilogues
+ * 
+ * Generated LLVM IR (2 roots):
+ *   entry:
+ *     %gc.frame = alloca i8*, i64 4
+ *     %gc.prev = load i8*, i8** @aria_shadow_stack_top
+ *     store i8* %gc.prev, i8** %gc.frame
+ *     store i32 2, i32* %gc.num_roots
+ *     store i32 0, i32* %gc.flags
+ *     call void @llvm.memset(%gc.roots, i8 0, i64 16)
+ *     store i8* %gc.frame, i8** @aria_shadow_stack_top
+ *     ...
+ *   ; before every ret:
+ *     %gc.caller = load i8*, i8** %gc.frame
+ *     store i8* %gc.caller, i8** @aria_shadow_stack_top
+ */
+void StmtCodegen::endGCRootFrame(const GCRootFrame& enclosing) {
+    GCRootFrame frame = gc_frame;
+    gc_frame = enclosing;
+    
+    if (!frame.slots) {
+        return;  // No gc locals: no frame, no overhead
+    }
+    
+    llvm::Type* i8_ptr = llvm::PointerType::get(llvm::Type::getInt8Ty(context), 0);
+    llvm::Type* i32_type = llvm::Type::getInt32Ty(context);
+    llvm::Type* i64_type = llvm::Type::getInt64Ty(context);
+    llvm::GlobalVariable* top = getOrDeclareShadowStackTop();
+    
+    frame.slots->setOperand(0, llvm::ConstantInt::get(
+        i64_type, SHADOW_FRAME_HEADER_WORDS + frame.num_roots));
+    
+    // Prologue, right after the frame alloca
+    llvm::IRBuilder<> prologue(frame.slots->getParent(), std::next(frame.slots->getIterator()));
+    llvm::Value* prev = prologue.CreateLoad(i8_ptr, top, "gc.prev");
+    prologue.CreateStore(prev, frame.slots);
+    llvm::Value* counts = prologue.CreateBitCast(
+        prologue.CreateConstInBoundsGEP1_64(i8_ptr, frame.slots, 1),
+        llvm::PointerType::get(i32_type, 0));
+    prologue.CreateStore(llvm::ConstantInt::get(i32_type, frame.num_roots), counts);
+    prologue.CreateStore(llvm::ConstantInt::get(i32_type, 0),
+                         prologue.CreateConstInBoundsGEP1_64(i32_type, counts, 1));
+    llvm::Value* roots = prologue.CreateConstInBoundsGEP1_64(
+        i8_ptr, frame.slots, SHADOW_FRAME_HEADER_WORDS, "gc.roots");
+    prologue.CreateMemSet(roots, llvm::ConstantInt::get(llvm::Type::getInt8Ty(context), 0),
+                          frame.num_roots * sizeof(void*), llvm::MaybeAlign(8));
+    prologue.CreateStore(prologue.CreateBitCast(frame.slots, i8_ptr), top);
+    
+    // Epilogue before every return
+    for (llvm::BasicBlock& block : *frame.func) {
+        if (auto* ret = llvm::dyn_cast_or_null<llvm::ReturnInst>(block.getTerminator())) {
+            llvm::IRBuilder<> epilogue(ret);
+            llvm::Value* caller = epilogue.CreateLoad(i8_ptr, frame.slots, "gc.caller");
+            epilogue.CreateStore(caller, top);
+        }
+    }
+}
+
 /**
  * Get or declare aria.alloc runtime function (wild memory)
  * Signature: void* aria_alloc(i64 size)
@@ -160,6 +632,74 @@ llvm::Function* StmtCodegen::getOrDeclareWildFree() {
     return func;
 }
 
+/**
+ * Get or declare aria_arena_create runtime function
+ * Signature: void* aria_arena_create(i64 chunk_size)
+ */
+llvm::Function* StmtCodegen::getOrDeclareArenaCreate() {
+    llvm::Function* func = module->getFunction("aria_arena_create");
+    if (!func) {
+        llvm::FunctionType* func_type = llvm::FunctionType::get(
+            llvm::PointerType::get(llvm::Type::getInt8Ty(context), 0),  // AriaArena* return
+            {llvm::Type::getInt64Ty(context)},                          // i64 chunk_size
+            false
+        );
+        func = llvm::Function::Create(
+            func_type,
+            llvm::Function::ExternalLinkage,
+            "aria_arena_create",
+            module
+        );
+    }
+    return func;
+}
+
+/**
+ * Get or declare aria_arena_alloc runtime function
+ * Signature: void* aria_arena_alloc(void* arena, i64 size, i64 alignment)
+ */
+llvm::Function* StmtCodegen::getOrDeclareArenaAlloc() {
+    llvm::Function* func = module->getFunction("aria_arena_alloc");
+    if (!func) {
+        llvm::Type* i8_ptr = llvm::PointerType::get(llvm::Type::getInt8Ty(context), 0);
+        llvm::Type* i64 = llvm::Type::getInt64Ty(context);
+        llvm::FunctionType* func_type = llvm::FunctionType::get(
+            i8_ptr,                 // void* return
+            {i8_ptr, i64, i64},     // arena, size, alignment
+            false
+        );
+        func = llvm::Function::Create(
+            func_type,
+            llvm::Function::ExternalLinkage,
+            "aria_arena_alloc",
+            module
+        );
+    }
+    return func;
+}
+
+/**
+ * Get or declare aria_arena_destroy runtime function
+ * Signature: void aria_arena_destroy(void* arena)
+ */
+llvm::Function* StmtCodegen::getOrDeclareArenaDestroy() {
+    llvm::Function* func = module->getFunction("aria_arena_destroy");
+    if (!func) {
+        llvm::FunctionType* func_type = llvm::FunctionType::get(
+            llvm::Type::getVoidTy(context),                              // void return
+            {llvm::PointerType::get(llvm::Type::getInt8Ty(context), 0)}, // AriaArena* param
+            false
+        );
+        func = llvm::Function::Create(
+            func_type,
+            llvm::Function::ExternalLinkage,
+            "aria_arena_destroy",
+            module
+        );
+    }
+    return func;
+}
+
 // ============================================================================
 // Phase 4.5.3: LLVM Coroutine Intrinsics for Async/Await
 // ============================================================================
@@ -276,11 +816,15 @@ llvm::Function* StmtCodegen::getCoroResume() {
 /**
  * Generate code for variable declaration
  * 
- * Supports four allocation strategies based on keywords:
+ * Supports five allocation strategies based on keywords:
  * 1. stack: Fast LIFO allocation via alloca (explicit or default for primitives)
- * 2. gc: Garbage collected heap via aria_gc_alloc (default for objects)
+ * 2. gc: Garbage collected heap via aria_gc_alloc (default for objects);
+ *    a stack slot instead if escape analysis proves the object dies with
+ *    the call and its type holds no references (the slot is the object:
+ *    zeroed like a heap one, and the name still evaluates to its address)
  * 3. wild: Manual heap via aria.alloc/aria.free (opt-out of GC)
  * 4. wildx: Executable memory via aria_alloc_exec (JIT code generation)
+ * 5. arena: Bump allocation from the enclosing region via aria_arena_alloc
  * 
  * Example Aria code:
  *   i32:x = 42;                    // Default (stack for primitive)
@@ -294,9 +838,10 @@ llvm::Function* StmtCodegen::getCoroResume() {
  *   store i32 42, i32* %x
  * 
  * Generated LLVM IR (gc):
- *   %0 = call i8* @aria_gc_alloc(i64 16)
- *   %x = bitcast i8* %0 to i32*
- *   store i32 42, i32* %x
+ *   %0 = call i8* @aria_gc_alloc(i64 16, i16 0)
+ *   %gc.root = getelementptr inbounds i8*, i8** %gc.frame, i64 2
+ *   store i8* %0, i8** %gc.root      ; the root slot is the variable
+ *   store i32 42, i32* %0            ; reloaded from %gc.root after a call
  * 
  * Generated LLVM IR (wild):
  *   %0 = call i8* @aria_alloc(i64 8)
@@ -316,8 +861,30 @@ void StmtCodegen::codegenVarDecl(VarDeclStmt* stmt) {
     // Default: stack for primitives, gc for objects
     
     llvm::Value* var_ptr = nullptr;
+    llvm::Value* gc_object = nullptr;  // Heap gc allocation, if any
+    
+    // A non-escaping gc object without references is invisible to the
+    // collector, so it needs neither the heap nor a root slot. Objects
+    // with references stay on the heap: a stack slot would hide their
+    // referents from the collector.
+    bool stack_promoted = false;
+    if (stmt->isGC && stmt->noEscape) {
+        std::vector<uint64_t> bitmap;
+        collectReferenceWords(module->getDataLayout(), var_type, 0, bitmap);
+        stack_promoted = bitmap.empty();
+    }
     
-    if (stmt->isStack || (!stmt->isWild && !stmt->isGC)) {
+    if (stack_promoted) {
+        llvm::IRBuilder<> tmp_builder(&func->getEntryBlock(), func->getEntryBlock().begin());
+        var_ptr = tmp_builder.CreateAlloca(var_type, nullptr, stmt->varName);
+        stack_gc_objects.insert(var_ptr);
+        
+        // aria_gc_alloc returns zeroed objects, once per execution of the
+        // declaration (it may sit in a loop); an initializer narrower than
+        // the type writes only part of the object
+        builder.CreateStore(llvm::Constant::getNullValue(var_type), var_ptr);
+        
+    } else if (stmt->isStack || (!stmt->isWild && !stmt->isGC && !stmt->isArena)) {
         // Stack allocation (default or explicit)
         // Use alloca instruction - fast LIFO allocation
         llvm::IRBuilder<> tmp_builder(&func->getEntryBlock(), func->getEntryBlock().begin());
@@ -334,15 +901,23 @@ void StmtCodegen::codegenVarDecl(VarDeclStmt* stmt) {
         uint64_t type_size = data_layout.getTypeAllocSize(var_type);
         llvm::Value* size = llvm::ConstantInt::get(llvm::Type::getInt64Ty(context), type_size);
         
-        // Call aria_gc_alloc(size) -> returns void* (i8*)
-        llvm::Value* raw_ptr = builder.CreateCall(gc_alloc, {size}, "gc_alloc");
-        
-        // Bitcast void* to appropriate pointer type
-        var_ptr = builder.CreateBitCast(
-            raw_ptr,
-            llvm::PointerType::get(var_type, 0),
-            stmt->varName
-        );
+        // Reference map for precise tracing (0 for pointer-free types)
+        llvm::Value* type_id = getGCTypeId(var_type);
+        
+        // Call aria_gc_alloc(size, type_id) -> returns void* (i8*)
+        gc_object = builder.CreateCall(gc_alloc, {size, type_id}, "gc_alloc");
+        
+        // Keep the object reachable from this function's shadow frame; the
+        // root slot is the variable (loaded at each use, since any call may
+        // move the object). Unrooted functions use the pointer directly.
+        var_ptr = addGCRoot(gc_object);
+        if (!var_ptr) {
+            var_ptr = builder.CreateBitCast(
+                gc_object,
+                llvm::PointerType::get(var_type, 0),
+                stmt->varName
+            );
+        }
         
     } else if (stmt->isWild) {
         // Wild heap allocation (manual memory management)
@@ -363,6 +938,30 @@ void StmtCodegen::codegenVarDecl(VarDeclStmt* stmt) {
             llvm::PointerType::get(var_type, 0),
             stmt->varName
         );
+        
+    } else if (stmt->isArena) {
+        // Region allocation: freed with the whole arena at region exit
+        if (arena_stack.empty()) {
+            throw std::runtime_error("arena variable outside of an arena region: " + stmt->varName);
+        }
+        llvm::Value* arena_slot = named_values[arena_stack.back()];
+        llvm::Value* arena = builder.CreateLoad(
+            llvm::PointerType::get(llvm::Type::getInt8Ty(context), 0), arena_slot, "arena");
+        
+        const llvm::DataLayout& data_layout = module->getDataLayout();
+        uint64_t type_size = data_layout.getTypeAllocSize(var_type);
+        uint64_t type_align = data_layout.getABITypeAlign(var_type).value();
+        llvm::Value* size = llvm::ConstantInt::get(llvm::Type::getInt64Ty(context), type_size);
+        llvm::Value* align = llvm::ConstantInt::get(llvm::Type::getInt64Ty(context), type_align);
+        
+        // Call aria_arena_alloc(arena, size, alignment) -> returns void* (i8*)
+        llvm::Value* raw_ptr = builder.CreateCall(getOrDeclareArenaAlloc(), {arena, size, align}, "arena_alloc");
+        
+        var_ptr = builder.CreateBitCast(
+            raw_ptr,
+            llvm::PointerType::get(var_type, 0),
+            stmt->varName
+        );
     }
     // Note: wildx allocation would be handled via explicit aria_alloc_exec() calls in user code,
     // not via variable declarations (it's for runtime code generation, not regular variables)
@@ -388,7 +987,18 @@ void StmtCodegen::codegenVarDecl(VarDeclStmt* stmt) {
         }
         
         // Store the initial value in the allocated memory
-        builder.CreateStore(init_value, var_ptr);
+        if (stmt->isGC && !stack_promoted) {
+            // The initializer may have collected and moved the object:
+            // reload it unless no call has run since the allocation
+            llvm::Value* obj = gc_object;
+            if (isGCRootSlot(var_ptr) && !isFreshGCAllocation(gc_object)) {
+                obj = builder.CreateLoad(
+                    llvm::PointerType::get(var_type, 0), var_ptr, stmt->varName);
+            }
+            emitGCStore(obj, obj, init_value);
+        } else {
+            builder.CreateStore(init_value, var_ptr);
+        }
     }
 }
 
@@ -467,7 +1077,9 @@ llvm::Function* StmtCodegen::codegenFuncDecl(FuncDeclStmt* stmt) {
         idx++;
     }
     
-    // Create entry block
+    // Create entry block (a nested function returns to the enclosing
+    // body's insertion point afterwards)
+    llvm::IRBuilderBase::InsertPoint enclosing_ip = builder.saveIP();
     llvm::BasicBlock* entry = llvm::BasicBlock::Create(context, "entry", func);
     builder.SetInsertPoint(entry);
     
@@ -528,6 +1140,11 @@ llvm::Function* StmtCodegen::codegenFuncDecl(FuncDeclStmt* stmt) {
     std::map<std::string, llvm::Value*> old_named_values = named_values;
     named_values.clear();
     
+    // Shadow stack frame for gc locals (coroutine frames outlive the
+    // call, so async functions are not given one)
+    GCRootFrame enclosing_gc_frame = beginGCRootFrame(stmt->isAsync ? nullptr : func);
+    FunctionScope enclosing_scope = beginFunctionScope();
+    
     // Create allocas for parameters and store their values
     // This allows parameters to be mutable (can be reassigned in function body)
     idx = 0;
@@ -548,6 +1165,10 @@ llvm::Function* StmtCodegen::codegenFuncDecl(FuncDeclStmt* stmt) {
     
     // Generate code for function body
     if (stmt->body) {
+        // Mark the gc locals that can live in this frame (codegenVarDecl)
+        EscapeAnalyzer escape_analyzer;
+        escape_analyzer.analyzeFuncDecl(stmt);
+        
         BlockStmt* body_block = static_cast<BlockStmt*>(stmt->body.get());
         codegenBlock(body_block);
     }
@@ -625,8 +1246,13 @@ llvm::Function* StmtCodegen::codegenFuncDecl(FuncDeclStmt* stmt) {
         builder.CreateRet(coro_handle);
     }
     
+    // Link/unlink the shadow frame now that every return exists
+    endGCRootFrame(enclosing_gc_frame);
+    endFunctionScope(std::move(enclosing_scope));
+    
     // Restore old named_values
     named_values = old_named_values;
+    builder.restoreIP(enclosing_ip);
     
     // Verify the function
     std::string error_msg;
@@ -878,7 +1504,7 @@ void StmtCodegen::codegenWhile(WhileStmt* stmt) {
     llvm::BasicBlock* end_block = llvm::BasicBlock::Create(context, "while.end");
     
     // Push loop context for break/continue (unlabeled)
-    loop_stack.emplace_back("", cond_block, end_block);
+    loop_stack.emplace_back("", cond_block, end_block, defer_stack.size());
     
     // Push new defer scope for loop body
     defer_stack.push_back(std::vector<BlockStmt*>());
@@ -996,7 +1622,7 @@ void StmtCodegen::codegenFor(ForStmt* stmt) {
     }
     
     // Push loop context for break/continue (continue goes to inc_block)
-    loop_stack.emplace_back("", inc_block, end_block);
+    loop_stack.emplace_back("", inc_block, end_block, defer_stack.size());
     
     // Push new defer scope for loop body
     defer_stack.push_back(std::vector<BlockStmt*>());
@@ -1135,7 +1761,7 @@ void StmtCodegen::codegenTill(TillStmt* stmt) {
     llvm::BasicBlock* end_block = llvm::BasicBlock::Create(context, "till.end");
     
     // Push loop context for break/continue (continue goes to inc_block)
-    loop_stack.emplace_back("", inc_block, end_block);
+    loop_stack.emplace_back("", inc_block, end_block, defer_stack.size());
     
     // Push new defer scope for loop body
     defer_stack.push_back(std::vector<BlockStmt*>());
@@ -1265,7 +1891,7 @@ void StmtCodegen::codegenLoop(LoopStmt* stmt) {
     llvm::BasicBlock* end_block = llvm::BasicBlock::Create(context, "loop.end");
     
     // Push loop context for break/continue (continue goes to inc_block)
-    loop_stack.emplace_back("", inc_block, end_block);
+    loop_stack.emplace_back("", inc_block, end_block, defer_stack.size());
     
     // Push new defer scope for loop body
     defer_stack.push_back(std::vector<BlockStmt*>());
@@ -1407,7 +2033,7 @@ void StmtCodegen::codegenWhen(WhenStmt* stmt) {
     }
     
     // Push loop context for break/continue (continue goes to cond_block, break goes to decision_block)
-    loop_stack.emplace_back("", cond_block, decision_block);
+    loop_stack.emplace_back("", cond_block, decision_block, defer_stack.size());
     
     // Push new defer scope for loop body
     defer_stack.push_back(std::vector<BlockStmt*>());
@@ -1864,6 +2490,12 @@ void StmtCodegen::executeScopeDefers() {
         return;
     }
     
+    // A scope ending in return/break/continue already ran its defers
+    // on that path
+    if (builder.GetInsertBlock()->getTerminator()) {
+        return;
+    }
+    
     // Get the current scope's defer blocks
     std::vector<BlockStmt*>& current_scope_defers = defer_stack.back();
     
@@ -1884,11 +2516,30 @@ void StmtCodegen::executeScopeDefers() {
  * are executed before returning, maintaining LIFO order.
  */
 void StmtCodegen::executeFunctionDefers() {
-    // Execute all scopes' defers in reverse order (inside-out)
+    executeDefersDownTo(0);
+}
+
+bool StmtCodegen::hasPendingDefers() const {
+    for (const std::vector<BlockStmt*>& scope_defers : defer_stack) {
+        if (!scope_defers.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Execute the defer blocks of every scope above depth
+ * 
+ * Called by break/continue with the target loop's depth, so that scopes
+ * nested inside the loop body (blocks, arena regions) are cleaned up
+ * along with it. Scopes run inside-out, each in LIFO order.
+ */
+void StmtCodegen::executeDefersDownTo(size_t depth) {
     // Note: Execute statements directly, not via codegenBlock to avoid recursive defer scoping
-    for (auto scope_it = defer_stack.rbegin(); scope_it != defer_stack.rend(); ++scope_it) {
-        // Within each scope, execute defers in LIFO order
-        for (auto defer_it = scope_it->rbegin(); defer_it != scope_it->rend(); ++defer_it) {
+    for (size_t scope = defer_stack.size(); scope > depth; --scope) {
+        std::vector<BlockStmt*>& scope_defers = defer_stack[scope - 1];
+        for (auto defer_it = scope_defers.rbegin(); defer_it != scope_defers.rend(); ++defer_it) {
             BlockStmt* defer_block = *defer_it;
             for (const auto& statement : defer_block->statements) {
                 codegenStatement(statement.get());
@@ -1910,12 +2561,11 @@ void StmtCodegen::executeFunctionDefers() {
  *   }
  * 
  * Per research_020: Return must execute all defers in the function
- * before transferring control to the caller.
+ * before transferring control to the caller. The return value is
+ * evaluated first, so `arena { ...; return x.f; }` reads x before the
+ * arena is released.
  */
 void StmtCodegen::codegenReturn(ReturnStmt* stmt) {
-    // Execute all defer blocks before returning (LIFO order)
-    executeFunctionDefers();
-    
     if (stmt->value) {
         if (!expr_codegen) {
             throw std::runtime_error("ExprCodegen not set in StmtCodegen");
@@ -1965,9 +2615,23 @@ void StmtCodegen::codegenReturn(ReturnStmt* stmt) {
             }
         }
         
+        // Defers run after the value is computed: it may still read
+        // memory a deferred block (e.g. an arena release) frees. They can
+        // also allocate, so a pointer result is kept in a root slot
+        // across them (a collection may move the object it points to)
+        llvm::Value* ret_slot = nullptr;
+        if (ret_value->getType()->isPointerTy() && !llvm::isa<llvm::Constant>(ret_value) &&
+            hasPendingDefers()) {
+            ret_slot = addGCRoot(ret_value);
+        }
+        executeFunctionDefers();
+        if (ret_slot) {
+            ret_value = builder.CreateLoad(ret_value->getType(), ret_slot, "ret.reload");
+        }
         builder.CreateRet(ret_value);
     } else {
-        // Return void
+        // Execute all defer blocks before returning (LIFO order)
+        executeFunctionDefers();
         builder.CreateRetVoid();
     }
 }
@@ -1976,7 +2640,8 @@ void StmtCodegen::codegenReturn(ReturnStmt* stmt) {
  * Generate code for break statement
  * 
  * Exits the current loop (or labeled loop) by branching to the loop's
- * break_block. Executes defer blocks in the current scope before exiting.
+ * break_block. Executes the defer blocks of every scope being exited,
+ * up to and including the loop body, before leaving.
  * 
  * Example Aria code:
  *   while (true) {
@@ -1999,29 +2664,30 @@ void StmtCodegen::codegenBreak(BreakStmt* stmt) {
         throw std::runtime_error("break statement outside of loop");
     }
     
-    // Execute defers in current scope before breaking
-    executeScopeDefers();
-    
     // Find the target loop
-    llvm::BasicBlock* target_break_block = nullptr;
+    const LoopContext* target = nullptr;
     
     if (stmt->label.empty()) {
         // Unlabeled break: target innermost loop
-        target_break_block = loop_stack.back().break_block;
+        target = &loop_stack.back();
     } else {
         // Labeled break: search for matching label
         for (auto it = loop_stack.rbegin(); it != loop_stack.rend(); ++it) {
             if (it->label == stmt->label) {
-                target_break_block = it->break_block;
+                target = &*it;
                 break;
             }
         }
         
-        if (!target_break_block) {
+        if (!target) {
             throw std::runtime_error("break label '" + stmt->label + "' not found");
         }
     }
     
+    // Execute defers of every scope inside the target loop
+    executeDefersDownTo(target->defer_depth);
+    llvm::BasicBlock* target_break_block = target->break_block;
+    
     // Branch to the loop's break block
     builder.CreateBr(target_break_block);
 }
@@ -2030,7 +2696,8 @@ void StmtCodegen::codegenBreak(BreakStmt* stmt) {
  * Generate code for continue statement
  * 
  * Skips the remainder of the current loop iteration by branching to
- * the loop's continue_block. Executes defer blocks before continuing.
+ * the loop's continue_block. Executes the defer blocks of every scope
+ * inside the loop body before continuing.
  * 
  * Example Aria code:
  *   for (i32:i = 0; i < 10; i++) {
@@ -2053,29 +2720,30 @@ void StmtCodegen::codegenContinue(ContinueStmt* stmt) {
         throw std::runtime_error("continue statement outside of loop");
     }
     
-    // Execute defers in current scope before continuing
-    executeScopeDefers();
-    
     // Find the target loop
-    llvm::BasicBlock* target_continue_block = nullptr;
+    const LoopContext* target = nullptr;
     
     if (stmt->label.empty()) {
         // Unlabeled continue: target innermost loop
-        target_continue_block = loop_stack.back().continue_block;
+        target = &loop_stack.back();
     } else {
         // Labeled continue: search for matching label
         for (auto it = loop_stack.rbegin(); it != loop_stack.rend(); ++it) {
             if (it->label == stmt->label) {
-                target_continue_block = it->continue_block;
+                target = &*it;
                 break;
             }
         }
         
-        if (!target_continue_block) {
+        if (!target) {
             throw std::runtime_error("continue label '" + stmt->label + "' not found");
         }
     }
     
+    // Execute defers of every scope inside the target loop
+    executeDefersDownTo(target->defer_depth);
+    llvm::BasicBlock* target_continue_block = target->continue_block;
+    
     // Branch to the loop's continue block
     builder.CreateBr(target_continue_block);
 }
@@ -2114,6 +2782,60 @@ void StmtCodegen::codegenDefer(DeferStmt* stmt) {
     // Note: Actual execution happens at scope exit, not here
 }
 
+/**
+ * Generate code for arena region
+ * 
+ * Creates an arena on entry and registers its destruction as the first
+ * defer of the region's scope, so it runs after the body's own defers
+ * (which may still use arena memory) and on every exit path that runs
+ * defers (fallthrough, break, continue, return).
+ * 
+ * Example Aria code:
+ *   arena {
+ *       arena Token:tok = next_token();
+ *       defer { print("done"); }
+ *   }  // Outputs "done", then releases tok with the arena
+ * 
+ * Generated LLVM IR:
+ *   %__arena.0 = alloca i8*              ; entry block
+ *   %0 = call i8* @aria_arena_create(i64 0)
+ *   store i8* %0, i8** %__arena.0
+ *   ...
+ *   %1 = load i8*, i8** %__arena.0
+ *   call void @aria_arena_destroy(i8* %1)
+ */
+void StmtCodegen::codegenRegion(RegionStmt* stmt) {
+    llvm::Function* func = builder.GetInsertBlock()->getParent();
+    llvm::Type* i8_ptr = llvm::PointerType::get(llvm::Type::getInt8Ty(context), 0);
+    
+    // Hidden local holding the arena (read back by the cleanup block)
+    llvm::IRBuilder<> tmp_builder(&func->getEntryBlock(), func->getEntryBlock().begin());
+    llvm::AllocaInst* arena_slot = tmp_builder.CreateAlloca(i8_ptr, nullptr, stmt->arenaName);
+    
+    llvm::Value* chunk_size = llvm::ConstantInt::get(llvm::Type::getInt64Ty(context), 0);
+    llvm::Value* arena = builder.CreateCall(getOrDeclareArenaCreate(), {chunk_size}, "arena");
+    builder.CreateStore(arena, arena_slot);
+    named_values[stmt->arenaName] = arena_slot;
+    
+    // The cleanup block calls aria_arena_destroy by name
+    getOrDeclareArenaDestroy();
+    
+    defer_stack.push_back(std::vector<BlockStmt*>());
+    defer_stack.back().push_back(static_cast<BlockStmt*>(stmt->cleanup.get()));
+    arena_stack.push_back(stmt->arenaName);
+    
+    BlockStmt* body = static_cast<BlockStmt*>(stmt->body.get());
+    for (const auto& statement : body->statements) {
+        codegenStatement(statement.get());
+    }
+    
+    // Execute defers at region exit (LIFO order: arena released last)
+    executeScopeDefers();
+    
+    arena_stack.pop_back();
+    defer_stack.pop_back();
+}
+
 void StmtCodegen::codegenExpressionStmt(ExpressionStmt* stmt) {
     if (!expr_codegen) {
         throw std::runtime_error("ExprCodegen not set in StmtCodegen");
@@ -2193,6 +2915,10 @@ void StmtCodegen::codegenStatement(ASTNode* stmt) {
             codegenDefer(static_cast<DeferStmt*>(stmt));
             break;
         
+        case ASTNode::NodeType::REGION:
+            codegenRegion(static_cast<RegionStmt*>(stmt));
+            break;
+        
         case ASTNode::NodeType::EXPRESSION_STMT:
             codegenExpressionStmt(static_cast<ExpressionStmt*>(stmt));
             break;
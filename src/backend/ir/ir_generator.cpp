@@ -284,6 +284,12 @@ llvm::Value* aria::IRGenerator::codegen(aria::ASTNode* node) {
     return func;
 }
 
+void aria::IRGenerator::setElideWriteBarriers(bool elide) {
+    if (elide && !module->getModuleFlag("aria.elide-write-barriers")) {
+        module->addModuleFlag(llvm::Module::Max, "aria.elide-write-barriers", 1);
+    }
+}
+
 llvm::Module* aria::IRGenerator::getModule() {
     return module.get();
 }
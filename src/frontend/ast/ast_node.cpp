@@ -38,6 +38,7 @@ std::string ASTNode::nodeTypeToString(NodeType type) {
         case NodeType::BREAK: return "BREAK";
         case NodeType::CONTINUE: return "CONTINUE";
         case NodeType::DEFER: return "DEFER";
+        case NodeType::REGION: return "REGION";
         case NodeType::BLOCK: return "BLOCK";
         case NodeType::EXPRESSION_STMT: return "EXPRESSION_STMT";
         
@@ -10,6 +10,7 @@ std::string VarDeclStmt::toString() const {
     if (isConst) oss << "const ";
     if (isStack) oss << "stack ";
     if (isGC) oss << "gc ";
+    if (isArena) oss << "arena ";
     oss << typeName << ":" << varName;
     if (initializer) {
         oss << " = " << initializer->toString();
@@ -109,6 +110,10 @@ std::string DeferStmt::toString() const {
     return "Defer(" + block->toString() + ")";
 }
 
+std::string RegionStmt::toString() const {
+    return "Region(" + body->toString() + ")";
+}
+
 std::string BreakStmt::toString() const {
     if (!label.empty()) {
         return "Break(" + label + ")";
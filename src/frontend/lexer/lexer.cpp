@@ -16,6 +16,7 @@ static const std::unordered_map<std::string, TokenType> keywords = {
     {"wildx", TokenType::TOKEN_KW_WILDX},
     {"stack", TokenType::TOKEN_KW_STACK},
     {"gc", TokenType::TOKEN_KW_GC},
+    {"arena", TokenType::TOKEN_KW_ARENA},
     {"defer", TokenType::TOKEN_KW_DEFER},
     
     // Control flow
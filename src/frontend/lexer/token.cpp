@@ -105,6 +105,7 @@ std::string tokenTypeToString(TokenType type) {
         case TokenType::TOKEN_KW_WILDX: return "WILDX";
         case TokenType::TOKEN_KW_STACK: return "STACK";
         case TokenType::TOKEN_KW_GC: return "GC";
+        case TokenType::TOKEN_KW_ARENA: return "ARENA";
         case TokenType::TOKEN_KW_DEFER: return "DEFER";
         
         // Control flow
@@ -194,6 +194,7 @@ void Parser::synchronize() {
             case TokenType::TOKEN_KW_BREAK:
             case TokenType::TOKEN_KW_CONTINUE:
             case TokenType::TOKEN_KW_DEFER:
+            case TokenType::TOKEN_KW_ARENA:
             case TokenType::TOKEN_KW_USE:
             case TokenType::TOKEN_KW_MOD:
             case TokenType::TOKEN_KW_EXTERN:
@@ -668,7 +669,11 @@ ASTNodePtr Parser::parseLambda() {
         return nullptr;
     }
     
+    // The body runs on its own call, outside any enclosing region
+    int enclosingRegionDepth = regionDepth;
+    regionDepth = 0;
     ASTNodePtr body = parseBlock();
+    regionDepth = enclosingRegionDepth;
     
     // Create and return the lambda node
     auto lambdaNode = std::make_shared<LambdaExpr>(
@@ -766,11 +771,19 @@ ASTNodePtr Parser::parseStatement() {
         return parseExternStatement();
     }
     
-    // Check for qualifiers (wild, const, stack, gc) followed by type
+    // Region scope: arena { ... } (arena followed by a type is a qualifier)
+    if (check(TokenType::TOKEN_KW_ARENA) && current + 1 < tokens.size() &&
+        tokens[current + 1].type == TokenType::TOKEN_LEFT_BRACE) {
+        advance();
+        return parseRegionStatement();
+    }
+    
+    // Check for qualifiers (wild, const, stack, gc, arena) followed by type
     if (peek().type == TokenType::TOKEN_KW_WILD ||
         peek().type == TokenType::TOKEN_KW_CONST ||
         peek().type == TokenType::TOKEN_KW_STACK ||
-        peek().type == TokenType::TOKEN_KW_GC) {
+        peek().type == TokenType::TOKEN_KW_GC ||
+        peek().type == TokenType::TOKEN_KW_ARENA) {
         return parseVarDecl();
     }
     
@@ -962,12 +975,14 @@ ASTNodePtr Parser::parseVarDecl() {
     bool isConst = false;
     bool isStack = false;
     bool isGC = false;
+    bool isArena = false;
     
     // Handle qualifiers
     while (peek().type == TokenType::TOKEN_KW_WILD ||
            peek().type == TokenType::TOKEN_KW_CONST ||
            peek().type == TokenType::TOKEN_KW_STACK ||
-           peek().type == TokenType::TOKEN_KW_GC) {
+           peek().type == TokenType::TOKEN_KW_GC ||
+           peek().type == TokenType::TOKEN_KW_ARENA) {
         if (match(TokenType::TOKEN_KW_WILD)) {
             isWild = true;
         } else if (match(TokenType::TOKEN_KW_CONST)) {
@@ -976,6 +991,11 @@ ASTNodePtr Parser::parseVarDecl() {
             isStack = true;
         } else if (match(TokenType::TOKEN_KW_GC)) {
             isGC = true;
+        } else if (match(TokenType::TOKEN_KW_ARENA)) {
+            if (regionDepth == 0) {
+                error("'arena' variable declared outside an 'arena { }' region");
+            }
+            isArena = true;
         }
     }
     
@@ -1027,6 +1047,7 @@ ASTNodePtr Parser::parseVarDecl() {
     varDecl->isConst = isConst;
     varDecl->isStack = isStack;
     varDecl->isGC = isGC;
+    varDecl->isArena = isArena;
     
     return varDecl;
 }
@@ -1108,7 +1129,11 @@ ASTNodePtr Parser::parseFuncDecl() {
     
     // Parse function body: { ... }
     consume(TokenType::TOKEN_LEFT_BRACE, "Expected '{' before function body");
+    // A nested function is not inside the enclosing function's regions
+    int enclosingRegionDepth = regionDepth;
+    regionDepth = 0;
     ASTNodePtr body = parseBlock();
+    regionDepth = enclosingRegionDepth;
     
     // Consume semicolon after closing brace
     consume(TokenType::TOKEN_SEMICOLON, "Expected ';' after function declaration");
@@ -1791,6 +1816,41 @@ ASTNodePtr Parser::parseDeferStatement() {
     return std::make_shared<DeferStmt>(block, deferToken.line, deferToken.column);
 }
 
+ASTNodePtr Parser::parseRegionStatement() {
+    using namespace frontend;
+    
+    Token arenaToken = previous(); // We already consumed 'arena'
+    
+    // Parse: arena { block }
+    consume(TokenType::TOKEN_LEFT_BRACE, "Expected '{' after 'arena'");
+    
+    regionDepth++;
+    ASTNodePtr body = parseBlock();
+    regionDepth--;
+    if (!body) {
+        error("Expected block after 'arena'");
+        return nullptr;
+    }
+    
+    // The arena lives in a hidden local ('.' cannot appear in user
+    // identifiers); the cleanup is an ordinary defer block calling
+    // aria_arena_destroy on it
+    std::string arenaName = "__arena." + std::to_string(regionCount++);
+    std::vector<ASTNodePtr> destroyArgs = {
+        std::make_shared<IdentifierExpr>(arenaName, arenaToken.line, arenaToken.column)
+    };
+    auto destroyCall = std::make_shared<CallExpr>(
+        std::make_shared<IdentifierExpr>("aria_arena_destroy", arenaToken.line, arenaToken.column),
+        destroyArgs, arenaToken.line, arenaToken.column);
+    auto cleanup = std::make_shared<BlockStmt>(
+        std::vector<ASTNodePtr>{std::make_shared<ExpressionStmt>(destroyCall, arenaToken.line, arenaToken.column)},
+        arenaToken.line, arenaToken.column);
+    
+    // No semicolon needed after region block (it's a block statement)
+    
+    return std::make_shared<RegionStmt>(body, arenaName, cleanup, arenaToken.line, arenaToken.column);
+}
+
 ASTNodePtr Parser::parseTillStatement() {
     using namespace frontend;
     
@@ -61,6 +61,10 @@ void AsyncSemanticAnalyzer::analyzeStatement(ASTNodePtr stmt) {
             break;
         }
         
+        case ASTNode::NodeType::REGION:
+            analyzeStatement(std::static_pointer_cast<RegionStmt>(stmt)->body);
+            break;
+        
         case ASTNode::NodeType::VAR_DECL: {
             auto varDecl = std::static_pointer_cast<VarDeclStmt>(stmt);
             if (varDecl->initializer) {
@@ -387,6 +387,10 @@ void BorrowChecker::checkStatement(ASTNode* stmt) {
             checkBlockStmt(static_cast<BlockStmt*>(stmt));
             break;
             
+        case ASTNode::NodeType::REGION:
+            checkBlockStmt(static_cast<BlockStmt*>(static_cast<RegionStmt*>(stmt)->body.get()));
+            break;
+            
         case ASTNode::NodeType::RETURN:
             checkReturnStmt(static_cast<ReturnStmt*>(stmt));
             break;
@@ -93,6 +93,10 @@ void ClosureAnalyzer::walkNode(ASTNode* node) {
             break;
         }
             
+        case ASTNode::NodeType::REGION:
+            walkNode(static_cast<RegionStmt*>(node)->body.get());
+            break;
+            
         case ASTNode::NodeType::IF: {
             auto ifStmt = static_cast<IfStmt*>(node);
             walkNode(ifStmt->condition.get());
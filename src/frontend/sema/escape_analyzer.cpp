@@ -0,0 +1,349 @@
+#include "frontend/sema/escape_analyzer.h"
+
+namespace aria {
+namespace sema {
+
+using frontend::TokenType;
+
+EscapeAnalyzer::EscapeAnalyzer()
+    : captureDepth(0), unknownNode(false) {}
+
+void EscapeAnalyzer::analyze(ASTNodePtr root) {
+    if (!root) return;
+
+    if (root->type == ASTNode::NodeType::PROGRAM) {
+        auto program = std::static_pointer_cast<ProgramNode>(root);
+        for (auto& decl : program->declarations) {
+            if (decl->type == ASTNode::NodeType::FUNC_DECL) {
+                analyzeFuncDecl(static_cast<FuncDeclStmt*>(decl.get()));
+            }
+        }
+    }
+}
+
+size_t EscapeAnalyzer::analyzeFuncDecl(FuncDeclStmt* funcDecl) {
+    if (!funcDecl || !funcDecl->body) return 0;
+
+    candidates.clear();
+    escaped.clear();
+    captureDepth = 0;
+    unknownNode = false;
+
+    analyzeStatement(funcDecl->body.get());
+
+    size_t promoted = 0;
+    for (auto& entry : candidates) {
+        bool noEscape = !unknownNode && escaped.count(entry.first) == 0;
+        for (VarDeclStmt* decl : entry.second) {
+            decl->noEscape = noEscape;
+            promoted += noEscape ? 1 : 0;
+        }
+    }
+    return promoted;
+}
+
+// ============================================================================
+// Statements
+// ============================================================================
+
+void EscapeAnalyzer::analyzeStatement(ASTNode* stmt) {
+    if (!stmt) return;
+
+    switch (stmt->type) {
+        case ASTNode::NodeType::BLOCK: {
+            auto block = static_cast<BlockStmt*>(stmt);
+            for (auto& s : block->statements) {
+                analyzeStatement(s.get());
+            }
+            break;
+        }
+
+        case ASTNode::NodeType::REGION:
+            // The cleanup block only names the hidden arena local
+            analyzeStatement(static_cast<RegionStmt*>(stmt)->body.get());
+            break;
+
+        case ASTNode::NodeType::DEFER:
+            analyzeStatement(static_cast<DeferStmt*>(stmt)->block.get());
+            break;
+
+        case ASTNode::NodeType::VAR_DECL: {
+            auto varDecl = static_cast<VarDeclStmt*>(stmt);
+            varDecl->noEscape = false;
+            if (varDecl->isGC && captureDepth == 0) {
+                candidates[varDecl->varName].push_back(varDecl);
+            }
+            // Stored into the new variable
+            analyzeExpression(varDecl->initializer.get(), true);
+            break;
+        }
+
+        case ASTNode::NodeType::FUNC_DECL: {
+            // A nested function sees the enclosing locals only by capture
+            captureDepth++;
+            analyzeStatement(static_cast<FuncDeclStmt*>(stmt)->body.get());
+            captureDepth--;
+            break;
+        }
+
+        case ASTNode::NodeType::EXPRESSION_STMT:
+            analyzeExpression(static_cast<ExpressionStmt*>(stmt)->expression.get(), false);
+            break;
+
+        case ASTNode::NodeType::RETURN:
+            analyzeExpression(static_cast<ReturnStmt*>(stmt)->value.get(), true);
+            break;
+
+        case ASTNode::NodeType::IF: {
+            auto ifStmt = static_cast<IfStmt*>(stmt);
+            analyzeExpression(ifStmt->condition.get(), false);
+            analyzeStatement(ifStmt->thenBranch.get());
+            analyzeStatement(ifStmt->elseBranch.get());
+            break;
+        }
+
+        case ASTNode::NodeType::WHILE: {
+            auto whileStmt = static_cast<WhileStmt*>(stmt);
+            analyzeExpression(whileStmt->condition.get(), false);
+            analyzeStatement(whileStmt->body.get());
+            break;
+        }
+
+        case ASTNode::NodeType::FOR: {
+            auto forStmt = static_cast<ForStmt*>(stmt);
+            if (forStmt->initializer && forStmt->initializer->isStatement()) {
+                analyzeStatement(forStmt->initializer.get());
+            } else {
+                analyzeExpression(forStmt->initializer.get(), false);
+            }
+            analyzeExpression(forStmt->condition.get(), false);
+            analyzeExpression(forStmt->update.get(), false);
+            analyzeStatement(forStmt->body.get());
+            break;
+        }
+
+        case ASTNode::NodeType::LOOP: {
+            auto loopStmt = static_cast<LoopStmt*>(stmt);
+            analyzeExpression(loopStmt->start.get(), false);
+            analyzeExpression(loopStmt->limit.get(), false);
+            analyzeExpression(loopStmt->step.get(), false);
+            analyzeStatement(loopStmt->body.get());
+            break;
+        }
+
+        case ASTNode::NodeType::TILL: {
+            auto tillStmt = static_cast<TillStmt*>(stmt);
+            analyzeExpression(tillStmt->limit.get(), false);
+            analyzeExpression(tillStmt->step.get(), false);
+            analyzeStatement(tillStmt->body.get());
+            break;
+        }
+
+        case ASTNode::NodeType::WHEN: {
+            auto whenStmt = static_cast<WhenStmt*>(stmt);
+            analyzeExpression(whenStmt->condition.get(), false);
+            analyzeStatement(whenStmt->body.get());
+            analyzeStatement(whenStmt->then_block.get());
+            analyzeStatement(whenStmt->end_block.get());
+            break;
+        }
+
+        case ASTNode::NodeType::PICK: {
+            auto pickStmt = static_cast<PickStmt*>(stmt);
+            analyzeExpression(pickStmt->selector.get(), false);
+            for (auto& c : pickStmt->cases) {
+                auto pickCase = static_cast<PickCase*>(c.get());
+                analyzeExpression(pickCase->pattern.get(), false);
+                analyzeStatement(pickCase->body.get());
+            }
+            break;
+        }
+
+        case ASTNode::NodeType::BREAK:
+        case ASTNode::NodeType::CONTINUE:
+        case ASTNode::NodeType::FALL:
+            break;
+
+        default:
+            if (stmt->isExpression()) {
+                analyzeExpression(stmt, false);
+            } else {
+                unknownNode = true;
+            }
+            break;
+    }
+}
+
+// ============================================================================
+// Expressions
+// ============================================================================
+
+void EscapeAnalyzer::analyzeExpression(ASTNode* expr, bool escapes) {
+    if (!expr) return;
+
+    switch (expr->type) {
+        case ASTNode::NodeType::LITERAL:
+            break;
+
+        case ASTNode::NodeType::IDENTIFIER: {
+            auto ident = static_cast<IdentifierExpr*>(expr);
+            if ((escapes || captureDepth > 0) && candidates.count(ident->name)) {
+                escaped.insert(ident->name);
+            }
+            break;
+        }
+
+        case ASTNode::NodeType::BINARY_OP: {
+            auto binary = static_cast<BinaryExpr*>(expr);
+            if (isAssignmentOp(binary->op.type)) {
+                // The parser builds assignments as binary expressions
+                analyzeAssignment(binary->left.get(), binary->op.type, binary->right.get());
+            } else {
+                // The result is a new value; the operands are only read
+                analyzeExpression(binary->left.get(), false);
+                analyzeExpression(binary->right.get(), false);
+            }
+            break;
+        }
+
+        case ASTNode::NodeType::UNARY_OP: {
+            auto unary = static_cast<UnaryExpr*>(expr);
+            TokenType op = unary->op.type;
+            if (op == TokenType::TOKEN_AT || op == TokenType::TOKEN_HASH ||
+                op == TokenType::TOKEN_DOLLAR) {
+                // Address taken or pinned: the object must stay put
+                markRootEscaped(unary->operand.get());
+                analyzeExpression(unary->operand.get(), true);
+            } else {
+                analyzeExpression(unary->operand.get(), false);
+            }
+            break;
+        }
+
+        case ASTNode::NodeType::CALL: {
+            auto call = static_cast<CallExpr*>(expr);
+            analyzeExpression(call->callee.get(), false);
+            for (auto& arg : call->arguments) {
+                analyzeExpression(arg.get(), true);
+            }
+            break;
+        }
+
+        case ASTNode::NodeType::INDEX: {
+            // Conservative: an escaping element may be an interior reference
+            auto index = static_cast<IndexExpr*>(expr);
+            analyzeExpression(index->array.get(), escapes);
+            analyzeExpression(index->index.get(), false);
+            break;
+        }
+
+        case ASTNode::NodeType::MEMBER_ACCESS:
+        case ASTNode::NodeType::POINTER_MEMBER: {
+            auto member = static_cast<MemberAccessExpr*>(expr);
+            analyzeExpression(member->object.get(), escapes);
+            break;
+        }
+
+        case ASTNode::NodeType::TERNARY: {
+            auto ternary = static_cast<TernaryExpr*>(expr);
+            analyzeExpression(ternary->condition.get(), false);
+            analyzeExpression(ternary->trueValue.get(), escapes);
+            analyzeExpression(ternary->falseValue.get(), escapes);
+            break;
+        }
+
+        case ASTNode::NodeType::ASSIGNMENT: {
+            auto assignment = static_cast<AssignmentExpr*>(expr);
+            analyzeAssignment(assignment->target.get(), assignment->op.type,
+                              assignment->value.get());
+            break;
+        }
+
+        case ASTNode::NodeType::ARRAY_LITERAL: {
+            auto array = static_cast<ArrayLiteralExpr*>(expr);
+            for (auto& element : array->elements) {
+                analyzeExpression(element.get(), true);
+            }
+            break;
+        }
+
+        case ASTNode::NodeType::AWAIT:
+            analyzeExpression(static_cast<AwaitExpr*>(expr)->operand.get(), true);
+            break;
+
+        case ASTNode::NodeType::LAMBDA: {
+            auto lambda = static_cast<LambdaExpr*>(expr);
+            captureDepth++;
+            analyzeStatement(lambda->body.get());
+            captureDepth--;
+            break;
+        }
+
+        default:
+            unknownNode = true;
+            break;
+    }
+}
+
+bool EscapeAnalyzer::isAssignmentOp(TokenType op) {
+    return op == TokenType::TOKEN_EQUAL ||
+           op == TokenType::TOKEN_PLUS_EQUAL ||
+           op == TokenType::TOKEN_MINUS_EQUAL ||
+           op == TokenType::TOKEN_STAR_EQUAL ||
+           op == TokenType::TOKEN_SLASH_EQUAL ||
+           op == TokenType::TOKEN_PERCENT_EQUAL;
+}
+
+void EscapeAnalyzer::analyzeAssignment(ASTNode* target, TokenType op, ASTNode* value) {
+    analyzeTarget(target);
+    // Only a plain store keeps the value itself; x += v stores x + v
+    analyzeExpression(value, op == TokenType::TOKEN_EQUAL);
+}
+
+void EscapeAnalyzer::analyzeTarget(ASTNode* target) {
+    if (!target) return;
+
+    switch (target->type) {
+        case ASTNode::NodeType::IDENTIFIER:
+            analyzeExpression(target, false);
+            break;
+
+        case ASTNode::NodeType::INDEX: {
+            auto index = static_cast<IndexExpr*>(target);
+            analyzeTarget(index->array.get());
+            analyzeExpression(index->index.get(), false);
+            break;
+        }
+
+        case ASTNode::NodeType::MEMBER_ACCESS:
+            analyzeTarget(static_cast<MemberAccessExpr*>(target)->object.get());
+            break;
+
+        default:
+            // ptr->field = v, *p = v: the target is computed from a value
+            analyzeExpression(target, false);
+            break;
+    }
+}
+
+void EscapeAnalyzer::markRootEscaped(ASTNode* expr) {
+    while (expr) {
+        if (expr->type == ASTNode::NodeType::IDENTIFIER) {
+            auto ident = static_cast<IdentifierExpr*>(expr);
+            if (candidates.count(ident->name)) {
+                escaped.insert(ident->name);
+            }
+            return;
+        }
+        if (expr->type == ASTNode::NodeType::INDEX) {
+            expr = static_cast<IndexExpr*>(expr)->array.get();
+        } else if (expr->type == ASTNode::NodeType::MEMBER_ACCESS) {
+            expr = static_cast<MemberAccessExpr*>(expr)->object.get();
+        } else {
+            return;
+        }
+    }
+}
+
+} // namespace sema
+} // namespace aria
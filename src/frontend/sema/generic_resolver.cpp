@@ -461,6 +461,7 @@ ASTNodePtr Monomorphizer::cloneAST(ASTNode* node) {
             cloned->isConst = var->isConst;
             cloned->isStack = var->isStack;
             cloned->isGC = var->isGC;
+            cloned->isArena = var->isArena;
             return cloned;
         }
         
@@ -749,6 +749,10 @@ void TypeChecker::checkStatement(ASTNode* stmt) {
             checkBlockStmt(static_cast<BlockStmt*>(stmt));
             break;
         
+        case ASTNode::NodeType::REGION:
+            checkBlockStmt(static_cast<BlockStmt*>(static_cast<RegionStmt*>(stmt)->body.get()));
+            break;
+        
         case ASTNode::NodeType::EXPRESSION_STMT:
             checkExpressionStmt(static_cast<ExpressionStmt*>(stmt));
             break;
@@ -61,6 +61,7 @@ struct CompilerOptions {
     bool dump_tokens = false;
     bool verbose = false;
     int opt_level = 0;  // -O0, -O1, -O2, -O3
+    bool elide_write_barriers = false;  // Skip GC barriers proven unnecessary
     std::vector<std::string> warning_flags;  // -Wall, -Werror, -W<warning>, etc.
 };
 
@@ -88,6 +89,9 @@ void print_help() {
     std::cout << "  --tokens          Dump tokens and exit\n";
     std::cout << "  -O<level>         Optimization level (0-3)\n";
     std::cout << "  -v, --verbose     Verbose output\n";
+    std::cout << "  --elide-write-barriers\n";
+    std::cout << "                    Omit GC write barriers on stores into freshly\n";
+    std::cout << "                    allocated objects\n";
     std::cout << "  -Wall             Enable all warnings\n";
     std::cout << "  -Werror           Treat warnings as errors\n";
     std::cout << "  -W<warning>       Enable specific warning\n";
@@ -138,6 +142,8 @@ bool parse_arguments(int argc, char** argv, CompilerOptions& opts) {
             opts.dump_tokens = true;
         } else if (arg == "-v" || arg == "--verbose") {
             opts.verbose = true;
+        } else if (arg == "--elide-write-barriers") {
+            opts.elide_write_barriers = true;
         } else if (arg.substr(0, 2) == "-O") {
             if (arg.length() == 3 && arg[2] >= '0' && arg[2] <= '3') {
                 opts.opt_level = arg[2] - '0';
@@ -320,6 +326,7 @@ llvm::Module* compile_to_module(
         std::cout << "Phase 4: IR generation...\n";
     }
     
+    ir_gen.setElideWriteBarriers(opts.elide_write_barriers);
     auto value = ir_gen.codegen(module_node.get());
     
     if (!value) {
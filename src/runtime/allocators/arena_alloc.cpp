@@ -0,0 +1,214 @@
+/**
+ * Arena Allocator Implementation
+ *
+ * Bump allocation over a list of chunks taken from the wild heap. The
+ * current chunk is always the list head; chunks for oversized requests
+ * are linked behind it so the head keeps serving small allocations.
+ *
+ * The default first chunk (32KB including its header) is the largest
+ * wild heap size class, so a short-lived arena is served from the
+ * thread cache without touching the page heap.
+ */
+
+#include "runtime/allocators.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+constexpr size_t DEFAULT_CHUNK_SIZE = 32 * 1024;
+constexpr size_t MIN_CHUNK_SIZE = 1024;
+constexpr size_t MAX_CHUNK_SIZE = 1024 * 1024;   // Growth stops doubling here
+constexpr size_t DEFAULT_ALIGNMENT = 16;
+constexpr size_t MAX_ALIGNMENT = 4096;
+
+struct alignas(16) ArenaChunk {
+    ArenaChunk* next;
+    size_t size;              // Including this header
+    bool dedicated;           // Holds a single oversized allocation
+
+    char* data() { return reinterpret_cast<char*>(this + 1); }
+    char* end() { return reinterpret_cast<char*>(this) + size; }
+};
+
+ArenaChunk* new_chunk(size_t size, bool dedicated) {
+    ArenaChunk* chunk = static_cast<ArenaChunk*>(aria_alloc(size));
+    if (chunk) {
+        chunk->next = nullptr;
+        chunk->size = size;
+        chunk->dedicated = dedicated;
+    }
+    return chunk;
+}
+
+uintptr_t align_up(uintptr_t value, size_t alignment) {
+    return (value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+}
+
+} // namespace
+
+struct AriaArena {
+    uintptr_t cursor;         // Bump pointer into the head chunk
+    uintptr_t limit;
+    ArenaChunk* chunks;       // Head is the current bump chunk
+    size_t next_chunk_size;
+    size_t bytes_allocated;
+    size_t bytes_reserved;
+    size_t num_chunks;
+};
+
+// =============================================================================
+// Arena Lifecycle
+// =============================================================================
+
+AriaArena* aria_arena_create(size_t chunk_size) {
+    AriaArena* arena = static_cast<AriaArena*>(aria_alloc(sizeof(AriaArena)));
+    if (!arena) {
+        return nullptr;
+    }
+
+    if (chunk_size == 0) {
+        chunk_size = DEFAULT_CHUNK_SIZE;
+    }
+    arena->cursor = 0;
+    arena->limit = 0;
+    arena->chunks = nullptr;
+    arena->next_chunk_size = std::min(std::max(chunk_size, MIN_CHUNK_SIZE), MAX_CHUNK_SIZE);
+    arena->bytes_allocated = 0;
+    arena->bytes_reserved = 0;
+    arena->num_chunks = 0;
+    return arena;
+}
+
+void aria_arena_reset(AriaArena* arena) {
+    if (!arena) {
+        return;
+    }
+
+    // Regular chunks are pushed in growing sizes, so the first regular
+    // chunk in the list is the largest
+    ArenaChunk* keep = nullptr;
+    ArenaChunk* chunk = arena->chunks;
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        if (!keep && !chunk->dedicated) {
+            keep = chunk;
+        } else {
+            aria_free(chunk);
+        }
+        chunk = next;
+    }
+
+    arena->chunks = keep;
+    arena->bytes_allocated = 0;
+    if (keep) {
+        keep->next = nullptr;
+        arena->cursor = reinterpret_cast<uintptr_t>(keep->data());
+        arena->limit = reinterpret_cast<uintptr_t>(keep->end());
+        arena->bytes_reserved = keep->size;
+        arena->num_chunks = 1;
+    } else {
+        arena->cursor = 0;
+        arena->limit = 0;
+        arena->bytes_reserved = 0;
+        arena->num_chunks = 0;
+    }
+}
+
+void aria_arena_destroy(AriaArena* arena) {
+    if (!arena) {
+        return;
+    }
+
+    ArenaChunk* chunk = arena->chunks;
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        aria_free(chunk);
+        chunk = next;
+    }
+    aria_free(arena);
+}
+
+// =============================================================================
+// Allocation
+// =============================================================================
+
+static void* arena_alloc_slow(AriaArena* arena, size_t size, size_t alignment) {
+    // Worst-case padding to reach the alignment from a 16-byte boundary
+    size_t padded = size + (alignment > DEFAULT_ALIGNMENT ? alignment - DEFAULT_ALIGNMENT : 0);
+    if (padded < size || padded > SIZE_MAX - sizeof(ArenaChunk)) {
+        return nullptr;
+    }
+
+    if (padded > (arena->next_chunk_size - sizeof(ArenaChunk)) / 4) {
+        // Oversized: own chunk, behind the current one
+        ArenaChunk* chunk = new_chunk(sizeof(ArenaChunk) + padded, true);
+        if (!chunk) {
+            return nullptr;
+        }
+        if (arena->chunks) {
+            chunk->next = arena->chunks->next;
+            arena->chunks->next = chunk;
+        } else {
+            arena->chunks = chunk;
+        }
+        arena->bytes_allocated += size;
+        arena->bytes_reserved += chunk->size;
+        arena->num_chunks++;
+        return reinterpret_cast<void*>(align_up(reinterpret_cast<uintptr_t>(chunk->data()), alignment));
+    }
+
+    ArenaChunk* chunk = new_chunk(arena->next_chunk_size, false);
+    if (!chunk) {
+        return nullptr;
+    }
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    arena->bytes_reserved += chunk->size;
+    arena->num_chunks++;
+    arena->next_chunk_size = std::min(arena->next_chunk_size * 2, MAX_CHUNK_SIZE);
+
+    uintptr_t ptr = align_up(reinterpret_cast<uintptr_t>(chunk->data()), alignment);
+    arena->cursor = ptr + size;
+    arena->limit = reinterpret_cast<uintptr_t>(chunk->end());
+    arena->bytes_allocated += size;
+    return reinterpret_cast<void*>(ptr);
+}
+
+void* aria_arena_alloc(AriaArena* arena, size_t size, size_t alignment) {
+    if (!arena || size == 0) {
+        return nullptr;
+    }
+    if (alignment == 0) {
+        alignment = DEFAULT_ALIGNMENT;
+    }
+    if ((alignment & (alignment - 1)) != 0 || alignment > MAX_ALIGNMENT) {
+        return nullptr;
+    }
+
+    uintptr_t ptr = align_up(arena->cursor, alignment);
+    if (ptr <= arena->limit && size <= arena->limit - ptr) {
+        arena->cursor = ptr + size;
+        arena->bytes_allocated += size;
+        return reinterpret_cast<void*>(ptr);
+    }
+    return arena_alloc_slow(arena, size, alignment);
+}
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+void aria_arena_get_stats(const AriaArena* arena, ArenaStats* stats) {
+    if (!stats) {
+        return;
+    }
+    if (!arena) {
+        *stats = ArenaStats{};
+        return;
+    }
+
+    stats->bytes_allocated = arena->bytes_allocated;
+    stats->bytes_reserved = arena->bytes_reserved;
+    stats->num_chunks = arena->num_chunks;
+}
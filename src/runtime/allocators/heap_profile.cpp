@@ -0,0 +1,664 @@
+/**
+ * Aria Heap Profiler Implementation
+ *
+ * Sampling allocation-site profiler for GC and wild memory:
+ * - Sampling: per-thread byte countdown with exponentially distributed
+ *   gaps (mean = sample interval)
+ * - Sites: samples aggregated by (allocator, type_id, backtrace), with
+ *   each sample weighted by the inverse of its sampling probability
+ * - Liveness: wild samples are dropped by aria_free; GC samples are
+ *   relocated or dropped by the collector after every minor GC and sweep
+ * - Export: pprof protobuf (profile.proto), written uncompressed
+ *
+ * Reference: research_022_wild_wildx_memory.txt
+ */
+
+#include "heap_profile.h"
+#include "runtime/allocators.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <execinfo.h>  // backtrace
+#include <unistd.h>    // pipe, read, write
+
+namespace aria {
+namespace runtime {
+
+thread_local int64_t t_heap_sample_countdown = 0;
+std::atomic<size_t> g_heap_live_wild_samples{0};
+std::atomic<size_t> g_heap_live_gc_samples{0};
+
+namespace {
+
+constexpr size_t DEFAULT_SAMPLE_INTERVAL = 512 * 1024;
+constexpr int64_t DISABLED_RECHECK_BYTES = 4 * 1024 * 1024;  // Countdown while stopped
+constexpr int MAX_FRAMES = 64;
+constexpr size_t NUM_WILD_SHARDS = 16;
+
+/**
+ * Site: Aggregated samples of one allocation site
+ *
+ * Counts are estimates of the unsampled totals: a sample of size s
+ * stands for 1 / (1 - e^(-s / interval)) allocations of that size.
+ */
+struct Site {
+    HeapSampleKind kind;
+    uint16_t type_id;
+    std::vector<uintptr_t> stack;      // Return addresses, innermost first
+    double alloc_objects = 0;
+    double alloc_bytes = 0;
+    double inuse_objects = 0;
+    double inuse_bytes = 0;
+};
+
+struct LiveSample {
+    void* ptr;
+    size_t size;
+    size_t site;
+    double weight;
+    uint64_t session;                  // Profile the sample belongs to
+};
+
+struct WildShard {
+    std::mutex mutex;
+    std::unordered_map<void*, LiveSample> samples;
+};
+
+struct Profiler {
+    std::atomic<bool> active{false};
+    std::atomic<size_t> interval{0};
+
+    // Sites, GC samples and counters
+    std::mutex mutex;
+    uint64_t session = 0;              // Bumped by every start
+    std::vector<Site> sites;
+    std::unordered_map<uint64_t, std::vector<size_t>> site_index;  // Hash -> sites
+    std::vector<LiveSample> gc_samples;
+    size_t num_samples = 0;
+
+    // Wild samples, sharded by address so aria_free rarely contends
+    WildShard wild[NUM_WILD_SHARDS];
+
+    // Signal-triggered dumps
+    std::mutex signal_mutex;
+    std::string signal_path;
+    int signal_pipe[2] = {-1, -1};
+};
+
+// Never destroyed: frees may still arrive from static destructors
+Profiler& profiler() {
+    static Profiler* instance = new Profiler();
+    return *instance;
+}
+
+WildShard& shard_for(void* ptr) {
+    uintptr_t bits = reinterpret_cast<uintptr_t>(ptr);
+    return profiler().wild[(bits >> 4) % NUM_WILD_SHARDS];
+}
+
+// -----------------------------------------------------------------------------
+// Sampling
+// -----------------------------------------------------------------------------
+
+uint64_t next_random() {
+    // xorshift64*, seeded per thread
+    thread_local uint64_t state = 0;
+    if (state == 0) {
+        state = reinterpret_cast<uintptr_t>(&state) ^
+                static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        state |= 1;
+    }
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1Dull;
+}
+
+int64_t next_gap(size_t interval) {
+    // Exponential with the given mean: a Poisson process over bytes
+    double u = static_cast<double>((next_random() >> 11) + 1) * (1.0 / 9007199254740992.0);
+    double gap = -std::log(u) * static_cast<double>(interval);
+    return static_cast<int64_t>(std::min(std::max(gap, 1.0), 1e15));
+}
+
+uint64_t hash_site(HeapSampleKind kind, uint16_t type_id, const uintptr_t* stack, size_t depth) {
+    uint64_t hash = 1469598103934665603ull ^ (static_cast<uint64_t>(kind) << 16 | type_id);
+    for (size_t i = 0; i < depth; ++i) {
+        hash = (hash ^ stack[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Requires profiler().mutex
+size_t find_or_add_site(Profiler& p, HeapSampleKind kind, uint16_t type_id,
+                        const uintptr_t* stack, size_t depth) {
+    std::vector<size_t>& bucket = p.site_index[hash_site(kind, type_id, stack, depth)];
+    for (size_t index : bucket) {
+        const Site& site = p.sites[index];
+        if (site.kind == kind && site.type_id == type_id && site.stack.size() == depth &&
+            std::equal(stack, stack + depth, site.stack.begin())) {
+            return index;
+        }
+    }
+
+    Site site;
+    site.kind = kind;
+    site.type_id = type_id;
+    site.stack.assign(stack, stack + depth);
+    p.sites.push_back(std::move(site));
+    bucket.push_back(p.sites.size() - 1);
+    return p.sites.size() - 1;
+}
+
+// Requires profiler().mutex
+void retire_sample(Profiler& p, const LiveSample& sample) {
+    if (sample.session != p.session) {
+        return;  // Belongs to a discarded profile
+    }
+    Site& site = p.sites[sample.site];
+    site.inuse_objects -= sample.weight;
+    site.inuse_bytes -= sample.weight * static_cast<double>(sample.size);
+}
+
+// Requires profiler().mutex
+void clear_profile(Profiler& p) {
+    p.session++;
+    p.sites.clear();
+    p.site_index.clear();
+    p.num_samples = 0;
+
+    g_heap_live_gc_samples.fetch_sub(p.gc_samples.size());
+    p.gc_samples.clear();
+    for (WildShard& shard : p.wild) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        g_heap_live_wild_samples.fetch_sub(shard.samples.size());
+        shard.samples.clear();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// pprof Encoding
+// -----------------------------------------------------------------------------
+
+/**
+ * ProtoWriter: Minimal protobuf wire-format encoder
+ *
+ * Only what profile.proto needs: varints, packed varints and
+ * length-delimited fields. Zero scalars are omitted (proto3 defaults).
+ */
+class ProtoWriter {
+public:
+    void varint_field(uint32_t field, uint64_t value) {
+        if (value == 0) return;
+        tag(field, 0);
+        varint(value);
+    }
+
+    void bytes_field(uint32_t field, const std::string& bytes) {
+        tag(field, 2);
+        varint(bytes.size());
+        out += bytes;
+    }
+
+    void message_field(uint32_t field, const ProtoWriter& message) {
+        bytes_field(field, message.out);
+    }
+
+    void packed_field(uint32_t field, const std::vector<uint64_t>& values) {
+        if (values.empty()) return;
+        ProtoWriter packed;
+        for (uint64_t value : values) {
+            packed.varint(value);
+        }
+        bytes_field(field, packed.out);
+    }
+
+    const std::string& bytes() const { return out; }
+
+private:
+    std::string out;
+
+    void tag(uint32_t field, uint32_t wire_type) {
+        varint(static_cast<uint64_t>(field) << 3 | wire_type);
+    }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+};
+
+class StringTable {
+public:
+    StringTable() { intern(""); }  // Index 0 must be the empty string
+
+    uint64_t intern(const std::string& text) {
+        auto it = index.find(text);
+        if (it != index.end()) {
+            return it->second;
+        }
+        strings.push_back(text);
+        index.emplace(text, strings.size() - 1);
+        return strings.size() - 1;
+    }
+
+    const std::vector<std::string>& all() const { return strings; }
+
+private:
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint64_t> index;
+};
+
+struct Mapping {
+    uint64_t start;
+    uint64_t limit;
+    uint64_t offset;
+    std::string path;
+};
+
+// Executable file mappings of this process, for offline symbolization
+std::vector<Mapping> read_mappings() {
+    std::vector<Mapping> mappings;
+    FILE* maps = std::fopen("/proc/self/maps", "r");
+    if (!maps) {
+        return mappings;
+    }
+
+    char line[4096];
+    while (std::fgets(line, sizeof(line), maps)) {
+        unsigned long long start, limit, offset;
+        char perms[8];
+        int path_pos = 0;
+        if (std::sscanf(line, "%llx-%llx %7s %llx %*s %*s %n",
+                        &start, &limit, perms, &offset, &path_pos) < 4) {
+            continue;
+        }
+        if (!std::strchr(perms, 'x') || path_pos == 0 || line[path_pos] != '/') {
+            continue;
+        }
+        std::string path(line + path_pos);
+        while (!path.empty() && (path.back() == '\n' || path.back() == ' ')) {
+            path.pop_back();
+        }
+        mappings.push_back({start, limit, offset, path});
+    }
+
+    std::fclose(maps);
+    return mappings;
+}
+
+ProtoWriter value_type(StringTable& strings, const char* type, const char* unit) {
+    ProtoWriter message;
+    message.varint_field(1, strings.intern(type));
+    message.varint_field(2, strings.intern(unit));
+    return message;
+}
+
+uint64_t round_count(double value) {
+    return value > 0 ? static_cast<uint64_t>(value + 0.5) : 0;
+}
+
+/**
+ * Encode a profile snapshot as a pprof Profile message
+ *
+ * Locations carry addresses only (has_functions is left unset), so pprof
+ * symbolizes them against the mapped binaries. Addresses are return
+ * addresses minus one, so they resolve to the call instruction.
+ */
+std::string encode_profile(const std::vector<Site>& sites, size_t interval) {
+    ProtoWriter profile;
+    StringTable strings;
+
+    profile.message_field(1, value_type(strings, "alloc_objects", "count"));
+    profile.message_field(1, value_type(strings, "alloc_space", "bytes"));
+    profile.message_field(1, value_type(strings, "inuse_objects", "count"));
+    profile.message_field(1, value_type(strings, "inuse_space", "bytes"));
+
+    std::vector<Mapping> mappings = read_mappings();
+    std::unordered_map<uintptr_t, uint64_t> location_ids;
+    std::vector<uintptr_t> locations;
+
+    uint64_t key_allocator = strings.intern("allocator");
+    uint64_t key_type_id = strings.intern("type_id");
+    uint64_t gc_name = strings.intern("gc");
+    uint64_t wild_name = strings.intern("wild");
+
+    for (const Site& site : sites) {
+        ProtoWriter sample;
+
+        std::vector<uint64_t> ids;
+        for (uintptr_t address : site.stack) {
+            auto inserted = location_ids.emplace(address - 1, locations.size() + 1);
+            if (inserted.second) {
+                locations.push_back(address - 1);
+            }
+            ids.push_back(inserted.first->second);
+        }
+        sample.packed_field(1, ids);
+        sample.packed_field(2, {round_count(site.alloc_objects), round_count(site.alloc_bytes),
+                                round_count(site.inuse_objects), round_count(site.inuse_bytes)});
+
+        ProtoWriter allocator;
+        allocator.varint_field(1, key_allocator);
+        allocator.varint_field(2, site.kind == HeapSampleKind::GC ? gc_name : wild_name);
+        sample.message_field(3, allocator);
+        if (site.kind == HeapSampleKind::GC) {
+            ProtoWriter type_id;
+            type_id.varint_field(1, key_type_id);
+            type_id.varint_field(3, site.type_id);
+            sample.message_field(3, type_id);
+        }
+
+        profile.message_field(2, sample);
+    }
+
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        ProtoWriter mapping;
+        mapping.varint_field(1, i + 1);
+        mapping.varint_field(2, mappings[i].start);
+        mapping.varint_field(3, mappings[i].limit);
+        mapping.varint_field(4, mappings[i].offset);
+        mapping.varint_field(5, strings.intern(mappings[i].path));
+        profile.message_field(3, mapping);
+    }
+
+    for (size_t i = 0; i < locations.size(); ++i) {
+        ProtoWriter location;
+        location.varint_field(1, i + 1);
+        for (size_t m = 0; m < mappings.size(); ++m) {
+            if (locations[i] >= mappings[m].start && locations[i] < mappings[m].limit) {
+                location.varint_field(2, m + 1);
+                break;
+            }
+        }
+        location.varint_field(3, locations[i]);
+        profile.message_field(4, location);
+    }
+
+    uint64_t now_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    profile.varint_field(9, now_ns);
+    profile.message_field(11, value_type(strings, "space", "bytes"));
+    profile.varint_field(12, interval);
+    profile.varint_field(14, strings.intern("inuse_space"));
+
+    // The string table goes last: every field above may add to it
+    for (const std::string& text : strings.all()) {
+        profile.bytes_field(6, text);
+    }
+
+    return profile.bytes();
+}
+
+// -----------------------------------------------------------------------------
+// Dump Triggers
+// -----------------------------------------------------------------------------
+
+void signal_handler(int) {
+    int saved_errno = errno;
+    char byte = 0;
+    ssize_t ignored = write(profiler().signal_pipe[1], &byte, 1);
+    (void)ignored;
+    errno = saved_errno;
+}
+
+void signal_dump_loop() {
+    Profiler& p = profiler();
+    for (;;) {
+        char byte;
+        ssize_t n = read(p.signal_pipe[0], &byte, 1);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return;
+        }
+
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(p.signal_mutex);
+            path = p.signal_path;
+        }
+        aria_heap_profile_dump(path.c_str());
+    }
+}
+
+std::string g_exit_path;
+
+void dump_at_exit() {
+    aria_heap_profile_dump(g_exit_path.c_str());
+}
+
+// ARIA_HEAPPROFILE: profile the whole run without code changes
+struct EnvironmentStartup {
+    EnvironmentStartup() {
+        const char* path = std::getenv("ARIA_HEAPPROFILE");
+        if (!path || !*path) {
+            return;
+        }
+
+        size_t interval = 0;
+        if (const char* rate = std::getenv("ARIA_HEAPPROFILE_RATE")) {
+            interval = static_cast<size_t>(std::strtoull(rate, nullptr, 10));
+        }
+        aria_heap_profile_start(interval);
+
+        g_exit_path = path;
+        std::atexit(dump_at_exit);
+
+        if (const char* signo = std::getenv("ARIA_HEAPPROFILE_SIGNAL")) {
+            aria_heap_profile_dump_on_signal(std::atoi(signo), path);
+        }
+    }
+};
+
+EnvironmentStartup g_environment_startup;
+
+} // namespace
+
+// =============================================================================
+// Allocator and Collector Hooks
+// =============================================================================
+
+__attribute__((noinline))
+void heap_profile_sample(void* ptr, size_t size, uint16_t type_id, HeapSampleKind kind) {
+    Profiler& p = profiler();
+    size_t interval = p.interval.load(std::memory_order_acquire);
+    if (!p.active.load(std::memory_order_acquire) || interval == 0) {
+        t_heap_sample_countdown = DISABLED_RECHECK_BYTES;
+        return;
+    }
+    t_heap_sample_countdown = next_gap(interval);
+
+    // Frame 0 is this function
+    void* frames[MAX_FRAMES];
+    int depth = backtrace(frames, MAX_FRAMES);
+    uintptr_t stack[MAX_FRAMES];
+    size_t num_frames = 0;
+    for (int i = 1; i < depth; ++i) {
+        stack[num_frames++] = reinterpret_cast<uintptr_t>(frames[i]);
+    }
+
+    double probability = 1.0 - std::exp(-static_cast<double>(size) / static_cast<double>(interval));
+    double weight = probability > 0 ? 1.0 / probability : 1.0;
+
+    std::lock_guard<std::mutex> lock(p.mutex);
+    if (!p.active.load(std::memory_order_relaxed)) {
+        return;  // Stopped meanwhile
+    }
+
+    size_t index = find_or_add_site(p, kind, type_id, stack, num_frames);
+    Site& site = p.sites[index];
+    site.alloc_objects += weight;
+    site.alloc_bytes += weight * static_cast<double>(size);
+    site.inuse_objects += weight;
+    site.inuse_bytes += weight * static_cast<double>(size);
+    p.num_samples++;
+
+    LiveSample sample{ptr, size, index, weight, p.session};
+    if (kind == HeapSampleKind::GC) {
+        p.gc_samples.push_back(sample);
+        g_heap_live_gc_samples.fetch_add(1);
+    } else {
+        WildShard& shard = shard_for(ptr);
+        std::lock_guard<std::mutex> shard_lock(shard.mutex);
+        shard.samples[ptr] = sample;
+        g_heap_live_wild_samples.fetch_add(1);
+    }
+}
+
+void heap_profile_free_slow(void* ptr) {
+    LiveSample sample;
+    {
+        WildShard& shard = shard_for(ptr);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.samples.find(ptr);
+        if (it == shard.samples.end()) {
+            return;
+        }
+        sample = it->second;
+        shard.samples.erase(it);
+        g_heap_live_wild_samples.fetch_sub(1);
+    }
+
+    Profiler& p = profiler();
+    std::lock_guard<std::mutex> lock(p.mutex);
+    retire_sample(p, sample);
+}
+
+void heap_profile_relocate_gc_samples(const std::function<void*(void*)>& relocate) {
+    Profiler& p = profiler();
+    std::lock_guard<std::mutex> lock(p.mutex);
+
+    for (size_t i = 0; i < p.gc_samples.size();) {
+        LiveSample& sample = p.gc_samples[i];
+        void* moved = relocate(sample.ptr);
+        if (moved) {
+            sample.ptr = moved;
+            ++i;
+            continue;
+        }
+
+        retire_sample(p, sample);
+        sample = p.gc_samples.back();
+        p.gc_samples.pop_back();
+        g_heap_live_gc_samples.fetch_sub(1);
+    }
+}
+
+// =============================================================================
+// C API Implementation
+// =============================================================================
+
+extern "C" {
+
+int aria_heap_profile_start(size_t sample_interval) {
+    Profiler& p = profiler();
+    std::lock_guard<std::mutex> lock(p.mutex);
+    if (p.active.load()) {
+        return -1;
+    }
+
+    clear_profile(p);
+    p.interval.store(sample_interval ? sample_interval : DEFAULT_SAMPLE_INTERVAL,
+                     std::memory_order_release);
+    p.active.store(true, std::memory_order_release);
+
+    // Other threads pick this up at their next countdown expiry
+    t_heap_sample_countdown = next_gap(p.interval.load());
+    return 0;
+}
+
+void aria_heap_profile_stop(void) {
+    profiler().active.store(false, std::memory_order_release);
+}
+
+int aria_heap_profile_dump(const char* path) {
+    if (!path) {
+        return -1;
+    }
+
+    // Snapshot under the lock, encode and write without it
+    Profiler& p = profiler();
+    std::vector<Site> sites;
+    size_t interval;
+    {
+        std::lock_guard<std::mutex> lock(p.mutex);
+        sites = p.sites;
+        interval = p.interval.load();
+    }
+
+    std::string bytes = encode_profile(sites, interval ? interval : DEFAULT_SAMPLE_INTERVAL);
+
+    FILE* out = std::fopen(path, "wb");
+    if (!out) {
+        return -1;
+    }
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), out) == bytes.size();
+    return std::fclose(out) == 0 && ok ? 0 : -1;
+}
+
+int aria_heap_profile_dump_on_signal(int signo, const char* path) {
+    if (!path) {
+        return -1;
+    }
+
+    Profiler& p = profiler();
+    std::lock_guard<std::mutex> lock(p.signal_mutex);
+    p.signal_path = path;
+
+    if (p.signal_pipe[0] < 0) {
+        if (pipe(p.signal_pipe) != 0) {
+            return -1;
+        }
+        std::thread(signal_dump_loop).detach();
+    }
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = signal_handler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    return sigaction(signo, &action, nullptr) == 0 ? 0 : -1;
+}
+
+void aria_heap_profile_get_stats(HeapProfileStats* stats) {
+    if (!stats) {
+        return;
+    }
+
+    Profiler& p = profiler();
+    std::lock_guard<std::mutex> lock(p.mutex);
+
+    double alloc_bytes = 0;
+    double inuse_bytes = 0;
+    for (const Site& site : p.sites) {
+        alloc_bytes += site.alloc_bytes;
+        inuse_bytes += site.inuse_bytes;
+    }
+
+    stats->sample_interval = p.active.load() ? p.interval.load() : 0;
+    stats->num_samples = p.num_samples;
+    stats->num_sites = p.sites.size();
+    stats->live_samples = g_heap_live_gc_samples.load() + g_heap_live_wild_samples.load();
+    stats->alloc_bytes = round_count(alloc_bytes);
+    stats->inuse_bytes = round_count(inuse_bytes);
+}
+
+} // extern "C"
+
+} // namespace runtime
+} // namespace aria
@@ -0,0 +1,68 @@
+/**
+ * Aria Heap Profiler Internal Interface
+ *
+ * Hooks called by the allocators (aria_gc_alloc, aria_alloc and
+ * friends) and by the garbage collector. The public API is the
+ * aria_heap_profile_* family in runtime/allocators.h.
+ *
+ * Sampling is driven by a per-thread byte countdown, so an allocation
+ * that is not sampled costs one thread-local subtraction and a
+ * predictable branch. Frees of wild memory cost one relaxed load while
+ * no wild sample is live.
+ *
+ * Reference: research_022_wild_wildx_memory.txt
+ */
+
+#ifndef ARIA_RUNTIME_HEAP_PROFILE_H
+#define ARIA_RUNTIME_HEAP_PROFILE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace aria {
+namespace runtime {
+
+enum class HeapSampleKind : uint8_t {
+    GC,      // aria_gc_alloc: freed by the collector, may move
+    WILD     // aria_alloc and friends: freed by aria_free
+};
+
+// Bytes this thread may still allocate before its next sample
+extern thread_local int64_t t_heap_sample_countdown;
+
+// Samples not yet freed (checked by every aria_free / collection)
+extern std::atomic<size_t> g_heap_live_wild_samples;
+extern std::atomic<size_t> g_heap_live_gc_samples;
+
+// Take a sample; called when the countdown runs out
+void heap_profile_sample(void* ptr, size_t size, uint16_t type_id, HeapSampleKind kind);
+void heap_profile_free_slow(void* ptr);
+
+inline void heap_profile_note_alloc(void* ptr, size_t size, uint16_t type_id,
+                                    HeapSampleKind kind) {
+    t_heap_sample_countdown -= static_cast<int64_t>(size);
+    if (__builtin_expect(t_heap_sample_countdown < 0, 0) && ptr) {
+        heap_profile_sample(ptr, size, type_id, kind);
+    }
+}
+
+inline void heap_profile_note_free(void* ptr) {
+    if (__builtin_expect(g_heap_live_wild_samples.load(std::memory_order_relaxed) != 0, 0)) {
+        heap_profile_free_slow(ptr);
+    }
+}
+
+/**
+ * Update sampled GC objects after a collection (world stopped)
+ *
+ * relocate(ptr) returns the object's current address, or nullptr if the
+ * collection freed it.
+ */
+void heap_profile_relocate_gc_samples(const std::function<void*(void*)>& relocate);
+
+} // namespace runtime
+} // namespace aria
+
+#endif // ARIA_RUNTIME_HEAP_PROFILE_H
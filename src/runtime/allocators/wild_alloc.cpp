@@ -1,40 +1,28 @@
 /**
  * Wild Memory Allocator Implementation
  * 
- * Manual heap allocator (malloc/free wrapper) for unmanaged memory.
+ * Manual heap allocator for unmanaged memory, backed by the
+ * thread-caching size-class heap in wild_heap.cpp.
  * Provides RAII integration via defer keyword.
  */
 
 #include "runtime/allocators.h"
+#include "heap_profile.h"
+#include "wild_heap.h"
 #include <cstdlib>
 #include <cstring>
 #include <atomic>
-#include <mutex>
 
-// =============================================================================
-// Statistics Tracking
-// =============================================================================
-
-struct AllocatorState {
-    std::atomic<size_t> total_wild_allocated{0};
-    std::atomic<size_t> num_wild_allocations{0};
-    std::atomic<size_t> peak_wild_usage{0};
-    std::mutex stats_mutex;  // For peak tracking
-};
-
-static AllocatorState g_alloc_state;
-
-static void update_peak_usage() {
-    std::lock_guard<std::mutex> lock(g_alloc_state.stats_mutex);
-    size_t current = g_alloc_state.total_wild_allocated.load();
-    size_t peak = g_alloc_state.peak_wild_usage.load();
-    if (current > peak) {
-        g_alloc_state.peak_wild_usage.store(current);
-    }
-}
+using aria::runtime::HeapSampleKind;
+using aria::runtime::heap_profile_note_alloc;
+using aria::runtime::heap_profile_note_free;
+using aria::runtime::wild_heap_allocate;
+using aria::runtime::wild_heap_allocate_aligned;
+using aria::runtime::wild_heap_free;
+using aria::runtime::wild_heap_usable_size;
 
 // =============================================================================
-// Wild Allocator (Basic malloc/free)
+// Wild Allocator
 // =============================================================================
 
 void* aria_alloc(size_t size) {
@@ -42,11 +30,9 @@ void* aria_alloc(size_t size) {
         return nullptr;
     }
 
-    void* ptr = std::malloc(size);
+    void* ptr = wild_heap_allocate(size);
     if (ptr) {
-        g_alloc_state.total_wild_allocated.fetch_add(size);
-        g_alloc_state.num_wild_allocations.fetch_add(1);
-        update_peak_usage();
+        heap_profile_note_alloc(ptr, size, 0, HeapSampleKind::WILD);
     }
 
     return ptr;
@@ -57,12 +43,8 @@ void aria_free(void* ptr) {
         return;  // NULL is a no-op
     }
 
-    std::free(ptr);
-    g_alloc_state.num_wild_allocations.fetch_sub(1);
-    
-    // Note: We cannot accurately track size without a header, so we
-    // don't decrement total_wild_allocated. This is acceptable for
-    // statistics purposes.
+    heap_profile_note_free(ptr);
+    wild_heap_free(ptr);
 }
 
 void* aria_realloc(void* ptr, size_t new_size) {
@@ -70,14 +52,29 @@ void* aria_realloc(void* ptr, size_t new_size) {
         aria_free(ptr);
         return nullptr;
     }
+    if (!ptr) {
+        return aria_alloc(new_size);
+    }
+
+    size_t usable = wild_heap_usable_size(ptr);
+    if (usable == 0) {
+        // Not from the wild heap (allocated before it existed): only its
+        // owner knows the block's size. The result stays foreign, and
+        // aria_free hands it back to std::free.
+        return std::realloc(ptr, new_size);
+    }
+
+    // Stay in place while the slot fits and is not mostly wasted
+    if (new_size <= usable && new_size > usable / 2) {
+        return ptr;
+    }
 
-    void* new_ptr = std::realloc(ptr, new_size);
-    if (new_ptr) {
-        // Note: realloc size tracking is imprecise without headers
-        // For simplicity, we treat it as a new allocation
-        g_alloc_state.total_wild_allocated.fetch_add(new_size);
-        update_peak_usage();
+    void* new_ptr = aria_alloc(new_size);
+    if (!new_ptr) {
+        return nullptr;  // ptr stays valid, as with realloc
     }
+    std::memcpy(new_ptr, ptr, usable < new_size ? usable : new_size);
+    aria_free(ptr);
 
     return new_ptr;
 }
@@ -93,22 +90,13 @@ void* aria_alloc_buffer(size_t size, size_t alignment, bool zero_init) {
 
     void* ptr = nullptr;
 
-    // Platform-specific aligned allocation
     if (alignment == 0) {
         // Default allocation
         ptr = aria_alloc(size);
     } else {
-#ifdef _WIN32
-        ptr = _aligned_malloc(size, alignment);
-#else
-        // POSIX aligned_alloc requires size to be multiple of alignment
-        size_t adjusted_size = (size + alignment - 1) & ~(alignment - 1);
-        ptr = aligned_alloc(alignment, adjusted_size);
-#endif
+        ptr = wild_heap_allocate_aligned(size, alignment);
         if (ptr) {
-            g_alloc_state.total_wild_allocated.fetch_add(size);
-            g_alloc_state.num_wild_allocations.fetch_add(1);
-            update_peak_usage();
+            heap_profile_note_alloc(ptr, size, 0, HeapSampleKind::WILD);
         }
     }
 
@@ -164,10 +152,12 @@ void aria_allocator_get_stats(AllocatorStats* stats) {
         return;
     }
 
-    // Wild stats (this file)
-    stats->total_wild_allocated = g_alloc_state.total_wild_allocated.load();
-    stats->num_wild_allocations = g_alloc_state.num_wild_allocations.load();
-    stats->peak_wild_usage = g_alloc_state.peak_wild_usage.load();
+    // Wild stats (wild_heap.cpp)
+    aria::runtime::WildHeapStats wild;
+    aria::runtime::wild_heap_get_stats(&wild);
+    stats->total_wild_allocated = wild.live_bytes;
+    stats->num_wild_allocations = wild.live_allocations;
+    stats->peak_wild_usage = wild.peak_bytes;
     
     // WildX stats (wildx_alloc.cpp)
     stats->total_wildx_allocated = g_wildx_total_allocated.load();
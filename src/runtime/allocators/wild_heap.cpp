@@ -0,0 +1,633 @@
+/**
+ * Aria Wild Heap Implementation
+ *
+ * Thread-caching size-class allocator for unmanaged memory. Layers,
+ * fastest first:
+ * 1. ThreadCache: per-class free lists owned by one thread
+ * 2. CentralList: per-class spans with free slots (one mutex per class)
+ * 3. PageHeap: maps and unmaps spans, caches freed large spans
+ *
+ * Free objects are linked through their first word. A span hands out
+ * slots it has never used from a bump index, so a fresh span is not
+ * touched until its slots are actually allocated.
+ *
+ * Reference: research_022_wild_wildx_memory.txt
+ */
+
+#include "wild_heap.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <sys/mman.h>
+
+namespace aria {
+namespace runtime {
+
+namespace {
+
+constexpr size_t SPAN_SHIFT = 18;
+constexpr size_t SPAN_SIZE = size_t(1) << SPAN_SHIFT;   // 256KB, also the alignment
+constexpr size_t PAGE_SIZE_BYTES = 4096;
+constexpr size_t MAX_SMALL_SIZE = 32 * 1024;
+constexpr size_t MIN_ALIGNMENT = 16;
+constexpr size_t NUM_SIZE_CLASSES = 73;                 // Class 0 = large
+constexpr uint8_t SIZE_CLASS_LARGE = 0;
+constexpr size_t MAX_BATCH = 32;                        // Objects moved per central trip
+constexpr int64_t STATS_FLUSH_BYTES = 64 * 1024;        // Per-thread unpublished drift
+constexpr size_t LARGE_CACHE_BYTES = 32 * 1024 * 1024;  // Freed large spans kept mapped
+
+// =============================================================================
+// Size Classes
+// =============================================================================
+
+/**
+ * 16-byte steps up to 128, then 8 classes per power of two. Above 1KB
+ * every class is a multiple of 128, so two direct tables cover the
+ * whole small range.
+ */
+struct SizeClasses {
+    size_t slot_size[NUM_SIZE_CLASSES];
+    size_t batch[NUM_SIZE_CLASSES];           // Objects per refill/release
+    uint8_t by_16[1024 / 16 + 1];             // size <= 1KB
+    uint8_t by_128[MAX_SMALL_SIZE / 128 + 1]; // size <= 32KB
+
+    SizeClasses() {
+        slot_size[SIZE_CLASS_LARGE] = 0;
+        batch[SIZE_CLASS_LARGE] = 0;
+
+        size_t count = 1;
+        for (size_t size = 16; size <= MAX_SMALL_SIZE; ) {
+            slot_size[count] = size;
+            batch[count] = std::min(MAX_BATCH, std::max<size_t>(2, 64 * 1024 / size));
+            count++;
+
+            size_t step = 16;
+            if (size >= 128) {
+                size_t top = size_t(1) << (63 - __builtin_clzll(size));
+                step = top / 8;
+            }
+            size += step;
+        }
+
+        size_t cls = 1;
+        for (size_t i = 0; i <= 1024 / 16; ++i) {
+            while (slot_size[cls] < std::max<size_t>(i * 16, 1)) cls++;
+            by_16[i] = static_cast<uint8_t>(cls);
+        }
+        cls = 1;
+        for (size_t i = 0; i <= MAX_SMALL_SIZE / 128; ++i) {
+            while (slot_size[cls] < std::max<size_t>(i * 128, 1)) cls++;
+            by_128[i] = static_cast<uint8_t>(cls);
+        }
+    }
+
+    uint8_t class_for(size_t size) const {
+        if (size <= 1024) {
+            return by_16[(size + 15) / 16];
+        }
+        if (size <= MAX_SMALL_SIZE) {
+            return by_128[(size + 127) / 128];
+        }
+        return SIZE_CLASS_LARGE;
+    }
+};
+
+const SizeClasses& size_classes() {
+    static const SizeClasses classes;
+    return classes;
+}
+
+// =============================================================================
+// Spans
+// =============================================================================
+
+struct Span {
+    char* memory;              // SPAN_SIZE-aligned
+    size_t mapped_size;
+    uint8_t size_class;        // SIZE_CLASS_LARGE: one object at memory
+    size_t slot_size;
+    size_t num_slots;
+
+    // Central list state (guarded by the class's CentralList::mutex)
+    void* free_list = nullptr; // Freed slots
+    size_t bump_index = 0;     // Slots from here on were never handed out
+    size_t in_use = 0;         // Slots held by thread caches or users
+    Span* prev = nullptr;      // Partial list links
+    Span* next = nullptr;
+    bool in_partial = false;
+
+    bool has_free() const { return free_list || bump_index < num_slots; }
+};
+
+/**
+ * SpanMap: Address -> span radix tree
+ *
+ * Same shape as the GC's SegmentMap, but entries are atomic: aria_free
+ * looks up pointers (possibly foreign ones) without a lock while other
+ * threads map new spans.
+ */
+class SpanMap {
+public:
+    Span* lookup(const void* ptr) const {
+        uintptr_t chunk = reinterpret_cast<uintptr_t>(ptr) >> SPAN_SHIFT;
+        if (chunk >> INDEX_BITS) {
+            return nullptr;
+        }
+        Leaf* leaf = root[chunk >> LEAF_BITS].load(std::memory_order_acquire);
+        return leaf ? leaf->entries[chunk & (LEAF_SIZE - 1)].load(std::memory_order_acquire)
+                    : nullptr;
+    }
+
+    // Callers hold PageHeap::mutex
+    void set(Span* span, Span* value) {
+        uintptr_t first = reinterpret_cast<uintptr_t>(span->memory) >> SPAN_SHIFT;
+        uintptr_t last = (reinterpret_cast<uintptr_t>(span->memory) + span->mapped_size - 1) >> SPAN_SHIFT;
+        for (uintptr_t chunk = first; chunk <= last; ++chunk) {
+            Leaf* leaf = root[chunk >> LEAF_BITS].load(std::memory_order_relaxed);
+            if (!leaf) {
+                if (!value) continue;
+                leaf = new Leaf();
+                root[chunk >> LEAF_BITS].store(leaf, std::memory_order_release);
+            }
+            leaf->entries[chunk & (LEAF_SIZE - 1)].store(value, std::memory_order_release);
+        }
+    }
+
+private:
+    static constexpr size_t ADDRESS_BITS = 48;
+    static constexpr size_t INDEX_BITS = ADDRESS_BITS - SPAN_SHIFT;
+    static constexpr size_t LEAF_BITS = INDEX_BITS / 2;
+    static constexpr size_t LEAF_SIZE = size_t(1) << LEAF_BITS;
+    static constexpr size_t ROOT_SIZE = size_t(1) << (INDEX_BITS - LEAF_BITS);
+
+    struct Leaf {
+        std::atomic<Span*> entries[LEAF_SIZE] = {};
+    };
+
+    std::atomic<Leaf*> root[ROOT_SIZE] = {};
+};
+
+/**
+ * PageHeap: Span mapping and the large-span cache
+ */
+class PageHeap {
+public:
+    SpanMap map;
+
+    Span* create_span(uint8_t size_class, size_t slot_size, size_t bytes) {
+        size_t mapped_size = (bytes + PAGE_SIZE_BYTES - 1) & ~(PAGE_SIZE_BYTES - 1);
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        Span* span = size_class == SIZE_CLASS_LARGE ? take_cached(mapped_size) : nullptr;
+        if (!span) {
+            char* memory = map_aligned(mapped_size);
+            if (!memory) {
+                return nullptr;
+            }
+            span = new Span();
+            span->memory = memory;
+            span->mapped_size = mapped_size;
+            map.set(span, span);
+        }
+
+        span->size_class = size_class;
+        span->slot_size = slot_size;
+        span->num_slots = size_class == SIZE_CLASS_LARGE ? 1 : span->mapped_size / slot_size;
+        span->free_list = nullptr;
+        span->bump_index = 0;
+        span->in_use = 0;
+        return span;
+    }
+
+    void release_span(Span* span) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Keep recently freed large spans: big buffers are often
+        // reallocated at the same size
+        if (span->size_class == SIZE_CLASS_LARGE && span->mapped_size <= LARGE_CACHE_BYTES / 4) {
+            large_cache.push_back(span);
+            cached_bytes += span->mapped_size;
+            while (cached_bytes > LARGE_CACHE_BYTES) {
+                Span* oldest = large_cache.front();
+                large_cache.erase(large_cache.begin());
+                cached_bytes -= oldest->mapped_size;
+                destroy(oldest);
+            }
+            return;
+        }
+        destroy(span);
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<Span*> large_cache;
+    size_t cached_bytes = 0;
+
+    // Best fit among cached spans no more than twice the request
+    Span* take_cached(size_t mapped_size) {
+        size_t best = large_cache.size();
+        for (size_t i = 0; i < large_cache.size(); ++i) {
+            size_t size = large_cache[i]->mapped_size;
+            if (size >= mapped_size && size <= mapped_size * 2 &&
+                (best == large_cache.size() || size < large_cache[best]->mapped_size)) {
+                best = i;
+            }
+        }
+        if (best == large_cache.size()) {
+            return nullptr;
+        }
+        Span* span = large_cache[best];
+        large_cache.erase(large_cache.begin() + best);
+        cached_bytes -= span->mapped_size;
+        return span;
+    }
+
+    void destroy(Span* span) {
+        map.set(span, nullptr);
+        munmap(span->memory, span->mapped_size);
+        delete span;
+    }
+
+    static char* map_aligned(size_t size) {
+        size_t padded = size + SPAN_SIZE;
+        void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            return nullptr;
+        }
+
+        // Trim the unaligned head and the unused tail
+        uintptr_t raw_addr = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t start = (raw_addr + SPAN_SIZE - 1) & ~(SPAN_SIZE - 1);
+        size_t head = start - raw_addr;
+        size_t tail = padded - head - size;
+        if (head) {
+            munmap(raw, head);
+        }
+        if (tail) {
+            munmap(reinterpret_cast<char*>(start) + size, tail);
+        }
+        return reinterpret_cast<char*>(start);
+    }
+};
+
+/**
+ * CentralList: Spans of one size class that have free slots
+ */
+struct CentralList {
+    std::mutex mutex;
+    Span* partial = nullptr;
+    size_t num_partial = 0;
+};
+
+struct WildHeap {
+    PageHeap pages;
+    CentralList central[NUM_SIZE_CLASSES];
+
+    // Published statistics (per-thread deltas are folded in batches)
+    std::atomic<int64_t> live_bytes{0};
+    std::atomic<int64_t> live_allocations{0};
+    std::atomic<int64_t> peak_bytes{0};
+};
+
+// Never destroyed: static destructors may still free wild memory
+WildHeap& heap() {
+    static WildHeap* instance = new WildHeap();
+    return *instance;
+}
+
+void link_partial(CentralList& list, Span* span) {
+    span->prev = nullptr;
+    span->next = list.partial;
+    if (list.partial) list.partial->prev = span;
+    list.partial = span;
+    span->in_partial = true;
+    list.num_partial++;
+}
+
+void unlink_partial(CentralList& list, Span* span) {
+    if (span->prev) span->prev->next = span->next;
+    else list.partial = span->next;
+    if (span->next) span->next->prev = span->prev;
+    span->prev = span->next = nullptr;
+    span->in_partial = false;
+    list.num_partial--;
+}
+
+// Move up to count objects of class cls into a linked list; returns the
+// number moved (0 when out of memory)
+size_t central_fetch(uint8_t cls, size_t count, void** head) {
+    WildHeap& h = heap();
+    CentralList& list = h.central[cls];
+    size_t slot_size = size_classes().slot_size[cls];
+
+    std::lock_guard<std::mutex> lock(list.mutex);
+
+    size_t moved = 0;
+    *head = nullptr;
+    while (moved < count) {
+        Span* span = list.partial;
+        if (!span) {
+            span = h.pages.create_span(cls, slot_size, SPAN_SIZE);
+            if (!span) break;
+            link_partial(list, span);
+        }
+
+        while (moved < count && span->has_free()) {
+            void* obj;
+            if (span->free_list) {
+                obj = span->free_list;
+                span->free_list = *static_cast<void**>(obj);
+            } else {
+                obj = span->memory + span->bump_index++ * slot_size;
+            }
+            *static_cast<void**>(obj) = *head;
+            *head = obj;
+            span->in_use++;
+            moved++;
+        }
+        if (!span->has_free()) {
+            unlink_partial(list, span);
+        }
+    }
+    return moved;
+}
+
+// Return a linked list of objects of class cls to their spans
+void central_release(uint8_t cls, void* head) {
+    WildHeap& h = heap();
+    CentralList& list = h.central[cls];
+
+    std::lock_guard<std::mutex> lock(list.mutex);
+
+    while (head) {
+        void* obj = head;
+        head = *static_cast<void**>(obj);
+
+        Span* span = h.pages.map.lookup(obj);
+        *static_cast<void**>(obj) = span->free_list;
+        span->free_list = obj;
+        span->in_use--;
+        if (!span->in_partial) {
+            link_partial(list, span);
+        }
+
+        // Keep one empty span per class to absorb alloc/free churn
+        if (span->in_use == 0 && list.num_partial > 1) {
+            unlink_partial(list, span);
+            h.pages.release_span(span);
+        }
+    }
+}
+
+void publish_stats(int64_t bytes, int64_t allocations) {
+    WildHeap& h = heap();
+    int64_t live = h.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    h.live_allocations.fetch_add(allocations, std::memory_order_relaxed);
+
+    int64_t peak = h.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !h.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+// =============================================================================
+// Thread Cache
+// =============================================================================
+
+struct FreeList {
+    void* head = nullptr;
+    uint32_t length = 0;
+};
+
+struct ThreadCache {
+    FreeList lists[NUM_SIZE_CLASSES];
+    int64_t bytes_delta = 0;       // Unpublished statistics
+    int64_t allocations_delta = 0;
+
+    void account(int64_t bytes, int64_t allocations) {
+        bytes_delta += bytes;
+        allocations_delta += allocations;
+        if (bytes_delta > STATS_FLUSH_BYTES || bytes_delta < -STATS_FLUSH_BYTES) {
+            flush_stats();
+        }
+    }
+
+    void flush_stats() {
+        publish_stats(bytes_delta, allocations_delta);
+        bytes_delta = 0;
+        allocations_delta = 0;
+    }
+
+    // Hand batch objects (or all, if batch is 0) of list cls back
+    void release(uint8_t cls, size_t batch) {
+        FreeList& list = lists[cls];
+        size_t count = batch ? std::min<size_t>(batch, list.length) : list.length;
+        if (count == 0) return;
+
+        void* head = list.head;
+        void* tail = head;
+        for (size_t i = 1; i < count; ++i) {
+            tail = *static_cast<void**>(tail);
+        }
+        list.head = *static_cast<void**>(tail);
+        list.length -= static_cast<uint32_t>(count);
+        *static_cast<void**>(tail) = nullptr;
+        central_release(cls, head);
+    }
+
+    ~ThreadCache() {
+        for (size_t cls = 1; cls < NUM_SIZE_CLASSES; ++cls) {
+            release(static_cast<uint8_t>(cls), 0);
+        }
+        flush_stats();
+    }
+};
+
+/**
+ * Per-thread handle. Once the cache is destroyed at thread exit, later
+ * calls on the thread (from other thread_local destructors) go straight
+ * to the central lists.
+ */
+struct ThreadCacheHandle {
+    ThreadCache* cache = nullptr;
+    bool exited = false;
+
+    ~ThreadCacheHandle() {
+        delete cache;
+        cache = nullptr;
+        exited = true;
+    }
+};
+
+thread_local ThreadCacheHandle t_cache;
+
+ThreadCache* thread_cache() {
+    if (__builtin_expect(t_cache.cache != nullptr, 1)) {
+        return t_cache.cache;
+    }
+    if (t_cache.exited) {
+        return nullptr;
+    }
+    t_cache.cache = new ThreadCache();
+    return t_cache.cache;
+}
+
+void* allocate_large(size_t size) {
+    Span* span = heap().pages.create_span(SIZE_CLASS_LARGE, 0, size);
+    if (!span) {
+        return nullptr;
+    }
+    span->slot_size = span->mapped_size;
+    span->in_use = 1;
+    return span->memory;
+}
+
+void* allocate_small(uint8_t cls) {
+    const SizeClasses& classes = size_classes();
+    ThreadCache* cache = thread_cache();
+
+    if (!cache) {
+        void* obj = nullptr;
+        if (!central_fetch(cls, 1, &obj)) {
+            return nullptr;
+        }
+        publish_stats(static_cast<int64_t>(classes.slot_size[cls]), 1);
+        return obj;
+    }
+
+    FreeList& list = cache->lists[cls];
+    if (__builtin_expect(!list.head, 0)) {
+        size_t moved = central_fetch(cls, classes.batch[cls], &list.head);
+        if (!moved) {
+            return nullptr;
+        }
+        list.length = static_cast<uint32_t>(moved);
+    }
+
+    void* obj = list.head;
+    list.head = *static_cast<void**>(obj);
+    list.length--;
+    cache->account(static_cast<int64_t>(classes.slot_size[cls]), 1);
+    return obj;
+}
+
+} // namespace
+
+// =============================================================================
+// Public Interface
+// =============================================================================
+
+void* wild_heap_allocate(size_t size) {
+    if (size > MAX_SMALL_SIZE) {
+        void* ptr = allocate_large(size);
+        if (ptr) {
+            Span* span = heap().pages.map.lookup(ptr);
+            publish_stats(static_cast<int64_t>(span->mapped_size), 1);
+        }
+        return ptr;
+    }
+    return allocate_small(size_classes().class_for(size));
+}
+
+void* wild_heap_allocate_aligned(size_t size, size_t alignment) {
+    if (alignment <= MIN_ALIGNMENT) {
+        return wild_heap_allocate(size);
+    }
+    if ((alignment & (alignment - 1)) != 0 || alignment > SPAN_SIZE ||
+        size > SIZE_MAX - alignment) {
+        return nullptr;
+    }
+
+    // Large spans start SPAN_SIZE-aligned; small slots are padded and
+    // the aligned interior pointer is returned (free accepts it)
+    if (size > MAX_SMALL_SIZE) {
+        return wild_heap_allocate(size);
+    }
+    char* raw = static_cast<char*>(wild_heap_allocate(size + alignment - MIN_ALIGNMENT));
+    if (!raw) {
+        return nullptr;
+    }
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + alignment - 1) & ~(alignment - 1);
+    return reinterpret_cast<void*>(aligned);
+}
+
+void wild_heap_free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    Span* span = heap().pages.map.lookup(ptr);
+    if (!span) {
+        std::free(ptr);  // Not ours (allocated before the wild heap existed)
+        return;
+    }
+
+    if (span->size_class == SIZE_CLASS_LARGE) {
+        publish_stats(-static_cast<int64_t>(span->mapped_size), -1);
+        heap().pages.release_span(span);
+        return;
+    }
+
+    // Interior pointers round down to their slot
+    uint8_t cls = span->size_class;
+    size_t slot_size = span->slot_size;
+    size_t index = static_cast<size_t>(static_cast<char*>(ptr) - span->memory) / slot_size;
+    void* obj = span->memory + index * slot_size;
+
+    ThreadCache* cache = thread_cache();
+    if (!cache) {
+        *static_cast<void**>(obj) = nullptr;
+        central_release(cls, obj);
+        publish_stats(-static_cast<int64_t>(slot_size), -1);
+        return;
+    }
+
+    FreeList& list = cache->lists[cls];
+    *static_cast<void**>(obj) = list.head;
+    list.head = obj;
+    list.length++;
+    cache->account(-static_cast<int64_t>(slot_size), -1);
+
+    // A thread that frees what others allocate would otherwise hoard
+    // objects: keep at most two batches per class
+    size_t batch = size_classes().batch[cls];
+    if (__builtin_expect(list.length > 2 * batch, 0)) {
+        cache->release(cls, batch);
+    }
+}
+
+size_t wild_heap_usable_size(const void* ptr) {
+    Span* span = ptr ? heap().pages.map.lookup(ptr) : nullptr;
+    if (!span) {
+        return 0;
+    }
+
+    size_t offset = static_cast<size_t>(static_cast<const char*>(ptr) - span->memory);
+    size_t slot_end = (offset / span->slot_size + 1) * span->slot_size;
+    return slot_end - offset;
+}
+
+void wild_heap_get_stats(WildHeapStats* stats) {
+    // Publish the caller's deltas first so a single-threaded program
+    // sees exact numbers
+    if (t_cache.cache) {
+        t_cache.cache->flush_stats();
+    }
+
+    WildHeap& h = heap();
+    int64_t bytes = h.live_bytes.load(std::memory_order_relaxed);
+    int64_t allocations = h.live_allocations.load(std::memory_order_relaxed);
+    int64_t peak = h.peak_bytes.load(std::memory_order_relaxed);
+
+    stats->live_bytes = static_cast<size_t>(std::max<int64_t>(bytes, 0));
+    stats->live_allocations = static_cast<size_t>(std::max<int64_t>(allocations, 0));
+    stats->peak_bytes = static_cast<size_t>(std::max<int64_t>(peak, 0));
+}
+
+} // namespace runtime
+} // namespace aria
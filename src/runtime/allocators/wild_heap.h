@@ -0,0 +1,53 @@
+/**
+ * Aria Wild Heap Internal Interface
+ *
+ * The allocator behind aria_alloc/aria_free (wild_alloc.cpp):
+ * - Size classes: 16-byte steps to 128 bytes, then 8 classes per power
+ *   of two up to 32KB (at most 12.5% internal waste)
+ * - Thread caches: per-thread, per-class free lists; the common
+ *   allocate/free is a list pop/push with no atomic operation
+ * - Central lists: per-class lists of spans with free slots, locked
+ *   only to move a batch of objects to or from a thread cache
+ * - Spans: 256KB-aligned page runs, one size class each; larger
+ *   allocations get a dedicated span. A radix map from address to span
+ *   finds the class of a freed pointer without an object header.
+ *
+ * Byte and allocation counts are accumulated per thread and published
+ * in batches, so peak tracking costs no shared write per call.
+ *
+ * Reference: research_022_wild_wildx_memory.txt
+ */
+
+#ifndef ARIA_RUNTIME_WILD_HEAP_H
+#define ARIA_RUNTIME_WILD_HEAP_H
+
+#include <cstddef>
+
+namespace aria {
+namespace runtime {
+
+void* wild_heap_allocate(size_t size);
+
+// alignment: power of two up to the span size (256KB)
+void* wild_heap_allocate_aligned(size_t size, size_t alignment);
+
+// Accepts interior pointers (from wild_heap_allocate_aligned). Memory
+// the wild heap does not own is passed to std::free.
+void wild_heap_free(void* ptr);
+
+// Bytes usable from ptr to the end of its slot, or 0 if not owned
+size_t wild_heap_usable_size(const void* ptr);
+
+struct WildHeapStats {
+    size_t live_bytes;          // Slot bytes handed out and not freed
+    size_t live_allocations;
+    size_t peak_bytes;          // Highest live_bytes published
+};
+
+// Exact for the calling thread; other threads publish every few KB
+void wild_heap_get_stats(WildHeapStats* stats);
+
+} // namespace runtime
+} // namespace aria
+
+#endif // ARIA_RUNTIME_WILD_HEAP_H
@@ -4,13 +4,21 @@
  * Provides W⊕X (Write XOR Execute) secure memory for JIT compilation.
  * Implements state machine: UNINITIALIZED → WRITABLE → EXECUTABLE → FREED
  * 
+ * Also provides AriaCodePool, which packs many small stubs into shared
+ * chunks and seals them in batches (dual-mapped through a memfd where
+ * available).
+ * 
  * Platform support: POSIX (mmap), Windows (VirtualAlloc)
  */
 
 #include "runtime/allocators.h"
+#include <cstdlib>
 #include <cstring>
+#include <algorithm>
 #include <atomic>
 #include <mutex>
+#include <new>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -206,3 +214,299 @@ void* aria_exec_jit(WildXGuard* guard, void* args) {
 
 // Note: aria_allocator_get_stats() is implemented in wild_alloc.cpp
 // This file only provides the WildX statistics via global atomics
+
+// =============================================================================
+// WildX Code Pool
+// =============================================================================
+
+static constexpr size_t CODE_POOL_DEFAULT_CHUNK = 64 * 1024;
+static constexpr size_t CODE_STUB_ALIGNMENT = 16;
+
+struct CodeChunk {
+    char* write_base;         // RW view (same as exec_base when single-mapped)
+    char* exec_base;          // RX once sealed
+    size_t size;
+    size_t cursor;            // Next free offset
+    size_t sealed;            // Offsets below this are published
+    size_t live_stubs;
+    bool pending;             // Holds stubs not yet sealed
+};
+
+struct AriaCodePool {
+    std::mutex mutex;
+    size_t chunk_size;
+    bool dual_mapped;
+    CodeChunk* open = nullptr;            // Chunk small stubs are carved from
+    std::vector<CodeChunk*> chunks;
+    std::vector<CodeChunk*> pending;
+    CodePoolStats stats = {};
+};
+
+/**
+ * Map a chunk as two views of one memfd: RW for the JIT, RX for callers
+ */
+static bool map_dual_chunk(CodeChunk* chunk) {
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+    int fd = memfd_create("aria-wildx", MFD_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(chunk->size)) != 0) {
+        close(fd);
+        return false;
+    }
+
+    void* rw = mmap(nullptr, chunk->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    void* rx = rw == MAP_FAILED ? MAP_FAILED
+                                : mmap(nullptr, chunk->size, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+    close(fd);  // The mappings keep the memory alive
+
+    if (rx == MAP_FAILED) {
+        if (rw != MAP_FAILED) {
+            munmap(rw, chunk->size);
+        }
+        return false;
+    }
+    chunk->write_base = static_cast<char*>(rw);
+    chunk->exec_base = static_cast<char*>(rx);
+    return true;
+#else
+    (void)chunk;
+    return false;
+#endif
+}
+
+static bool map_single_chunk(CodeChunk* chunk) {
+#ifdef _WIN32
+    void* ptr = VirtualAlloc(nullptr, chunk->size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+    void* ptr = mmap(nullptr, chunk->size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        ptr = nullptr;
+    }
+#endif
+    if (!ptr) {
+        return false;
+    }
+    chunk->write_base = static_cast<char*>(ptr);
+    chunk->exec_base = static_cast<char*>(ptr);
+    return true;
+}
+
+static bool protect_exec_range(void* ptr, size_t size) {
+#ifdef _WIN32
+    DWORD old_protect;
+    return VirtualProtect(ptr, size, PAGE_EXECUTE_READ, &old_protect) != 0;
+#else
+    return mprotect(ptr, size, PROT_READ | PROT_EXEC) == 0;
+#endif
+}
+
+static void unmap_chunk_views(CodeChunk* chunk) {
+#ifdef _WIN32
+    VirtualFree(chunk->exec_base, 0, MEM_RELEASE);
+#else
+    if (chunk->write_base != chunk->exec_base) {
+        munmap(chunk->write_base, chunk->size);
+    }
+    munmap(chunk->exec_base, chunk->size);
+#endif
+}
+
+// Callers hold pool->mutex
+static CodeChunk* create_code_chunk(AriaCodePool* pool, size_t size) {
+    CodeChunk* chunk = new CodeChunk();
+    chunk->size = size;
+
+    bool mapped = false;
+    if (pool->dual_mapped) {
+        mapped = map_dual_chunk(chunk);
+        if (!mapped) {
+            pool->dual_mapped = false;  // e.g. no memfd, or exec of shared mappings denied
+        }
+    }
+    if (!mapped && !map_single_chunk(chunk)) {
+        delete chunk;
+        return nullptr;
+    }
+
+    pool->chunks.push_back(chunk);
+    pool->stats.num_chunks++;
+    pool->stats.bytes_reserved += size;
+
+    g_wildx_total_allocated.fetch_add(size);
+    update_wildx_peak();
+    return chunk;
+}
+
+static void destroy_code_chunk(AriaCodePool* pool, CodeChunk* chunk) {
+    pool->chunks.erase(std::find(pool->chunks.begin(), pool->chunks.end(), chunk));
+    if (chunk->pending) {
+        pool->pending.erase(std::find(pool->pending.begin(), pool->pending.end(), chunk));
+    }
+    if (pool->open == chunk) {
+        pool->open = nullptr;
+    }
+
+    pool->stats.num_chunks--;
+    pool->stats.bytes_reserved -= chunk->size;
+    pool->stats.bytes_used -= chunk->cursor;
+    g_wildx_total_allocated.fetch_sub(chunk->size);
+
+    unmap_chunk_views(chunk);
+    delete chunk;
+}
+
+AriaCodePool* aria_code_pool_create(size_t chunk_size) {
+    AriaCodePool* pool = new (std::nothrow) AriaCodePool();
+    if (!pool) {
+        return nullptr;
+    }
+
+    pool->chunk_size = round_to_page(chunk_size ? chunk_size : CODE_POOL_DEFAULT_CHUNK);
+
+    // ARIA_WILDX_DUAL_MAP=0 forces the single-mapped (mprotect) scheme
+    const char* dual = std::getenv("ARIA_WILDX_DUAL_MAP");
+#ifdef _WIN32
+    pool->dual_mapped = false;
+    (void)dual;
+#else
+    pool->dual_mapped = !(dual && dual[0] == '0');
+#endif
+    return pool;
+}
+
+int aria_code_pool_alloc(AriaCodePool* pool, size_t size, AriaCodeStub* stub) {
+    if (!stub) {
+        return -1;
+    }
+    *stub = AriaCodeStub{};
+    if (!pool || size == 0 || size > SIZE_MAX - pool->chunk_size) {
+        return -1;
+    }
+
+    size_t padded = (size + CODE_STUB_ALIGNMENT - 1) & ~(CODE_STUB_ALIGNMENT - 1);
+
+    std::lock_guard<std::mutex> lock(pool->mutex);
+
+    CodeChunk* chunk;
+    if (padded > pool->chunk_size / 4) {
+        // Large stub: own chunk, so small stubs keep packing into the open one
+        chunk = create_code_chunk(pool, round_to_page(padded));
+    } else {
+        chunk = pool->open;
+        if (!chunk || chunk->size - chunk->cursor < padded) {
+            CodeChunk* retired = pool->open;
+            chunk = create_code_chunk(pool, pool->chunk_size);
+            if (chunk) {
+                pool->open = chunk;
+                if (retired && retired->live_stubs == 0) {
+                    destroy_code_chunk(pool, retired);
+                }
+            }
+        }
+    }
+    if (!chunk) {
+        return -1;
+    }
+
+    size_t offset = chunk->cursor;
+    chunk->cursor += padded;
+    chunk->live_stubs++;
+    if (!chunk->pending) {
+        chunk->pending = true;
+        pool->pending.push_back(chunk);
+    }
+
+    pool->stats.bytes_used += padded;
+    pool->stats.num_stubs++;
+    g_wildx_num_allocations.fetch_add(1);
+
+    stub->write_ptr = chunk->write_base + offset;
+    stub->exec_ptr = chunk->exec_base + offset;
+    stub->size = size;
+    stub->chunk = chunk;
+    return 0;
+}
+
+int aria_code_pool_seal(AriaCodePool* pool) {
+    if (!pool) {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(pool->mutex);
+
+    int result = 0;
+    for (CodeChunk* chunk : pool->pending) {
+        chunk->pending = false;
+        if (chunk->write_base != chunk->exec_base) {
+            // Dual-mapped: the RX view already sees the bytes
+            flush_instruction_cache(chunk->exec_base + chunk->sealed, chunk->cursor - chunk->sealed);
+            chunk->sealed = chunk->cursor;
+            continue;
+        }
+
+        // Single-mapped: flip the written pages, continue on the next page
+        size_t end = std::min(round_to_page(chunk->cursor), chunk->size);
+        flush_instruction_cache(chunk->exec_base + chunk->sealed, end - chunk->sealed);
+        pool->stats.num_protect_calls++;
+        if (!protect_exec_range(chunk->exec_base + chunk->sealed, end - chunk->sealed)) {
+            result = -1;
+            continue;
+        }
+        pool->stats.bytes_used += end - chunk->cursor;
+        chunk->cursor = end;
+        chunk->sealed = end;
+    }
+    pool->pending.clear();
+    pool->stats.num_seals++;
+    return result;
+}
+
+void aria_code_pool_free(AriaCodePool* pool, AriaCodeStub* stub) {
+    if (!pool || !stub || !stub->chunk) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(pool->mutex);
+
+    CodeChunk* chunk = static_cast<CodeChunk*>(stub->chunk);
+    chunk->live_stubs--;
+    pool->stats.num_stubs--;
+    g_wildx_num_allocations.fetch_sub(1);
+
+    if (chunk->live_stubs == 0 && chunk != pool->open) {
+        destroy_code_chunk(pool, chunk);
+    }
+    *stub = AriaCodeStub{};
+}
+
+void aria_code_pool_destroy(AriaCodePool* pool) {
+    if (!pool) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        g_wildx_num_allocations.fetch_sub(pool->stats.num_stubs);
+        while (!pool->chunks.empty()) {
+            destroy_code_chunk(pool, pool->chunks.back());
+        }
+    }
+    delete pool;
+}
+
+void aria_code_pool_get_stats(AriaCodePool* pool, CodePoolStats* stats) {
+    if (!stats) {
+        return;
+    }
+    if (!pool) {
+        *stats = CodePoolStats{};
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    *stats = pool->stats;
+    stats->dual_mapped = pool->dual_mapped;
+}
@@ -463,6 +463,31 @@ WildXGuard aria_asm_finalize(Assembler* asm_ctx) {
     return guard;
 }
 
+int aria_asm_finalize_to_pool(Assembler* asm_ctx, AriaCodePool* pool, AriaCodeStub* stub) {
+    if (asm_ctx->error) {
+        return -1;
+    }
+    
+    // Verify all labels are bound
+    for (uint32_t i = 0; i < asm_ctx->label_count; ++i) {
+        if (!aria_asm_label_is_bound(&asm_ctx->labels[i])) {
+            set_error(asm_ctx, "Unbound label detected at finalization");
+            return -1;
+        }
+    }
+    
+    // Allocate a stub from the shared chunks
+    if (aria_code_pool_alloc(pool, asm_ctx->buffer->size, stub) != 0) {
+        set_error(asm_ctx, "Failed to allocate code pool stub");
+        return -1;
+    }
+    
+    // Copy code through the writable view; sealing is batched by the caller
+    memcpy(stub->write_ptr, asm_ctx->buffer->data, asm_ctx->buffer->size);
+    
+    return 0;
+}
+
 int64_t aria_asm_execute(WildXGuard* guard) {
     if (!guard || !guard->ptr || guard->state != WILDX_STATE_EXECUTABLE) {
         return -1;
@@ -4,11 +4,12 @@
  * Array utilities and functional programming operations.
  */
 
-#include "runtime/collections.h"
+#include "collections_internal.h"
 #include "runtime/gc.h"
 #include "runtime/stdlib.h"
 #include <cstring>
 #include <cstdlib>
+#include <cstddef>
 
 // Default initial capacity for arrays
 #define ARIA_ARRAY_DEFAULT_CAPACITY 16
@@ -17,10 +18,52 @@
 #define ARIA_ARRAY_GROWTH_FACTOR 3
 #define ARIA_ARRAY_GROWTH_DIVISOR 2
 
+namespace aria {
+namespace runtime {
+
+void barrier_before_overwrite_elements(const AriaArray* array, size_t begin, size_t end) {
+    if (array->type_id == 0 || !aria_gc_satb_active) return;
+    char* first = static_cast<char*>(array->data) + begin * array->element_size;
+    char* last = static_cast<char*>(array->data) + end * array->element_size;
+    for (char* word = first; word + sizeof(void*) <= last; word += sizeof(void*)) {
+        aria_gc_write_barrier_pre(reinterpret_cast<void**>(word));
+    }
+}
+
+void barrier_after_store_elements(const AriaArray* array, size_t begin, size_t end) {
+    if (array->type_id == 0) return;
+    const char* first = static_cast<const char*>(array->data) + begin * array->element_size;
+    const char* last = static_cast<const char*>(array->data) + end * array->element_size;
+    for (const char* word = first; word + sizeof(void*) <= last; word += sizeof(void*)) {
+        void* ref;
+        std::memcpy(&ref, word, sizeof(ref));
+        aria_gc_write_barrier(array->data, ref);
+    }
+}
+
+} // namespace runtime
+} // namespace aria
+
+using aria::runtime::LocalRoots;
+using aria::runtime::barrier_after_store_elements;
+using aria::runtime::barrier_before_overwrite_elements;
+
 // ═══════════════════════════════════════════════════════════════════════
 // Array Creation and Destruction
 // ═══════════════════════════════════════════════════════════════════════
 
+/**
+ * GC type ID for AriaArray headers (data is a traced reference; the
+ * elements themselves are traced through the caller's type_id).
+ */
+static uint16_t array_type_id() {
+    static const uint16_t id = [] {
+        uint64_t bitmap = uint64_t(1) << (offsetof(AriaArray, data) / 8);
+        return aria_gc_register_type(sizeof(AriaArray), &bitmap);
+    }();
+    return id;
+}
+
 AriaResultPtr aria_array_new(size_t element_size, size_t initial_capacity, int type_id) {
     if (element_size == 0) {
         AriaError* error = aria_error_new(
@@ -35,7 +78,7 @@ AriaResultPtr aria_array_new(size_t element_size, size_t initial_capacity, int t
     size_t capacity = initial_capacity > 0 ? initial_capacity : ARIA_ARRAY_DEFAULT_CAPACITY;
     
     // Allocate array structure on GC heap
-    AriaArray* array = (AriaArray*)aria_gc_alloc(sizeof(AriaArray), 0);
+    AriaArray* array = (AriaArray*)aria_gc_alloc(sizeof(AriaArray), array_type_id());
     if (!array) {
         AriaError* error = aria_error_new(
             ARIA_ERR_OUT_OF_MEMORY,
@@ -109,8 +152,10 @@ AriaResultPtr aria_array_get(const AriaArray* array, size_t index) {
 
 void aria_array_set_unchecked(AriaArray* array, size_t index, const void* value) {
     if (!array || !array->data || !value) return;
+    barrier_before_overwrite_elements(array, index, index + 1);
     void* dest = (char*)array->data + (index * array->element_size);
     std::memcpy(dest, value, array->element_size);
+    barrier_after_store_elements(array, index, index + 1);
 }
 
 AriaResultVoid aria_array_set(AriaArray* array, size_t index, const void* value) {
@@ -169,6 +214,10 @@ AriaResultVoid aria_array_push(AriaArray* array, const void* value) {
         size_t new_capacity = (array->capacity * ARIA_ARRAY_GROWTH_FACTOR) / ARIA_ARRAY_GROWTH_DIVISOR;
         if (new_capacity <= array->capacity) new_capacity = array->capacity + 1;
         
+        // The header follows a collection that moves it
+        LocalRoots roots;
+        roots.add(&array);
+        
         void* new_data = aria_gc_alloc(array->element_size * new_capacity, array->type_id);
         if (!new_data) {
             AriaError* error = aria_error_new(
@@ -179,15 +228,21 @@ AriaResultVoid aria_array_push(AriaArray* array, const void* value) {
             return aria_result_err_void(error);
         }
         
-        // Copy existing elements
+        // Copy existing elements. A large buffer is allocated in the old
+        // generation, so the copied references need card marks, and an
+        // old header needs one for its new buffer.
         std::memcpy(new_data, array->data, array->element_size * array->length);
         array->data = new_data;
         array->capacity = new_capacity;
+        aria_gc_write_barrier(array, new_data);
+        barrier_after_store_elements(array, 0, array->length);
     }
     
-    // Copy element to end
-    aria_array_set_unchecked(array, array->length, value);
+    // Copy element to end (a fresh slot: nothing to log)
+    void* dest = (char*)array->data + (array->length * array->element_size);
+    std::memcpy(dest, value, array->element_size);
     array->length++;
+    barrier_after_store_elements(array, array->length - 1, array->length);
     
     return aria_result_ok_void();
 }
@@ -390,48 +445,6 @@ AriaResultPtr aria_array_reduce(const AriaArray* array, AriaReducerFn reducer,
     return aria_result_ok_ptr(accumulator);
 }
 
-// Global context for qsort (not thread-safe, but simple)
-static struct {
-    AriaComparatorFn comparator;
-    void* context;
-} g_sort_context;
-
-static int sort_wrapper(const void* a, const void* b) {
-    return g_sort_context.comparator(a, b, g_sort_context.context);
-}
-
-AriaResultVoid aria_array_sort(AriaArray* array, AriaComparatorFn comparator, void* context) {
-    if (!array) {
-        AriaError* error = aria_error_new(
-            ARIA_ERR_NULL_PTR,
-            "Array is NULL",
-            __FILE__, __LINE__
-        );
-        return aria_result_err_void(error);
-    }
-    
-    if (!comparator) {
-        AriaError* error = aria_error_new(
-            ARIA_ERR_NULL_PTR,
-            "Comparator function is NULL",
-            __FILE__, __LINE__
-        );
-        return aria_result_err_void(error);
-    }
-    
-    if (array->length <= 1) {
-        return aria_result_ok_void();
-    }
-    
-    // Use qsort with global context (not thread-safe, but works)
-    g_sort_context.comparator = comparator;
-    g_sort_context.context = context;
-    
-    std::qsort(array->data, array->length, array->element_size, sort_wrapper);
-    
-    return aria_result_ok_void();
-}
-
 AriaResultVoid aria_array_reverse(AriaArray* array) {
     if (!array) {
         AriaError* error = aria_error_new(
@@ -488,13 +501,18 @@ AriaResultPtr aria_array_unique(const AriaArray* array, AriaComparatorFn compara
         return aria_result_err_ptr(error);
     }
     
+    // Bytewise equality: hash the elements (see hash_map.cpp)
+    if (!comparator) {
+        return aria_array_unique_by(array, nullptr, nullptr, nullptr);
+    }
+    
     // Create result array
     AriaResultPtr result = aria_array_new(array->element_size, array->capacity, array->type_id);
     if (result.is_error) return result;
     
     AriaArray* unique = (AriaArray*)result.value;
     
-    // Add elements if not already present
+    // A comparator gives no hash: check against every kept element
     for (size_t i = 0; i < array->length; i++) {
         void* element = aria_array_get_unchecked(array, i);
         
@@ -503,14 +521,7 @@ AriaResultPtr aria_array_unique(const AriaArray* array, AriaComparatorFn compara
         for (size_t j = 0; j < unique->length; j++) {
             void* existing = aria_array_get_unchecked(unique, j);
             
-            int cmp;
-            if (comparator) {
-                cmp = comparator(element, existing, context);
-            } else {
-                cmp = std::memcmp(element, existing, array->element_size);
-            }
-            
-            if (cmp == 0) {
+            if (comparator(element, existing, context) == 0) {
                 found = true;
                 break;
             }
@@ -0,0 +1,111 @@
+/**
+ * Phase 6.2 Standard Library - Collections Internal Interfaces
+ *
+ * Shared by the collections translation units; not part of the public
+ * runtime API.
+ */
+
+#ifndef ARIA_RUNTIME_COLLECTIONS_INTERNAL_H
+#define ARIA_RUNTIME_COLLECTIONS_INTERNAL_H
+
+#include "runtime/collections.h"
+#include "runtime/gc.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aria {
+namespace runtime {
+
+/**
+ * Roots local GC pointers for the lifetime of the object (the collector
+ * updates them in place if it moves their objects).
+ */
+class LocalRoots {
+public:
+    LocalRoots() { aria_shadow_stack_push_frame(); }
+    ~LocalRoots() { aria_shadow_stack_pop_frame(); }
+
+    LocalRoots(const LocalRoots&) = delete;
+    LocalRoots& operator=(const LocalRoots&) = delete;
+
+    template <typename T>
+    void add(T** root_addr) {
+        aria_shadow_stack_add_root(reinterpret_cast<void**>(root_addr));
+    }
+};
+
+/**
+ * CollectionWorkerPool - Persistent helper threads for data-parallel
+ * collection operations
+ *
+ * One process-wide pool (hardware_concurrency threads including the
+ * caller, or ARIA_COLLECTION_THREADS) serves every caller. parallel_for may be called from any
+ * thread, concurrently and from inside a running task: the caller
+ * always works through its own indices too, so a job completes even
+ * when every helper is busy elsewhere.
+ *
+ * Tasks run on threads that are not GC mutators and must not allocate
+ * from the GC heap.
+ */
+class CollectionWorkerPool {
+public:
+    static CollectionWorkerPool& shared();
+
+    // Threads that can run tasks at once, including the caller
+    size_t num_workers() const { return helpers.size() + 1; }
+
+    /**
+     * Run task(i) for every i in [0, count), in any order and on any
+     * thread; returns once all calls have finished
+     */
+    void parallel_for(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    struct Job {
+        const std::function<void(size_t)>* task;
+        size_t count;
+        std::atomic<size_t> next{0};
+        size_t finished = 0;               // Guarded by the pool mutex
+        std::condition_variable done_cv;
+    };
+
+    explicit CollectionWorkerPool(size_t num_workers);
+
+    void helper_loop();
+
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::deque<Job*> jobs;
+    std::vector<std::thread> helpers;
+};
+
+/**
+ * SATB-log the references held by elements [begin, end) of array before
+ * they are overwritten or moved (no-op when type_id is 0 or no marking
+ * cycle is running)
+ */
+void barrier_before_overwrite_elements(const AriaArray* array, size_t begin, size_t end);
+
+/**
+ * Card-mark the references held by elements [begin, end) of array after
+ * they were written with plain stores (no-op when type_id is 0)
+ */
+void barrier_after_store_elements(const AriaArray* array, size_t begin, size_t end);
+
+/**
+ * Sort count elements of element_size bytes in place (pattern-defeating
+ * quicksort, not stable). Reentrant: all state is per call.
+ */
+void sort_elements(void* data, size_t count, size_t element_size,
+                   AriaComparatorFn comparator, void* context);
+
+} // namespace runtime
+} // namespace aria
+
+#endif // ARIA_RUNTIME_COLLECTIONS_INTERNAL_H
@@ -0,0 +1,697 @@
+/**
+ * Phase 6.2 Standard Library - Hash Map and Hash Set Implementation
+ *
+ * Swiss-table open addressing. Each slot has a control byte holding
+ * EMPTY, DELETED or a 7-bit tag from the key's hash. Probing loads a
+ * whole group of control bytes at once and compares all of them with
+ * the tag in a few instructions (SSE2, or 8-byte SWAR arithmetic where
+ * SSE2 is unavailable); keys are only compared on tag hits.
+ *
+ * GC integration: the map header, control bytes and entries are GC
+ * objects. Entries are traced through the map's type_id, stores into
+ * them go through the write barriers, and locals holding GC pointers
+ * are rooted on the shadow stack across allocations, since a collection
+ * may move them.
+ */
+
+#include "collections_internal.h"
+#include "runtime/gc.h"
+#include <cstring>
+#include <cstddef>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using aria::runtime::LocalRoots;
+
+namespace {
+
+constexpr uint8_t CTRL_EMPTY = 0x80;    // 0b10000000
+constexpr uint8_t CTRL_DELETED = 0xFE;  // 0b11111110
+                                        // Full: 0b0ttttttt (tag)
+
+constexpr size_t NPOS = ~size_t(0);
+
+// ═══════════════════════════════════════════════════════════════════════
+// Control Byte Groups
+// ═══════════════════════════════════════════════════════════════════════
+
+#if defined(__SSE2__)
+
+constexpr size_t GROUP_WIDTH = 16;
+
+/**
+ * Sixteen control bytes; masks have one bit per slot.
+ */
+struct Group {
+    typedef uint32_t Mask;
+
+    __m128i ctrl;
+
+    explicit Group(const uint8_t* pos)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+    Mask match(uint8_t tag) const {
+        __m128i tags = _mm_set1_epi8(static_cast<char>(tag));
+        return static_cast<Mask>(_mm_movemask_epi8(_mm_cmpeq_epi8(tags, ctrl)));
+    }
+
+    Mask match_empty() const {
+        return match(CTRL_EMPTY);
+    }
+
+    // EMPTY and DELETED are the only control bytes below -1
+    Mask match_empty_or_deleted() const {
+        return static_cast<Mask>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl)));
+    }
+
+    static size_t lowest(Mask mask) { return __builtin_ctz(mask); }
+    static size_t leading(Mask mask) { return __builtin_clz(mask) - (32 - GROUP_WIDTH); }
+};
+
+#else
+
+constexpr size_t GROUP_WIDTH = 8;
+
+/**
+ * Eight control bytes in a word; masks have the high bit of each
+ * matching byte set.
+ */
+struct Group {
+    typedef uint64_t Mask;
+
+    static constexpr uint64_t LSBS = 0x0101010101010101ull;
+    static constexpr uint64_t MSBS = 0x8080808080808080ull;
+
+    uint64_t ctrl;
+
+    explicit Group(const uint8_t* pos) {
+        std::memcpy(&ctrl, pos, sizeof(ctrl));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        ctrl = __builtin_bswap64(ctrl);
+#endif
+    }
+
+    // May report a false positive next to a true match; callers check
+    // the control byte before comparing keys
+    Mask match(uint8_t tag) const {
+        uint64_t x = ctrl ^ (LSBS * tag);
+        return (x - LSBS) & ~x & MSBS;
+    }
+
+    // High bit set and bit 1 clear: EMPTY only
+    Mask match_empty() const {
+        return ctrl & (~ctrl << 6) & MSBS;
+    }
+
+    // High bit set and bit 0 clear: EMPTY or DELETED
+    Mask match_empty_or_deleted() const {
+        return ctrl & (~ctrl << 7) & MSBS;
+    }
+
+    static size_t lowest(Mask mask) { return __builtin_ctzll(mask) / 8; }
+    static size_t leading(Mask mask) { return __builtin_clzll(mask) / 8; }
+};
+
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════
+// Helpers
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * GC type ID for AriaHashMap headers (ctrl and slots are traced
+ * references; entries are traced through the map's type_id).
+ */
+uint16_t hashmap_type_id() {
+    static const uint16_t id = [] {
+        uint64_t bitmap = (uint64_t(1) << (offsetof(AriaHashMap, ctrl) / 8)) |
+                          (uint64_t(1) << (offsetof(AriaHashMap, slots) / 8));
+        return aria_gc_register_type(sizeof(AriaHashMap), &bitmap);
+    }();
+    return id;
+}
+
+inline size_t entry_size(const AriaHashMap* map) {
+    return map->key_size + map->value_size;
+}
+
+inline char* entry_at(const AriaHashMap* map, size_t index) {
+    return static_cast<char*>(map->slots) + index * entry_size(map);
+}
+
+inline bool is_full(uint8_t ctrl) {
+    return (ctrl & 0x80) == 0;
+}
+
+// Entries allowed in a table of capacity slots (7/8 load factor)
+inline size_t max_load(size_t capacity) {
+    return capacity - capacity / 8;
+}
+
+// Smallest power-of-two capacity holding count entries
+size_t capacity_for(size_t count) {
+    size_t capacity = GROUP_WIDTH;
+    while (max_load(capacity) < count) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+inline uint64_t hash_key(const AriaHashMap* map, const void* key) {
+    return map->hash ? map->hash(key, map->key_size, map->context)
+                     : aria_hash_bytes(key, map->key_size);
+}
+
+inline bool keys_equal(const AriaHashMap* map, const void* a, const void* b) {
+    return map->equals ? map->equals(a, b, map->key_size, map->context)
+                       : std::memcmp(a, b, map->key_size) == 0;
+}
+
+inline uint8_t hash_tag(uint64_t hash) {
+    return static_cast<uint8_t>(hash & 0x7F);
+}
+
+// Set a control byte, keeping the mirrored first group in sync
+inline void set_ctrl(AriaHashMap* map, size_t index, uint8_t ctrl) {
+    map->ctrl[index] = ctrl;
+    if (index < GROUP_WIDTH) {
+        map->ctrl[map->capacity + index] = ctrl;
+    }
+}
+
+/**
+ * Write barriers for an entry of a map whose entries hold references:
+ * card-mark after a store (old slots may now reference young objects),
+ * SATB-log before references are overwritten or cleared.
+ */
+void barrier_after_store(const AriaHashMap* map, char* entry) {
+    if (map->type_id == 0) return;
+    for (size_t offset = 0; offset + sizeof(void*) <= entry_size(map); offset += sizeof(void*)) {
+        void* ref;
+        std::memcpy(&ref, entry + offset, sizeof(ref));
+        aria_gc_write_barrier(map->slots, ref);
+    }
+}
+
+void barrier_before_overwrite(const AriaHashMap* map, char* entry) {
+    if (map->type_id == 0 || !aria_gc_satb_active) return;
+    for (size_t offset = 0; offset + sizeof(void*) <= entry_size(map); offset += sizeof(void*)) {
+        aria_gc_write_barrier_pre(reinterpret_cast<void**>(entry + offset));
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// Probing
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * Index of the entry equal to key, or NPOS
+ *
+ * Groups are visited in triangular steps (pos, pos + 1, pos + 3, ...
+ * groups), which covers every group of a power-of-two table. The load
+ * factor guarantees an EMPTY slot, where the search stops.
+ */
+size_t find_index(const AriaHashMap* map, const void* key, uint64_t hash) {
+    if (map->capacity == 0) return NPOS;
+
+    size_t mask = map->capacity - 1;
+    uint8_t tag = hash_tag(hash);
+    size_t pos = (hash >> 7) & mask;
+    size_t stride = 0;
+
+    for (;;) {
+        Group group(map->ctrl + pos);
+        for (Group::Mask m = group.match(tag); m; m &= m - 1) {
+            size_t index = (pos + Group::lowest(m)) & mask;
+            if (map->ctrl[index] == tag && keys_equal(map, key, entry_at(map, index))) {
+                return index;
+            }
+        }
+        if (group.match_empty()) {
+            return NPOS;
+        }
+        stride += GROUP_WIDTH;
+        pos = (pos + stride) & mask;
+    }
+}
+
+/**
+ * First EMPTY or DELETED slot on the probe sequence of hash
+ */
+size_t find_insert_index(const AriaHashMap* map, uint64_t hash) {
+    size_t mask = map->capacity - 1;
+    size_t pos = (hash >> 7) & mask;
+    size_t stride = 0;
+
+    for (;;) {
+        Group::Mask m = Group(map->ctrl + pos).match_empty_or_deleted();
+        if (m) {
+            return (pos + Group::lowest(m)) & mask;
+        }
+        stride += GROUP_WIDTH;
+        pos = (pos + stride) & mask;
+    }
+}
+
+/**
+ * Move every entry into fresh tables of new_capacity slots (dropping
+ * DELETED markers). map is a root for the duration, so the caller's
+ * variable follows the header if a collection moves it.
+ */
+bool rehash(AriaHashMap*& map, size_t new_capacity) {
+    LocalRoots roots;
+    roots.add(&map);
+
+    uint8_t* old_ctrl = map->ctrl;
+    void* old_slots = map->slots;
+    size_t old_capacity = map->capacity;
+    roots.add(&old_ctrl);
+    roots.add(&old_slots);
+
+    uint8_t* ctrl = static_cast<uint8_t*>(aria_gc_alloc(new_capacity + GROUP_WIDTH, 0));
+    if (!ctrl) return false;
+    roots.add(&ctrl);
+
+    void* slots = aria_gc_alloc(new_capacity * entry_size(map),
+                                static_cast<uint16_t>(map->type_id));
+    if (!slots) return false;
+
+    std::memset(ctrl, CTRL_EMPTY, new_capacity + GROUP_WIDTH);
+    map->ctrl = ctrl;
+    map->slots = slots;
+    map->capacity = new_capacity;
+    aria_gc_write_barrier(map, ctrl);
+    aria_gc_write_barrier(map, slots);
+
+    size_t stride = entry_size(map);
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (!is_full(old_ctrl[i])) continue;
+
+        const char* entry = static_cast<const char*>(old_slots) + i * stride;
+        uint64_t hash = hash_key(map, entry);
+        size_t index = find_insert_index(map, hash);
+        set_ctrl(map, index, hash_tag(hash));
+        std::memcpy(entry_at(map, index), entry, stride);
+        barrier_after_store(map, entry_at(map, index));
+    }
+
+    map->growth_left = max_load(new_capacity) - map->length;
+    return true;
+}
+
+/**
+ * Store a new entry in the free slot at index
+ */
+void store_entry(AriaHashMap* map, size_t index, uint64_t hash,
+                 const void* key, const void* value) {
+    if (map->ctrl[index] == CTRL_EMPTY) {
+        map->growth_left--;
+    }
+    set_ctrl(map, index, hash_tag(hash));
+
+    char* entry = entry_at(map, index);
+    std::memcpy(entry, key, map->key_size);
+    if (value && map->value_size) {
+        std::memcpy(entry + map->key_size, value, map->value_size);
+    }
+    map->length++;
+    barrier_after_store(map, entry);
+}
+
+/**
+ * Remove the entry at index
+ *
+ * The slot can go back to EMPTY only if no probe sequence ever passed
+ * over it: that holds when every group containing it still has an
+ * EMPTY slot, i.e. the run of non-empty slots around it is shorter than
+ * a group. Otherwise it becomes DELETED so lookups keep probing past.
+ */
+void erase_at(AriaHashMap* map, size_t index) {
+    char* entry = entry_at(map, index);
+    barrier_before_overwrite(map, entry);
+    std::memset(entry, 0, entry_size(map));  // Drop references held by the entry
+
+    size_t before = (index - GROUP_WIDTH) & (map->capacity - 1);
+    Group::Mask empty_after = Group(map->ctrl + index).match_empty();
+    Group::Mask empty_before = Group(map->ctrl + before).match_empty();
+    bool never_full = empty_before && empty_after &&
+                      Group::lowest(empty_after) + Group::leading(empty_before) < GROUP_WIDTH;
+
+    set_ctrl(map, index, never_full ? CTRL_EMPTY : CTRL_DELETED);
+    if (never_full) {
+        map->growth_left++;
+    }
+    map->length--;
+}
+
+// Capacity to rehash into when an insert finds no room
+size_t grown_capacity(const AriaHashMap* map) {
+    // Enough DELETED slots to free: clean up in place. Above 25/32 full
+    // that would leave too little room before the next rehash.
+    if (map->capacity && map->length <= map->capacity / 32 * 25) {
+        return map->capacity;
+    }
+    return map->capacity ? map->capacity * 2 : capacity_for(map->length + 1);
+}
+
+} // namespace
+
+// ═══════════════════════════════════════════════════════════════════════
+// Hashing
+// ═══════════════════════════════════════════════════════════════════════
+
+uint64_t aria_hash_bytes(const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const uint64_t k1 = 0x87c37b91114253d5ull;
+    const uint64_t k2 = 0x4cf5ad432745937full;
+    uint64_t h = 0x9e3779b97f4a7c15ull ^ (size * k2);
+
+    auto mix = [&](uint64_t word) {
+        word *= k1;
+        word = (word << 31) | (word >> 33);
+        h ^= word * k2;
+        h = ((h << 27) | (h >> 37)) * 5 + 0x52dce729;
+    };
+
+    for (; size >= 8; bytes += 8, size -= 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        mix(word);
+    }
+    if (size) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes, size);
+        mix(word);
+    }
+
+    // Finalizer: every input bit affects every output bit
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// Hash Map
+// ═══════════════════════════════════════════════════════════════════════
+
+AriaResultPtr aria_hashmap_new(size_t key_size, size_t value_size, size_t initial_capacity,
+                               int type_id, AriaHashFn hash, AriaEqualsFn equals, void* context) {
+    if (key_size == 0) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_INVALID_ARG,
+            "Key size cannot be zero",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    LocalRoots roots;
+    AriaHashMap* map = (AriaHashMap*)aria_gc_alloc(sizeof(AriaHashMap), hashmap_type_id());
+    if (!map) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_OUT_OF_MEMORY,
+            "Failed to allocate hash map structure",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+    roots.add(&map);
+
+    map->key_size = key_size;
+    map->value_size = value_size;
+    map->type_id = type_id;
+    map->hash = hash;
+    map->equals = equals;
+    map->context = context;
+
+    if (!rehash(map, capacity_for(initial_capacity))) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_OUT_OF_MEMORY,
+            "Failed to allocate hash map table",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    return aria_result_ok_ptr(map);
+}
+
+size_t aria_hashmap_length(const AriaHashMap* map) {
+    if (!map) return 0;
+    return map->length;
+}
+
+void* aria_hashmap_get(const AriaHashMap* map, const void* key) {
+    if (!map || !key) return nullptr;
+
+    size_t index = find_index(map, key, hash_key(map, key));
+    return index == NPOS ? nullptr : entry_at(map, index) + map->key_size;
+}
+
+bool aria_hashmap_contains(const AriaHashMap* map, const void* key) {
+    return aria_hashmap_get(map, key) != nullptr;
+}
+
+AriaResultBool aria_hashmap_put(AriaHashMap* map, const void* key, const void* value) {
+    if (!map) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Hash map is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_bool(error);
+    }
+
+    if (!key) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Key is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_bool(error);
+    }
+
+    uint64_t hash = hash_key(map, key);
+    size_t index = find_index(map, key, hash);
+
+    if (index != NPOS) {
+        // Existing key: overwrite the value in place
+        if (value && map->value_size) {
+            char* entry = entry_at(map, index);
+            barrier_before_overwrite(map, entry);
+            std::memcpy(entry + map->key_size, value, map->value_size);
+            barrier_after_store(map, entry);
+        }
+        return aria_result_ok_bool(false);
+    }
+
+    index = find_insert_index(map, hash);
+    if (map->growth_left == 0 && map->ctrl[index] == CTRL_EMPTY) {
+        // Rehashing allocates, and a collection may move whatever key
+        // and value point into, so store from a copy
+        std::vector<char> scratch(entry_size(map), 0);
+        std::memcpy(scratch.data(), key, map->key_size);
+        if (value && map->value_size) {
+            std::memcpy(scratch.data() + map->key_size, value, map->value_size);
+        }
+
+        if (!rehash(map, grown_capacity(map))) {
+            AriaError* error = aria_error_new(
+                ARIA_ERR_OUT_OF_MEMORY,
+                "Failed to grow hash map",
+                __FILE__, __LINE__
+            );
+            return aria_result_err_bool(error);
+        }
+
+        index = find_insert_index(map, hash);
+        store_entry(map, index, hash, scratch.data(), scratch.data() + map->key_size);
+        return aria_result_ok_bool(true);
+    }
+
+    store_entry(map, index, hash, key, value);
+    return aria_result_ok_bool(true);
+}
+
+bool aria_hashmap_remove(AriaHashMap* map, const void* key) {
+    if (!map || !key) return false;
+
+    size_t index = find_index(map, key, hash_key(map, key));
+    if (index == NPOS) return false;
+
+    erase_at(map, index);
+    return true;
+}
+
+void aria_hashmap_clear(AriaHashMap* map) {
+    if (!map || map->capacity == 0) return;
+
+    for (size_t i = 0; i < map->capacity; ++i) {
+        if (is_full(map->ctrl[i])) {
+            barrier_before_overwrite(map, entry_at(map, i));
+        }
+    }
+    std::memset(map->ctrl, CTRL_EMPTY, map->capacity + GROUP_WIDTH);
+    std::memset(map->slots, 0, map->capacity * entry_size(map));
+    map->length = 0;
+    map->growth_left = max_load(map->capacity);
+}
+
+AriaResultVoid aria_hashmap_reserve(AriaHashMap* map, size_t count) {
+    if (!map) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Hash map is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_void(error);
+    }
+
+    if (count > map->length + map->growth_left && !rehash(map, capacity_for(count))) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_OUT_OF_MEMORY,
+            "Failed to grow hash map",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_void(error);
+    }
+
+    return aria_result_ok_void();
+}
+
+bool aria_hashmap_next(const AriaHashMap* map, size_t* cursor, void** out_key, void** out_value) {
+    if (!map || !cursor) return false;
+
+    for (size_t i = *cursor; i < map->capacity; ++i) {
+        if (is_full(map->ctrl[i])) {
+            char* entry = entry_at(map, i);
+            if (out_key) *out_key = entry;
+            if (out_value) *out_value = entry + map->key_size;
+            *cursor = i + 1;
+            return true;
+        }
+    }
+
+    *cursor = map->capacity;
+    return false;
+}
+
+void aria_hashmap_free(AriaHashMap* map) {
+    // No-op for GC-managed memory
+    (void)map;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// Hash Set
+// ═══════════════════════════════════════════════════════════════════════
+
+AriaResultPtr aria_hashset_new(size_t element_size, size_t initial_capacity, int type_id,
+                               AriaHashFn hash, AriaEqualsFn equals, void* context) {
+    return aria_hashmap_new(element_size, 0, initial_capacity, type_id, hash, equals, context);
+}
+
+AriaResultBool aria_hashset_insert(AriaHashSet* set, const void* element) {
+    return aria_hashmap_put(set, element, nullptr);
+}
+
+bool aria_hashset_contains(const AriaHashSet* set, const void* element) {
+    return aria_hashmap_contains(set, element);
+}
+
+bool aria_hashset_remove(AriaHashSet* set, const void* element) {
+    return aria_hashmap_remove(set, element);
+}
+
+size_t aria_hashset_length(const AriaHashSet* set) {
+    return aria_hashmap_length(set);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// Array Deduplication
+// ═══════════════════════════════════════════════════════════════════════
+
+namespace {
+
+/**
+ * The set used by aria_array_unique_by holds element indices, so it
+ * stays a leaf object and elements are never copied twice. Its hash and
+ * equality callbacks look the elements up in the source array.
+ */
+struct UniqueContext {
+    AriaArray* array;  // Rooted: the collector may move it
+    AriaHashFn hash;
+    AriaEqualsFn equals;
+    void* context;
+};
+
+const void* unique_element(const UniqueContext* ctx, const void* index) {
+    size_t i;
+    std::memcpy(&i, index, sizeof(i));
+    return aria_array_get_unchecked(ctx->array, i);
+}
+
+uint64_t unique_hash(const void* index, size_t, void* context) {
+    const UniqueContext* ctx = static_cast<const UniqueContext*>(context);
+    const void* element = unique_element(ctx, index);
+    return ctx->hash ? ctx->hash(element, ctx->array->element_size, ctx->context)
+                     : aria_hash_bytes(element, ctx->array->element_size);
+}
+
+bool unique_equals(const void* a, const void* b, size_t, void* context) {
+    const UniqueContext* ctx = static_cast<const UniqueContext*>(context);
+    const void* x = unique_element(ctx, a);
+    const void* y = unique_element(ctx, b);
+    return ctx->equals ? ctx->equals(x, y, ctx->array->element_size, ctx->context)
+                       : std::memcmp(x, y, ctx->array->element_size) == 0;
+}
+
+} // namespace
+
+AriaResultPtr aria_array_unique_by(const AriaArray* array, AriaHashFn hash,
+                                   AriaEqualsFn equals, void* context) {
+    if (!array) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Array is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    UniqueContext ctx = { const_cast<AriaArray*>(array), hash, equals, context };
+    LocalRoots roots;
+    roots.add(&ctx.array);
+
+    AriaResultPtr result = aria_array_new(array->element_size, array->capacity, array->type_id);
+    if (result.is_error) return result;
+    AriaArray* unique = (AriaArray*)result.value;
+    roots.add(&unique);
+
+    // Sized up front: no rehash while elements are being inserted
+    result = aria_hashset_new(sizeof(size_t), ctx.array->length, 0,
+                              unique_hash, unique_equals, &ctx);
+    if (result.is_error) return result;
+    AriaHashSet* seen = (AriaHashSet*)result.value;
+    roots.add(&seen);
+
+    for (size_t i = 0; i < ctx.array->length; i++) {
+        AriaResultBool inserted = aria_hashset_insert(seen, &i);
+        if (inserted.is_error) {
+            return aria_result_err_ptr((AriaError*)inserted.error);
+        }
+        if (!inserted.value) continue;
+
+        AriaResultVoid push_result = aria_array_push(unique, aria_array_get_unchecked(ctx.array, i));
+        if (push_result.is_error) {
+            return aria_result_err_ptr((AriaError*)push_result.error);
+        }
+    }
+
+    return aria_result_ok_ptr(unique);
+}
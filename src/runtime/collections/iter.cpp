@@ -0,0 +1,296 @@
+/**
+ * Phase 6.2 Standard Library - Lazy Iterators
+ *
+ * An AriaIter records a source array and a chain of filter/transform
+ * stages; nothing runs until a terminal operation. The terminal then
+ * walks the source once and pushes every element through all stages,
+ * so chained operations cost one pass and no intermediate arrays.
+ *
+ * Each transform stage writes into its own scratch slot (malloc'd
+ * once per terminal call). The collect sink reserves room for the next
+ * element before the element enters the stages, so no GC allocation
+ * happens between the last mapper returning and its output being
+ * copied into the result: references produced by the last stage are
+ * never held in untraced memory across a collection.
+ */
+
+#include "collections_internal.h"
+#include "runtime/gc.h"
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+using aria::runtime::LocalRoots;
+using aria::runtime::barrier_after_store_elements;
+
+namespace {
+
+void iter_fail(AriaIter* iter, int code, const char* message) {
+    if (iter->error_code == 0) {
+        iter->error_code = code;
+        iter->error_message = message;
+    }
+}
+
+AriaIterStage* iter_add_stage(AriaIter* iter) {
+    if (iter->num_stages == ARIA_ITER_MAX_STAGES) {
+        iter_fail(iter, ARIA_ERR_OVERFLOW, "Too many iterator stages");
+        return nullptr;
+    }
+    AriaIterStage* stage = &iter->stages[iter->num_stages++];
+    std::memset(stage, 0, sizeof(*stage));
+    return stage;
+}
+
+// Error for an iterator that cannot run, or NULL
+AriaError* iter_check(const AriaIter* iter) {
+    if (!iter) {
+        return aria_error_new(ARIA_ERR_NULL_PTR, "Iterator is NULL", __FILE__, __LINE__);
+    }
+    if (iter->error_code != 0) {
+        return aria_error_new(iter->error_code, iter->error_message, __FILE__, __LINE__);
+    }
+    if (!iter->source) {
+        return aria_error_new(ARIA_ERR_NULL_PTR, "Array is NULL", __FILE__, __LINE__);
+    }
+    return nullptr;
+}
+
+/**
+ * Per-call state of a terminal operation: scratch slots for transform
+ * outputs and the number of elements that reached each stage
+ */
+class IterRun {
+public:
+    explicit IterRun(AriaIter* iter) : iter(iter), counts(iter->num_stages, 0) {
+        size_t total = 0;
+        for (size_t k = 0; k < iter->num_stages; k++) {
+            offsets.push_back(total);
+            if (iter->stages[k].kind == ARIA_ITER_STAGE_TRANSFORM) {
+                total += (iter->stages[k].element_size + 15) & ~size_t(15);
+            }
+        }
+        scratch = total ? std::malloc(total) : nullptr;
+        ok = (total == 0 || scratch != nullptr);
+    }
+
+    ~IterRun() { std::free(scratch); }
+
+    IterRun(const IterRun&) = delete;
+    IterRun& operator=(const IterRun&) = delete;
+
+    bool ok;
+
+    /**
+     * Push source element i through every stage. Returns the element
+     * leaving the last stage, or NULL if a filter dropped it.
+     */
+    const void* run(size_t i) {
+        const void* element = aria_array_get_unchecked(iter->source, i);
+        for (size_t k = 0; k < iter->num_stages; k++) {
+            const AriaIterStage& stage = iter->stages[k];
+            size_t index = counts[k]++;
+            if (stage.kind == ARIA_ITER_STAGE_FILTER) {
+                if (!stage.predicate(element, index, stage.context)) {
+                    return nullptr;
+                }
+            } else {
+                void* out = static_cast<char*>(scratch) + offsets[k];
+                stage.mapper(element, index, out, stage.context);
+                element = out;
+            }
+        }
+        return element;
+    }
+
+private:
+    AriaIter* iter;
+    std::vector<size_t> counts;
+    std::vector<size_t> offsets;
+    void* scratch;
+};
+
+// Make room for one more element without an allocation after it is produced
+bool reserve_one(AriaArray* array) {
+    if (array->length < array->capacity) return true;
+
+    size_t new_capacity = array->capacity + array->capacity / 2;
+    if (new_capacity <= array->capacity) new_capacity = array->capacity + 1;
+
+    void* new_data = aria_gc_alloc(array->element_size * new_capacity, array->type_id);
+    if (!new_data) return false;
+    std::memcpy(new_data, array->data, array->element_size * array->length);
+    array->data = new_data;
+    aria_gc_write_barrier(array, new_data);
+    array->capacity = new_capacity;
+    return true;
+}
+
+// Append into reserved capacity; card-marks references in the new slot
+void append_reserved(AriaArray* array, const void* element) {
+    char* slot = static_cast<char*>(array->data) + array->length * array->element_size;
+    std::memcpy(slot, element, array->element_size);
+    array->length++;
+    barrier_after_store_elements(array, array->length - 1, array->length);
+}
+
+} // namespace
+
+void aria_iter_init(AriaIter* iter, const AriaArray* array) {
+    if (!iter) return;
+    std::memset(iter, 0, sizeof(*iter));
+    iter->source = const_cast<AriaArray*>(array);
+    if (array) {
+        iter->element_size = array->element_size;
+        iter->type_id = array->type_id;
+    }
+}
+
+void aria_iter_filter(AriaIter* iter, AriaPredicateFn predicate, void* context) {
+    if (!iter) return;
+    if (!predicate) {
+        iter_fail(iter, ARIA_ERR_NULL_PTR, "Predicate function is NULL");
+        return;
+    }
+
+    AriaIterStage* stage = iter_add_stage(iter);
+    if (!stage) return;
+    stage->kind = ARIA_ITER_STAGE_FILTER;
+    stage->predicate = predicate;
+    stage->element_size = iter->element_size;
+    stage->type_id = iter->type_id;
+    stage->context = context;
+}
+
+void aria_iter_transform(AriaIter* iter, AriaMapperFn mapper,
+                         size_t output_element_size, int output_type_id, void* context) {
+    if (!iter) return;
+    if (!mapper) {
+        iter_fail(iter, ARIA_ERR_NULL_PTR, "Mapper function is NULL");
+        return;
+    }
+    if (output_element_size == 0) {
+        iter_fail(iter, ARIA_ERR_INVALID_ARG, "Element size cannot be zero");
+        return;
+    }
+
+    AriaIterStage* stage = iter_add_stage(iter);
+    if (!stage) return;
+    stage->kind = ARIA_ITER_STAGE_TRANSFORM;
+    stage->mapper = mapper;
+    stage->element_size = output_element_size;
+    stage->type_id = output_type_id;
+    stage->context = context;
+
+    iter->element_size = output_element_size;
+    iter->type_id = output_type_id;
+}
+
+AriaResultPtr aria_iter_collect(AriaIter* iter) {
+    if (AriaError* error = iter_check(iter)) {
+        return aria_result_err_ptr(error);
+    }
+
+    LocalRoots roots;
+    roots.add(&iter->source);
+
+    // Without filters the output length is known up front
+    bool has_filter = false;
+    for (size_t k = 0; k < iter->num_stages; k++) {
+        has_filter = has_filter || iter->stages[k].kind == ARIA_ITER_STAGE_FILTER;
+    }
+    size_t capacity = has_filter ? iter->source->capacity : iter->source->length;
+
+    AriaResultPtr result = aria_array_new(iter->element_size, capacity, iter->type_id);
+    if (result.is_error) return result;
+    AriaArray* collected = (AriaArray*)result.value;
+    roots.add(&collected);
+
+    IterRun run(iter);
+    if (!run.ok) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_OUT_OF_MEMORY,
+            "Failed to allocate iterator scratch",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    for (size_t i = 0; i < iter->source->length; i++) {
+        if (!reserve_one(collected)) {
+            AriaError* error = aria_error_new(
+                ARIA_ERR_OUT_OF_MEMORY,
+                "Failed to grow array",
+                __FILE__, __LINE__
+            );
+            return aria_result_err_ptr(error);
+        }
+        const void* element = run.run(i);
+        if (element) {
+            append_reserved(collected, element);
+        }
+    }
+
+    return aria_result_ok_ptr(collected);
+}
+
+AriaResultPtr aria_iter_reduce(AriaIter* iter, AriaReducerFn reducer,
+                               const void* initial, size_t accumulator_size, void* context) {
+    if (AriaError* error = iter_check(iter)) {
+        return aria_result_err_ptr(error);
+    }
+
+    if (!reducer) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Reducer function is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    if (!initial) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Initial value is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    LocalRoots roots;
+    roots.add(&iter->source);
+
+    // Allocate accumulator on GC heap
+    void* accumulator = aria_gc_alloc(accumulator_size, 0);
+    if (!accumulator) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_OUT_OF_MEMORY,
+            "Failed to allocate accumulator",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+    roots.add(&accumulator);
+    std::memcpy(accumulator, initial, accumulator_size);
+
+    IterRun run(iter);
+    if (!run.ok) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_OUT_OF_MEMORY,
+            "Failed to allocate iterator scratch",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    size_t index = 0;
+    for (size_t i = 0; i < iter->source->length; i++) {
+        const void* element = run.run(i);
+        if (element) {
+            reducer(accumulator, element, index++, context);
+        }
+    }
+
+    return aria_result_ok_ptr(accumulator);
+}
@@ -0,0 +1,233 @@
+/**
+ * Phase 6.2 Standard Library - Parallel Array Operations
+ *
+ * Data-parallel transform, filter and reduce on the collection worker
+ * pool. Arrays are cut into fixed grain-size chunks (never by thread
+ * count), so results do not depend on how many threads ran them.
+ *
+ * GC integration: the calling mutator does all GC allocation, before or
+ * after the parallel phases; while chunks run it sits in parallel_for
+ * without reaching a safepoint, so no collection can move the arrays
+ * the helpers are reading and writing.
+ */
+
+#include "collections_internal.h"
+#include "runtime/gc.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+using aria::runtime::CollectionWorkerPool;
+using aria::runtime::LocalRoots;
+using aria::runtime::barrier_after_store_elements;
+
+namespace {
+
+// Chunk c covers [c * grain, min((c + 1) * grain, length))
+struct Chunking {
+    size_t length;
+    size_t grain;
+
+    size_t count() const { return (length + grain - 1) / grain; }
+    size_t begin(size_t chunk) const { return chunk * grain; }
+    size_t end(size_t chunk) const { return std::min(length, (chunk + 1) * grain); }
+};
+
+Chunking chunking(size_t length, size_t grain_size) {
+    return Chunking{length, grain_size ? grain_size : ARIA_PAR_DEFAULT_GRAIN};
+}
+
+} // namespace
+
+AriaResultPtr aria_array_par_transform(const AriaArray* array, AriaMapperFn mapper,
+                                       size_t output_element_size, int output_type_id,
+                                       size_t grain_size, void* context) {
+    if (!array) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Array is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    if (!mapper) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Mapper function is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    AriaArray* source = const_cast<AriaArray*>(array);
+    LocalRoots roots;
+    roots.add(&source);
+
+    AriaResultPtr result = aria_array_new(output_element_size, source->length, output_type_id);
+    if (result.is_error) return result;
+    AriaArray* transformed = (AriaArray*)result.value;
+    roots.add(&transformed);
+    transformed->length = source->length;
+
+    Chunking chunks = chunking(source->length, grain_size);
+    CollectionWorkerPool::shared().parallel_for(chunks.count(), [&](size_t chunk) {
+        for (size_t i = chunks.begin(chunk); i < chunks.end(chunk); i++) {
+            mapper(aria_array_get_unchecked(source, i), i,
+                   aria_array_get_unchecked(transformed, i), context);
+        }
+    });
+
+    barrier_after_store_elements(transformed, 0, transformed->length);
+    return aria_result_ok_ptr(transformed);
+}
+
+AriaResultPtr aria_array_par_filter(const AriaArray* array, AriaPredicateFn predicate,
+                                    size_t grain_size, void* context) {
+    if (!array) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Array is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    if (!predicate) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Predicate function is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    AriaArray* source = const_cast<AriaArray*>(array);
+    LocalRoots roots;
+    roots.add(&source);
+
+    Chunking chunks = chunking(source->length, grain_size);
+    CollectionWorkerPool& pool = CollectionWorkerPool::shared();
+
+    // Pass 1: evaluate the predicate once per element, count per chunk
+    std::vector<uint8_t> keep(source->length);
+    std::vector<size_t> offsets(chunks.count() + 1, 0);
+    pool.parallel_for(chunks.count(), [&](size_t chunk) {
+        size_t kept = 0;
+        for (size_t i = chunks.begin(chunk); i < chunks.end(chunk); i++) {
+            keep[i] = predicate(aria_array_get_unchecked(source, i), i, context);
+            kept += keep[i];
+        }
+        offsets[chunk + 1] = kept;
+    });
+
+    // Exclusive prefix sum: chunk c writes from offsets[c]
+    for (size_t chunk = 0; chunk < chunks.count(); chunk++) {
+        offsets[chunk + 1] += offsets[chunk];
+    }
+    size_t total = offsets[chunks.count()];
+
+    AriaResultPtr result = aria_array_new(source->element_size, total, source->type_id);
+    if (result.is_error) return result;
+    AriaArray* filtered = (AriaArray*)result.value;
+    roots.add(&filtered);
+    filtered->length = total;
+
+    // Pass 2: compact the survivors in order
+    size_t element_size = source->element_size;
+    pool.parallel_for(chunks.count(), [&](size_t chunk) {
+        char* out = static_cast<char*>(filtered->data) + offsets[chunk] * element_size;
+        for (size_t i = chunks.begin(chunk); i < chunks.end(chunk); i++) {
+            if (keep[i]) {
+                std::memcpy(out, aria_array_get_unchecked(source, i), element_size);
+                out += element_size;
+            }
+        }
+    });
+
+    barrier_after_store_elements(filtered, 0, filtered->length);
+    return aria_result_ok_ptr(filtered);
+}
+
+AriaResultPtr aria_array_par_reduce(const AriaArray* array, AriaReducerFn reducer,
+                                    AriaCombinerFn combiner, const void* identity,
+                                    size_t accumulator_size, size_t grain_size, void* context) {
+    if (!array) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Array is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    if (!reducer || !combiner) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Reducer or combiner function is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    if (!identity) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Identity value is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    AriaArray* source = const_cast<AriaArray*>(array);
+    LocalRoots roots;
+    roots.add(&source);
+
+    // Allocate accumulator on GC heap
+    void* accumulator = aria_gc_alloc(accumulator_size, 0);
+    if (!accumulator) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_OUT_OF_MEMORY,
+            "Failed to allocate accumulator",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+    roots.add(&accumulator);
+    std::memcpy(accumulator, identity, accumulator_size);
+
+    Chunking chunks = chunking(source->length, grain_size);
+    if (chunks.count() == 0) {
+        return aria_result_ok_ptr(accumulator);
+    }
+
+    // One partial per chunk, each starting from the identity (16-byte
+    // aligned, like the accumulator)
+    size_t stride = (accumulator_size + 15) & ~size_t(15);
+    char* partials = static_cast<char*>(std::malloc(chunks.count() * stride));
+    if (!partials) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_OUT_OF_MEMORY,
+            "Failed to allocate partial results",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+
+    CollectionWorkerPool::shared().parallel_for(chunks.count(), [&](size_t chunk) {
+        char* partial = partials + chunk * stride;
+        std::memcpy(partial, identity, accumulator_size);
+        for (size_t i = chunks.begin(chunk); i < chunks.end(chunk); i++) {
+            reducer(partial, aria_array_get_unchecked(source, i), i, context);
+        }
+    });
+
+    // Combine in chunk order (the accumulator is a leaf: no barriers)
+    for (size_t chunk = 0; chunk < chunks.count(); chunk++) {
+        combiner(accumulator, partials + chunk * stride, context);
+    }
+    std::free(partials);
+
+    return aria_result_ok_ptr(accumulator);
+}
@@ -0,0 +1,486 @@
+/**
+ * Phase 6.2 Standard Library - Array Sorting
+ *
+ * Pattern-defeating quicksort (pdqsort): median-of-3 (ninther for large
+ * ranges) quicksort with insertion sort for small ranges, a linear pass
+ * for already-partitioned input, partition_left for runs of equal
+ * elements, and a heapsort fallback that bounds the worst case to
+ * O(n log n). All state lives in the sorter, so concurrent sorts with
+ * different comparators are safe. Element moves are specialized for 4,
+ * 8 and 16 byte elements.
+ *
+ * The parallel variant sorts chunks on the collection worker pool and
+ * merges them pairwise, also in parallel.
+ */
+
+#include "collections_internal.h"
+#include "runtime/gc.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+namespace aria {
+namespace runtime {
+
+namespace {
+
+// Ranges shorter than this are insertion sorted
+constexpr size_t INSERTION_SORT_THRESHOLD = 24;
+
+// Ranges longer than this use the ninther for the pivot
+constexpr size_t NINTHER_THRESHOLD = 128;
+
+// Moves a partial insertion sort may make before giving up
+constexpr size_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+
+// Element size known at compile time (memcpy becomes a single move)
+template <size_t N>
+struct FixedSize {
+    size_t get() const { return N; }
+};
+
+struct DynamicSize {
+    size_t value;
+    size_t get() const { return value; }
+};
+
+template <typename Size>
+class PdqSorter {
+public:
+    PdqSorter(Size size, AriaComparatorFn comparator, void* context, char* scratch)
+        : size(size), comparator(comparator), context(context),
+          tmp(scratch), pivot(scratch + size.get()) {}
+
+    void sort(char* begin, size_t count) {
+        if (count < 2) return;
+        int bad_allowed = 0;
+        for (size_t n = count; n > 1; n >>= 1) {
+            bad_allowed++;
+        }
+        sort_loop(begin, at(begin, count), bad_allowed, true);
+    }
+
+private:
+    Size size;
+    AriaComparatorFn comparator;
+    void* context;
+    char* tmp;    // Held element during insertion sort and swaps
+    char* pivot;  // Pivot copy during partitioning
+
+    size_t stride() const { return size.get(); }
+    char* at(char* p, ptrdiff_t k) const { return p + k * static_cast<ptrdiff_t>(stride()); }
+    size_t distance(const char* a, const char* b) const { return (b - a) / stride(); }
+
+    bool less(const char* a, const char* b) const { return comparator(a, b, context) < 0; }
+    void copy(char* dst, const char* src) const { std::memcpy(dst, src, stride()); }
+
+    void swap(char* a, char* b) const {
+        copy(tmp, a);
+        copy(a, b);
+        copy(b, tmp);
+    }
+
+    void sort2(char* a, char* b) const {
+        if (less(b, a)) swap(a, b);
+    }
+
+    void sort3(char* a, char* b, char* c) const {
+        sort2(a, b);
+        sort2(b, c);
+        sort2(a, b);
+    }
+
+    void insertion_sort(char* begin, char* end) const {
+        if (begin == end) return;
+        for (char* cur = at(begin, 1); cur != end; cur = at(cur, 1)) {
+            char* sift = cur;
+            char* sift_1 = at(cur, -1);
+            if (less(sift, sift_1)) {
+                copy(tmp, sift);
+                do {
+                    copy(sift, sift_1);
+                    sift = sift_1;
+                } while (sift != begin && less(tmp, sift_1 = at(sift_1, -1)));
+                copy(sift, tmp);
+            }
+        }
+    }
+
+    // Requires an element before begin that is not greater than any in range
+    void unguarded_insertion_sort(char* begin, char* end) const {
+        if (begin == end) return;
+        for (char* cur = at(begin, 1); cur != end; cur = at(cur, 1)) {
+            char* sift = cur;
+            char* sift_1 = at(cur, -1);
+            if (less(sift, sift_1)) {
+                copy(tmp, sift);
+                do {
+                    copy(sift, sift_1);
+                    sift = sift_1;
+                } while (less(tmp, sift_1 = at(sift_1, -1)));
+                copy(sift, tmp);
+            }
+        }
+    }
+
+    // Insertion sort that gives up after a few moves; true if sorted
+    bool partial_insertion_sort(char* begin, char* end) const {
+        if (begin == end) return true;
+        size_t moves = 0;
+        for (char* cur = at(begin, 1); cur != end; cur = at(cur, 1)) {
+            if (moves > PARTIAL_INSERTION_SORT_LIMIT) return false;
+
+            char* sift = cur;
+            char* sift_1 = at(cur, -1);
+            if (less(sift, sift_1)) {
+                copy(tmp, sift);
+                do {
+                    copy(sift, sift_1);
+                    sift = sift_1;
+                } while (sift != begin && less(tmp, sift_1 = at(sift_1, -1)));
+                copy(sift, tmp);
+                moves += distance(sift, cur);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Partition around *begin: elements less than the pivot go left,
+     * the rest right. Returns the pivot's final position; sets
+     * already_partitioned when no element had to be swapped.
+     */
+    char* partition_right(char* begin, char* end, bool& already_partitioned) const {
+        copy(pivot, begin);
+        char* first = begin;
+        char* last = end;
+
+        // The median-of-3 guarantees an element >= pivot on the right
+        while (less(first = at(first, 1), pivot)) {}
+
+        // No guard on the left if nothing was skipped
+        if (at(first, -1) == begin) {
+            while (first < last && !less(last = at(last, -1), pivot)) {}
+        } else {
+            while (!less(last = at(last, -1), pivot)) {}
+        }
+
+        already_partitioned = first >= last;
+
+        while (first < last) {
+            swap(first, last);
+            while (less(first = at(first, 1), pivot)) {}
+            while (!less(last = at(last, -1), pivot)) {}
+        }
+
+        char* pivot_pos = at(first, -1);
+        copy(begin, pivot_pos);
+        copy(pivot_pos, pivot);
+        return pivot_pos;
+    }
+
+    /**
+     * Partition around *begin with elements equal to the pivot going
+     * left; used when the pivot equals the element before the range,
+     * so the left part is all equal and needs no further sorting
+     */
+    char* partition_left(char* begin, char* end) const {
+        copy(pivot, begin);
+        char* first = begin;
+        char* last = end;
+
+        while (less(pivot, last = at(last, -1))) {}
+
+        if (at(last, 1) == end) {
+            while (first < last && !less(pivot, first = at(first, 1))) {}
+        } else {
+            while (!less(pivot, first = at(first, 1))) {}
+        }
+
+        while (first < last) {
+            swap(first, last);
+            while (less(pivot, last = at(last, -1))) {}
+            while (!less(pivot, first = at(first, 1))) {}
+        }
+
+        copy(begin, last);
+        copy(last, pivot);
+        return last;
+    }
+
+    void sift_down(char* begin, size_t count, size_t root) const {
+        for (;;) {
+            size_t child = 2 * root + 1;
+            if (child >= count) return;
+            if (child + 1 < count && less(at(begin, child), at(begin, child + 1))) {
+                child++;
+            }
+            if (!less(at(begin, root), at(begin, child))) return;
+            swap(at(begin, root), at(begin, child));
+            root = child;
+        }
+    }
+
+    void heap_sort(char* begin, char* end) const {
+        size_t count = distance(begin, end);
+        for (size_t i = count / 2; i-- > 0; ) {
+            sift_down(begin, count, i);
+        }
+        for (size_t n = count; n-- > 1; ) {
+            swap(begin, at(begin, n));
+            sift_down(begin, n, 0);
+        }
+    }
+
+    void sort_loop(char* begin, char* end, int bad_allowed, bool leftmost) const {
+        for (;;) {
+            size_t count = distance(begin, end);
+
+            if (count < INSERTION_SORT_THRESHOLD) {
+                if (leftmost) {
+                    insertion_sort(begin, end);
+                } else {
+                    unguarded_insertion_sort(begin, end);
+                }
+                return;
+            }
+
+            // Move the pivot candidate to begin
+            size_t half = count / 2;
+            if (count > NINTHER_THRESHOLD) {
+                sort3(begin, at(begin, half), at(end, -1));
+                sort3(at(begin, 1), at(begin, half - 1), at(end, -2));
+                sort3(at(begin, 2), at(begin, half + 1), at(end, -3));
+                sort3(at(begin, half - 1), at(begin, half), at(begin, half + 1));
+                swap(begin, at(begin, half));
+            } else {
+                sort3(at(begin, half), begin, at(end, -1));
+            }
+
+            // Pivot equal to the predecessor: everything <= pivot is final
+            if (!leftmost && !less(at(begin, -1), begin)) {
+                begin = at(partition_left(begin, end), 1);
+                continue;
+            }
+
+            bool already_partitioned;
+            char* pivot_pos = partition_right(begin, end, already_partitioned);
+
+            size_t left_count = distance(begin, pivot_pos);
+            size_t right_count = distance(pivot_pos, end) - 1;
+            bool unbalanced = left_count < count / 8 || right_count < count / 8;
+
+            if (unbalanced) {
+                // Too many bad pivots: fall back to the guaranteed bound
+                if (--bad_allowed == 0) {
+                    heap_sort(begin, end);
+                    return;
+                }
+
+                // Break up patterns that may be causing the bad pivots
+                if (left_count >= INSERTION_SORT_THRESHOLD) {
+                    size_t q = left_count / 4;
+                    swap(begin, at(begin, q));
+                    swap(at(pivot_pos, -1), at(pivot_pos, -static_cast<ptrdiff_t>(q)));
+                    if (left_count > NINTHER_THRESHOLD) {
+                        swap(at(begin, 1), at(begin, q + 1));
+                        swap(at(begin, 2), at(begin, q + 2));
+                        swap(at(pivot_pos, -2), at(pivot_pos, -static_cast<ptrdiff_t>(q + 1)));
+                        swap(at(pivot_pos, -3), at(pivot_pos, -static_cast<ptrdiff_t>(q + 2)));
+                    }
+                }
+                if (right_count >= INSERTION_SORT_THRESHOLD) {
+                    size_t q = right_count / 4;
+                    swap(at(pivot_pos, 1), at(pivot_pos, q + 1));
+                    swap(at(end, -1), at(end, -static_cast<ptrdiff_t>(q)));
+                    if (right_count > NINTHER_THRESHOLD) {
+                        swap(at(pivot_pos, 2), at(pivot_pos, q + 2));
+                        swap(at(pivot_pos, 3), at(pivot_pos, q + 3));
+                        swap(at(end, -2), at(end, -static_cast<ptrdiff_t>(q + 1)));
+                        swap(at(end, -3), at(end, -static_cast<ptrdiff_t>(q + 2)));
+                    }
+                }
+            } else if (already_partitioned &&
+                       partial_insertion_sort(begin, pivot_pos) &&
+                       partial_insertion_sort(at(pivot_pos, 1), end)) {
+                // Nearly sorted input finishes in linear time
+                return;
+            }
+
+            // Recurse into the left part, loop on the right
+            sort_loop(begin, pivot_pos, bad_allowed, leftmost);
+            begin = at(pivot_pos, 1);
+            leftmost = false;
+        }
+    }
+};
+
+template <size_t N>
+void sort_fixed(char* data, size_t count, AriaComparatorFn comparator, void* context) {
+    alignas(16) char scratch[2 * N];
+    PdqSorter<FixedSize<N>>(FixedSize<N>(), comparator, context, scratch).sort(data, count);
+}
+
+/**
+ * Merge the sorted runs [a, a + a_count) and [b, b + b_count) into out.
+ * Ties take the left run first.
+ */
+void merge_runs(const char* a, size_t a_count, const char* b, size_t b_count, char* out,
+                size_t element_size, AriaComparatorFn comparator, void* context) {
+    const char* a_end = a + a_count * element_size;
+    const char* b_end = b + b_count * element_size;
+
+    while (a != a_end && b != b_end) {
+        if (comparator(b, a, context) < 0) {
+            std::memcpy(out, b, element_size);
+            b += element_size;
+        } else {
+            std::memcpy(out, a, element_size);
+            a += element_size;
+        }
+        out += element_size;
+    }
+    std::memcpy(out, a, a_end - a);
+    out += a_end - a;
+    std::memcpy(out, b, b_end - b);
+}
+
+} // namespace
+
+void sort_elements(void* data, size_t count, size_t element_size,
+                   AriaComparatorFn comparator, void* context) {
+    char* begin = static_cast<char*>(data);
+    switch (element_size) {
+        case 4:
+            sort_fixed<4>(begin, count, comparator, context);
+            break;
+        case 8:
+            sort_fixed<8>(begin, count, comparator, context);
+            break;
+        case 16:
+            sort_fixed<16>(begin, count, comparator, context);
+            break;
+        default: {
+            std::vector<char> scratch(2 * element_size);
+            PdqSorter<DynamicSize>(DynamicSize{element_size}, comparator, context, scratch.data())
+                .sort(begin, count);
+            break;
+        }
+    }
+}
+
+} // namespace runtime
+} // namespace aria
+
+using aria::runtime::CollectionWorkerPool;
+using aria::runtime::barrier_after_store_elements;
+using aria::runtime::barrier_before_overwrite_elements;
+using aria::runtime::sort_elements;
+using aria::runtime::merge_runs;
+
+// Smallest chunk worth handing to another thread
+#define ARIA_SORT_PARALLEL_MIN_CHUNK 8192
+
+AriaResultVoid aria_array_sort(AriaArray* array, AriaComparatorFn comparator, void* context) {
+    if (!array) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Array is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_void(error);
+    }
+
+    if (!comparator) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_NULL_PTR,
+            "Comparator function is NULL",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_void(error);
+    }
+
+    if (array->length <= 1) {
+        return aria_result_ok_void();
+    }
+
+    // Sorting moves every reference to another slot: a concurrent mark
+    // must still see each one, and old buffers need their cards redone
+    barrier_before_overwrite_elements(array, 0, array->length);
+    sort_elements(array->data, array->length, array->element_size, comparator, context);
+    barrier_after_store_elements(array, 0, array->length);
+    return aria_result_ok_void();
+}
+
+AriaResultVoid aria_array_sort_parallel(AriaArray* array, AriaComparatorFn comparator, void* context) {
+    if (!array || !comparator) {
+        return aria_array_sort(array, comparator, context);
+    }
+
+    CollectionWorkerPool& pool = CollectionWorkerPool::shared();
+    size_t length = array->length;
+    size_t chunks = std::min(pool.num_workers(), length / ARIA_SORT_PARALLEL_MIN_CHUNK);
+    if (chunks < 2) {
+        return aria_array_sort(array, comparator, context);
+    }
+
+    size_t element_size = array->element_size;
+    char* data = static_cast<char*>(array->data);
+    barrier_before_overwrite_elements(array, 0, length);  // See aria_array_sort
+
+    // Run boundaries: run i is [bounds[i], bounds[i + 1])
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; i++) {
+        bounds[i] = length * i / chunks;
+    }
+
+    pool.parallel_for(chunks, [&](size_t i) {
+        sort_elements(data + bounds[i] * element_size, bounds[i + 1] - bounds[i],
+                      element_size, comparator, context);
+    });
+
+    // Merge adjacent runs pairwise, ping-ponging with a scratch copy.
+    // Nothing here allocates from the GC heap, so the array cannot move.
+    char* scratch = static_cast<char*>(std::malloc(length * element_size));
+    if (!scratch) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_OUT_OF_MEMORY,
+            "Failed to allocate sort buffer",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_void(error);
+    }
+
+    char* src = data;
+    char* dst = scratch;
+    while (bounds.size() > 2) {
+        size_t runs = bounds.size() - 1;
+        pool.parallel_for((runs + 1) / 2, [&](size_t pair) {
+            size_t lo = bounds[2 * pair];
+            size_t mid = bounds[std::min(2 * pair + 1, runs)];
+            size_t hi = bounds[std::min(2 * pair + 2, runs)];
+            merge_runs(src + lo * element_size, mid - lo,
+                       src + mid * element_size, hi - mid,
+                       dst + lo * element_size, element_size, comparator, context);
+        });
+
+        std::vector<size_t> merged;
+        for (size_t i = 0; i < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+        }
+        if (merged.back() != length) {
+            merged.push_back(length);
+        }
+        bounds.swap(merged);
+        std::swap(src, dst);
+    }
+
+    if (src != data) {
+        std::memcpy(data, src, length * element_size);
+    }
+    std::free(scratch);
+    barrier_after_store_elements(array, 0, length);
+
+    return aria_result_ok_void();
+}
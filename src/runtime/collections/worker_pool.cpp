@@ -0,0 +1,99 @@
+/**
+ * Phase 6.2 Standard Library - Collection Worker Pool
+ *
+ * Shared helper threads for the parallel collection operations.
+ */
+
+#include "collections_internal.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace aria {
+namespace runtime {
+
+CollectionWorkerPool& CollectionWorkerPool::shared() {
+    // Never destroyed: helpers may still be parked when the process exits
+    static CollectionWorkerPool* pool = [] {
+        size_t num_workers = std::max(std::thread::hardware_concurrency(), 1u);
+        if (const char* text = std::getenv("ARIA_COLLECTION_THREADS")) {
+            long value = std::strtol(text, nullptr, 10);
+            if (value > 0) num_workers = std::min<size_t>(value, 256);
+        }
+        return new CollectionWorkerPool(num_workers);
+    }();
+    return *pool;
+}
+
+CollectionWorkerPool::CollectionWorkerPool(size_t num_workers) {
+    helpers.reserve(num_workers - 1);
+    for (size_t i = 1; i < num_workers; ++i) {
+        helpers.emplace_back(&CollectionWorkerPool::helper_loop, this);
+        helpers.back().detach();
+    }
+}
+
+void CollectionWorkerPool::parallel_for(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+    if (count == 1 || helpers.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    Job job;
+    job.task = &task;
+    job.count = count;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(&job);
+    }
+    work_cv.notify_all();
+
+    size_t completed = 0;
+    for (size_t i; (i = job.next.fetch_add(1, std::memory_order_relaxed)) < count; ) {
+        task(i);
+        completed++;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = std::find(jobs.begin(), jobs.end(), &job);
+    if (it != jobs.end()) {
+        jobs.erase(it);
+    }
+    job.finished += completed;
+    job.done_cv.wait(lock, [&] { return job.finished == count; });
+}
+
+void CollectionWorkerPool::helper_loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    for (;;) {
+        work_cv.wait(lock, [this] { return !jobs.empty(); });
+
+        // Claim the first index under the lock: the job cannot complete
+        // (and leave its owner's stack) while a claimed index is unreported
+        Job* job = jobs.front();
+        size_t i = job->next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= job->count) {
+            jobs.pop_front();  // Exhausted; the owner is finishing it
+            continue;
+        }
+
+        lock.unlock();
+        size_t completed = 0;
+        do {
+            (*job->task)(i);
+            completed++;
+        } while ((i = job->next.fetch_add(1, std::memory_order_relaxed)) < job->count);
+        lock.lock();
+
+        job->finished += completed;
+        if (job->finished == job->count) {
+            job->done_cv.notify_one();
+        }
+    }
+}
+
+} // namespace runtime
+} // namespace aria
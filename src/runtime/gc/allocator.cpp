@@ -6,8 +6,10 @@
  * and the Nursery allocator infrastructure.
  * 
  * Allocation Strategy:
- * 1. Fast path: Bump pointer allocation in nursery (O(1))
- * 2. Fragment search: If pinned objects exist, search free gaps
+ * 1. Fast path: Bump pointer allocation in the calling thread's TLAB (O(1),
+ *    no lock; see GCState::alloc)
+ * 2. Refill: Carve a new TLAB chunk from the nursery bump region or, if
+ *    pinned objects exist, from a free gap
  * 3. GC trigger: If nursery full, trigger minor GC
  * 4. OOM: If still failing, trigger major GC or return NULL
  * 
@@ -15,10 +17,14 @@
  */
 
 #include "gc_internal.h"
+#include "../allocators/heap_profile.h"
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <cstdio>
 #include <sys/mman.h>  // For mmap (nursery allocation)
+#include <sys/syscall.h>
+#include <unistd.h>
 
 namespace aria {
 namespace runtime {
@@ -27,198 +33,621 @@ namespace runtime {
 // Nursery Implementation
 // =============================================================================
 
-Nursery::Nursery(size_t size) : capacity(size), used(0) {
-    // Allocate nursery using mmap for alignment and large pages
+namespace {
+
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// Whole blocks, at least one
+size_t nursery_capacity_for(size_t size) {
+    size_t block = Nursery::BLOCK_SIZE;
+    return (std::max(size, block) + block - 1) & ~(block - 1);
+}
+
+/**
+ * Map size bytes (a page multiple) at an alignment-aligned address
+ */
+char* map_aligned_memory(size_t size, size_t alignment) {
+    size_t span = size + alignment;
+    void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    
+    // Trim the unaligned head and the unused tail
+    uintptr_t raw_addr = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t start = (raw_addr + alignment - 1) & ~(alignment - 1);
+    size_t head = start - raw_addr;
+    size_t tail = span - head - size;
+    if (head) {
+        munmap(raw, head);
+    }
+    if (tail) {
+        munmap(reinterpret_cast<char*>(start) + size, tail);
+    }
+    return reinterpret_cast<char*>(start);
+}
+
+void advise_huge_pages(void* memory, size_t size) {
+#ifdef MADV_HUGEPAGE
+    // Advisory: fails harmlessly when THP is disabled
+    madvise(memory, size, MADV_HUGEPAGE);
+#else
+    (void)memory;
+    (void)size;
+#endif
+}
+
+void* map_nursery_memory(size_t size, const HeapBacking& backing,
+                         size_t* mapped_size, bool* hugetlb) {
+    *mapped_size = size;
+    *hugetlb = false;
+    
+#ifdef MAP_HUGETLB
+    if (backing.explicit_huge_pages) {
+        // Reserved up front, so an empty pool fails here rather than
+        // with SIGBUS on first touch
+        size_t length = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        void* memory = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED) {
+            *mapped_size = length;
+            *hugetlb = true;
+            return memory;
+        }
+    }
+#endif
+    
+    if (backing.transparent_huge_pages || backing.explicit_huge_pages) {
+        // 2MB-aligned so every whole huge page of the range can be backed
+        char* memory = map_aligned_memory(size, HUGE_PAGE_SIZE);
+        if (memory) {
+            advise_huge_pages(memory, size);
+        }
+        return memory;
+    }
+    
+    // Allocate nursery using mmap for alignment
     // PROT_READ | PROT_WRITE: Memory is readable and writable
     // MAP_PRIVATE | MAP_ANONYMOUS: Private, not backed by file
-    start_addr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
-                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return memory == MAP_FAILED ? nullptr : memory;
+}
+
+void unmap_nursery_memory(void* memory, size_t size) {
+    // Check if munmap succeeds (indicates it was mmapped)
+    if (memory != nullptr && munmap(memory, size) != 0) {
+        // Not mmapped, use free
+        std::free(memory);
+    }
+}
+
+/**
+ * Prefer node for [start, start + size) (page-aligned). Preferred rather
+ * than bound: a full node spills to the others instead of failing.
+ */
+void bind_to_node(void* start, size_t size, size_t node) {
+#if defined(__linux__) && defined(SYS_mbind)
+    constexpr int MPOL_PREFERRED_MODE = 1;
+    constexpr size_t MAX_NODES = 1024;
+    if (node >= MAX_NODES) {
+        return;
+    }
+    unsigned long mask[MAX_NODES / (8 * sizeof(unsigned long))] = {};
+    mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+    // Errors (no NUMA support, offline node) leave first-touch placement
+    syscall(SYS_mbind, start, size, MPOL_PREFERRED_MODE, mask, MAX_NODES + 1, 0);
+#else
+    (void)start;
+    (void)size;
+    (void)node;
+#endif
+}
+
+} // namespace
+
+size_t online_numa_nodes() {
+    // "0-1,3": the highest listed node bounds the node ids
+    std::FILE* file = std::fopen("/sys/devices/system/node/online", "r");
+    if (!file) {
+        return 1;
+    }
     
-    if (start_addr == MAP_FAILED) {
+    size_t highest = 0;
+    unsigned long value = 0;
+    bool in_number = false;
+    for (int c = std::fgetc(file); ; c = std::fgetc(file)) {
+        if (c >= '0' && c <= '9') {
+            value = value * 10 + static_cast<unsigned long>(c - '0');
+            in_number = true;
+            continue;
+        }
+        if (in_number) {
+            highest = std::max<size_t>(highest, value);
+        }
+        value = 0;
+        in_number = false;
+        if (c == EOF) {
+            break;
+        }
+    }
+    std::fclose(file);
+    return highest + 1;
+}
+
+size_t current_numa_node() {
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return node;
+    }
+#endif
+    return 0;
+}
+
+Nursery::Nursery(size_t size, const HeapBacking& backing)
+    : capacity(nursery_capacity_for(size)), used(0), num_blocks(0), backing(backing),
+      mapped_size(0), hugetlb(false), num_pinned(0), nonempty_bins(0) {
+    start_addr = map_nursery_memory(capacity, backing, &mapped_size, &hugetlb);
+    
+    if (!start_addr) {
         // Fallback to malloc if mmap fails
-        start_addr = std::malloc(size);
+        start_addr = std::malloc(capacity);
         if (!start_addr) {
             throw std::bad_alloc();
         }
+        mapped_size = capacity;
     }
     
-    bump_ptr = start_addr;
-    end_addr = (char*)start_addr + size;
+    place_partitions();
 }
 
 Nursery::~Nursery() {
-    // Try to unmap if it was mmapped
-    if (start_addr != nullptr) {
-        // Check if munmap succeeds (indicates it was mmapped)
-        if (munmap(start_addr, capacity) != 0) {
-            // Not mmapped, use free
-            std::free(start_addr);
+    unmap_nursery_memory(start_addr, mapped_size);
+}
+
+void Nursery::place_partitions() {
+    end_addr = (char*)start_addr + capacity;
+    
+    num_blocks = capacity / BLOCK_SIZE;
+    pinned_bits.assign(num_blocks * BITMAP_WORDS_PER_BLOCK, 0);
+    block_pins.assign(num_blocks, 0);
+    pinned_blocks.assign((num_blocks + 63) / 64, 0);
+    
+    // Split on huge page boundaries when each node gets at least one,
+    // so no huge page straddles two nodes; otherwise on blocks
+    size_t nodes = std::max<size_t>(backing.numa_nodes, 1);
+    size_t granule = capacity / nodes >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : BLOCK_SIZE;
+    size_t share = capacity / nodes / granule * granule;
+    if (share == 0) {
+        nodes = 1;
+    }
+    
+    // Binding needs page alignment, which the malloc fallback lacks
+    bool bind = nodes > 1 && reinterpret_cast<uintptr_t>(start_addr) % 4096 == 0;
+    
+    partitions.clear();
+    char* cursor = static_cast<char*>(start_addr);
+    for (size_t node = 0; node < nodes; ++node) {
+        char* end = node + 1 == nodes ? static_cast<char*>(end_addr) : cursor + share;
+        if (bind) {
+            bind_to_node(cursor, end - cursor, node);
         }
+        partitions.push_back(Partition{cursor, cursor, end});
+        cursor = end;
     }
 }
 
-void* Nursery::allocate(size_t obj_size, uint16_t type_id) {
-    // Total allocation size: header + object payload
-    size_t total_size = sizeof(ObjHeader) + obj_size;
+bool Nursery::resize(size_t new_size) {
+    size_t new_capacity = nursery_capacity_for(new_size);
+    if (new_capacity == capacity) {
+        return true;
+    }
+    if (num_pinned != 0) {
+        return false;  // Pinned objects cannot move
+    }
     
-    // Align to 8 bytes for performance
-    total_size = (total_size + 7) & ~7;
+    size_t new_mapped_size = 0;
+    bool new_hugetlb = false;
+    void* memory = map_nursery_memory(new_capacity, backing, &new_mapped_size, &new_hugetlb);
+    if (!memory) {
+        return false;  // Keep the current mapping
+    }
     
-    // Fast path: Bump pointer allocation
-    void* alloc_ptr = bump_ptr;
-    void* new_bump_ptr = (char*)alloc_ptr + total_size;
+    unmap_nursery_memory(start_addr, mapped_size);
+    start_addr = memory;
+    capacity = new_capacity;
+    mapped_size = new_mapped_size;
+    hugetlb = new_hugetlb;
+    used = 0;
+    clear_fragments();
+    place_partitions();
+    return true;
+}
+
+void* Nursery::allocate(size_t obj_size, uint16_t type_id, size_t node) {
+    // Total allocation size: header + object payload, 8-byte aligned
+    size_t total_size = object_total_size(obj_size);
     
-    if (new_bump_ptr <= end_addr) {
-        // Allocation succeeds
-        bump_ptr = new_bump_ptr;
-        used += total_size;
-        
-        // Initialize header
-        ObjHeader* header = static_cast<ObjHeader*>(alloc_ptr);
-        std::memset(header, 0, sizeof(ObjHeader));
-        header->is_nursery = 1;
-        header->type_id = type_id;
-        header->size_class = total_size / 8;  // Simplified size class
-        
-        // Return pointer after header
-        void* obj_ptr = (char*)alloc_ptr + sizeof(ObjHeader);
-        
-        // Zero-initialize payload (important for safety)
-        std::memset(obj_ptr, 0, obj_size);
-        
-        return obj_ptr;
+    void* alloc_ptr = carve(total_size, node);
+    if (!alloc_ptr) {
+        // No space available - caller must trigger GC
+        return nullptr;
     }
     
-    // Slow path: Try to find a suitable fragment
-    for (size_t i = 0; i < fragments.size(); ++i) {
-        Fragment& frag = fragments[i];
-        
-        if (frag.size >= total_size) {
-            // Found suitable fragment
-            alloc_ptr = frag.start;
-            
-            // Update fragment (shrink or remove)
-            frag.start = (char*)frag.start + total_size;
-            frag.size -= total_size;
-            
-            if (frag.size < sizeof(ObjHeader) + 8) {
-                // Fragment too small to be useful, remove it
-                fragments.erase(fragments.begin() + i);
-            }
-            
-            used += total_size;
-            
-            // Initialize header
-            ObjHeader* header = static_cast<ObjHeader*>(alloc_ptr);
-            std::memset(header, 0, sizeof(ObjHeader));
-            header->is_nursery = 1;
-            header->type_id = type_id;
-            header->size_class = total_size / 8;
-            
-            // Return pointer after header
-            void* obj_ptr = (char*)alloc_ptr + sizeof(ObjHeader);
-            std::memset(obj_ptr, 0, obj_size);
-            
-            return obj_ptr;
-        }
+    return init_object(alloc_ptr, total_size, type_id, true);
+}
+
+void* Nursery::bump(Partition& partition, size_t min_size, size_t max_size, size_t* out_size) {
+    size_t bump_avail = (char*)partition.end - (char*)partition.bump_ptr;
+    if (bump_avail < min_size) {
+        return nullptr;
+    }
+    
+    size_t chunk = std::min(bump_avail, max_size);
+    void* chunk_ptr = partition.bump_ptr;
+    partition.bump_ptr = (char*)chunk_ptr + chunk;
+    used += chunk;
+    *out_size = chunk;
+    return chunk_ptr;
+}
+
+void* Nursery::carve(size_t total_size, size_t node) {
+    size_t size = 0;
+    return allocate_chunk(total_size, total_size, &size, node);
+}
+
+void* Nursery::allocate_chunk(size_t min_size, size_t max_size, size_t* out_size, size_t node) {
+    /**
+     * TLAB refill: hand out as much of the next free region as the
+     * caller wants, but never less than min_size (the object that
+     * triggered the refill must fit).
+     * 
+     * Local memory first: the caller's partition, then fragments (which
+     * only exist while objects are pinned), then the other partitions.
+     */
+    
+    size_t local = node % partitions.size();
+    void* chunk_ptr = bump(partitions[local], min_size, max_size, out_size);
+    if (chunk_ptr) {
+        return chunk_ptr;
+    }
+    
+    Fragment frag(nullptr, nullptr);
+    if (take_fragment(min_size, &frag)) {
+        size_t chunk = std::min(frag.size, max_size);
+        add_fragment((char*)frag.start + chunk, frag.end);
+        used += chunk;
+        *out_size = chunk;
+        return frag.start;
     }
     
-    // No space available - caller must trigger GC
+    for (size_t i = 1; i < partitions.size(); ++i) {
+        chunk_ptr = bump(partitions[(local + i) % partitions.size()], min_size, max_size, out_size);
+        if (chunk_ptr) {
+            return chunk_ptr;
+        }
+    }
     return nullptr;
 }
 
+namespace {
+
+// floor(log2(n)) for n > 0
+inline size_t log2_floor(size_t n) {
+    return 63 - __builtin_clzll(n);
+}
+
+} // namespace
+
+bool Nursery::take_fragment(size_t min_size, Fragment* out) {
+    // Every fragment in bin b holds at least 2^b bytes, so bins from
+    // ceil(log2(min_size)) up are guaranteed to fit
+    size_t bin = log2_floor(min_size);
+    if ((size_t(1) << bin) < min_size) {
+        bin++;
+    }
+    if (bin >= NUM_FRAGMENT_BINS) {
+        return false;
+    }
+    
+    uint64_t candidates = nonempty_bins & (~uint64_t(0) << bin);
+    if (!candidates) {
+        return false;
+    }
+    
+    bin = __builtin_ctzll(candidates);
+    *out = fragment_bins[bin].back();
+    fragment_bins[bin].pop_back();
+    if (fragment_bins[bin].empty()) {
+        nonempty_bins &= ~(uint64_t(1) << bin);
+    }
+    return true;
+}
+
+void Nursery::add_fragment(void* start, void* end) {
+    size_t size = (char*)end - (char*)start;
+    if (start >= end || size < MIN_FRAGMENT) {
+        return;  // Too small to be useful
+    }
+    
+    size_t bin = log2_floor(size);
+    fragment_bins[bin].emplace_back(start, end);
+    nonempty_bins |= uint64_t(1) << bin;
+}
+
+void Nursery::clear_fragments() {
+    for (uint64_t bins = nonempty_bins; bins; bins &= bins - 1) {
+        fragment_bins[__builtin_ctzll(bins)].clear();
+    }
+    nonempty_bins = 0;
+}
+
+void Nursery::pin(void* obj_ptr) {
+    size_t index = pin_index(obj_ptr);
+    uint64_t bit = uint64_t(1) << (index % 64);
+    if (pinned_bits[index / 64] & bit) {
+        return;
+    }
+    
+    pinned_bits[index / 64] |= bit;
+    size_t block = index / (BITMAP_WORDS_PER_BLOCK * 64);
+    if (block_pins[block]++ == 0) {
+        pinned_blocks[block / 64] |= uint64_t(1) << (block % 64);
+    }
+    num_pinned++;
+}
+
+void Nursery::unpin(void* obj_ptr) {
+    size_t index = pin_index(obj_ptr);
+    uint64_t bit = uint64_t(1) << (index % 64);
+    if (!(pinned_bits[index / 64] & bit)) {
+        return;
+    }
+    
+    pinned_bits[index / 64] &= ~bit;
+    size_t block = index / (BITMAP_WORDS_PER_BLOCK * 64);
+    if (--block_pins[block] == 0) {
+        pinned_blocks[block / 64] &= ~(uint64_t(1) << (block % 64));
+    }
+    num_pinned--;
+}
+
 void Nursery::reset_with_pinned() {
     /**
      * Fragmented Nursery Reset Algorithm
      * 
-     * When pinned objects exist, we cannot simply reset bump_ptr to start_addr
-     * (that would overwrite pinned objects on next allocation).
-     * 
-     * Instead:
-     * 1. Collect all pinned object regions
-     * 2. Sort by address
-     * 3. Find gaps between pinned regions
-     * 4. Create Fragment structs for each gap
-     * 5. Reset bump_ptr to first available space
+     * When pinned objects exist, we cannot simply reset each partition's
+     * bump_ptr to its start (that would overwrite pinned objects on next
+     * allocation).
      * 
-     * This transforms the nursery into a freelist-backed space when pinning
-     * is active, with performance degradation from O(1) to O(N) allocation.
+     * Instead, walk the pinned objects in address order (for_each_pinned
+     * only visits blocks that contain pins, so long unpinned stretches
+     * cost nothing) and turn the gaps between them into binned fragments.
+     * The trailing gap of each partition becomes its bump region.
      */
     
-    if (pinned_objects.empty()) {
+    clear_fragments();
+    used = 0;
+    
+    if (num_pinned == 0) {
         // No pinned objects - simple reset
-        bump_ptr = start_addr;
-        used = 0;
-        fragments.clear();
+        for (Partition& partition : partitions) {
+            partition.bump_ptr = partition.start;
+        }
         return;
     }
     
-    // Collect pinned regions (address ranges)
-    struct Region {
-        void* start;
-        void* end;
-        
-        bool operator<(const Region& other) const {
-            return start < other.start;
+    size_t current = 0;
+    void* prev_end = partitions[0].start;
+    
+    // Give every partition before the one containing addr its bump region
+    auto close_partitions_before = [&](void* addr) {
+        while (addr >= partitions[current].end) {
+            // A pinned object may run past the partition end
+            partitions[current].bump_ptr = std::min(prev_end, partitions[current].end);
+            ++current;
+            prev_end = std::max(prev_end, partitions[current].start);
         }
     };
     
-    std::vector<Region> pinned_regions;
-    pinned_regions.reserve(pinned_objects.size());
-    
-    for (void* obj_ptr : pinned_objects) {
-        // Get header (before object pointer)
+    for_each_pinned([&](void* obj_ptr) {
         ObjHeader* header = (ObjHeader*)((char*)obj_ptr - sizeof(ObjHeader));
+        void* region_end = (char*)header + object_footprint(header);
+        close_partitions_before(header);
         
-        // Calculate region: [header_start, obj_end)
-        void* region_start = (void*)header;
-        size_t obj_size = header->size_class * 8;  // Reconstruct size
-        void* region_end = (char*)region_start + obj_size;
-        
-        pinned_regions.push_back({region_start, region_end});
-    }
-    
-    // Sort by address
-    std::sort(pinned_regions.begin(), pinned_regions.end());
+        // Gap exists: [prev_end, header)
+        add_fragment(prev_end, header);
+        used += (char*)region_end - (char*)header;
+        prev_end = region_end;
+    });
     
-    // Find gaps and create fragments
-    fragments.clear();
-    void* prev_end = start_addr;
+    // The trailing gap (if any) becomes the bump region. Interior gaps stay
+    // in the fragment bins: bumping from the first gap would run straight
+    // over the pinned objects that follow it.
+    close_partitions_before(partitions.back().start);
+    partitions.back().bump_ptr = prev_end;
+}
+
+// =============================================================================
+// Size Classes
+// =============================================================================
+
+namespace {
+
+/**
+ * Slot sizes and the footprint -> class lookup table, built once.
+ * Footprints are multiples of 8, so the lookup is indexed by words.
+ */
+struct SizeClassTable {
+    size_t slot_size[NUM_SIZE_CLASSES + 1];
+    uint8_t class_by_words[MAX_SMALL_SIZE / 8 + 1];
     
-    for (const Region& region : pinned_regions) {
-        if (region.start > prev_end) {
-            // Gap exists: [prev_end, region.start)
-            size_t gap_size = (char*)region.start - (char*)prev_end;
-            
-            // Only create fragment if gap is useful (>= min allocation)
-            if (gap_size >= sizeof(ObjHeader) + 8) {
-                fragments.emplace_back(prev_end, region.start);
+    SizeClassTable() {
+        size_t count = 0;
+        slot_size[0] = 0;
+        for (size_t size = 16; size <= 64; size += 8) {
+            slot_size[++count] = size;
+        }
+        for (size_t base = 64; base < MAX_SMALL_SIZE; base *= 2) {
+            for (size_t step = 1; step <= 4; ++step) {
+                slot_size[++count] = base + base * step / 4;
             }
         }
         
-        prev_end = region.end;
+        uint8_t size_class = 1;
+        for (size_t words = 0; words <= MAX_SMALL_SIZE / 8; ++words) {
+            while (slot_size[size_class] < words * 8) {
+                ++size_class;
+            }
+            class_by_words[words] = size_class;
+        }
+    }
+};
+
+const SizeClassTable& size_classes() {
+    static const SizeClassTable table;
+    return table;
+}
+
+constexpr size_t PAGE_SIZE_BYTES = 4096;
+
+} // namespace
+
+uint8_t size_class_for(size_t footprint) {
+    if (footprint > MAX_SMALL_SIZE) {
+        return SIZE_CLASS_LARGE;
+    }
+    return size_classes().class_by_words[(footprint + 7) / 8];
+}
+
+size_t size_class_slot_size(uint8_t size_class) {
+    return size_classes().slot_size[size_class];
+}
+
+// =============================================================================
+// Segment Implementation
+// =============================================================================
+
+Segment::Segment(char* memory, size_t mapped_size, size_t slot_size, uint8_t size_class)
+    : memory(memory), mapped_size(mapped_size), base(memory + CARD_AREA_SIZE),
+      slot_size(slot_size), num_slots((mapped_size - CARD_AREA_SIZE) / slot_size),
+      size_class(size_class),
+      live_slots(0), alloc_hint(0),
+      alloc_bits((num_slots + 63) / 64, 0), mark_bits((num_slots + 63) / 64, 0) {}
+
+void* Segment::allocate_slot() {
+    if (live_slots == num_slots) {
+        return nullptr;
     }
     
-    // Final gap: [last_pinned_end, end_addr)
-    if (prev_end < end_addr) {
-        size_t gap_size = (char*)end_addr - (char*)prev_end;
-        if (gap_size >= sizeof(ObjHeader) + 8) {
-            fragments.emplace_back(prev_end, end_addr);
+    size_t num_words = alloc_bits.size();
+    for (size_t n = 0; n < num_words; ++n) {
+        size_t w = (alloc_hint + n) % num_words;
+        uint64_t free_bits = ~alloc_bits[w];
+        if (w == num_words - 1 && num_slots % 64 != 0) {
+            free_bits &= (uint64_t(1) << (num_slots % 64)) - 1;
+        }
+        if (free_bits) {
+            size_t bit = __builtin_ctzll(free_bits);
+            alloc_bits[w] |= uint64_t(1) << bit;
+            alloc_hint = w;
+            live_slots++;
+            return base + (w * 64 + bit) * slot_size;
         }
     }
     
-    // Update bump pointer to first fragment (or end if no fragments)
-    if (!fragments.empty()) {
-        bump_ptr = fragments[0].start;
-    } else {
-        // Completely fragmented - bump_ptr is unusable
-        bump_ptr = end_addr;
+    return nullptr;
+}
+
+size_t Segment::sweep() {
+    size_t freed = 0;
+    size_t live = 0;
+    
+    for (size_t w = 0; w < alloc_bits.size(); ++w) {
+        uint64_t survivors = alloc_bits[w] & mark_bits[w];
+        freed += __builtin_popcountll(alloc_bits[w] & ~mark_bits[w]);
+        live += __builtin_popcountll(survivors);
+        alloc_bits[w] = survivors;
+        mark_bits[w] = 0;
     }
     
-    // Recalculate used memory (sum of pinned regions)
-    used = 0;
-    for (const Region& region : pinned_regions) {
-        used += (char*)region.end - (char*)region.start;
+    live_slots = live;
+    alloc_hint = 0;
+    return freed;
+}
+
+bool Segment::has_pinned() const {
+    bool pinned = false;
+    for_each_object_in(base, base + num_slots * slot_size, [&](void* obj) {
+        pinned |= reinterpret_cast<const ObjHeader*>(
+            static_cast<char*>(obj) - sizeof(ObjHeader))->pinned_bit;
+    });
+    return pinned;
+}
+
+void Segment::release_free_pages() {
+    // Walk runs of free slots; the card area is never inside one, since
+    // runs start at base or later and are rounded in to page boundaries
+    auto release = [](char* lo, char* hi) {
+        uintptr_t start = (reinterpret_cast<uintptr_t>(lo) + PAGE_SIZE_BYTES - 1) &
+                          ~(PAGE_SIZE_BYTES - 1);
+        uintptr_t end = reinterpret_cast<uintptr_t>(hi) & ~(PAGE_SIZE_BYTES - 1);
+        if (end > start) {
+            madvise(reinterpret_cast<void*>(start), end - start, MADV_DONTNEED);
+        }
+    };
+    
+    char* run_start = nullptr;
+    for (size_t i = 0; i < num_slots; ++i) {
+        bool allocated = alloc_bits[i / 64] & (uint64_t(1) << (i % 64));
+        char* slot = base + i * slot_size;
+        if (!allocated && !run_start) {
+            run_start = slot;
+        } else if (allocated && run_start) {
+            release(run_start, slot);
+            run_start = nullptr;
+        }
+    }
+    if (run_start) {
+        release(run_start, memory + mapped_size);
+    }
+}
+
+// =============================================================================
+// SegmentMap Implementation
+// =============================================================================
+
+SegmentMap::SegmentMap() : leaves(ROOT_SIZE, nullptr) {}
+
+SegmentMap::~SegmentMap() {
+    for (Segment** leaf : leaves) {
+        delete[] leaf;
+    }
+}
+
+void SegmentMap::insert(Segment* segment) {
+    set(segment, segment);
+}
+
+void SegmentMap::erase(Segment* segment) {
+    set(segment, nullptr);
+}
+
+void SegmentMap::set(Segment* segment, Segment* value) {
+    uintptr_t first = reinterpret_cast<uintptr_t>(segment->memory) >> Segment::SHIFT;
+    uintptr_t last = (reinterpret_cast<uintptr_t>(segment->memory) +
+                      segment->mapped_size - 1) >> Segment::SHIFT;
+    
+    for (uintptr_t chunk = first; chunk <= last; ++chunk) {
+        Segment**& leaf = leaves[chunk >> LEAF_BITS];
+        if (!leaf) {
+            if (!value) continue;
+            leaf = new Segment*[LEAF_SIZE]();
+        }
+        leaf[chunk & (LEAF_SIZE - 1)] = value;
     }
 }
 
@@ -227,98 +656,402 @@ void Nursery::reset_with_pinned() {
 // =============================================================================
 
 OldGeneration::OldGeneration(size_t threshold) 
-    : used(0), threshold(threshold) {
-    objects.reserve(1024);  // Pre-allocate for efficiency
+    : used(0), mapped(0), threshold(threshold), allocate_black(false), huge_pages(false),
+      segments_released(0) {
+    std::fill(std::begin(bin_cursor), std::end(bin_cursor), 0);
+}
+
+OldGeneration::~OldGeneration() {
+    for (auto& bin : bins) {
+        bin.insert(bin.end(), evacuated.begin(), evacuated.end());
+        evacuated.clear();
+        for (Segment* segment : bin) {
+            munmap(segment->memory, segment->mapped_size);
+            delete segment;
+        }
+        bin.clear();
+    }
+    for (char* memory : free_segments) {
+        munmap(memory, Segment::SIZE);
+    }
+}
+
+Segment* OldGeneration::create_segment(uint8_t size_class, size_t slot_size,
+                                       size_t mapped_size) {
+    char* memory = nullptr;
+    if (mapped_size == Segment::SIZE && !free_segments.empty()) {
+        // Released pages fault back in zeroed, so the cards read CLEAN
+        memory = free_segments.back();
+        free_segments.pop_back();
+    } else {
+        memory = map_aligned_memory(mapped_size, Segment::SIZE);
+        if (!memory) {
+            return nullptr;
+        }
+        if (huge_pages) {
+            // Adjacent segments merge into one VMA, so runs of them can
+            // still be collapsed into huge pages
+            advise_huge_pages(memory, mapped_size);
+        }
+    }
+    
+    // Fresh anonymous memory: every card starts CLEAN
+    Segment* segment = new Segment(memory, mapped_size, slot_size, size_class);
+    segment_map.insert(segment);
+    bins[size_class].push_back(segment);
+    mapped += mapped_size;
+    return segment;
+}
+
+void OldGeneration::release_segment(Segment* segment) {
+    segment_map.erase(segment);
+    mapped -= segment->mapped_size;
+    segments_released++;
+    
+    if (segment->mapped_size == Segment::SIZE && free_segments.size() < MAX_FREE_SEGMENTS) {
+        // Give the pages back but keep the aligned address range, so the
+        // next segment needs no mmap/munmap round trip
+        madvise(segment->memory, segment->mapped_size, MADV_DONTNEED);
+        free_segments.push_back(segment->memory);
+    } else {
+        munmap(segment->memory, segment->mapped_size);
+    }
+    delete segment;
 }
 
 void* OldGeneration::allocate(size_t obj_size, uint16_t type_id) {
-    // Total size: header + payload
-    size_t total_size = sizeof(ObjHeader) + obj_size;
+    // Total size: header + payload, 8-byte aligned
+    size_t total_size = object_total_size(obj_size);
+    uint8_t size_class = size_class_for(total_size);
     
-    // Align to 8 bytes
-    total_size = (total_size + 7) & ~7;
+    void* block = nullptr;
+    size_t slot_size = 0;
     
-    // Use malloc for old generation objects
-    void* alloc_ptr = std::malloc(total_size);
-    if (!alloc_ptr) {
+    if (size_class == SIZE_CLASS_LARGE) {
+        // Dedicated single-slot segment (card area + object)
+        size_t mapped_size = (Segment::CARD_AREA_SIZE + total_size + PAGE_SIZE_BYTES - 1) &
+                             ~(PAGE_SIZE_BYTES - 1);
+        slot_size = mapped_size - Segment::CARD_AREA_SIZE;
+        Segment* segment = create_segment(SIZE_CLASS_LARGE, slot_size, mapped_size);
+        block = segment ? segment->allocate_slot() : nullptr;
+    } else {
+        // First segment of the class with a free slot. Slots are only
+        // freed by sweep(), which rewinds the cursor, so segments before
+        // the cursor are known to be full.
+        slot_size = size_class_slot_size(size_class);
+        std::vector<Segment*>& bin = bins[size_class];
+        size_t& cursor = bin_cursor[size_class];
+        
+        for (; cursor < bin.size() && !block; ) {
+            block = bin[cursor]->allocate_slot();
+            if (!block) ++cursor;
+        }
+        
+        if (!block) {
+            Segment* segment = create_segment(size_class, slot_size, Segment::SIZE);
+            if (segment) {
+                cursor = bin.size() - 1;
+                block = segment->allocate_slot();
+            }
+        }
+    }
+    
+    if (!block) {
         return nullptr;  // OOM
     }
     
-    used += total_size;
+    used += slot_size;
     
-    // Initialize header
-    ObjHeader* header = static_cast<ObjHeader*>(alloc_ptr);
-    std::memset(header, 0, sizeof(ObjHeader));
-    header->is_nursery = 0;  // Old generation
-    header->type_id = type_id;
-    header->size_class = total_size / 8;
+    void* obj_ptr = init_object(block, total_size, type_id, false);
+    static_cast<ObjHeader*>(block)->size_class = size_class;
     
-    // Return pointer after header
-    void* obj_ptr = (char*)alloc_ptr + sizeof(ObjHeader);
-    std::memset(obj_ptr, 0, obj_size);
+    if (allocate_black) {
+        mark(obj_ptr);  // Created during concurrent marking: live this cycle
+    }
+    return obj_ptr;
+}
+
+bool OldGeneration::mark(void* ptr) {
+    Segment* segment = segment_map.lookup(ptr);
+    if (!segment) {
+        return false;
+    }
     
-    // Track for sweeping
-    objects.push_back(obj_ptr);
+    size_t index = segment->slot_index(ptr);
+    if (index == Segment::NO_SLOT) {
+        return false;
+    }
     
-    return obj_ptr;
+    // Atomic test-and-set: parallel markers race on shared words, and
+    // the one that flips the bit owns tracing the object
+    uint64_t* word = &segment->mark_bits[index / 64];
+    uint64_t bit = uint64_t(1) << (index % 64);
+    if (__atomic_load_n(word, __ATOMIC_RELAXED) & bit) {
+        return false;
+    }
+    return !(__atomic_fetch_or(word, bit, __ATOMIC_RELAXED) & bit);
 }
 
-void OldGeneration::add_object(void* ptr) {
-    if (ptr) {
-        objects.push_back(ptr);
+size_t OldGeneration::sweep(GCWorkerPool& pool) {
+    // Phase 1 (parallel): sweep bitmaps; segments are independent, so
+    // workers just claim the next unswept one
+    std::vector<Segment*> all_segments;
+    for (const auto& bin : bins) {
+        all_segments.insert(all_segments.end(), bin.begin(), bin.end());
+    }
+    
+    std::atomic<size_t> next_segment{0};
+    std::atomic<size_t> bytes_freed{0};
+    
+    pool.run([&](size_t) {
+        size_t freed = 0;
+        for (;;) {
+            size_t i = next_segment.fetch_add(1, std::memory_order_relaxed);
+            if (i >= all_segments.size()) break;
+            Segment* segment = all_segments[i];
+            freed += segment->sweep() * segment->slot_size;
+        }
+        bytes_freed.fetch_add(freed, std::memory_order_relaxed);
+    });
+    
+    // Phase 2 (serial): release segments left empty
+    for (size_t size_class = 0; size_class <= NUM_SIZE_CLASSES; ++size_class) {
+        std::vector<Segment*>& bin = bins[size_class];
         
-        // Update header: mark as old generation
-        ObjHeader* header = (ObjHeader*)((char*)ptr - sizeof(ObjHeader));
-        header->is_nursery = 0;
+        for (size_t i = 0; i < bin.size(); ) {
+            Segment* segment = bin[i];
+            if (segment->live_slots == 0) {
+                // Swap-remove; don't advance i
+                bin[i] = bin.back();
+                bin.pop_back();
+                release_segment(segment);
+            } else {
+                ++i;
+            }
+        }
+        
+        bin_cursor[size_class] = 0;
     }
+    
+    used -= bytes_freed.load();
+    return bytes_freed.load();
 }
 
-bool OldGeneration::contains(void* ptr) const {
-    // Check if pointer is in our tracked objects
-    // This is O(N) but only called during GC/debugging
-    return std::find(objects.begin(), objects.end(), ptr) != objects.end();
+size_t OldGeneration::scan_dirty_cards(const std::function<void(void*)>& visit) {
+    // Snapshot the dirty segments first: visiting promotes objects, which
+    // may add segments to the bins
+    std::vector<Segment*> dirty_segments;
+    for (const auto& bin : bins) {
+        for (Segment* segment : bin) {
+            const uint8_t* cards = reinterpret_cast<const uint8_t*>(segment->memory);
+            if (cards[CardTable::SUMMARY_CARD] != CardTable::CARD_CLEAN) {
+                dirty_segments.push_back(segment);
+            }
+        }
+    }
+    
+    size_t dirty_cards = 0;
+    for (Segment* segment : dirty_segments) {
+        uint8_t* cards = reinterpret_cast<uint8_t*>(segment->memory);
+        cards[CardTable::SUMMARY_CARD] = CardTable::CARD_CLEAN;
+        
+        // Eight cards per load; clean words are skipped outright
+        for (size_t w = 0; w < CardTable::CARDS_PER_SEGMENT / 8; ++w) {
+            uint64_t word;
+            std::memcpy(&word, cards + w * 8, sizeof(word));
+            
+            while (word) {
+                size_t byte = __builtin_ctzll(word) / 8;
+                word &= ~(uint64_t(0xFF) << (byte * 8));
+                
+                size_t card = w * 8 + byte;
+                cards[card] = CardTable::CARD_CLEAN;
+                dirty_cards++;
+                
+                const char* lo = segment->memory + card * CardTable::CARD_SIZE;
+                segment->for_each_object_in(lo, lo + CardTable::CARD_SIZE, visit);
+            }
+        }
+    }
+    
+    return dirty_cards;
 }
 
-// =============================================================================
-// CardTable Implementation
-// =============================================================================
-
-CardTable::CardTable(void* heap_start, size_t heap_size) 
-    : heap_start(heap_start) {
-    num_cards = (heap_size + CARD_SIZE - 1) / CARD_SIZE;
-    cards = new uint8_t[num_cards];
-    clear();
+size_t OldGeneration::evacuate_sparse_segments() {
+    /**
+     * Two-finger compaction per size class. Slots within a class are
+     * interchangeable, so sliding objects inside a segment would free
+     * nothing; instead whole segments are emptied. Segments are ordered
+     * densest first: the destination finger fills free slots from the
+     * front while the source finger empties segments from the back, as
+     * long as the segments ahead of the source have room for all of its
+     * objects. A source holding a pinned object is left in place and
+     * only gives back its free pages.
+     */
+    
+    size_t bytes_moved = 0;
+    
+    for (size_t size_class = 1; size_class <= NUM_SIZE_CLASSES; ++size_class) {
+        std::vector<Segment*>& bin = bins[size_class];
+        if (bin.size() < 2) {
+            continue;
+        }
+        
+        size_t live = 0;
+        size_t capacity = 0;
+        for (Segment* segment : bin) {
+            live += segment->live_slots;
+            capacity += segment->num_slots;
+        }
+        if (capacity - live < bin[0]->num_slots) {
+            continue;  // Not even one segment's worth of free slots
+        }
+        
+        std::sort(bin.begin(), bin.end(), [](const Segment* a, const Segment* b) {
+            return a->live_slots > b->live_slots;
+        });
+        
+        // free_before[k] = free slots in bin[0..k)
+        std::vector<size_t> free_before(bin.size() + 1, 0);
+        for (size_t k = 0; k < bin.size(); ++k) {
+            free_before[k + 1] = free_before[k] + bin[k]->num_slots - bin[k]->live_slots;
+        }
+        
+        size_t dest = 0;
+        size_t slots_used = 0;  // Free slots filled so far, all in bin[0..dest]
+        size_t source = bin.size();
+        std::vector<Segment*> kept;  // Pinned sources, stay in the bin
+        
+        while (source - 1 > dest) {
+            Segment* from = bin[source - 1];
+            if (free_before[source - 1] - slots_used < from->live_slots) {
+                break;  // The rest cannot be emptied
+            }
+            --source;
+            
+            if (from->has_pinned()) {
+                from->release_free_pages();
+                kept.push_back(from);
+                continue;
+            }
+            
+            from->for_each_object_in(from->base, from->base + from->num_slots * from->slot_size,
+                                     [&](void* obj) {
+                void* block = nullptr;
+                while (!(block = bin[dest]->allocate_slot())) {
+                    ++dest;
+                }
+                
+                ObjHeader* header = reinterpret_cast<ObjHeader*>(
+                    static_cast<char*>(obj) - sizeof(ObjHeader));
+                std::memcpy(block, header, object_footprint(header));
+                
+                // Forward the old copy (sweep already cleared the marks)
+                header->forwarded_bit = 1;
+                *static_cast<void**>(obj) = static_cast<char*>(block) + sizeof(ObjHeader);
+                
+                bytes_moved += from->slot_size;
+                slots_used++;
+            });
+            evacuated.push_back(from);
+        }
+        
+        bin.resize(source);
+        bin.insert(bin.end(), kept.begin(), kept.end());
+        bin_cursor[size_class] = 0;
+    }
+    
+    return bytes_moved;
 }
 
-CardTable::~CardTable() {
-    delete[] cards;
+void OldGeneration::release_evacuated() {
+    // The moved objects are accounted to their new slots in used
+    for (Segment* segment : evacuated) {
+        release_segment(segment);
+    }
+    evacuated.clear();
 }
 
-void CardTable::mark_dirty(void* addr) {
-    // Calculate card index
-    size_t offset = (char*)addr - (char*)heap_start;
-    size_t card_idx = offset >> CARD_SHIFT;  // Divide by 512
-    
-    if (card_idx < num_cards) {
-        cards[card_idx] = CARD_DIRTY;
+void OldGeneration::for_each_object(GCWorkerPool& pool,
+                                   const std::function<void(void*)>& visit) {
+    std::vector<Segment*> all_segments;
+    for (const auto& bin : bins) {
+        all_segments.insert(all_segments.end(), bin.begin(), bin.end());
     }
+    
+    std::atomic<size_t> next_segment{0};
+    pool.run([&](size_t) {
+        for (;;) {
+            size_t i = next_segment.fetch_add(1, std::memory_order_relaxed);
+            if (i >= all_segments.size()) break;
+            Segment* segment = all_segments[i];
+            segment->for_each_object_in(segment->base,
+                                        segment->base + segment->num_slots * segment->slot_size,
+                                        visit);
+        }
+    });
 }
 
-std::vector<void*> CardTable::get_dirty_cards() {
-    std::vector<void*> dirty;
+// =============================================================================
+// TypeRegistry Implementation
+// =============================================================================
+
+uint16_t TypeRegistry::register_type(size_t size, const uint64_t* ptr_bitmap) {
+    size_t num_words = size / 8;
+    size_t bitmap_len = (num_words + 63) / 64;
     
-    for (size_t i = 0; i < num_cards; ++i) {
-        if (cards[i] == CARD_DIRTY) {
-            void* card_addr = (char*)heap_start + (i * CARD_SIZE);
-            dirty.push_back(card_addr);
+    // Canonicalize: drop bits beyond the instance size
+    std::vector<uint64_t> bitmap(bitmap_len, 0);
+    bool has_refs = false;
+    for (size_t i = 0; i < bitmap_len && ptr_bitmap; ++i) {
+        bitmap[i] = ptr_bitmap[i];
+        if (i == bitmap_len - 1 && num_words % 64 != 0) {
+            bitmap[i] &= (uint64_t(1) << (num_words % 64)) - 1;
         }
+        has_refs |= bitmap[i] != 0;
+    }
+    
+    if (!has_refs) {
+        return ARIA_GC_TYPE_LEAF;
+    }
+    
+    std::vector<uint64_t> key;
+    key.reserve(bitmap_len + 1);
+    key.push_back(size);
+    key.insert(key.end(), bitmap.begin(), bitmap.end());
+    
+    auto it = ids_by_layout.find(key);
+    if (it != ids_by_layout.end()) {
+        return it->second;
+    }
+    
+    size_t next_id = num_layouts.load(std::memory_order_relaxed);
+    if (next_id >= ARIA_GC_TYPE_INVALID) {
+        return ARIA_GC_TYPE_INVALID;  // ID space exhausted
+    }
+    
+    TypeLayout* chunk = chunks[next_id / CHUNK_SIZE].load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new TypeLayout[CHUNK_SIZE];
+        chunks[next_id / CHUNK_SIZE].store(chunk, std::memory_order_release);
     }
     
-    return dirty;
+    TypeLayout& layout = chunk[next_id % CHUNK_SIZE];
+    layout.size = size;
+    layout.ptr_bitmap = std::move(bitmap);
+    
+    // Publish only after the layout is complete
+    uint16_t type_id = static_cast<uint16_t>(next_id);
+    num_layouts.store(next_id + 1, std::memory_order_release);
+    ids_by_layout.emplace(std::move(key), type_id);
+    
+    return type_id;
 }
 
-void CardTable::clear() {
-    std::memset(cards, CARD_CLEAN, num_cards);
+TypeRegistry::~TypeRegistry() {
+    for (auto& chunk : chunks) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
 }
 
 // =============================================================================
@@ -328,7 +1061,9 @@ void CardTable::clear() {
 extern "C" {
 
 void* aria_gc_alloc(size_t size, uint16_t type_id) {
-    return GCState::instance().alloc(size, type_id);
+    void* ptr = GCState::instance().alloc(size, type_id);
+    heap_profile_note_alloc(ptr, size, type_id, HeapSampleKind::GC);
+    return ptr;
 }
 
 void aria_gc_pin(void* ptr) {
@@ -347,6 +1082,12 @@ void aria_gc_get_stats(GCStats* stats) {
     GCState::instance().get_stats(stats);
 }
 
+bool aria_gc_dump_trace(const char* path) {
+    return GCState::instance().dump_trace(path);
+}
+
+ARIA_THREAD_LOCAL AriaShadowFrame* aria_shadow_stack_top = nullptr;
+
 void aria_shadow_stack_push_frame(void) {
     GCState::instance().push_frame();
 }
@@ -363,10 +1104,42 @@ void aria_shadow_stack_remove_root(void** root_addr) {
     GCState::instance().remove_root(root_addr);
 }
 
+uint16_t aria_gc_register_type(size_t size, const uint64_t* ptr_bitmap) {
+    return GCState::instance().register_type(size, ptr_bitmap);
+}
+
+void aria_gc_register_thread(void) {
+    GCState::instance().current_thread();
+}
+
+void aria_gc_unregister_thread(void) {
+    GCState::instance().unregister_thread();
+}
+
+void aria_gc_safepoint(void) {
+    GCState::instance().safepoint_poll();
+}
+
+void aria_gc_enter_blocking(void) {
+    GCState::instance().enter_blocking();
+}
+
+void aria_gc_leave_blocking(void) {
+    GCState::instance().leave_blocking();
+}
+
+uint8_t aria_gc_satb_active = 0;
+
 void aria_gc_write_barrier(void* obj, void* ref) {
     GCState::instance().write_barrier(obj, ref);
 }
 
+void aria_gc_write_barrier_pre(void** slot) {
+    if (slot) {
+        GCState::instance().write_barrier_pre(slot);
+    }
+}
+
 ObjHeader* aria_gc_get_header(void* ptr) {
     return GCState::instance().get_header(ptr);
 }
@@ -375,8 +1148,21 @@ bool aria_gc_is_heap_pointer(void* ptr) {
     return GCState::instance().is_heap_pointer(ptr);
 }
 
-void aria_gc_init(size_t nursery_size, size_t old_gen_threshold) {
-    GCState::instance().init(nursery_size, old_gen_threshold);
+void aria_gc_init(size_t nursery_size, size_t old_gen_threshold, size_t num_gc_threads,
+                  uint32_t flags) {
+    GCState::instance().init(nursery_size, old_gen_threshold, num_gc_threads, flags);
+}
+
+void aria_gc_get_policy(GCPolicy* policy) {
+    if (policy) {
+        GCState::instance().get_policy(policy);
+    }
+}
+
+void aria_gc_set_policy(const GCPolicy* policy) {
+    if (policy) {
+        GCState::instance().set_policy(*policy);
+    }
 }
 
 void aria_gc_shutdown(void) {
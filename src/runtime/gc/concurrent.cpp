@@ -0,0 +1,277 @@
+/**
+ * Aria GC Concurrent Marking
+ *
+ * This file implements the mostly-concurrent major GC mode selected with
+ * ARIA_GC_CONCURRENT_MARK:
+ * - Initial pause: minor GC, shade roots, enable the SATB barrier
+ * - Concurrent mark: a background marker thread drains the gray set
+ *   while mutators run
+ * - Remark pause: drain the SATB buffers, finish marking, sweep (and
+ *   compact, with ARIA_GC_COMPACT)
+ *
+ * Snapshot-at-the-beginning invariant: every object reachable when the
+ * cycle starts is marked. Mutators may only hide such an object by
+ * overwriting a reference to it, and aria_gc_write_barrier_pre logs the
+ * overwritten reference. Objects created during the cycle are live by
+ * construction: nursery objects are never swept by a major GC and
+ * promotions are allocated black, so their fields need no tracing.
+ *
+ * The marker registers as a mutator thread with no roots. It polls for
+ * safepoints between mark steps, so minor GCs can run (and promote into
+ * the old generation) while a cycle is in progress.
+ *
+ * Reference: research_021_garbage_collection_system.txt
+ */
+
+#include "gc_internal.h"
+#include <unordered_set>
+
+namespace aria {
+namespace runtime {
+
+namespace {
+
+constexpr size_t MARK_STEP = 256;         // Objects traced between safepoint polls
+constexpr size_t SATB_BUFFER_SIZE = 256;  // Thread-local entries before flushing
+
+uint64_t elapsed_since(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+}
+
+} // namespace
+
+// =============================================================================
+// SATB Buffers
+// =============================================================================
+
+void GCState::satb_enqueue(void* old_ref) {
+    // Nursery references need no logging: after the initial minor GC the
+    // nursery only holds pinned objects (already scanned as roots) and
+    // objects created during the cycle
+    if (!old_ref || nursery->contains(old_ref)) {
+        return;
+    }
+
+    MutatorThread* self = current_thread();
+    self->satb_buffer.push_back(old_ref);
+    if (self->satb_buffer.size() >= SATB_BUFFER_SIZE) {
+        flush_satb_buffer(self);
+    }
+}
+
+void GCState::flush_satb_buffer(MutatorThread* thread) {
+    if (thread->satb_buffer.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(satb_mutex);
+    satb_queue.insert(satb_queue.end(), thread->satb_buffer.begin(),
+                      thread->satb_buffer.end());
+    thread->satb_buffer.clear();
+}
+
+void GCState::drain_satb_queue() {
+    std::vector<void*> refs;
+    {
+        std::lock_guard<std::mutex> lock(satb_mutex);
+        refs.swap(satb_queue);
+    }
+
+    for (void* ref : refs) {
+        if (old_gen->mark(ref)) {
+            mark_stack.push_back(ref);
+        }
+    }
+}
+
+// =============================================================================
+// Cycle Phases
+// =============================================================================
+
+void GCState::start_concurrent_mark() {
+    /**
+     * Initial pause (world stopped, minor GC just completed)
+     *
+     * Shades everything directly reachable from the roots. Pinned
+     * nursery objects are scanned here rather than marked: they are not
+     * part of the old generation and minor GCs during the cycle still
+     * use their mark_bit as a "queued" flag.
+     */
+
+    cycle_start = std::chrono::steady_clock::now();
+    mark_stack.clear();
+
+    std::vector<void*> nursery_gray;
+    std::unordered_set<void*> nursery_seen;
+
+    auto shade = [&](void* ptr) {
+        if (!ptr) return;
+        if (nursery->contains(ptr)) {
+            if (nursery_seen.insert(ptr).second) {
+                nursery_gray.push_back(ptr);
+            }
+        } else if (old_gen->mark(ptr)) {
+            mark_stack.push_back(ptr);
+        }
+    };
+
+    for_each_root([&](void** root_addr) { shade(*root_addr); });
+    nursery->for_each_pinned(shade);
+    while (!nursery_gray.empty()) {
+        void* obj_ptr = nursery_gray.back();
+        nursery_gray.pop_back();
+        types.for_each_slot(obj_ptr, get_header(obj_ptr), [&](void** slot) {
+            shade(*slot);
+        });
+    }
+
+    old_gen->allocate_black = true;
+    set_marking_active(true);
+
+    {
+        std::lock_guard<std::mutex> lock(marker_mutex);
+        marker_wakeup = true;
+    }
+    marker_cv.notify_one();
+}
+
+bool GCState::concurrent_mark_step() {
+    /**
+     * Trace up to MARK_STEP gray objects while mutators run
+     *
+     * Returns false once both the gray set and the flushed SATB buffers
+     * are empty. Slots are read atomically because mutators may be
+     * storing to them; a stale read is harmless since the previous
+     * value was logged by the SATB barrier.
+     */
+
+    auto visit = [this](void** slot) {
+        void* child = __atomic_load_n(slot, __ATOMIC_RELAXED);
+        if (child && !nursery->contains(child) && old_gen->mark(child)) {
+            mark_stack.push_back(child);
+        }
+    };
+
+    for (size_t n = 0; n < MARK_STEP; ++n) {
+        if (mark_stack.empty()) {
+            drain_satb_queue();
+            if (mark_stack.empty()) {
+                return false;
+            }
+        }
+
+        void* obj_ptr = mark_stack.back();
+        mark_stack.pop_back();
+        types.for_each_slot(obj_ptr, get_header(obj_ptr), visit);
+    }
+
+    return true;
+}
+
+void GCState::finish_concurrent_mark() {
+    /**
+     * Remark pause (world stopped)
+     *
+     * Collects the SATB entries still sitting in thread-local buffers,
+     * finishes the closure on the worker pool and sweeps. Usually only
+     * a handful of objects remain, so the pause is short regardless of
+     * heap size.
+     */
+
+    for (MutatorThread* thread : threads) {
+        flush_satb_buffer(thread);
+    }
+    drain_satb_queue();
+
+    // Skips nursery children, unlike drain_mark_stack (see parallel_mark)
+    parallel_mark();
+
+    set_marking_active(false);
+    old_gen->allocate_black = false;
+
+    stats.num_major_collections++;
+    stats.last_mark_ns = elapsed_since(cycle_start);
+    stats.total_mark_ns += stats.last_mark_ns;
+
+    auto sweep_start = std::chrono::steady_clock::now();
+    size_t used_before_sweep = old_gen->used;
+    sweep_old_gen();
+    stats.last_sweep_ns = elapsed_since(sweep_start);
+    stats.total_sweep_ns += stats.last_sweep_ns;
+    
+    if (compact_mode) {
+        // Young objects created during the cycle may reference objects
+        // about to move; promote them so only pinned ones remain
+        minor_gc();
+        compact_old_gen();
+    }
+    
+    GCEvent& event = trace.append(GCEventKind::CONCURRENT_MARK, cycle_start,
+                                  elapsed_since(cycle_start));
+    event.freed_bytes = used_before_sweep - old_gen->used;
+    event.old_gen_used = old_gen->used;
+
+    stats.old_gen_used = old_gen->used;
+    finish_major_cycle();
+}
+
+// =============================================================================
+// Marker Thread
+// =============================================================================
+
+void GCState::marker_loop() {
+    // Take part in safepoints like a mutator (no roots, never allocates)
+    current_thread();
+
+    for (;;) {
+        enter_blocking();
+        {
+            std::unique_lock<std::mutex> lock(marker_mutex);
+            marker_cv.wait(lock, [this] { return marker_wakeup || marker_stop.load(); });
+            marker_wakeup = false;
+        }
+        leave_blocking();
+
+        if (marker_stop.load()) {
+            break;
+        }
+
+        while (marking_active.load() && !marker_stop.load()) {
+            if (!concurrent_mark_step()) {
+                std::unique_lock<std::mutex> lock = lock_gc();
+                run_pause([this] {
+                    // Another thread may have finished the cycle meanwhile
+                    if (marking_active.load()) {
+                        finish_concurrent_mark();
+                    }
+                });
+                break;
+            }
+            safepoint_poll();
+        }
+    }
+
+    unregister_thread();
+}
+
+void GCState::stop_marker() {
+    if (!marker_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(marker_mutex);
+        marker_stop.store(true);
+    }
+    marker_cv.notify_all();
+
+    // The marker may be in a remark pause waiting for this thread to stop
+    enter_blocking();
+    marker_thread.join();
+    leave_blocking();
+}
+
+} // namespace runtime
+} // namespace aria
@@ -3,66 +3,247 @@
  * 
  * This file implements the main garbage collection algorithms:
  * - Minor GC: Copying collector for nursery (with pinning support)
- * - Major GC: Mark-sweep collector for old generation
+ * - Major GC: Mark-sweep collector for old generation (bitmap marks)
+ * - Precise tracing through per-type_id reference maps
  * - Shadow stack management
+ * - TLAB allocation fast path
  * - GC state coordination
  * 
  * Reference: research_021_garbage_collection_system.txt
  */
 
 #include "gc_internal.h"
+#include "../allocators/heap_profile.h"
 #include <algorithm>
 #include <iostream>
 #include <cstring>
+#include <chrono>
+#include <thread>
 
 namespace aria {
 namespace runtime {
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t elapsed_ns(Clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - start).count());
+}
+
+} // namespace
+
 // =============================================================================
 // ShadowStack Implementation
 // =============================================================================
 
 ShadowStack::~ShadowStack() {
-    // Clean up all frames
-    while (top) {
+    // Drop runtime frames still linked by this thread; compiled frames
+    // belong to activations that are gone by thread exit
+    while (*top && ((*top)->flags & SHADOW_FRAME_DYNAMIC)) {
         pop_frame();
     }
+    for (DynamicFrame* frame : free_frames) {
+        delete frame;
+    }
 }
 
 void ShadowStack::push_frame() {
-    top = new ShadowFrame(top);
+    DynamicFrame* frame;
+    if (free_frames.empty()) {
+        frame = new DynamicFrame();
+        frame->header.num_roots = 0;
+        frame->header.flags = SHADOW_FRAME_DYNAMIC;
+    } else {
+        frame = free_frames.back();
+        free_frames.pop_back();
+    }
+    
+    frame->header.prev = *top;
+    *top = &frame->header;
 }
 
 void ShadowStack::pop_frame() {
-    if (!top) return;
+    AriaShadowFrame* frame = *top;
+    if (!frame || !(frame->flags & SHADOW_FRAME_DYNAMIC)) return;
     
-    ShadowFrame* old_top = top;
-    top = top->prev;
-    delete old_top;
+    *top = frame->prev;
+    DynamicFrame* dynamic = reinterpret_cast<DynamicFrame*>(frame);
+    dynamic->roots.clear();  // Keeps capacity for the next push
+    free_frames.push_back(dynamic);
 }
 
 void ShadowStack::add_root(void** root_addr) {
-    if (top) {
-        top->roots.push_back(root_addr);
+    AriaShadowFrame* frame = *top;
+    if (frame && (frame->flags & SHADOW_FRAME_DYNAMIC)) {
+        reinterpret_cast<DynamicFrame*>(frame)->roots.push_back(root_addr);
     }
 }
 
 void ShadowStack::remove_root(void** root_addr) {
-    if (!top) return;
+    AriaShadowFrame* frame = *top;
+    if (!frame || !(frame->flags & SHADOW_FRAME_DYNAMIC)) return;
     
-    auto& roots = top->roots;
+    auto& roots = reinterpret_cast<DynamicFrame*>(frame)->roots;
     roots.erase(std::remove(roots.begin(), roots.end(), root_addr), roots.end());
 }
 
-std::vector<void**> ShadowStack::get_all_roots() const {
-    std::vector<void**> all_roots;
+// =============================================================================
+// Thread Registry
+// =============================================================================
+
+namespace {
+
+/**
+ * Per-thread handle to the thread's MutatorThread. The destructor runs
+ * at thread exit and unregisters the thread, so exited threads are never
+ * waited on at a safepoint and their unreported allocation counts are
+ * folded into the global statistics.
+ */
+struct ThreadContext {
+    MutatorThread* mutator = nullptr;
+    
+    ~ThreadContext() {
+        if (mutator) {
+            GCState::instance().unregister_thread();
+        }
+    }
+};
+
+thread_local ThreadContext t_context;
+
+} // namespace
+
+MutatorThread* GCState::current_thread() {
+    MutatorThread* self = t_context.mutator;
+    if (self) {
+        return self;
+    }
     
-    // Walk the frame chain
-    for (ShadowFrame* frame = top; frame != nullptr; frame = frame->prev) {
-        all_roots.insert(all_roots.end(), frame->roots.begin(), frame->roots.end());
+    std::lock_guard<std::mutex> lock(gc_mutex);
+    return register_thread_locked();
+}
+
+MutatorThread* GCState::register_thread_locked() {
+    // Holding gc_mutex means no collection is in progress, so the new
+    // thread cannot appear halfway through a stop-the-world pause
+    MutatorThread* self = t_context.mutator;
+    if (!self) {
+        self = new MutatorThread();
+        threads.push_back(self);
+        t_context.mutator = self;
     }
+    return self;
+}
+
+void GCState::unregister_thread() {
+    MutatorThread* self = t_context.mutator;
+    if (!self) return;
+    
+    std::unique_lock<std::mutex> lock = lock_gc();
+    
+    stats.total_allocated += self->tlab.allocated;
+    flush_satb_buffer(self);
+    threads.erase(std::remove(threads.begin(), threads.end(), self), threads.end());
+    t_context.mutator = nullptr;
     
-    return all_roots;
+    lock.unlock();
+    delete self;
+}
+
+// =============================================================================
+// Safepoints (Stop-the-World Handshake)
+// =============================================================================
+
+/**
+ * Protocol:
+ * 
+ * Collector (holds gc_mutex):       Mutator:
+ *   safepoint_requested = true        state = RUNNING
+ *   wait until every other thread     if (safepoint_requested)
+ *     has state != RUNNING              park (state = AT_SAFEPOINT)
+ *   ... collect ...
+ *   safepoint_requested = false
+ *   notify_all
+ * 
+ * Both sides use sequentially consistent accesses, so a thread leaving a
+ * blocking region either sees the request and parks, or is seen RUNNING
+ * by the collector and waited for. The relaxed load in safepoint_poll is
+ * only for polls made while already RUNNING; leave_blocking must not use
+ * it, since a relaxed load may be satisfied before its state store is
+ * visible.
+ */
+
+void GCState::safepoint_slow() {
+    MutatorThread* self = t_context.mutator;
+    if (!self) return;  // Unregistered threads hold no roots
+    
+    std::unique_lock<std::mutex> lock(safepoint_mutex);
+    self->state.store(MUTATOR_AT_SAFEPOINT);
+    safepoint_cv.notify_all();
+    safepoint_cv.wait(lock, [this] { return !safepoint_requested.load(); });
+    self->state.store(MUTATOR_RUNNING);
+}
+
+void GCState::enter_blocking() const {
+    MutatorThread* self = t_context.mutator;
+    if (!self) return;
+    
+    if (self->blocking_depth++ == 0) {
+        self->state.store(MUTATOR_BLOCKED);
+        // Wake a collector that may be waiting on this thread
+        std::lock_guard<std::mutex> lock(safepoint_mutex);
+        safepoint_cv.notify_all();
+    }
+}
+
+void GCState::leave_blocking() {
+    MutatorThread* self = t_context.mutator;
+    if (!self || self->blocking_depth == 0) return;
+    
+    if (--self->blocking_depth == 0) {
+        self->state.store(MUTATOR_RUNNING);
+        if (safepoint_requested.load()) {  // seq_cst: ordered after the store
+            safepoint_slow();
+        }
+    }
+}
+
+std::unique_lock<std::mutex> GCState::lock_gc() const {
+    // A registered thread waiting for gc_mutex may be waiting on a
+    // collector that is itself waiting for this thread to stop; treat
+    // lock acquisition as a blocking region to break the cycle
+    enter_blocking();
+    std::unique_lock<std::mutex> lock(gc_mutex);
+    MutatorThread* self = t_context.mutator;
+    if (self && --self->blocking_depth == 0) {
+        // No poll needed: we hold gc_mutex, so no collection can be running
+        self->state.store(MUTATOR_RUNNING);
+    }
+    return lock;
+}
+
+void GCState::stop_the_world() {
+    safepoint_requested.store(true);
+    
+    MutatorThread* self = t_context.mutator;
+    std::unique_lock<std::mutex> lock(safepoint_mutex);
+    for (MutatorThread* thread : threads) {
+        if (thread == self) continue;
+        safepoint_cv.wait(lock, [thread] {
+            return thread->state.load() != MUTATOR_RUNNING;
+        });
+    }
+}
+
+void GCState::resume_the_world() {
+    {
+        std::lock_guard<std::mutex> lock(safepoint_mutex);
+        safepoint_requested.store(false);
+    }
+    safepoint_cv.notify_all();
 }
 
 // =============================================================================
@@ -74,13 +255,20 @@ GCState& GCState::instance() {
     return inst;
 }
 
-void GCState::init(size_t nursery_size, size_t old_gen_threshold) {
-    std::lock_guard<std::mutex> lock(gc_mutex);
-    
+void GCState::init(size_t nursery_size, size_t old_gen_threshold, size_t num_gc_threads,
+                   uint32_t flags) {
+    std::unique_lock<std::mutex> lock = lock_gc();
+    init_locked(nursery_size, old_gen_threshold, num_gc_threads, flags);
+}
+
+void GCState::init_locked(size_t nursery_size, size_t old_gen_threshold,
+                          size_t num_gc_threads, uint32_t flags) {
     if (initialized) {
         return;  // Already initialized
     }
     
+    apply_environment(nursery_size, old_gen_threshold, num_gc_threads, flags);
+    
     // Default sizes if not specified
     if (nursery_size == 0) {
         nursery_size = 4 * 1024 * 1024;  // 4MB default
@@ -88,86 +276,235 @@ void GCState::init(size_t nursery_size, size_t old_gen_threshold) {
     if (old_gen_threshold == 0) {
         old_gen_threshold = 64 * 1024 * 1024;  // 64MB default
     }
+    if (num_gc_threads == 0) {
+        // One per core, capped: small heaps gain little from more
+        num_gc_threads = std::min<size_t>(
+            std::max(std::thread::hardware_concurrency(), 1u), 8);
+    }
     
     // Initialize components
-    nursery = new Nursery(nursery_size);
+    init_policy(nursery_size);
+    init_backing(flags);
+    nursery = new Nursery(nursery_size, backing);
     old_gen = new OldGeneration(old_gen_threshold);
+    old_gen->huge_pages = backing.transparent_huge_pages || backing.explicit_huge_pages;
+    workers = new GCWorkerPool(num_gc_threads);
     
-    // Card table covers both nursery and old gen (worst case: 128MB = 256K cards)
-    size_t total_heap = nursery_size + old_gen_threshold;
-    card_table = new CardTable(nursery->start_addr, total_heap);
+    // Keep TLABs small relative to the nursery so a handful of threads
+    // cannot strand most of it in half-used buffers
+    tlab_size = std::max(TLAB::MIN_SIZE,
+                         std::min(TLAB::DEFAULT_SIZE, nursery_size / 16));
     
     // Initialize stats
     stats = {};
-    stats.nursery_size = nursery_size;
+    trace.clear();
+    minor_pauses.clear();
+    major_pauses.clear();
+    stats.nursery_size = nursery->capacity;
+    stats.nursery_partitions = nursery->partitions.size();
+    stats.nursery_hugetlb = nursery->hugetlb;
     stats.old_gen_size = 0;
+    stats.num_gc_threads = workers->size();
+    
+    next_major_trigger = old_gen_threshold;
+    minor_promoted = 0;
+    cycle_promoted = 0;
+    concurrent_mode = (flags & ARIA_GC_CONCURRENT_MARK) != 0;
+    compact_mode = (flags & ARIA_GC_COMPACT) != 0;
+    if (concurrent_mode) {
+        marker_stop = false;
+        marker_wakeup = false;
+        marker_thread = std::thread(&GCState::marker_loop, this);
+    }
     
     initialized = true;
+    invalidate_tlabs();
 }
 
 void GCState::shutdown() {
-    std::lock_guard<std::mutex> lock(gc_mutex);
+    // The marker may need gc_mutex for its remark pause, so it is
+    // stopped before the lock is taken
+    stop_marker();
+    
+    std::unique_lock<std::mutex> lock = lock_gc();
     
     if (!initialized) return;
     
+    invalidate_tlabs();
+    
+    // Abandon an unfinished concurrent cycle
+    set_marking_active(false);
+    mark_stack.clear();
+    {
+        std::lock_guard<std::mutex> satb_lock(satb_mutex);
+        satb_queue.clear();
+    }
+    for (MutatorThread* thread : threads) {
+        thread->satb_buffer.clear();
+    }
+    
+    // Every sampled object goes away with the heap
+    if (g_heap_live_gc_samples.load(std::memory_order_relaxed)) {
+        heap_profile_relocate_gc_samples([](void*) -> void* { return nullptr; });
+    }
+    
     delete nursery;
     delete old_gen;
-    delete card_table;
+    delete workers;  // Joins the helper threads
     
     nursery = nullptr;
     old_gen = nullptr;
-    card_table = nullptr;
+    workers = nullptr;
     
     initialized = false;
+    cycle_cv.notify_all();  // Release threads waiting for a cycle
+}
+
+// =============================================================================
+// Allocation (TLAB fast path + locked refill)
+// =============================================================================
+
+void GCState::invalidate_tlabs() {
+    // Release: a thread that observes the new epoch also observes the
+    // reset nursery layout published under gc_mutex
+    tlab_epoch.fetch_add(1, std::memory_order_release);
+}
+
+void GCState::flush_tlab_stats(TLAB& tlab) {
+    stats.total_allocated += tlab.allocated;
+    tlab.allocated = 0;
 }
 
 void* GCState::alloc(size_t size, uint16_t type_id) {
-    std::lock_guard<std::mutex> lock(gc_mutex);
+    /**
+     * Fast path: bump-allocate from the calling thread's TLAB.
+     * 
+     * No lock and no shared writes - the shared reads are the safepoint
+     * flag and the epoch, which tells us whether a collection has reset
+     * the nursery since this buffer was carved. Statistics are accumulated
+     * per thread and folded into GCStats on refill.
+     */
+    MutatorThread* self = current_thread();
+    safepoint_poll();
+    
+    size_t total_size = object_total_size(size);
+    TLAB& tlab = self->tlab;
+    
+    if (tlab.epoch == tlab_epoch.load(std::memory_order_acquire)) {
+        void* block = tlab.try_allocate(total_size);
+        if (block) {
+            tlab.allocated += size;
+            return init_object(block, total_size, type_id, true);
+        }
+    }
+    
+    return alloc_slow(tlab, size, total_size, type_id);
+}
+
+void* GCState::alloc_slow(TLAB& tlab, size_t size, size_t total_size, uint16_t type_id) {
+    std::unique_lock<std::mutex> lock = lock_gc();
     
     if (!initialized) {
-        init(0, 0);  // Auto-initialize with defaults
+        init_locked(0, 0, 0, 0);  // Auto-initialize with defaults
     }
     
-    // Try to allocate in nursery
-    void* ptr = nursery->allocate(size, type_id);
+    flush_tlab_stats(tlab);
     
-    if (ptr) {
-        stats.total_allocated += size;
-        stats.nursery_used = nursery->used;
-        return ptr;
+    if (policy.large_object_size && size >= policy.large_object_size) {
+        return alloc_large(size, type_id);
     }
     
-    // Nursery full - trigger minor GC
-    minor_gc();
+    // Objects too large to share a TLAB go straight to the nursery
+    bool direct = total_size > tlab_size / 4;
+    
+    // Allocation group: threads running on the same NUMA node share a
+    // nursery partition. Looked up per refill, so it follows migration.
+    size_t node = nursery->partitions.size() > 1 ? current_numa_node() : 0;
     
-    // Retry allocation
-    ptr = nursery->allocate(size, type_id);
+    // Try the nursery, then minor GC, then major GC
+    void* ptr = nullptr;
+    for (int attempt = 0; attempt < 3 && !ptr; ++attempt) {
+        if (attempt == 1) {
+            collect_locked(false);
+        } else if (attempt == 2) {
+            collect_locked(true);
+        }
+        
+        if (direct) {
+            ptr = nursery->allocate(size, type_id, node);
+        } else {
+            void* block = refill_and_allocate(tlab, total_size, node);
+            if (block) {
+                ptr = init_object(block, total_size, type_id, true);
+            }
+        }
+    }
     
-    if (ptr) {
-        stats.total_allocated += size;
-        stats.nursery_used = nursery->used;
-        return ptr;
+    if (!ptr) {
+        // Out of memory
+        std::cerr << "Aria GC: Out of memory!\n";
+        return nullptr;
     }
     
-    // Still failing - trigger major GC
-    major_gc();
+    stats.total_allocated += size;
+    stats.nursery_used = nursery->used;
+    return ptr;
+}
+
+void* GCState::alloc_large(size_t size, uint16_t type_id) {
+    /**
+     * Large-object space: a dedicated old generation span, so the object
+     * is never copied. Called with gc_mutex held.
+     * 
+     * The object is unreachable until returned, so a major GC it would
+     * trigger has to run before allocating it rather than after.
+     */
+    if (old_gen->used + object_total_size(size) >= next_major_trigger &&
+        !marking_active.load()) {
+        run_pause([this] {
+            if (concurrent_mode) {
+                minor_gc();
+                start_concurrent_mark();
+            } else {
+                major_gc();
+            }
+        });
+    }
     
-    // Final retry
-    ptr = nursery->allocate(size, type_id);
+    void* ptr = old_gen->allocate(size, type_id);
+    if (!ptr) {
+        collect_locked(true);
+        ptr = old_gen->allocate(size, type_id);
+    }
+    if (!ptr) {
+        std::cerr << "Aria GC: Out of memory!\n";
+        return nullptr;
+    }
     
-    if (ptr) {
-        stats.total_allocated += size;
-        stats.nursery_used = nursery->used;
-        return ptr;
+    stats.total_allocated += size;
+    stats.old_gen_used = old_gen->used;
+    return ptr;
+}
+
+void* GCState::refill_and_allocate(TLAB& tlab, size_t total_size, size_t node) {
+    // The unused tail of the old buffer is abandoned; it is reclaimed
+    // wholesale when the next minor GC resets the nursery.
+    size_t chunk_size = 0;
+    void* chunk = nursery->allocate_chunk(total_size, tlab_size, &chunk_size, node);
+    if (!chunk) {
+        tlab.reset();
+        return nullptr;
     }
     
-    // Out of memory
-    std::cerr << "Aria GC: Out of memory!\n";
-    return nullptr;
+    tlab.cursor = static_cast<char*>(chunk);
+    tlab.limit = tlab.cursor + chunk_size;
+    tlab.epoch = tlab_epoch.load(std::memory_order_relaxed);
+    
+    return tlab.try_allocate(total_size);
 }
 
 void GCState::pin(void* ptr) {
-    std::lock_guard<std::mutex> lock(gc_mutex);
+    std::unique_lock<std::mutex> lock = lock_gc();
     
     if (!ptr) return;
     
@@ -180,13 +517,13 @@ void GCState::pin(void* ptr) {
     
     // Track in nursery
     if (header->is_nursery && nursery) {
-        nursery->pinned_objects.insert(ptr);
-        stats.num_pinned_objects++;
+        nursery->pin(ptr);
+        stats.num_pinned_objects = nursery->num_pinned;
     }
 }
 
 void GCState::unpin(void* ptr) {
-    std::lock_guard<std::mutex> lock(gc_mutex);
+    std::unique_lock<std::mutex> lock = lock_gc();
     
     if (!ptr) return;
     
@@ -198,84 +535,245 @@ void GCState::unpin(void* ptr) {
     
     // Remove from tracking
     if (header->is_nursery && nursery) {
-        nursery->pinned_objects.erase(ptr);
-        if (stats.num_pinned_objects > 0) {
-            stats.num_pinned_objects--;
-        }
+        nursery->unpin(ptr);
+        stats.num_pinned_objects = nursery->num_pinned;
     }
 }
 
 void GCState::collect(bool full) {
-    std::lock_guard<std::mutex> lock(gc_mutex);
+    std::unique_lock<std::mutex> lock = lock_gc();
+    
+    if (!full || !concurrent_mode || !initialized) {
+        collect_locked(full);
+        return;
+    }
+    
+    /**
+     * Concurrent mode: start a cycle (unless one is running) and wait
+     * for the marker to finish it. The caller waits as a blocked thread,
+     * so it does not hold up the pauses of the cycle it is waiting for.
+     */
+    if (!marking_active.load()) {
+        run_pause([this] {
+            minor_gc();
+            start_concurrent_mark();
+        });
+    }
     
+    uint64_t target = cycles_completed + 1;
+    enter_blocking();
+    cycle_cv.wait(lock, [&] { return cycles_completed >= target || !initialized; });
+    lock.unlock();
+    leave_blocking();
+}
+
+void GCState::collect_locked(bool full) {
+    run_pause([this, full] {
+        if (full) {
+            full_gc();
+        } else {
+            minor_gc();
+            maybe_start_major();
+        }
+    });
+}
+
+void GCState::run_pause(const std::function<void()>& body) {
     if (!initialized || collecting) {
         return;  // Already collecting or not initialized
     }
     
     collecting = true;
+    auto pause_start = Clock::now();
+    uint64_t majors_before = stats.num_major_collections;
+    bool marking_before = marking_active.load();
+    
+    stop_the_world();
+    body();
+    resume_the_world();
+    
+    uint64_t pause_ns = elapsed_ns(pause_start);
+    stats.last_pause_ns = pause_ns;
+    stats.total_pause_ns += pause_ns;
+    if (pause_ns > stats.max_pause_ns) {
+        stats.max_pause_ns = pause_ns;
+    }
     
-    if (full) {
-        major_gc();
+    bool major = stats.num_major_collections != majors_before ||
+                 marking_active.load() != marking_before;
+    (major ? major_pauses : minor_pauses).record(pause_ns);
+    trace.append(major ? GCEventKind::MAJOR_PAUSE : GCEventKind::MINOR_PAUSE,
+                 pause_start, pause_ns).old_gen_used = old_gen->used;
+    
+    collecting = false;
+}
+
+void GCState::full_gc() {
+    if (marking_active.load()) {
+        // Complete the running cycle now rather than starting another
+        finish_concurrent_mark();
     } else {
-        minor_gc();
+        major_gc();
+    }
+}
+
+void GCState::maybe_start_major() {
+    if (old_gen->used < next_major_trigger || marking_active.load()) {
+        return;
     }
     
-    collecting = false;
+    if (concurrent_mode) {
+        start_concurrent_mark();
+    } else {
+        major_gc();
+    }
+}
+
+void GCState::finish_major_cycle() {
+    // Let the old generation grow by the policy factor before the next
+    // major GC, so a large live set does not trigger one after every
+    // minor GC
+    update_major_trigger();
+    cycles_completed++;
+    cycle_cv.notify_all();
 }
 
 void GCState::minor_gc() {
     /**
      * Minor GC: Evacuate nursery to old generation
      * 
-     * Algorithm:
-     * 1. Scan all roots (shadow stack)
-     * 2. For each root pointing to nursery:
-     *    a. If object is pinned: mark as live, don't move
-     *    b. If object is unpinned: evacuate to old gen
-     * 3. Reconstruct nursery (handle pinned objects)
-     * 4. Clear card table
+     * Algorithm (Cheney-style, with an explicit scan list):
+     * 1. Forward every root that points into the nursery:
+     *    a. Pinned object: stays in place, queued for field scanning
+     *    b. Unpinned object: copied to old gen, root updated
+     * 2. Old generation objects in dirty cards are roots too: the write
+     *    barrier recorded that they may reference the nursery
+     * 3. Pinned nursery objects are roots in their own right (wild
+     *    pointers may reference them), so their fields are scanned too
+     * 4. Scan the fields of every promoted/pinned object using its type
+     *    layout, forwarding nursery children the same way
+     * 5. Reconstruct nursery (handle pinned objects)
      * 
-     * This is a stop-the-world copying collector with pinning support.
+     * Cards are cleared as they are scanned. An old object that still
+     * references the nursery afterwards (only possible for pinned
+     * children) gets its card re-dirtied, so the reference is updated
+     * once the child is unpinned and moves.
+     * 
+     * This is a stop-the-world copying collector with pinning support;
+     * collect_locked() has already parked every other mutator. Pinned
+     * objects borrow mark_bit as a "queued" flag, cleared at the end.
      */
     
     if (!initialized) return;
     
     stats.num_minor_collections++;
+    auto phase_start = Clock::now();
+    size_t nursery_used_before = nursery->used;
     
-    // Scan roots
-    auto roots = shadow_stack.get_all_roots();
+    std::vector<void*> scan_list;
     
-    for (void** root_addr : roots) {
-        void* obj_ptr = *root_addr;
-        
+    auto forward = [&](void** slot) {
+        void* obj_ptr = *slot;
         if (!obj_ptr || !nursery->contains(obj_ptr)) {
-            continue;  // Not a nursery object
+            return;  // Not a nursery object
         }
         
         ObjHeader* header = get_header(obj_ptr);
-        if (!header) continue;
         
-        // Check if pinned
         if (header->pinned_bit) {
-            // Pinned object - mark as live but don't move
-            header->mark_bit = 1;
-            continue;
+            // Pinned object - keep in place, scan its fields once
+            if (!header->mark_bit) {
+                header->mark_bit = 1;
+                scan_list.push_back(obj_ptr);
+            }
+            return;
         }
         
-        // Evacuate to old generation
+        bool already_forwarded = header->forwarded_bit;
         void* new_ptr = evacuate_object(obj_ptr);
         
         if (new_ptr) {
-            // Update root to point to new location
-            *root_addr = new_ptr;
+            *slot = new_ptr;
+            if (!already_forwarded) {
+                scan_list.push_back(new_ptr);
+            }
+        }
+    };
+    
+    // Trace an old generation object, re-dirtying its card if it keeps
+    // a reference into the nursery
+    auto scan_old_object = [&](void* obj_ptr) {
+        bool references_nursery = false;
+        types.for_each_slot(obj_ptr, get_header(obj_ptr), [&](void** slot) {
+            forward(slot);
+            if (*slot && nursery->contains(*slot)) {
+                references_nursery = true;
+            }
+        });
+        if (references_nursery) {
+            CardTable::mark_dirty(obj_ptr);
         }
+    };
+    
+    // Roots (every registered thread is stopped)
+    for_each_root(forward);
+    
+    // Old-to-young references recorded by the write barrier
+    auto card_scan_start = Clock::now();
+    stats.last_dirty_cards = old_gen->scan_dirty_cards(scan_old_object);
+    trace.append(GCEventKind::CARD_SCAN, card_scan_start,
+                 elapsed_ns(card_scan_start)).dirty_cards = stats.last_dirty_cards;
+    
+    // Pinned objects are implicitly live
+    nursery->for_each_pinned([&](void* pinned) {
+        void* slot = pinned;
+        forward(&slot);
+    });
+    
+    // Transitive closure over promoted and pinned objects
+    while (!scan_list.empty()) {
+        void* obj_ptr = scan_list.back();
+        scan_list.pop_back();
+        if (get_header(obj_ptr)->is_nursery) {
+            types.for_each_slot(obj_ptr, get_header(obj_ptr), forward);
+        } else {
+            scan_old_object(obj_ptr);
+        }
+    }
+    
+    nursery->for_each_pinned([this](void* pinned) {
+        get_header(pinned)->mark_bit = 0;
+    });
+    
+    // Sampled objects: follow the promoted, drop the dead
+    if (g_heap_live_gc_samples.load(std::memory_order_relaxed)) {
+        heap_profile_relocate_gc_samples([this](void* obj) -> void* {
+            if (!nursery->contains(obj)) {
+                return obj;
+            }
+            ObjHeader* header = get_header(obj);
+            if (header->forwarded_bit) {
+                return *static_cast<void**>(obj);
+            }
+            return header->pinned_bit ? obj : nullptr;
+        });
     }
     
     // Reconstruct nursery (handle fragments from pinned objects)
     nursery->reset_with_pinned();
+    stats.last_evacuate_ns = elapsed_ns(phase_start);
+    stats.total_evacuate_ns += stats.last_evacuate_ns;
+    
+    // Grow or shrink the (now empty) nursery for the next cycle
+    adapt_nursery(nursery_used_before);
     
-    // Clear card table
-    card_table->clear();
+    GCEvent& event = trace.append(GCEventKind::MINOR_GC, phase_start, stats.last_evacuate_ns);
+    event.promoted_bytes = stats.last_promoted;
+    event.pinned_objects = nursery->num_pinned;
+    event.old_gen_used = old_gen->used;
+    
+    // Every outstanding TLAB now points into reclaimed space
+    invalidate_tlabs();
     
     // Update stats
     stats.nursery_used = nursery->used;
@@ -289,10 +787,9 @@ void* GCState::evacuate_object(void* ptr) {
      * Steps:
      * 1. Get object size from header
      * 2. Allocate in old generation
-     * 3. Copy header + payload
-     * 4. Update header metadata
-     * 5. Set forwarding pointer in old location
-     * 6. Return new address
+     * 3. Copy payload (type_id carried over)
+     * 4. Set forwarding pointer in old location
+     * 5. Return new address
      */
     
     if (!ptr) return nullptr;
@@ -309,7 +806,7 @@ void* GCState::evacuate_object(void* ptr) {
     }
     
     // Get object size
-    size_t obj_size = old_header->size_class * 8 - sizeof(ObjHeader);
+    size_t obj_size = object_payload_size(old_header);
     
     // Allocate in old generation
     void* new_ptr = old_gen->allocate(obj_size, old_header->type_id);
@@ -331,7 +828,11 @@ void* GCState::evacuate_object(void* ptr) {
     *forward_ptr = new_ptr;
     
     // Update statistics
-    stats.total_collected += (old_header->size_class * 8);
+    stats.total_collected += object_footprint(old_header);
+    minor_promoted += object_footprint(old_header);
+    if (marking_active.load(std::memory_order_relaxed)) {
+        cycle_promoted += object_footprint(old_header);
+    }
     
     return new_ptr;
 }
@@ -341,134 +842,211 @@ void GCState::major_gc() {
      * Major GC: Mark-sweep for old generation
      * 
      * Algorithm:
-     * 1. Mark Phase: Starting from roots, mark all reachable objects
-     * 2. Sweep Phase: Free unmarked objects, reset marks for next cycle
+     * 0. Minor GC first, so every live nursery object except the pinned
+     *    ones has been promoted and the nursery holds no stale marks
+     * 1. Mark Phase: Starting from roots (shadow stacks + pinned nursery
+     *    objects), trace the object graph through type layouts -
+     *    O(live objects + reference slots), no recursion depth limit.
+     *    Roots are marked serially; the closure runs on every GC worker
+     *    with work stealing (see parallel_mark)
+     * 2. Sweep Phase: Free unmarked objects, reset marks for next cycle;
+     *    segments are swept in parallel
+     * 3. Compact Phase (ARIA_GC_COMPACT): empty sparse segments into
+     *    denser ones and update references (see compact_old_gen)
      * 
-     * This is a simple stop-the-world mark-sweep collector.
+     * This is a stop-the-world mark-sweep(-compact) collector.
      */
     
     if (!initialized) return;
     
+    minor_gc();
+    
     stats.num_major_collections++;
     
     // =========================================================================
     // Mark Phase
     // =========================================================================
     
-    // Scan all roots
-    auto roots = shadow_stack.get_all_roots();
+    auto mark_start = Clock::now();
+    auto phase_start = mark_start;
+    mark_stack.clear();
     
-    for (void** root_addr : roots) {
-        void* obj_ptr = *root_addr;
-        if (obj_ptr) {
-            mark_object(obj_ptr);
-        }
+    for_each_root([this](void** root_addr) { mark_object(*root_addr); });
+    nursery->for_each_pinned([this](void* pinned) { mark_object(pinned); });
+    
+    if (workers->size() > 1) {
+        parallel_mark();
+    } else {
+        drain_mark_stack();
     }
     
-    // Also scan nursery objects that reference old gen
-    // (For simplicity, we'll skip this in the basic implementation)
+    stats.last_mark_ns = elapsed_ns(phase_start);
+    stats.total_mark_ns += stats.last_mark_ns;
     
     // =========================================================================
     // Sweep Phase
     // =========================================================================
     
+    phase_start = Clock::now();
+    size_t used_before_sweep = old_gen->used;
     sweep_old_gen();
+    stats.last_sweep_ns = elapsed_ns(phase_start);
+    stats.total_sweep_ns += stats.last_sweep_ns;
+    
+    if (compact_mode) {
+        compact_old_gen();
+    }
+    
+    GCEvent& event = trace.append(GCEventKind::MAJOR_GC, mark_start, elapsed_ns(mark_start));
+    event.freed_bytes = used_before_sweep - old_gen->used;
+    event.old_gen_used = old_gen->used;
+    
+    // Pinned nursery objects are not swept; reset their marks here
+    nursery->for_each_pinned([this](void* pinned) {
+        get_header(pinned)->mark_bit = 0;
+    });
     
     // Update stats
     stats.old_gen_used = old_gen->used;
+    finish_major_cycle();
+}
+
+bool GCState::is_heap_pointer_locked(void* ptr) const {
+    return ptr && (nursery->contains(ptr) || old_gen->contains(ptr));
 }
 
 void GCState::mark_object(void* ptr) {
     /**
-     * Mark phase: Recursively mark reachable objects
-     * 
-     * This is a simplified implementation that marks objects
-     * but doesn't trace their references (would require type information).
+     * Mark a single object and queue it for tracing
      * 
-     * A full implementation would:
-     * 1. Use type_id to look up object layout
-     * 2. Scan fields for references
-     * 3. Recursively mark referenced objects
+     * Reference slots may legitimately hold NULL, wild pointers or
+     * pointers to static data; only GC heap objects are marked.
+     * Old generation marks live in segment bitmaps; nursery objects
+     * (only pinned ones survive the preceding minor GC) use mark_bit.
      */
     
     if (!ptr) return;
     
-    ObjHeader* header = get_header(ptr);
-    if (!header) return;
-    
-    // Already marked?
-    if (header->mark_bit) return;
-    
-    // Mark this object
-    header->mark_bit = 1;
+    if (nursery->contains(ptr)) {
+        ObjHeader* header = get_header(ptr);
+        if (header->mark_bit) return;  // Already marked
+        header->mark_bit = 1;
+    } else if (!old_gen->mark(ptr)) {
+        return;  // Not a heap object, or already marked
+    }
     
-    // TODO: Trace references (requires type information)
-    // For now, we just mark the object itself
+    mark_stack.push_back(ptr);
+}
+
+void GCState::drain_mark_stack() {
+    while (!mark_stack.empty()) {
+        void* obj_ptr = mark_stack.back();
+        mark_stack.pop_back();
+        
+        types.for_each_slot(obj_ptr, get_header(obj_ptr), [this](void** slot) {
+            mark_object(*slot);
+        });
+    }
 }
 
 void GCState::sweep_old_gen() {
     /**
      * Sweep phase: Free unmarked objects
      * 
-     * Iterates through old generation objects:
-     * - If mark_bit == 1: Object is live, reset mark for next cycle
-     * - If mark_bit == 0: Object is dead, free it
+     * Per segment, live = alloc & mark and the mark bitmap is cleared,
+     * 64 slots per word operation. Dead objects are never touched and
+     * segments left empty are returned to the OS. Segments are handed
+     * out to the GC workers one at a time.
+     */
+    
+    size_t bytes_freed = old_gen->sweep(*workers);
+    
+    if (g_heap_live_gc_samples.load(std::memory_order_relaxed)) {
+        heap_profile_relocate_gc_samples([this](void* obj) -> void* {
+            return nursery->contains(obj) || old_gen->contains(obj) ? obj : nullptr;
+        });
+    }
+    
+    // Update statistics
+    stats.total_collected += bytes_freed;
+    stats.segments_released = old_gen->segments_released;
+}
+
+void GCState::compact_old_gen() {
+    /**
+     * Compaction: evacuate sparse segments, then update references
      * 
-     * Uses swap-remove optimization for O(1) deletion from vector.
+     * Runs right after the sweep with the world stopped, when every
+     * allocated old generation object is live and no object is marked.
+     * The nursery holds only pinned objects (a minor GC precedes it), so
+     * references to moved objects can only be in:
+     * - Roots (shadow stacks)
+     * - Old generation objects, scanned in parallel via type layouts
+     * - Pinned nursery objects
+     * - Heap profile samples
+     * Each slot is rewritten to the forwarding address left in the old
+     * copy; only then are the emptied segments released. An updated old
+     * object that references the nursery gets its card dirtied, since
+     * it may have moved away from the card that recorded the reference.
      */
     
-    auto& objects = old_gen->objects;
-    size_t bytes_freed = 0;
+    auto phase_start = Clock::now();
+    stats.last_compacted = old_gen->evacuate_sparse_segments();
     
-    for (size_t i = 0; i < objects.size(); ) {
-        void* obj_ptr = objects[i];
-        ObjHeader* header = get_header(obj_ptr);
+    if (stats.last_compacted > 0) {
+        auto relocate = [this](void** slot) {
+            if (*slot) {
+                *slot = old_gen->forwarding_address(*slot);
+            }
+        };
         
-        if (!header) {
-            // Corrupted header - skip
-            ++i;
-            continue;
-        }
+        for_each_root(relocate);
+        nursery->for_each_pinned([&](void* pinned) {
+            types.for_each_slot(pinned, get_header(pinned), relocate);
+        });
         
-        if (header->mark_bit) {
-            // Live object - reset mark bit for next cycle
-            header->mark_bit = 0;
-            ++i;
-        } else {
-            // Dead object - free it
-            size_t obj_size = header->size_class * 8;
-            bytes_freed += obj_size;
-            
-            // Free memory
-            void* alloc_ptr = (char*)obj_ptr - sizeof(ObjHeader);
-            std::free(alloc_ptr);
-            
-            // Remove from vector (swap with last and pop)
-            objects[i] = objects.back();
-            objects.pop_back();
-            // Don't increment i - we moved a new element to position i
+        old_gen->for_each_object(*workers, [&](void* obj_ptr) {
+            bool references_nursery = false;
+            types.for_each_slot(obj_ptr, get_header(obj_ptr), [&](void** slot) {
+                relocate(slot);
+                references_nursery |= *slot && nursery->contains(*slot);
+            });
+            if (references_nursery) {
+                CardTable::mark_dirty(obj_ptr);
+            }
+        });
+        
+        if (g_heap_live_gc_samples.load(std::memory_order_relaxed)) {
+            heap_profile_relocate_gc_samples([this](void* obj) -> void* {
+                return old_gen->forwarding_address(obj);
+            });
         }
     }
     
-    // Update statistics
-    old_gen->used -= bytes_freed;
-    stats.total_collected += bytes_freed;
+    old_gen->release_evacuated();
+    
+    stats.total_compacted += stats.last_compacted;
+    stats.last_compact_ns = elapsed_ns(phase_start);
+    stats.segments_released = old_gen->segments_released;
 }
 
 void GCState::push_frame() {
-    shadow_stack.push_frame();
+    // Function prologues double as safepoint polls
+    MutatorThread* self = current_thread();
+    safepoint_poll();
+    self->shadow_stack.push_frame();
 }
 
 void GCState::pop_frame() {
-    shadow_stack.pop_frame();
+    current_thread()->shadow_stack.pop_frame();
 }
 
 void GCState::add_root(void** root_addr) {
-    shadow_stack.add_root(root_addr);
+    current_thread()->shadow_stack.add_root(root_addr);
 }
 
 void GCState::remove_root(void** root_addr) {
-    shadow_stack.remove_root(root_addr);
+    current_thread()->shadow_stack.remove_root(root_addr);
 }
 
 void GCState::write_barrier(void* obj, void* ref) {
@@ -481,26 +1059,27 @@ void GCState::write_barrier(void* obj, void* ref) {
      * mark the card containing obj as DIRTY.
      * 
      * During minor GC, DIRTY cards are scanned as additional roots.
+     * ref may be any pointer (wild, static), so it is range-checked
+     * rather than having its header read.
      */
     
-    if (!obj || !ref) return;
-    
-    ObjHeader* obj_header = get_header(obj);
-    ObjHeader* ref_header = get_header(ref);
-    
-    if (!obj_header || !ref_header) return;
+    if (!obj || !ref || !initialized) return;
     
     // Only care about old-to-young references
-    if (!obj_header->is_nursery && ref_header->is_nursery) {
-        card_table->mark_dirty(obj);
+    if (!get_header(obj)->is_nursery && nursery->contains(ref)) {
+        CardTable::mark_dirty(obj);
     }
 }
 
 bool GCState::is_heap_pointer(void* ptr) const {
     if (!initialized || !ptr) return false;
     
-    return (nursery && nursery->contains(ptr)) || 
-           (old_gen && old_gen->contains(ptr));
+    return is_heap_pointer_locked(ptr);
+}
+
+uint16_t GCState::register_type(size_t size, const uint64_t* ptr_bitmap) {
+    std::unique_lock<std::mutex> lock = lock_gc();
+    return types.register_type(size, ptr_bitmap);
 }
 
 ObjHeader* GCState::get_header(void* ptr) const {
@@ -513,8 +1092,31 @@ ObjHeader* GCState::get_header(void* ptr) const {
 void GCState::get_stats(GCStats* stats_out) const {
     if (!stats_out) return;
     
-    std::lock_guard<std::mutex> lock(gc_mutex);
+    std::unique_lock<std::mutex> lock = lock_gc();
     *stats_out = stats;
+    stats_out->num_threads = threads.size();
+    stats_out->old_gen_size = old_gen ? old_gen->mapped : 0;
+    stats_out->large_objects = 0;
+    stats_out->large_object_bytes = 0;
+    if (old_gen) {
+        for (const Segment* segment : old_gen->bins[SIZE_CLASS_LARGE]) {
+            stats_out->large_objects++;
+            stats_out->large_object_bytes += segment->mapped_size;
+        }
+    }
+    stats_out->marking_in_progress = marking_active.load();
+    stats_out->minor_pause_p50_ns = minor_pauses.percentile(0.50);
+    stats_out->minor_pause_p99_ns = minor_pauses.percentile(0.99);
+    stats_out->minor_pause_p999_ns = minor_pauses.percentile(0.999);
+    stats_out->major_pause_p50_ns = major_pauses.percentile(0.50);
+    stats_out->major_pause_p99_ns = major_pauses.percentile(0.99);
+    stats_out->major_pause_p999_ns = major_pauses.percentile(0.999);
+    
+    // Include the caller's own not-yet-flushed TLAB allocations so a
+    // single-threaded program sees exact totals
+    if (t_context.mutator) {
+        stats_out->total_allocated += t_context.mutator->tlab.allocated;
+    }
 }
 
 } // namespace runtime
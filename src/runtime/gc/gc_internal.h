@@ -8,9 +8,15 @@
  * Architecture:
  * - Generational: Nursery (young) + Old Generation
  * - Nursery: Copying collector with fragmentation tolerance for pinned objects
- * - Old Gen: Mark-sweep collector with malloc-backed allocation
- * - Rooting: Explicit shadow stack (no stack maps)
- * - Barriers: Card table for old-to-young references
+ * - Allocation: Per-thread TLABs carved from the nursery (lock-free fast path)
+ * - Old Gen: Mark-sweep over segregated size-class segments (bitmap sweep),
+ *   optionally compacted after the sweep (pinned objects stay in place)
+ * - Rooting: Explicit per-thread shadow stacks (no stack maps)
+ * - Threads: Mutator registry with safepoint-based stop-the-world
+ * - Major GC: Parallel mark (work stealing) and sweep on a worker pool,
+ *   or concurrent SATB marking on a background thread with a final remark
+ * - Barriers: Per-segment card tables for old-to-young references
+ * - Tracing: Ring buffer of collection events and pause histograms
  * 
  * Reference: research_021_garbage_collection_system.txt
  */
@@ -20,12 +26,70 @@
 
 #include "runtime/gc.h"
 #include <vector>
-#include <unordered_set>
+#include <map>
+#include <cstdint>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <chrono>
+#include <array>
 
 namespace aria {
 namespace runtime {
 
+// =============================================================================
+// Object Layout Helpers
+// =============================================================================
+
+/**
+ * Round a payload size up to the full heap footprint of an object
+ * (header + payload, 8-byte aligned).
+ */
+inline size_t object_total_size(size_t obj_size) {
+    // At least one payload word: evacuation stores the forwarding
+    // address there
+    if (obj_size < sizeof(void*)) {
+        obj_size = sizeof(void*);
+    }
+    return (sizeof(ObjHeader) + obj_size + 7) & ~static_cast<size_t>(7);
+}
+
+/**
+ * Footprint (header + payload) and payload size of an existing object
+ */
+inline size_t object_footprint(const ObjHeader* header) {
+    return static_cast<size_t>(header->size_words) * 8;
+}
+
+inline size_t object_payload_size(const ObjHeader* header) {
+    return object_footprint(header) - sizeof(ObjHeader);
+}
+
+/**
+ * Initialize a freshly carved block as a GC object
+ * 
+ * Writes the header, zeroes the payload and returns the payload pointer.
+ * Shared by every allocation path (TLAB, nursery slow path, old gen).
+ */
+inline void* init_object(void* block, size_t total_size, uint16_t type_id,
+                         bool in_nursery) {
+    ObjHeader* header = static_cast<ObjHeader*>(block);
+    std::memset(header, 0, sizeof(ObjHeader));
+    header->is_nursery = in_nursery ? 1 : 0;
+    header->type_id = type_id;
+    header->size_words = total_size / 8;
+    
+    // Zero-initialize the whole aligned payload (not just the requested
+    // size): the tracer may read reference slots up to the footprint end
+    void* obj_ptr = (char*)block + sizeof(ObjHeader);
+    std::memset(obj_ptr, 0, total_size - sizeof(ObjHeader));
+    return obj_ptr;
+}
+
 // =============================================================================
 // Memory Regions
 // =============================================================================
@@ -35,8 +99,8 @@ namespace runtime {
  * 
  * When objects are pinned during minor GC, the nursery cannot be
  * simply reset. Instead, we track free gaps between pinned objects
- * as fragments. Allocation searches these fragments before falling
- * back to the global bump pointer.
+ * as fragments. Allocation uses these fragments once the global bump
+ * region is exhausted.
  */
 struct Fragment {
     void* start;      // Start address of free region
@@ -47,64 +111,360 @@ struct Fragment {
         : start(s), end(e), size((char*)e - (char*)s) {}
 };
 
+/**
+ * HeapBacking: How GC heap memory is mapped (aria_gc_init flags)
+ * 
+ * - transparent_huge_pages: nursery mappings are 2MB-aligned and both
+ *   the nursery and old generation segments are madvise(MADV_HUGEPAGE)d,
+ *   so the kernel can back them with huge pages (fewer TLB misses)
+ * - explicit_huge_pages: the nursery is mapped MAP_HUGETLB from the
+ *   reserved pool; if none is available it falls back to the above
+ * - numa_nodes: nursery partitions, one per node (1 = no placement)
+ */
+struct HeapBacking {
+    bool transparent_huge_pages = false;
+    bool explicit_huge_pages = false;
+    size_t numa_nodes = 1;
+};
+
+// Highest online NUMA node + 1 (1 without NUMA support)
+size_t online_numa_nodes();
+
+// Node the calling thread is running on (0 if unknown)
+size_t current_numa_node();
+
 /**
  * Nursery: Young generation allocator
  * 
  * Uses a bump pointer allocator for fast O(1) allocation.
- * Degrades to freelist allocation when objects are pinned.
+ * Falls back to size-binned fragments when objects are pinned.
+ * 
+ * Pin tracking: the nursery is divided into fixed BLOCK_SIZE blocks.
+ * A pinned object sets the bit of its header word in pinned_bits and
+ * counts towards its block; blocks with at least one pin are flagged in
+ * pinned_blocks. Enumerating pinned objects visits only flagged blocks,
+ * in address order, so no set or sort is needed.
+ * 
+ * After a minor GC, runs of unpinned blocks and the gaps between pinned
+ * objects become fragments, binned by floor(log2(size)). A request of
+ * size s is served from the lowest non-empty bin >= ceil(log2(s)), found
+ * with one bit scan, so allocation stays O(1) however many objects are
+ * pinned. Gaps smaller than MIN_FRAGMENT are skipped.
+ * 
+ * NUMA placement: with HeapBacking.numa_nodes > 1 the nursery is split
+ * into one bump partition per node, each bound to its node before first
+ * touch. Threads refill their TLABs from the partition of the node they
+ * are running on, so the threads of a node form one allocation group
+ * whose young objects stay in local memory. Collection still treats the
+ * nursery as one region.
  * 
  * Allocation Algorithm:
- * 1. Try bump pointer: if (bump_ptr + size <= end_addr)
- * 2. Try fragments: search fragment_list for suitable gap
- * 3. Trigger minor GC and retry
- * 4. If still failing, trigger major GC or OOM
+ * 1. Try the bump pointer of the caller's partition
+ * 2. Try fragments: first fragment of the smallest bin that must fit
+ * 3. Try the other partitions
+ * 4. Trigger minor GC and retry
+ * 5. If still failing, trigger major GC or OOM
  */
 struct Nursery {
+    static constexpr size_t BLOCK_SHIFT = 15;
+    static constexpr size_t BLOCK_SIZE = size_t(1) << BLOCK_SHIFT;  // 32KB
+    static constexpr size_t BITMAP_WORDS_PER_BLOCK = BLOCK_SIZE / 8 / 64;
+    static constexpr size_t MIN_FRAGMENT = 256;  // Smaller gaps are not reused
+    static constexpr size_t NUM_FRAGMENT_BINS = 64;
+    
+    // One bump region per NUMA node (a single one without NUMA placement)
+    struct Partition {
+        void* start;
+        void* bump_ptr;            // Current allocation pointer
+        void* end;
+    };
+    
     void* start_addr;              // Nursery base address
-    void* bump_ptr;                // Current allocation pointer
     void* end_addr;                // Nursery limit
-    size_t capacity;               // Total size (bytes)
+    size_t capacity;               // Total size (bytes, whole blocks)
     size_t used;                   // Current utilization
+    size_t num_blocks;
+    std::vector<Partition> partitions;
     
-    std::vector<Fragment> fragments;  // Free gaps (when pinned objects exist)
-    std::unordered_set<void*> pinned_objects;  // Pinned object set
+    HeapBacking backing;
+    size_t mapped_size;            // Length of the mapping (>= capacity)
+    bool hugetlb;                  // Backed by explicit huge pages
     
-    Nursery(size_t size);
+    // Pinned objects
+    std::vector<uint64_t> pinned_bits;    // One bit per 8-byte nursery word
+    std::vector<uint32_t> block_pins;     // Pinned objects per block
+    std::vector<uint64_t> pinned_blocks;  // One bit per block with pins
+    size_t num_pinned;
+    
+    Nursery(size_t size, const HeapBacking& backing = HeapBacking());
     ~Nursery();
     
-    // Allocate from nursery (may trigger GC)
-    void* allocate(size_t size, uint16_t type_id);
+    // Allocate from nursery (may trigger GC); node selects the partition
+    void* allocate(size_t size, uint16_t type_id, size_t node = 0);
+    
+    // Carve a raw chunk of [min_size, max_size] bytes for a TLAB.
+    // Returns nullptr if no gap of at least min_size remains.
+    void* allocate_chunk(size_t min_size, size_t max_size, size_t* out_size,
+                         size_t node = 0);
     
     // Reset after minor GC (reconstruct fragments)
     void reset_with_pinned();
     
+    // Remap with a new capacity. Only valid while the nursery holds no
+    // live objects (after a minor GC with nothing pinned).
+    bool resize(size_t new_size);
+    
+    // Track pinning of a nursery object (idempotent)
+    void pin(void* obj_ptr);
+    void unpin(void* obj_ptr);
+    
+    // Call visit(void* obj_ptr) for every pinned object, in address order
+    template <typename Visit>
+    void for_each_pinned(Visit&& visit) const {
+        for (size_t w = 0; w < pinned_blocks.size(); ++w) {
+            for (uint64_t blocks = pinned_blocks[w]; blocks; blocks &= blocks - 1) {
+                size_t block = w * 64 + __builtin_ctzll(blocks);
+                size_t first = block * BITMAP_WORDS_PER_BLOCK;
+                for (size_t i = first; i < first + BITMAP_WORDS_PER_BLOCK; ++i) {
+                    for (uint64_t bits = pinned_bits[i]; bits; bits &= bits - 1) {
+                        size_t word = i * 64 + __builtin_ctzll(bits);
+                        visit(static_cast<char*>(start_addr) + word * 8 + sizeof(ObjHeader));
+                    }
+                }
+            }
+        }
+    }
+    
     // Check if pointer is in nursery
     bool contains(void* ptr) const {
         return ptr >= start_addr && ptr < end_addr;
     }
+    
+private:
+    std::vector<Fragment> fragment_bins[NUM_FRAGMENT_BINS];
+    uint64_t nonempty_bins;        // Bit b set: fragment_bins[b] non-empty
+    
+    // Carve total_size raw bytes (local bump region, fragments, then
+    // the other partitions)
+    void* carve(size_t total_size, size_t node);
+    
+    // Take [min_size, max_size] bytes from a partition's bump region
+    void* bump(Partition& partition, size_t min_size, size_t max_size, size_t* out_size);
+    
+    // (Re)build the partitions over a fresh mapping and bind them to nodes
+    void place_partitions();
+    
+    // Take a fragment of at least min_size bytes out of its bin
+    bool take_fragment(size_t min_size, Fragment* out);
+    void add_fragment(void* start, void* end);
+    void clear_fragments();
+    
+    // Bit index of the header word of obj_ptr in pinned_bits
+    size_t pin_index(void* obj_ptr) const {
+        return (static_cast<size_t>((char*)obj_ptr - (char*)start_addr) - sizeof(ObjHeader)) / 8;
+    }
 };
 
 /**
- * OldGeneration: Tenured object space
+ * TLAB: Thread-local allocation buffer
+ * 
+ * A chunk of the nursery owned by a single mutator thread. Objects are
+ * bump-allocated from [cursor, limit) without taking gc_mutex; the buffer
+ * is only refilled from the nursery (under the lock) when it runs dry.
  * 
- * Uses malloc/free for allocation (relies on system allocator).
- * Tracks all live objects in a vector for mark-sweep collection.
+ * The epoch ties the buffer to one nursery layout. Every collection bumps
+ * GCState's epoch, which invalidates all outstanding buffers without the
+ * collector having to visit other threads.
  */
-struct OldGeneration {
-    std::vector<void*> objects;    // All old gen objects (for sweeping)
-    size_t used;                   // Current utilization (bytes)
-    size_t threshold;              // Major GC trigger threshold
+struct TLAB {
+    static constexpr size_t DEFAULT_SIZE = 32 * 1024;  // Refill chunk size
+    static constexpr size_t MIN_SIZE = 1024;           // Floor for tiny nurseries
     
-    OldGeneration(size_t threshold);
+    char* cursor = nullptr;   // Next free byte
+    char* limit = nullptr;    // End of buffer (exclusive)
+    uint64_t epoch = 0;       // Nursery epoch the buffer was carved in
+    size_t allocated = 0;     // Payload bytes not yet folded into GCStats
     
-    // Allocate in old generation
-    void* allocate(size_t size, uint16_t type_id);
+    // Bump-allocate total_size bytes, or nullptr if the buffer is exhausted
+    void* try_allocate(size_t total_size) {
+        if (static_cast<size_t>(limit - cursor) < total_size) {
+            return nullptr;
+        }
+        void* block = cursor;
+        cursor += total_size;
+        return block;
+    }
+    
+    void reset() {
+        cursor = nullptr;
+        limit = nullptr;
+    }
+};
+
+// =============================================================================
+// Parallel Collection (Worker Pool)
+// =============================================================================
+
+/**
+ * GCWorkerPool: Collector threads for the parallel phases of major GC
+ * 
+ * The thread that runs the collection is worker 0; size() - 1 helper
+ * threads sleep between phases. Helpers are never registered as
+ * mutators: they only run while the world is stopped and never
+ * allocate.
+ */
+class GCWorkerPool {
+public:
+    explicit GCWorkerPool(size_t num_workers);  // Includes the caller
+    ~GCWorkerPool();
     
-    // Add evacuated object from nursery
-    void add_object(void* ptr);
+    GCWorkerPool(const GCWorkerPool&) = delete;
+    GCWorkerPool& operator=(const GCWorkerPool&) = delete;
     
-    // Check if pointer is in old generation
-    bool contains(void* ptr) const;
+    size_t size() const { return num_workers; }
+    
+    // Run task(worker_index) on every worker and wait for all of them
+    void run(const std::function<void(size_t)>& task);
+    
+private:
+    size_t num_workers;
+    std::vector<std::thread> helpers;
+    
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    const std::function<void(size_t)>* current_task = nullptr;
+    uint64_t generation = 0;   // Bumped per run() so helpers see new work
+    size_t running = 0;        // Helpers still executing current_task
+    bool stopping = false;
+    
+    void helper_loop(size_t index);
+};
+
+/**
+ * MarkDeque: Shared half of a marker's work
+ * 
+ * Each marker traces from a private stack and publishes a batch here
+ * when its stack is deep and the deque has run dry; idle markers steal
+ * from the opposite end. Only the owner pushes, so the lock is taken
+ * once per batch rather than once per object.
+ */
+class MarkDeque {
+public:
+    void push_batch(const void* const* objs, size_t count);
+    
+    // Move up to max_count objects into out (owner end / thief end)
+    size_t pop_batch(std::vector<void*>& out, size_t max_count);
+    size_t steal_batch(std::vector<void*>& out, size_t max_count);
+    
+    bool empty() const { return count.load() == 0; }
+    
+private:
+    mutable std::mutex mutex;
+    std::deque<void*> items;
+    std::atomic<size_t> count{0};
+};
+
+// =============================================================================
+// Old Generation (Segregated Size Classes)
+// =============================================================================
+
+/**
+ * Size classes for tenured objects
+ * 
+ * Object footprints (header + payload) are rounded up to one of
+ * NUM_SIZE_CLASSES slot sizes: 8-byte steps up to 64 bytes, then four
+ * classes per power of two up to MAX_SMALL_SIZE. Class indices start at
+ * 1 and are stored in ObjHeader::size_class; 0 means the object is not
+ * in a size-classed segment (nursery object or large object).
+ */
+constexpr size_t NUM_SIZE_CLASSES = 43;
+constexpr size_t MAX_SMALL_SIZE = 32 * 1024;
+constexpr uint8_t SIZE_CLASS_LARGE = 0;
+
+// Smallest class whose slots fit footprint, or SIZE_CLASS_LARGE
+uint8_t size_class_for(size_t footprint);
+
+// Slot size of a class (1..NUM_SIZE_CLASSES)
+size_t size_class_slot_size(uint8_t size_class);
+
+/**
+ * Segment: Aligned block of equally sized slots
+ * 
+ * Small-object segments are SIZE bytes and carved into slots of one
+ * size class. A large object gets a dedicated segment with a single
+ * slot. The first CARD_AREA_SIZE bytes of every segment hold its card
+ * table (see CardTable); slots start right after. Liveness lives in side
+ * bitmaps rather than object headers, so sweeping a segment is a handful
+ * of word operations and never touches object memory:
+ *   alloc_bits - slot holds an object
+ *   mark_bits  - object was reached in the current major GC
+ */
+struct Segment {
+    static constexpr size_t SHIFT = 18;
+    static constexpr size_t SIZE = size_t(1) << SHIFT;  // 256KB, also the alignment
+    static constexpr size_t NO_SLOT = ~size_t(0);
+    static constexpr size_t CARD_AREA_SIZE = 512;  // One byte per 512-byte card
+    
+    char* memory;                  // Mapping start (SIZE-aligned, card table)
+    size_t mapped_size;            // Bytes mapped at memory
+    char* base;                    // First slot
+    size_t slot_size;              // Bytes per slot
+    size_t num_slots;
+    uint8_t size_class;            // SIZE_CLASS_LARGE for dedicated segments
+    size_t live_slots;             // Set bits in alloc_bits
+    size_t alloc_hint;             // Word of alloc_bits to resume searching at
+    std::vector<uint64_t> alloc_bits;
+    std::vector<uint64_t> mark_bits;
+    
+    Segment(char* memory, size_t mapped_size, size_t slot_size, uint8_t size_class);
+    
+    // Claim a free slot, or nullptr if the segment is full
+    void* allocate_slot();
+    
+    // Slot of the object whose payload starts at ptr, or NO_SLOT if ptr
+    // is not the payload address of an allocated object
+    size_t slot_index(const void* ptr) const {
+        const char* p = static_cast<const char*>(ptr);
+        if (p < base + sizeof(ObjHeader)) {
+            return NO_SLOT;
+        }
+        size_t offset = static_cast<size_t>(p - base) - sizeof(ObjHeader);
+        size_t index = offset / slot_size;
+        if (offset % slot_size != 0 || index >= num_slots) {
+            return NO_SLOT;
+        }
+        if (!(alloc_bits[index / 64] & (uint64_t(1) << (index % 64)))) {
+            return NO_SLOT;
+        }
+        return index;
+    }
+    
+    // Free unmarked slots and clear marks; returns the number freed
+    size_t sweep();
+    
+    // Whether any allocated object has pinned_bit set
+    bool has_pinned() const;
+    
+    // Return every page covered only by free slots to the OS
+    // (MADV_DONTNEED; the pages read as zero when reused)
+    void release_free_pages();
+    
+    // Call visit(obj) for each allocated object whose payload starts in
+    // [lo, hi)
+    template <typename Visitor>
+    void for_each_object_in(const char* lo, const char* hi, Visitor&& visit) const {
+        const char* first_payload = base + sizeof(ObjHeader);
+        size_t first = lo <= first_payload
+            ? 0 : (static_cast<size_t>(lo - first_payload) + slot_size - 1) / slot_size;
+        for (size_t i = first; i < num_slots; ++i) {
+            char* payload = base + i * slot_size + sizeof(ObjHeader);
+            if (payload >= hi) break;
+            if (alloc_bits[i / 64] & (uint64_t(1) << (i % 64))) {
+                visit(static_cast<void*>(payload));
+            }
+        }
+    }
 };
 
 // =============================================================================
@@ -114,66 +474,297 @@ struct OldGeneration {
 /**
  * CardTable: Track old-to-young references
  * 
- * Divides the heap into fixed-size cards (512 bytes).
- * Each card is mapped to a byte:
- * - CLEAN (0): No old-to-young references in this card
- * - DIRTY (1): Card may contain old-to-young references
+ * Each old generation segment is divided into 512-byte cards, and the
+ * segment's first CARD_AREA_SIZE bytes hold one byte per card:
+ * - CLEAN (0): No object starting in this card references the nursery
+ * - DIRTY (1): Objects starting in this card may reference the nursery
  * 
- * During minor GC, DIRTY cards in old generation are scanned
- * to find additional roots for nursery tracing.
+ * Two levels: card 0 covers the card area itself, which never holds an
+ * object, so its byte doubles as the segment summary ("some card in this
+ * segment is dirty"). Minor GC skips clean segments with one byte test
+ * and scans dirty ones 8 cards per word, so its cost follows the number
+ * of dirty cards rather than the heap size.
+ * 
+ * Because the table is found by masking the object address, marking a
+ * card needs no lookup: two byte stores, cheap enough to inline.
+ * Cards are cleared as they are scanned and re-dirtied if an object in
+ * them still references the nursery (a pinned object).
  */
-class CardTable {
-public:
+struct CardTable {
     static constexpr size_t CARD_SIZE = 512;  // Bytes per card
     static constexpr size_t CARD_SHIFT = 9;   // log2(512)
+    static constexpr size_t CARDS_PER_SEGMENT = Segment::SIZE / CARD_SIZE;
+    static constexpr size_t SUMMARY_CARD = 0;
     
     static constexpr uint8_t CARD_CLEAN = 0;
     static constexpr uint8_t CARD_DIRTY = 1;
     
-    CardTable(void* heap_start, size_t heap_size);
-    ~CardTable();
+    static_assert(CARDS_PER_SEGMENT == Segment::CARD_AREA_SIZE,
+                  "Card area must hold one byte per card");
+    static_assert(Segment::SIZE == ARIA_GC_SEGMENT_SIZE &&
+                  CARD_SHIFT == ARIA_GC_CARD_SHIFT && CARD_DIRTY == ARIA_GC_CARD_DIRTY,
+                  "Inline barrier protocol in gc.h must match the card layout");
+    
+    // Card bytes of the segment containing an old generation object
+    static uint8_t* cards_of(const void* obj) {
+        return reinterpret_cast<uint8_t*>(
+            reinterpret_cast<uintptr_t>(obj) & ~(Segment::SIZE - 1));
+    }
+    
+    // Mark the card of an old generation object (write barrier)
+    static void mark_dirty(const void* obj) {
+        uint8_t* cards = cards_of(obj);
+        size_t card = (reinterpret_cast<uintptr_t>(obj) & (Segment::SIZE - 1)) >> CARD_SHIFT;
+        cards[card] = CARD_DIRTY;
+        cards[SUMMARY_CARD] = CARD_DIRTY;
+    }
+};
+
+/**
+ * SegmentMap: O(1) address -> Segment side table
+ * 
+ * Two-level radix table indexed by address >> Segment::SHIFT over a
+ * 48-bit address space. Leaves are allocated on first use. A large
+ * segment spanning several SIZE-aligned chunks is entered for each one.
+ */
+class SegmentMap {
+public:
+    SegmentMap();
+    ~SegmentMap();
+    
+    SegmentMap(const SegmentMap&) = delete;
+    SegmentMap& operator=(const SegmentMap&) = delete;
     
-    // Mark card as dirty (write barrier)
-    void mark_dirty(void* addr);
+    Segment* lookup(const void* ptr) const {
+        uintptr_t chunk = reinterpret_cast<uintptr_t>(ptr) >> Segment::SHIFT;
+        if (chunk >> INDEX_BITS) {
+            return nullptr;  // Outside the mapped address range
+        }
+        Segment** leaf = leaves[chunk >> LEAF_BITS];
+        return leaf ? leaf[chunk & (LEAF_SIZE - 1)] : nullptr;
+    }
     
-    // Get dirty cards for scanning
-    std::vector<void*> get_dirty_cards();
+    void insert(Segment* segment);
+    void erase(Segment* segment);
     
-    // Clear all cards (after GC)
-    void clear();
+private:
+    static constexpr size_t ADDRESS_BITS = 48;
+    static constexpr size_t INDEX_BITS = ADDRESS_BITS - Segment::SHIFT;
+    static constexpr size_t LEAF_BITS = INDEX_BITS / 2;
+    static constexpr size_t LEAF_SIZE = size_t(1) << LEAF_BITS;
+    static constexpr size_t ROOT_SIZE = size_t(1) << (INDEX_BITS - LEAF_BITS);
+    
+    std::vector<Segment**> leaves;  // ROOT_SIZE entries, nullptr = no leaf
+    
+    void set(Segment* segment, Segment* value);
+};
+
+/**
+ * OldGeneration: Tenured object space
+ * 
+ * Segregated-fit heap: each size class owns a list of segments, and
+ * objects are placed in the first segment of their class with a free
+ * slot. Containment, marking and sweeping go through the segment side
+ * table and bitmaps, so they cost O(1) per object (O(1) per 64 slots
+ * for sweeping) regardless of how many objects are tenured.
+ * 
+ * With ARIA_GC_COMPACT, sparse segments are emptied into denser ones of
+ * their class after each sweep. Released segments are madvise(
+ * MADV_DONTNEED)d and a few of them kept mapped for reuse.
+ */
+struct OldGeneration {
+    size_t used;                   // Bytes in allocated slots
+    size_t mapped;                 // Bytes mapped by segments in the bins
+    size_t threshold;              // Major GC trigger threshold
+    bool allocate_black;           // Mark new objects (concurrent marking)
+    bool huge_pages;               // madvise new segments MADV_HUGEPAGE
+    size_t segments_released;      // Segments returned to the OS so far
+    
+    // bins[c] = segments of size class c; bins[0] = large-object space,
+    // one dedicated span per object, marked and swept like the others
+    std::vector<Segment*> bins[NUM_SIZE_CLASSES + 1];
+    size_t bin_cursor[NUM_SIZE_CLASSES + 1];  // First segment that may have room
+    SegmentMap segment_map;
+    
+    // Released small-segment mappings, pages already given back with
+    // MADV_DONTNEED; reused before mapping new ones
+    static constexpr size_t MAX_FREE_SEGMENTS = 16;
+    std::vector<char*> free_segments;
+    
+    // Segments emptied by evacuate_sparse_segments(), awaiting release
+    std::vector<Segment*> evacuated;
+    
+    OldGeneration(size_t threshold);
+    ~OldGeneration();
+    
+    // Allocate in old generation
+    void* allocate(size_t size, uint16_t type_id);
+    
+    // Check if pointer is the payload address of an old generation object
+    bool contains(void* ptr) const {
+        Segment* segment = segment_map.lookup(ptr);
+        return segment && segment->slot_index(ptr) != Segment::NO_SLOT;
+    }
+    
+    // Set the mark bit of an old generation object; false if ptr is not
+    // an old generation object or was already marked. Safe to call from
+    // several markers at once.
+    bool mark(void* ptr);
+    
+    // Free every unmarked object and release empty segments; returns
+    // bytes freed. Segments are swept concurrently on the pool.
+    size_t sweep(GCWorkerPool& pool);
+    
+    // Clear every dirty card and call visit(obj) for each object starting
+    // in one; returns the number of dirty cards
+    size_t scan_dirty_cards(const std::function<void(void*)>& visit);
+    
+    // Compaction, right after sweep(): move the objects of the sparsest
+    // segments of each size class into free slots of denser ones. Moved
+    // objects keep their old slot, marked forwarded, until
+    // release_evacuated(). Segments with a pinned object never move.
+    // Returns bytes moved.
+    size_t evacuate_sparse_segments();
+    
+    // New address of an evacuated object, else ptr unchanged
+    void* forwarding_address(void* ptr) const {
+        Segment* segment = segment_map.lookup(ptr);
+        if (!segment || segment->slot_index(ptr) == Segment::NO_SLOT) {
+            return ptr;
+        }
+        const ObjHeader* header = reinterpret_cast<const ObjHeader*>(
+            static_cast<char*>(ptr) - sizeof(ObjHeader));
+        return header->forwarded_bit ? *static_cast<void**>(ptr) : ptr;
+    }
+    
+    // Release the segments emptied by evacuate_sparse_segments() once no
+    // reference to their old objects remains
+    void release_evacuated();
+    
+    // Call visit(obj) for every object in the bins; segments are handed
+    // out to the pool's workers one at a time
+    void for_each_object(GCWorkerPool& pool, const std::function<void(void*)>& visit);
     
 private:
-    uint8_t* cards;       // Card array
-    size_t num_cards;     // Array length
-    void* heap_start;     // Heap base for offset calculation
+    Segment* create_segment(uint8_t size_class, size_t slot_size, size_t mapped_size);
+    void release_segment(Segment* segment);
 };
 
 // =============================================================================
-// Shadow Stack (Root Tracking)
+// Type Layouts (Precise Tracing)
 // =============================================================================
 
 /**
- * ShadowFrame: Stack frame for GC roots
+ * TypeLayout: Reference map for one type_id
  * 
- * Tracks root addresses for a single function activation.
+ * Bit i of ptr_bitmap is set if the word at byte offset i*8 of an
+ * instance holds a GC reference. Payloads larger than size are treated
+ * as arrays of instances and the map repeats.
  */
-struct ShadowFrame {
-    std::vector<void**> roots;  // Root addresses (e.g., &local_var)
-    ShadowFrame* prev;          // Previous frame (linked list)
+struct TypeLayout {
+    size_t size = 0;                   // Instance size in bytes
+    std::vector<uint64_t> ptr_bitmap;  // One bit per word, LSB first
+};
+
+/**
+ * TypeRegistry: type_id -> TypeLayout
+ * 
+ * Indexed directly by type_id; ID 0 is the leaf type and has no entry.
+ * Mutated only under gc_mutex. Layouts live in fixed-size chunks that
+ * never move, so the concurrent marker can look them up without the
+ * lock while new types are being registered.
+ */
+class TypeRegistry {
+public:
+    TypeRegistry() = default;
+    ~TypeRegistry();
     
-    ShadowFrame(ShadowFrame* p) : prev(p) {}
+    TypeRegistry(const TypeRegistry&) = delete;
+    TypeRegistry& operator=(const TypeRegistry&) = delete;
+    
+    // Returns an existing ID for an identical layout, or assigns a new one
+    uint16_t register_type(size_t size, const uint64_t* ptr_bitmap);
+    
+    // nullptr for leaf or unknown types
+    const TypeLayout* lookup(uint16_t type_id) const {
+        if (type_id == ARIA_GC_TYPE_LEAF ||
+            type_id >= num_layouts.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        const TypeLayout* chunk =
+            chunks[type_id / CHUNK_SIZE].load(std::memory_order_acquire);
+        return &chunk[type_id % CHUNK_SIZE];
+    }
+    
+    // Call visit(void** slot) for every reference slot of an object
+    template <typename Visitor>
+    void for_each_slot(void* obj, const ObjHeader* header, Visitor&& visit) const {
+        const TypeLayout* layout = lookup(header->type_id);
+        if (!layout || layout->size == 0) {
+            return;
+        }
+        
+        size_t payload = object_payload_size(header);
+        for (size_t base = 0; base < payload; base += layout->size) {
+            for (size_t w = 0; w < layout->ptr_bitmap.size(); ++w) {
+                uint64_t bits = layout->ptr_bitmap[w];
+                while (bits) {
+                    size_t word = w * 64 + __builtin_ctzll(bits);
+                    bits &= bits - 1;
+                    
+                    size_t offset = base + word * 8;
+                    if (offset + sizeof(void*) > payload) {
+                        return;  // Partial trailing element
+                    }
+                    visit(reinterpret_cast<void**>((char*)obj + offset));
+                }
+            }
+        }
+    }
+    
+private:
+    static constexpr size_t CHUNK_SIZE = 256;
+    static constexpr size_t NUM_CHUNKS = (size_t(ARIA_GC_TYPE_INVALID) + CHUNK_SIZE) / CHUNK_SIZE;
+    
+    std::atomic<TypeLayout*> chunks[NUM_CHUNKS] = {};
+    std::atomic<size_t> num_layouts{1};  // [0] = leaf placeholder
+    std::map<std::vector<uint64_t>, uint16_t> ids_by_layout;  // key: size + bitmap
 };
 
+// =============================================================================
+// Shadow Stack (Root Tracking)
+// =============================================================================
+
+/**
+ * DynamicFrame: Shadow frame for the aria_shadow_stack_* API
+ * 
+ * Frames emitted by the compiler live in the caller's stack memory and
+ * hold the roots themselves (see AriaShadowFrame in gc.h). Runtime C
+ * code that cannot lay out a frame in advance uses the push/add_root
+ * API instead, which links one of these into the same chain. They hold
+ * root addresses and are recycled per thread, so steady-state use does
+ * not allocate.
+ */
+struct DynamicFrame {
+    AriaShadowFrame header;        // flags = SHADOW_FRAME_DYNAMIC
+    std::vector<void**> roots;     // Root addresses (e.g., &local_var)
+};
+
+constexpr uint32_t SHADOW_FRAME_DYNAMIC = 0x1u;
+
 /**
  * ShadowStack: Thread-local root tracking
  * 
- * Maintains a linked list of shadow frames, one per active function
- * that has GC-managed locals. The GC scans this structure to find
- * all roots during collection.
+ * A view of one thread's frame chain, which starts at that thread's
+ * aria_shadow_stack_top. Compiled functions link and unlink their
+ * frames inline; the collector walks the chain in place and updates
+ * root slots directly.
+ * 
+ * Must be constructed on the thread it describes.
  */
 class ShadowStack {
 public:
-    ShadowStack() : top(nullptr) {}
+    ShadowStack() : top(&aria_shadow_stack_top) {}
     ~ShadowStack();
     
     void push_frame();
@@ -181,11 +772,155 @@ public:
     void add_root(void** root_addr);
     void remove_root(void** root_addr);
     
-    // Get all roots for GC scanning
-    std::vector<void**> get_all_roots() const;
+    // Call visit(void** root_addr) for every root of this stack
+    template <typename Visit>
+    void for_each_root(Visit&& visit) const {
+        for (AriaShadowFrame* frame = *top; frame != nullptr; frame = frame->prev) {
+            if (frame->flags & SHADOW_FRAME_DYNAMIC) {
+                for (void** root_addr : reinterpret_cast<DynamicFrame*>(frame)->roots) {
+                    visit(root_addr);
+                }
+            } else {
+                void** slots = reinterpret_cast<void**>(frame + 1);
+                for (uint32_t i = 0; i < frame->num_roots; ++i) {
+                    visit(&slots[i]);
+                }
+            }
+        }
+    }
     
 private:
-    ShadowFrame* top;  // Current frame (top of stack)
+    AriaShadowFrame** top;                  // The owning thread's chain head
+    std::vector<DynamicFrame*> free_frames; // Popped dynamic frames for reuse
+};
+
+// =============================================================================
+// Mutator Threads (Safepoints)
+// =============================================================================
+
+/**
+ * MutatorState: Where a registered thread stands relative to the collector
+ * 
+ * - RUNNING: Executing Aria code; may touch the heap at any moment
+ * - AT_SAFEPOINT: Parked in aria_gc_safepoint until the collection ends
+ * - BLOCKED: In a blocking call (join, lock, sleep, ...) that does not
+ *   touch the heap; the collector may proceed without waiting for it
+ */
+enum MutatorState : int {
+    MUTATOR_RUNNING = 0,
+    MUTATOR_AT_SAFEPOINT = 1,
+    MUTATOR_BLOCKED = 2
+};
+
+/**
+ * MutatorThread: Per-thread GC context
+ * 
+ * Created the first time a thread touches the GC (allocation or shadow
+ * stack operation) and destroyed at thread exit. Holds everything the
+ * collector needs from the thread: its roots, its allocation buffer and
+ * its safepoint state.
+ */
+struct MutatorThread {
+    ShadowStack shadow_stack;          // This thread's roots
+    TLAB tlab;                         // This thread's allocation buffer
+    std::atomic<int> state{MUTATOR_RUNNING};
+    int blocking_depth = 0;            // Nesting of enter_blocking calls
+    std::vector<void*> satb_buffer;    // Overwritten references (concurrent marking)
+};
+
+// =============================================================================
+// Tracing
+// =============================================================================
+
+enum class GCEventKind : uint8_t {
+    MINOR_PAUSE,       // Stop-the-world pause that only ran a minor GC
+    MAJOR_PAUSE,       // Pause that ran, started or finished a major GC
+    MINOR_GC,          // Nursery evacuation
+    CARD_SCAN,         // Dirty card scan within a minor GC
+    MAJOR_GC,          // Stop-the-world mark and sweep
+    CONCURRENT_MARK    // Initial pause to end of remark (concurrent mode)
+};
+
+/**
+ * GCEvent: One timed collector phase
+ * 
+ * Fields that do not apply to the kind are zero.
+ */
+struct GCEvent {
+    GCEventKind kind;
+    uint64_t start_ns;         // Relative to GCTrace::epoch
+    uint64_t duration_ns;
+    uint64_t promoted_bytes;   // MINOR_GC
+    uint64_t freed_bytes;      // MAJOR_GC, CONCURRENT_MARK
+    uint64_t pinned_objects;   // MINOR_GC
+    uint64_t dirty_cards;      // CARD_SCAN
+    uint64_t old_gen_used;     // After the phase
+};
+
+/**
+ * GCTrace: Fixed-size ring of the most recent collector events
+ * 
+ * Always on: an event is a handful of stores per collection. Older
+ * events are overwritten once the ring is full. Guarded by gc_mutex.
+ */
+class GCTrace {
+public:
+    static constexpr size_t CAPACITY = 4096;
+    
+    GCTrace() : events(CAPACITY), next(0), recorded(0),
+                epoch(std::chrono::steady_clock::now()) {}
+    
+    // Zeroed slot for a phase that began at start; the caller fills in
+    // the kind-specific fields
+    GCEvent& append(GCEventKind kind, std::chrono::steady_clock::time_point start,
+                    uint64_t duration_ns);
+    
+    // Events oldest first
+    std::vector<GCEvent> snapshot() const;
+    uint64_t dropped() const { return recorded > CAPACITY ? recorded - CAPACITY : 0; }
+    
+    void clear();
+    
+private:
+    std::vector<GCEvent> events;
+    size_t next;               // Slot the next event goes to
+    uint64_t recorded;         // Events appended since clear()
+    std::chrono::steady_clock::time_point epoch;
+};
+
+/**
+ * PauseHistogram: HDR-style log-linear histogram of durations
+ * 
+ * Values below SUB_BUCKETS nanoseconds get exact buckets. Above that,
+ * each power of two is split into SUB_BUCKETS / 2 linear buckets, each
+ * at most 1 / 16 of its lower bound wide. Every recorded value is
+ * reported within ~6% (1 / 16) while the whole 64-bit range fits in a
+ * fixed array. Recording is O(1).
+ */
+class PauseHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t NUM_BUCKETS = (64 - SUB_BUCKET_BITS + 2) * (SUB_BUCKETS / 2);
+    
+    PauseHistogram() { clear(); }
+    
+    void record(uint64_t value_ns);
+    
+    // Smallest recorded-bucket upper bound covering fraction p of the
+    // values (0 if empty), capped at the largest value recorded
+    uint64_t percentile(double p) const;
+    
+    uint64_t count() const { return total; }
+    void clear();
+    
+private:
+    std::array<uint64_t, NUM_BUCKETS> buckets;
+    uint64_t total;
+    uint64_t max_value;
+    
+    static size_t bucket_index(uint64_t value);
+    static uint64_t bucket_upper_bound(size_t index);
 };
 
 // =============================================================================
@@ -202,7 +937,8 @@ class GCState {
 public:
     static GCState& instance();
     
-    void init(size_t nursery_size, size_t old_gen_threshold);
+    void init(size_t nursery_size, size_t old_gen_threshold, size_t num_gc_threads,
+              uint32_t flags);
     void shutdown();
     
     // Allocation
@@ -221,16 +957,52 @@ public:
     void add_root(void** root_addr);
     void remove_root(void** root_addr);
     
-    // Write barrier
+    // Thread registry and safepoints
+    MutatorThread* current_thread();   // Registers the caller on first use
+    void unregister_thread();
+    void safepoint_poll() {
+        if (safepoint_requested.load(std::memory_order_relaxed)) {
+            safepoint_slow();
+        }
+    }
+    void enter_blocking() const;
+    void leave_blocking();
+    
+    // Write barriers
     void write_barrier(void* obj, void* ref);
+    void set_marking_active(bool active) {
+        marking_active.store(active);
+        aria_gc_satb_active = active ? 1 : 0;  // Read by inline barriers
+    }
+    void write_barrier_pre(void** slot) {
+        // SATB: while marking, remember the reference about to be lost
+        if (marking_active.load(std::memory_order_relaxed)) {
+            satb_enqueue(*slot);
+        }
+    }
+    
+    // Type layouts
+    uint16_t register_type(size_t size, const uint64_t* ptr_bitmap);
+    
+    // Tuning
+    void set_policy(const GCPolicy& new_policy);
+    void get_policy(GCPolicy* out) const;
     
     // Queries
     bool is_heap_pointer(void* ptr) const;
     ObjHeader* get_header(void* ptr) const;
     void get_stats(GCStats* stats) const;
+    bool dump_trace(const char* path) const;
     
 private:
-    GCState() : initialized(false), collecting(false) {}
+    GCState() : initialized(false), collecting(false), tlab_epoch(0),
+                nursery(nullptr), old_gen(nullptr),
+                workers(nullptr), concurrent_mode(false), compact_mode(false),
+                marking_active(false),
+                next_major_trigger(0), cycles_completed(0),
+                policy(), minor_promoted(0), cycle_promoted(0),
+                marker_wakeup(false), marker_stop(false),
+                safepoint_requested(false) {}
     ~GCState() { shutdown(); }
     
     // No copy/move
@@ -240,25 +1012,122 @@ private:
     bool initialized;
     bool collecting;  // GC in progress flag
     
+    // Bumped whenever the nursery layout changes (collection, init, shutdown);
+    // TLABs carved under an older epoch are discarded on their next use.
+    std::atomic<uint64_t> tlab_epoch;
+    size_t tlab_size;  // Refill chunk size for this nursery
+    HeapBacking backing;
+    
     Nursery* nursery;
     OldGeneration* old_gen;
-    CardTable* card_table;
     
-    // Thread-local shadow stacks (for now, single-threaded)
-    ShadowStack shadow_stack;
+    // Collector threads for parallel mark and sweep
+    GCWorkerPool* workers;
+    
+    // Concurrent marking (ARIA_GC_CONCURRENT_MARK). mark_stack holds the
+    // gray set between the initial pause and the remark pause and is
+    // touched only by the marker thread or by a paused collector.
+    bool concurrent_mode;
+    bool compact_mode;                 // ARIA_GC_COMPACT
+    std::atomic<bool> marking_active;  // SATB barrier enabled
+    size_t next_major_trigger;         // old_gen->used that starts a major GC
+    uint64_t cycles_completed;         // Finished major GCs (guarded by gc_mutex)
+    std::condition_variable cycle_cv;  // Signalled when a major GC finishes
+    std::chrono::steady_clock::time_point cycle_start;
+    
+    // Adaptive sizing (guarded by gc_mutex)
+    GCPolicy policy;
+    size_t minor_promoted;             // Bytes evacuated by the running minor GC
+    size_t cycle_promoted;             // Bytes promoted since marking started
+    
+    std::thread marker_thread;
+    std::mutex marker_mutex;
+    std::condition_variable marker_cv;
+    bool marker_wakeup;
+    std::atomic<bool> marker_stop;
+    
+    std::mutex satb_mutex;
+    std::vector<void*> satb_queue;     // Flushed SATB buffers
+    
+    // Registered mutator threads (guarded by gc_mutex)
+    std::vector<MutatorThread*> threads;
+    
+    // Reference maps for precise tracing (guarded by gc_mutex)
+    TypeRegistry types;
+    
+    // Explicit mark stack (reused across collections)
+    std::vector<void*> mark_stack;
     
     // Statistics
     GCStats stats;
     
+    // Event history and pause distributions (guarded by gc_mutex)
+    GCTrace trace;
+    PauseHistogram minor_pauses;
+    PauseHistogram major_pauses;
+    
     // Synchronization
     mutable std::mutex gc_mutex;
     
+    // Safepoint handshake: the collector raises the flag while holding
+    // gc_mutex; mutators park on safepoint_cv until it is cleared
+    std::atomic<bool> safepoint_requested;
+    mutable std::mutex safepoint_mutex;
+    mutable std::condition_variable safepoint_cv;
+    
+    void safepoint_slow();
+    std::unique_lock<std::mutex> lock_gc() const;
+    void stop_the_world();
+    void resume_the_world();
+    
+    // Lock-held halves of the public entry points
+    void init_locked(size_t nursery_size, size_t old_gen_threshold, size_t num_gc_threads,
+                     uint32_t flags);
+    void* alloc_slow(TLAB& tlab, size_t size, size_t total_size, uint16_t type_id);
+    void* alloc_large(size_t size, uint16_t type_id);  // Large-object space
+    void* refill_and_allocate(TLAB& tlab, size_t total_size, size_t node);
+    void flush_tlab_stats(TLAB& tlab);
+    void invalidate_tlabs();
+    MutatorThread* register_thread_locked();
+    
     // Collection helpers
-    void mark_object(void* ptr);
+    void collect_locked(bool full);   // Stop-the-world wrapper around minor/major GC
+    void run_pause(const std::function<void()>& body);  // Stop the world, run body, record the pause
+    void full_gc();                   // Major GC, or finish the concurrent cycle
+    void maybe_start_major();         // Old gen over its trigger after a minor GC
+    void finish_major_cycle();
+    template <typename Visit>
+    void for_each_root(Visit&& visit) const {
+        for (const MutatorThread* thread : threads) {
+            thread->shadow_stack.for_each_root(visit);
+        }
+    }
+    bool is_heap_pointer_locked(void* ptr) const;
+    void mark_object(void* ptr);      // Mark and push onto mark_stack
+    void drain_mark_stack();
+    void parallel_mark();             // Drain mark_stack on every worker
+    
+    // Concurrent marking
+    void start_concurrent_mark();     // Initial pause: shade roots, enable SATB
+    bool concurrent_mark_step();      // Marker: drain gray set; false when done
+    void finish_concurrent_mark();    // Remark pause: drain SATB, sweep
+    void marker_loop();
+    void stop_marker();
+    void satb_enqueue(void* old_ref);
+    void flush_satb_buffer(MutatorThread* thread);
+    void drain_satb_queue();
+    
+    // Adaptive sizing (policy.cpp)
+    void apply_environment(size_t& nursery_size, size_t& old_gen_threshold,
+                           size_t& num_gc_threads, uint32_t& flags) const;
+    void init_backing(uint32_t flags);
+    void init_policy(size_t nursery_size);
+    void adapt_nursery(size_t nursery_used_before);  // End of minor GC
+    void update_major_trigger();                     // End of major GC
+    
     void sweep_old_gen();
-    void evacuate_nursery();
+    void compact_old_gen();            // ARIA_GC_COMPACT, after sweep_old_gen
     void* evacuate_object(void* ptr);  // Copy to old gen
-    void scan_roots();
 };
 
 } // namespace runtime
@@ -0,0 +1,226 @@
+/**
+ * Aria GC Parallel Collection
+ *
+ * This file implements the collector worker pool and the parallel mark
+ * phase of major GC:
+ * - GCWorkerPool: Persistent helper threads, woken once per phase
+ * - MarkDeque: Batch-granular work-stealing deques
+ * - GCState::parallel_mark: Work-stealing transitive closure with
+ *   idle-counter termination
+ *
+ * Parallel sweep lives with the segment code (OldGeneration::sweep).
+ *
+ * Reference: research_021_garbage_collection_system.txt
+ */
+
+#include "gc_internal.h"
+#include <algorithm>
+
+namespace aria {
+namespace runtime {
+
+// =============================================================================
+// GCWorkerPool Implementation
+// =============================================================================
+
+GCWorkerPool::GCWorkerPool(size_t num_workers)
+    : num_workers(std::max<size_t>(num_workers, 1)) {
+    helpers.reserve(this->num_workers - 1);
+    for (size_t i = 1; i < this->num_workers; ++i) {
+        helpers.emplace_back(&GCWorkerPool::helper_loop, this, i);
+    }
+}
+
+GCWorkerPool::~GCWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    start_cv.notify_all();
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+}
+
+void GCWorkerPool::run(const std::function<void(size_t)>& task) {
+    if (helpers.empty()) {
+        task(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current_task = &task;
+        running = helpers.size();
+        generation++;
+    }
+    start_cv.notify_all();
+
+    task(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [this] { return running == 0; });
+    current_task = nullptr;
+}
+
+void GCWorkerPool::helper_loop(size_t index) {
+    uint64_t seen = 0;
+
+    for (;;) {
+        const std::function<void(size_t)>* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start_cv.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            task = current_task;
+        }
+
+        (*task)(index);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--running == 0) {
+            done_cv.notify_one();
+        }
+    }
+}
+
+// =============================================================================
+// MarkDeque Implementation
+// =============================================================================
+
+void MarkDeque::push_batch(const void* const* objs, size_t n) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < n; ++i) {
+        items.push_back(const_cast<void*>(objs[i]));
+    }
+    count.store(items.size());
+}
+
+size_t MarkDeque::pop_batch(std::vector<void*>& out, size_t max_count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t n = std::min(max_count, items.size());
+    for (size_t i = 0; i < n; ++i) {
+        out.push_back(items.back());
+        items.pop_back();
+    }
+    count.store(items.size());
+    return n;
+}
+
+size_t MarkDeque::steal_batch(std::vector<void*>& out, size_t max_count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // Take half, so a single large batch spreads across several thieves
+    size_t n = std::min(max_count, (items.size() + 1) / 2);
+    for (size_t i = 0; i < n; ++i) {
+        out.push_back(items.front());
+        items.pop_front();
+    }
+    count.store(items.size());
+    return n;
+}
+
+// =============================================================================
+// Parallel Mark
+// =============================================================================
+
+namespace {
+
+constexpr size_t PUBLISH_THRESHOLD = 64;  // Private depth before sharing
+constexpr size_t BATCH_SIZE = 128;        // Max objects moved per steal
+
+} // namespace
+
+void GCState::parallel_mark() {
+    /**
+     * Parallel transitive closure over the old generation
+     *
+     * The serially marked roots in mark_stack are dealt round-robin into
+     * the workers' deques. Each worker then repeatedly:
+     * 1. Traces objects from its private stack, marking children with an
+     *    atomic fetch-or on the segment mark bitmap (the winner of the
+     *    race pushes the child, so every object is traced exactly once)
+     * 2. Publishes half of its stack when the stack is deep and its
+     *    deque is empty, so idle workers have something to steal
+     * 3. Refills from its own deque, then steals from the others
+     *
+     * Termination: a worker that finds no work anywhere increments
+     * idle_workers and watches the deques. Work can only be published by
+     * a non-idle worker, so once every worker is idle all deques are
+     * empty and the closure is complete.
+     *
+     * Nursery children are skipped: after the preceding minor GC the only
+     * live nursery objects are pinned, and those were marked as roots.
+     */
+
+    size_t num_workers = workers->size();
+    std::vector<MarkDeque> deques(num_workers);
+
+    for (size_t i = 0; i < mark_stack.size(); ++i) {
+        deques[i % num_workers].push_batch(&mark_stack[i], 1);
+    }
+    mark_stack.clear();
+
+    std::atomic<size_t> idle_workers{0};
+
+    workers->run([&](size_t self) {
+        std::vector<void*> local;
+        local.reserve(BATCH_SIZE * 2);
+
+        auto visit = [&](void** slot) {
+            void* child = *slot;
+            if (child && !nursery->contains(child) && old_gen->mark(child)) {
+                local.push_back(child);
+            }
+        };
+
+        auto find_work = [&]() {
+            if (deques[self].pop_batch(local, BATCH_SIZE)) {
+                return true;
+            }
+            for (size_t n = 1; n < num_workers; ++n) {
+                if (deques[(self + n) % num_workers].steal_batch(local, BATCH_SIZE)) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        for (;;) {
+            while (!local.empty()) {
+                void* obj_ptr = local.back();
+                local.pop_back();
+                types.for_each_slot(obj_ptr, get_header(obj_ptr), visit);
+
+                if (local.size() > PUBLISH_THRESHOLD && deques[self].empty()) {
+                    size_t half = local.size() / 2;
+                    deques[self].push_batch(local.data(), half);
+                    local.erase(local.begin(), local.begin() + half);
+                }
+            }
+
+            if (find_work()) {
+                continue;
+            }
+
+            // Out of work: wait for someone to publish, or for everyone
+            // to run dry
+            idle_workers.fetch_add(1);
+            for (;;) {
+                if (idle_workers.load() == num_workers) {
+                    return;
+                }
+                bool available = std::any_of(deques.begin(), deques.end(),
+                    [](const MarkDeque& deque) { return !deque.empty(); });
+                if (available) {
+                    idle_workers.fetch_sub(1);
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        }
+    });
+}
+
+} // namespace runtime
+} // namespace aria
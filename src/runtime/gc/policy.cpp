@@ -0,0 +1,248 @@
+/**
+ * Aria GC Adaptive Sizing
+ *
+ * This file implements the tuning surface of the collector:
+ * - ARIA_GC_* environment overrides, read once at initialization
+ * - Heap backing (huge pages, NUMA partitions) from the init flags
+ * - GCPolicy defaults, validation and aria_gc_set_policy
+ * - Nursery resizing from the survival rate and pause time of each
+ *   minor GC
+ * - The major GC trigger, from the live size after each major GC and
+ *   the promotion volume of the last concurrent cycle
+ *
+ * Reference: research_021_garbage_collection_system.txt
+ */
+
+#include "gc_internal.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cerrno>
+
+namespace aria {
+namespace runtime {
+
+namespace {
+
+constexpr size_t MIN_OLD_GEN_THRESHOLD = 1024 * 1024;  // Floor for ARIA_GC_OLD_THRESHOLD
+
+// Compiled code relies on this bound to skip barriers (see gc.h)
+static_assert(MAX_SMALL_SIZE == ARIA_GC_MIN_LARGE_OBJECT_SIZE,
+              "large_object_size is clamped to the public minimum");
+
+/**
+ * Parse a byte count with an optional K/M/G suffix ("64M").
+ * Returns false if the variable is unset or malformed.
+ */
+bool env_size(const char* name, size_t* out) {
+    const char* text = std::getenv(name);
+    if (!text || !*text) {
+        return false;
+    }
+
+    errno = 0;
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text, &end, 10);
+    if (errno != 0 || end == text) {
+        return false;
+    }
+
+    switch (*end) {
+        case 'k': case 'K': value <<= 10; ++end; break;
+        case 'm': case 'M': value <<= 20; ++end; break;
+        case 'g': case 'G': value <<= 30; ++end; break;
+        default: break;
+    }
+    if (*end != '\0') {
+        return false;
+    }
+
+    *out = static_cast<size_t>(value);
+    return true;
+}
+
+bool env_double(const char* name, double* out) {
+    const char* text = std::getenv(name);
+    if (!text || !*text) {
+        return false;
+    }
+
+    char* end = nullptr;
+    double value = std::strtod(text, &end);
+    if (end == text || *end != '\0') {
+        return false;
+    }
+
+    *out = value;
+    return true;
+}
+
+void clamp_policy(GCPolicy& policy) {
+    policy.min_nursery_size = std::max(policy.min_nursery_size, Nursery::BLOCK_SIZE);
+    policy.max_nursery_size = std::max(policy.max_nursery_size, policy.min_nursery_size);
+    policy.survival_target = std::min(std::max(policy.survival_target, 0.0), 1.0);
+    policy.major_growth_factor = std::max(policy.major_growth_factor, 1.0);
+    if (policy.large_object_size) {
+        // Smaller objects share old generation segments and fit a TLAB
+        policy.large_object_size = std::max(policy.large_object_size, MAX_SMALL_SIZE);
+    }
+}
+
+} // namespace
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+void GCState::apply_environment(size_t& nursery_size, size_t& old_gen_threshold,
+                                size_t& num_gc_threads, uint32_t& flags) const {
+    env_size("ARIA_GC_NURSERY_SIZE", &nursery_size);
+    if (env_size("ARIA_GC_OLD_THRESHOLD", &old_gen_threshold)) {
+        old_gen_threshold = std::max(old_gen_threshold, MIN_OLD_GEN_THRESHOLD);
+    }
+    env_size("ARIA_GC_THREADS", &num_gc_threads);
+
+    size_t concurrent;
+    if (env_size("ARIA_GC_CONCURRENT", &concurrent)) {
+        flags = concurrent ? (flags | ARIA_GC_CONCURRENT_MARK)
+                           : (flags & ~ARIA_GC_CONCURRENT_MARK);
+    }
+
+    size_t compact;
+    if (env_size("ARIA_GC_COMPACT", &compact)) {
+        flags = compact ? (flags | ARIA_GC_COMPACT) : (flags & ~ARIA_GC_COMPACT);
+    }
+}
+
+void GCState::init_backing(uint32_t flags) {
+    backing = HeapBacking();
+    backing.transparent_huge_pages = (flags & ARIA_GC_HUGE_PAGES) != 0;
+    backing.explicit_huge_pages = (flags & ARIA_GC_HUGETLB) != 0;
+    if (flags & ARIA_GC_NUMA_LOCAL) {
+        backing.numa_nodes = online_numa_nodes();
+    }
+
+    size_t mode;
+    if (env_size("ARIA_GC_HUGE_PAGES", &mode)) {
+        backing.transparent_huge_pages = mode == 1;
+        backing.explicit_huge_pages = mode >= 2;
+    }
+    size_t numa;
+    if (env_size("ARIA_GC_NUMA", &numa)) {
+        backing.numa_nodes = numa ? online_numa_nodes() : 1;
+    }
+    size_t nodes;
+    if (env_size("ARIA_GC_NUMA_NODES", &nodes) && nodes > 0) {
+        backing.numa_nodes = nodes;
+    }
+}
+
+void GCState::init_policy(size_t nursery_size) {
+    policy.min_nursery_size = nursery_size / 4;
+    policy.max_nursery_size = nursery_size * 8;
+    policy.pause_target_ns = 10 * 1000 * 1000;  // 10ms
+    policy.survival_target = 0.1;
+    policy.major_growth_factor = 2.0;
+    policy.large_object_size = 128 * 1024;
+
+    env_size("ARIA_GC_MIN_NURSERY", &policy.min_nursery_size);
+    env_size("ARIA_GC_MAX_NURSERY", &policy.max_nursery_size);
+
+    size_t pause_us;
+    if (env_size("ARIA_GC_PAUSE_TARGET_US", &pause_us)) {
+        policy.pause_target_ns = static_cast<uint64_t>(pause_us) * 1000;
+    }
+    double percent;
+    if (env_double("ARIA_GC_SURVIVAL_TARGET", &percent)) {
+        policy.survival_target = percent / 100.0;
+    }
+    env_double("ARIA_GC_MAJOR_GROWTH", &policy.major_growth_factor);
+    env_size("ARIA_GC_LARGE_OBJECT", &policy.large_object_size);
+
+    clamp_policy(policy);
+}
+
+void GCState::set_policy(const GCPolicy& new_policy) {
+    std::unique_lock<std::mutex> lock = lock_gc();
+
+    if (!initialized) {
+        init_locked(0, 0, 0, 0);  // Otherwise init would reset the policy
+    }
+    policy = new_policy;
+    clamp_policy(policy);
+}
+
+void GCState::get_policy(GCPolicy* out) const {
+    std::unique_lock<std::mutex> lock = lock_gc();
+    *out = policy;
+}
+
+// =============================================================================
+// Nursery Sizing
+// =============================================================================
+
+void GCState::adapt_nursery(size_t nursery_used_before) {
+    /**
+     * Runs at the end of every minor GC (world stopped, nursery reset)
+     *
+     * Evacuation time stands in for the pause: it is the part that
+     * scales with the nursery. Survival is measured against the bytes
+     * actually handed out, so a collection forced early (aria_gc_collect)
+     * does not look like a high survival rate.
+     */
+
+    stats.last_promoted = minor_promoted;
+    stats.last_survival_rate = nursery_used_before
+        ? static_cast<double>(minor_promoted) / static_cast<double>(nursery_used_before)
+        : 0.0;
+    minor_promoted = 0;
+
+    size_t current = nursery->capacity;
+    size_t target = current;
+
+    bool over_pause = policy.pause_target_ns && stats.last_evacuate_ns > policy.pause_target_ns;
+    bool pause_room = !policy.pause_target_ns || stats.last_evacuate_ns < policy.pause_target_ns / 2;
+
+    if (over_pause) {
+        target = current / 2;
+    } else if (pause_room && stats.last_survival_rate > policy.survival_target &&
+               nursery_used_before >= current / 2) {
+        target = current * 2;
+    }
+    target = std::min(std::max(target, policy.min_nursery_size), policy.max_nursery_size);
+
+    if (target != current && nursery->resize(target)) {
+        tlab_size = std::max(TLAB::MIN_SIZE,
+                             std::min(TLAB::DEFAULT_SIZE, nursery->capacity / 16));
+        stats.nursery_size = nursery->capacity;
+        stats.nursery_partitions = nursery->partitions.size();
+        stats.nursery_hugetlb = nursery->hugetlb;
+    }
+}
+
+// =============================================================================
+// Major GC Trigger
+// =============================================================================
+
+void GCState::update_major_trigger() {
+    /**
+     * Runs at the end of every major GC, with old_gen->used = live size
+     *
+     * A concurrent cycle keeps promoting while it marks. Starting the
+     * next cycle earlier by what the last one promoted (capped at half
+     * the growth allowance) keeps the heap near its target size when the
+     * allocation rate is high, and costs nothing when it is low.
+     */
+
+    size_t live = old_gen->used;
+    size_t target = static_cast<size_t>(static_cast<double>(live) * policy.major_growth_factor);
+
+    if (concurrent_mode) {
+        target -= std::min(cycle_promoted, (target - live) / 2);
+    }
+    cycle_promoted = 0;
+
+    next_major_trigger = std::max(old_gen->threshold, target);
+}
+
+} // namespace runtime
+} // namespace aria
@@ -0,0 +1,229 @@
+/**
+ * Aria GC Tracing
+ *
+ * This file implements the collector's observability:
+ * - GCTrace: Ring buffer of timed collection phases
+ * - PauseHistogram: Log-linear pause-time histograms behind the
+ *   GCStats percentiles
+ * - aria_gc_dump_trace: Chrome trace-event JSON export
+ *
+ * Reference: research_021_garbage_collection_system.txt
+ */
+
+#include "gc_internal.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace aria {
+namespace runtime {
+
+namespace {
+
+// Chrome trace track ids
+constexpr int TRACK_PAUSES = 1;
+constexpr int TRACK_MARKER = 2;
+
+const char* event_name(GCEventKind kind) {
+    switch (kind) {
+        case GCEventKind::MINOR_PAUSE:     return "minor pause";
+        case GCEventKind::MAJOR_PAUSE:     return "major pause";
+        case GCEventKind::MINOR_GC:        return "minor GC";
+        case GCEventKind::CARD_SCAN:       return "card scan";
+        case GCEventKind::MAJOR_GC:        return "major GC";
+        case GCEventKind::CONCURRENT_MARK: return "concurrent mark";
+    }
+    return "unknown";
+}
+
+// Nanoseconds as trace-event microseconds, without float rounding
+void write_us(FILE* out, uint64_t ns) {
+    std::fprintf(out, "%llu.%03llu", static_cast<unsigned long long>(ns / 1000),
+                 static_cast<unsigned long long>(ns % 1000));
+}
+
+void write_event(FILE* out, const GCEvent& event) {
+    int track = event.kind == GCEventKind::CONCURRENT_MARK ? TRACK_MARKER : TRACK_PAUSES;
+
+    std::fprintf(out, "{\"name\":\"%s\",\"cat\":\"gc\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":",
+                 event_name(event.kind), track);
+    write_us(out, event.start_ns);
+    std::fprintf(out, ",\"dur\":");
+    write_us(out, event.duration_ns);
+
+    std::fprintf(out, ",\"args\":{\"old_gen_used\":%llu",
+                 static_cast<unsigned long long>(event.old_gen_used));
+    switch (event.kind) {
+        case GCEventKind::MINOR_GC:
+            std::fprintf(out, ",\"promoted_bytes\":%llu,\"pinned_objects\":%llu",
+                         static_cast<unsigned long long>(event.promoted_bytes),
+                         static_cast<unsigned long long>(event.pinned_objects));
+            break;
+        case GCEventKind::CARD_SCAN:
+            std::fprintf(out, ",\"dirty_cards\":%llu",
+                         static_cast<unsigned long long>(event.dirty_cards));
+            break;
+        case GCEventKind::MAJOR_GC:
+        case GCEventKind::CONCURRENT_MARK:
+            std::fprintf(out, ",\"freed_bytes\":%llu",
+                         static_cast<unsigned long long>(event.freed_bytes));
+            break;
+        default:
+            break;
+    }
+    std::fprintf(out, "}}");
+}
+
+} // namespace
+
+// =============================================================================
+// GCTrace Implementation
+// =============================================================================
+
+GCEvent& GCTrace::append(GCEventKind kind, std::chrono::steady_clock::time_point start,
+                         uint64_t duration_ns) {
+    GCEvent& event = events[next];
+    next = (next + 1) % CAPACITY;
+    recorded++;
+
+    event = GCEvent{};
+    event.kind = kind;
+    event.start_ns = start > epoch
+        ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+              start - epoch).count())
+        : 0;
+    event.duration_ns = duration_ns;
+    return event;
+}
+
+std::vector<GCEvent> GCTrace::snapshot() const {
+    std::vector<GCEvent> out;
+    if (recorded < CAPACITY) {
+        out.assign(events.begin(), events.begin() + next);
+    } else {
+        out.assign(events.begin() + next, events.end());
+        out.insert(out.end(), events.begin(), events.begin() + next);
+    }
+    return out;
+}
+
+void GCTrace::clear() {
+    next = 0;
+    recorded = 0;
+    epoch = std::chrono::steady_clock::now();
+}
+
+// =============================================================================
+// PauseHistogram Implementation
+// =============================================================================
+
+size_t PauseHistogram::bucket_index(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+
+    // Keep the top SUB_BUCKET_BITS bits: the leading one selects the
+    // power of two, the rest the linear bucket within it
+    unsigned shift = static_cast<unsigned>(63 - __builtin_clzll(value)) - (SUB_BUCKET_BITS - 1);
+    return shift * (SUB_BUCKETS / 2) + static_cast<size_t>(value >> shift);
+}
+
+uint64_t PauseHistogram::bucket_upper_bound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+
+    unsigned shift = static_cast<unsigned>(index / (SUB_BUCKETS / 2)) - 1;
+    uint64_t sub = index % (SUB_BUCKETS / 2) + SUB_BUCKETS / 2;
+    return ((sub + 1) << shift) - 1;
+}
+
+void PauseHistogram::record(uint64_t value_ns) {
+    buckets[bucket_index(value_ns)]++;
+    total++;
+    max_value = std::max(max_value, value_ns);
+}
+
+uint64_t PauseHistogram::percentile(double p) const {
+    if (total == 0) {
+        return 0;
+    }
+
+    p = std::min(std::max(p, 0.0), 1.0);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(p * static_cast<double>(total) + 0.5));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(bucket_upper_bound(i), max_value);
+        }
+    }
+    return max_value;
+}
+
+void PauseHistogram::clear() {
+    buckets.fill(0);
+    total = 0;
+    max_value = 0;
+}
+
+// =============================================================================
+// Trace Export
+// =============================================================================
+
+bool GCState::dump_trace(const char* path) const {
+    if (!path) {
+        return false;
+    }
+
+    // Copy under the lock, write without it: file I/O must not hold up
+    // collections
+    std::vector<GCEvent> events;
+    uint64_t dropped;
+    GCStats summary;
+    {
+        std::unique_lock<std::mutex> lock = lock_gc();
+        events = trace.snapshot();
+        dropped = trace.dropped();
+    }
+    get_stats(&summary);
+
+    FILE* out = std::fopen(path, "w");
+    if (!out) {
+        return false;
+    }
+
+    std::fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    std::fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Aria GC\"}},\n");
+    std::fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"GC pauses\"}},\n",
+                 TRACK_PAUSES);
+    std::fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"Concurrent mark\"}}",
+                 TRACK_MARKER);
+    for (const GCEvent& event : events) {
+        std::fprintf(out, ",\n");
+        write_event(out, event);
+    }
+
+    std::fprintf(out,
+                 "\n],\"otherData\":{\"dropped_events\":%llu,"
+                 "\"minor_collections\":%llu,\"major_collections\":%llu,"
+                 "\"minor_pause_p50_ns\":%llu,\"minor_pause_p99_ns\":%llu,\"minor_pause_p999_ns\":%llu,"
+                 "\"major_pause_p50_ns\":%llu,\"major_pause_p99_ns\":%llu,\"major_pause_p999_ns\":%llu,"
+                 "\"max_pause_ns\":%llu}}\n",
+                 static_cast<unsigned long long>(dropped),
+                 static_cast<unsigned long long>(summary.num_minor_collections),
+                 static_cast<unsigned long long>(summary.num_major_collections),
+                 static_cast<unsigned long long>(summary.minor_pause_p50_ns),
+                 static_cast<unsigned long long>(summary.minor_pause_p99_ns),
+                 static_cast<unsigned long long>(summary.minor_pause_p999_ns),
+                 static_cast<unsigned long long>(summary.major_pause_p50_ns),
+                 static_cast<unsigned long long>(summary.major_pause_p99_ns),
+                 static_cast<unsigned long long>(summary.major_pause_p999_ns),
+                 static_cast<unsigned long long>(summary.max_pause_ns));
+
+    bool ok = !std::ferror(out);
+    return std::fclose(out) == 0 && ok;
+}
+
+} // namespace runtime
+} // namespace aria
@@ -10,6 +10,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 
 // ============================================================================
 // Result Construction Functions
@@ -97,9 +98,22 @@ AriaResultVoid aria_result_err_void(AriaError* error) {
 // Error Construction Functions
 // ============================================================================
 
+/**
+ * GC type ID for AriaError (message and file are traced references).
+ * Registered on first use.
+ */
+static uint16_t error_type_id() {
+    static const uint16_t id = [] {
+        uint64_t bitmap = (uint64_t(1) << (offsetof(AriaError, message) / 8)) |
+                          (uint64_t(1) << (offsetof(AriaError, file) / 8));
+        return aria_gc_register_type(sizeof(AriaError), &bitmap);
+    }();
+    return id;
+}
+
 AriaError* aria_error_new(int32_t code, const char* message, const char* file, int32_t line) {
-    // Allocate error on GC heap (type_id 0 for generic)
-    AriaError* error = (AriaError*)aria_gc_alloc(sizeof(AriaError), 0);
+    // Allocate error on GC heap (message/file copies are traced)
+    AriaError* error = (AriaError*)aria_gc_alloc(sizeof(AriaError), error_type_id());
     if (!error) {
         return NULL;  // OOM - caller must handle
     }
@@ -9,17 +9,93 @@
 #include <cstring>
 #include <cctype>
 #include <cstdlib>
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
 
 // ═══════════════════════════════════════════════════════════════════════
 // Helper Functions
 // ═══════════════════════════════════════════════════════════════════════
 
+// Flags in the tag byte (small[15], also the top byte of heap.length)
+static const uint8_t STRING_SMALL = 0x80;         // Bytes stored inline
+static const uint8_t STRING_INTERNED = 0x40;      // Owned by the intern table
+static const uint8_t STRING_SMALL_LENGTH = 0x0F;  // Inline length bits
+static const uint64_t STRING_HEAP_LENGTH = (uint64_t(1) << 56) - 1;
+static const size_t STRING_TAG = sizeof(AriaString) - 1;
+
+static_assert(sizeof(AriaString) == 16, "AriaString must stay two words");
+static_assert(ARIA_STRING_INLINE_CAPACITY <= STRING_SMALL_LENGTH,
+              "Inline length must fit in the tag byte");
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "The tag byte must overlap the top byte of heap.length");
+
+static inline uint8_t string_tag(const AriaString& str) {
+    return (uint8_t)str.small[STRING_TAG];
+}
+
+static inline bool is_small(const AriaString& str) {
+    return string_tag(str) & STRING_SMALL;
+}
+
+static inline int64_t string_length(const AriaString& str) {
+    return is_small(str) ? (int64_t)(string_tag(str) & STRING_SMALL_LENGTH)
+                         : (int64_t)(str.heap.length & STRING_HEAP_LENGTH);
+}
+
+static inline const char* string_data(const AriaString& str) {
+    return is_small(str) ? str.small : str.heap.data;
+}
+
+// Inline string value; unused bytes are zero so equal values compare bytewise
+static AriaString make_small(const char* data, int64_t length, uint8_t flags = 0) {
+    AriaString str;
+    memset(&str, 0, sizeof(str));
+    if (length > 0) {
+        memcpy(str.small, data, length);
+    }
+    str.small[STRING_TAG] = (char)(STRING_SMALL | flags | length);
+    return str;
+}
+
+static AriaString make_heap(const char* data, int64_t length, uint8_t flags = 0) {
+    AriaString str;
+    str.heap.data = data;
+    str.heap.length = (uint64_t)length | ((uint64_t)flags << 56);
+    return str;
+}
+
+/**
+ * GC type ID for heap-form AriaString headers (data is a traced reference).
+ * Registered on first use. Inline strings hold no references and are
+ * allocated as leaves (type 0).
+ */
+static uint16_t string_type_id() {
+    static const uint16_t id = [] {
+        uint64_t bitmap = uint64_t(1) << (offsetof(AriaStringHeap, data) / 8);
+        return aria_gc_register_type(sizeof(AriaString), &bitmap);
+    }();
+    return id;
+}
+
 /**
  * Allocate an AriaString on GC heap and return as result.
  * Helper to wrap string values in result type.
  */
-static AriaResultPtr alloc_string_result(const char* data, int64_t length) {
-    AriaString* str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0);
+static AriaResultPtr alloc_string_result(const AriaString& value) {
+    AriaString copy = value;
+    AriaString* str;
+    if (is_small(copy)) {
+        str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0);
+    } else {
+        // Keep the bytes alive, and tracked if they move, meanwhile
+        aria_shadow_stack_push_frame();
+        aria_shadow_stack_add_root((void**)&copy.heap.data);
+        str = (AriaString*)aria_gc_alloc(sizeof(AriaString), string_type_id());
+        aria_shadow_stack_pop_frame();
+    }
     if (!str) {
         AriaError* error = aria_error_new(
             ARIA_ERR_OUT_OF_MEMORY,
@@ -28,11 +104,50 @@ static AriaResultPtr alloc_string_result(const char* data, int64_t length) {
         );
         return aria_result_err_ptr(error);
     }
-    str->data = data;
-    str->length = length;
+    *str = copy;
     return aria_result_ok_ptr(str);
 }
 
+/**
+ * Builds a new string of known length. Results that fit inline are
+ * assembled in the value itself and boxed with a single allocation;
+ * longer ones get a GC-allocated byte buffer (null-terminated for C
+ * interop).
+ */
+class StringBuilder {
+public:
+    explicit StringBuilder(int64_t length) : length(length), buffer(nullptr) {
+        if (length <= ARIA_STRING_INLINE_CAPACITY) {
+            value = make_small(nullptr, 0);
+            value.small[STRING_TAG] = (char)(STRING_SMALL | length);
+            buffer = value.small;
+        } else {
+            buffer = (char*)aria_gc_alloc(length + 1, 0);
+            if (buffer) {
+                buffer[length] = '\0';
+            }
+        }
+    }
+
+    StringBuilder(const StringBuilder&) = delete;
+    StringBuilder& operator=(const StringBuilder&) = delete;
+
+    // Writable bytes, or NULL if the buffer could not be allocated
+    char* bytes() { return buffer; }
+
+    AriaResultPtr finish() {
+        if (length <= ARIA_STRING_INLINE_CAPACITY) {
+            return alloc_string_result(value);
+        }
+        return alloc_string_result(make_heap(buffer, length));
+    }
+
+private:
+    int64_t length;
+    char* buffer;
+    AriaString value;
+};
+
 // ═══════════════════════════════════════════════════════════════════════
 // String Creation
 // ═══════════════════════════════════════════════════════════════════════
@@ -46,7 +161,7 @@ AriaResultPtr aria_string_from_cstr(const char* cstr) {
         );
         return aria_result_err_ptr(error);
     }
-    
+
     int64_t length = strlen(cstr);
     return aria_string_from_bytes(cstr, length);
 }
@@ -60,7 +175,7 @@ AriaResultPtr aria_string_from_bytes(const char* data, int64_t length) {
         );
         return aria_result_err_ptr(error);
     }
-    
+
     if (length < 0) {
         AriaError* error = aria_error_new(
             ARIA_ERR_INVALID_ARG,
@@ -69,9 +184,10 @@ AriaResultPtr aria_string_from_bytes(const char* data, int64_t length) {
         );
         return aria_result_err_ptr(error);
     }
-    
-    // Allocate GC memory for string data (with null terminator for C interop)
-    char* copied_data = (char*)aria_gc_alloc(length + 1, 0);
+
+    // Short strings are copied inline, longer ones into GC memory
+    StringBuilder builder(length);
+    char* copied_data = builder.bytes();
     if (!copied_data) {
         AriaError* error = aria_error_new(
             ARIA_ERR_OUT_OF_MEMORY,
@@ -80,68 +196,173 @@ AriaResultPtr aria_string_from_bytes(const char* data, int64_t length) {
         );
         return aria_result_err_ptr(error);
     }
-    
-    // Copy data and add null terminator
+
     if (length > 0) {
         memcpy(copied_data, data, length);
     }
-    copied_data[length] = '\0';
-    
-    // Allocate AriaString struct on GC heap
+
+    return builder.finish();
+}
+
+AriaString* aria_string_empty() {
     AriaString* str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0);
     if (!str) {
+        // For empty string, we can return a static version on allocation failure
+        static AriaString static_empty = make_small(nullptr, 0);
+        return &static_empty;
+    }
+    *str = make_small(nullptr, 0);
+    return str;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+// String Interning
+// ═══════════════════════════════════════════════════════════════════════
+
+/**
+ * Process-wide intern table. Sharded by hash so threads interning
+ * different strings rarely contend; a hit, the common case for repeated
+ * keys, only takes its shard's lock shared. Canonical strings are
+ * malloc'd (AriaString followed by its bytes) and never freed or moved,
+ * so the table keys on views of their own bytes.
+ */
+class InternTable {
+public:
+    static InternTable& shared() {
+        // Leaked: interned strings must outlive static destructors
+        static InternTable* table = new InternTable();
+        return *table;
+    }
+
+    // Canonical string with these bytes, or NULL if out of memory
+    AriaString* intern(const char* data, int64_t length) {
+        std::string_view key(data, (size_t)length);
+        Shard& shard = shards[aria_hash_bytes(data, length) >> (64 - SHARD_BITS)];
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.strings.find(key);
+            if (it != shard.strings.end()) {
+                return it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.strings.find(key);
+        if (it != shard.strings.end()) {
+            return it->second;  // Interned by another thread meanwhile
+        }
+        AriaString* canonical = create(data, length);
+        if (canonical) {
+            shard.strings.emplace(std::string_view(string_data(*canonical), (size_t)length),
+                                  canonical);
+        }
+        return canonical;
+    }
+
+private:
+    static const unsigned SHARD_BITS = 4;
+
+    struct KeyHash {
+        size_t operator()(std::string_view key) const {
+            return aria_hash_bytes(key.data(), key.size());
+        }
+    };
+
+    struct Shard {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string_view, AriaString*, KeyHash> strings;
+    };
+
+    Shard shards[1u << SHARD_BITS];
+
+    static AriaString* create(const char* data, int64_t length) {
+        if (length <= ARIA_STRING_INLINE_CAPACITY) {
+            AriaString* str = (AriaString*)malloc(sizeof(AriaString));
+            if (str) {
+                *str = make_small(data, length, STRING_INTERNED);
+            }
+            return str;
+        }
+
+        AriaString* str = (AriaString*)malloc(sizeof(AriaString) + length + 1);
+        if (str) {
+            char* bytes = (char*)(str + 1);
+            memcpy(bytes, data, length);
+            bytes[length] = '\0';
+            *str = make_heap(bytes, length, STRING_INTERNED);
+        }
+        return str;
+    }
+};
+
+AriaResultPtr aria_string_intern(AriaString str) {
+    AriaString* canonical = InternTable::shared().intern(string_data(str), string_length(str));
+    if (!canonical) {
         AriaError* error = aria_error_new(
             ARIA_ERR_OUT_OF_MEMORY,
-            "Failed to allocate string structure",
+            "Failed to allocate interned string",
             __FILE__, __LINE__
         );
         return aria_result_err_ptr(error);
     }
-    
-    str->data = copied_data;
-    str->length = length;
-    
-    return aria_result_ok_ptr(str);
+    return aria_result_ok_ptr(canonical);
 }
 
-AriaString* aria_string_empty() {
-    static const char empty_str[] = "";
-    AriaString* str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0);
-    if (!str) {
-        // For empty string, we can return a static version on allocation failure
-        static AriaString static_empty = {empty_str, 0};
-        return &static_empty;
-    }
-    str->data = empty_str;
-    str->length = 0;
-    return str;
+bool aria_string_is_interned(AriaString str) {
+    return string_tag(str) & STRING_INTERNED;
 }
 
 // ═══════════════════════════════════════════════════════════════════════
 // String Basic Operations
 // ═══════════════════════════════════════════════════════════════════════
 
+const char* aria_string_data(const AriaString* str) {
+    return str ? string_data(*str) : NULL;
+}
+
 int64_t aria_string_length(AriaString str) {
-    return str.length;
+    return string_length(str);
 }
 
 bool aria_string_is_empty(AriaString str) {
-    return str.length == 0;
+    return string_length(str) == 0;
 }
 
 bool aria_string_equals(AriaString a, AriaString b) {
-    if (a.length != b.length) {
+    uint8_t tag_a = string_tag(a);
+    uint8_t tag_b = string_tag(b);
+
+    if (tag_a & tag_b & STRING_SMALL) {
+        // Both inline and zero-padded: equal iff all 16 bytes match,
+        // ignoring the interned flag
+        uint64_t words_a[2], words_b[2];
+        memcpy(words_a, &a, sizeof(a));
+        memcpy(words_b, &b, sizeof(b));
+        return words_a[0] == words_b[0] &&
+               ((words_a[1] ^ words_b[1]) & ~((uint64_t)STRING_INTERNED << 56)) == 0;
+    }
+    if (tag_a & tag_b & STRING_INTERNED) {
+        // Both canonical: equal iff the same copy
+        return !((tag_a | tag_b) & STRING_SMALL) && a.heap.data == b.heap.data;
+    }
+
+    int64_t length = string_length(a);
+    if (length != string_length(b)) {
         return false;
     }
-    if (a.length == 0) {
-        return true;  // Both empty
+    const char* data_a = string_data(a);
+    const char* data_b = string_data(b);
+    if (length == 0 || data_a == data_b) {
+        return true;  // Both empty, or the same bytes
     }
-    return memcmp(a.data, b.data, a.length) == 0;
+    return memcmp(data_a, data_b, length) == 0;
 }
 
 AriaResultPtr aria_string_substring(AriaString str, int64_t start, int64_t end) {
+    int64_t length = string_length(str);
+
     // Bounds checking
-    if (start < 0 || start > str.length) {
+    if (start < 0 || start > length) {
         AriaError* error = aria_error_new(
             ARIA_ERR_OUT_OF_BOUNDS,
             "Substring start index out of bounds",
@@ -150,7 +371,7 @@ AriaResultPtr aria_string_substring(AriaString str, int64_t start, int64_t end)
         return aria_result_err_ptr(error);
     }
     
-    if (end < start || end > str.length) {
+    if (end < start || end > length) {
         AriaError* error = aria_error_new(
             ARIA_ERR_OUT_OF_BOUNDS,
             "Substring end index out of bounds",
@@ -166,17 +387,20 @@ AriaResultPtr aria_string_substring(AriaString str, int64_t start, int64_t end)
         return aria_result_ok_ptr(aria_string_empty());
     }
     
-    // Create new string from substring
-    return aria_string_from_bytes(str.data + start, sub_length);
+    // Create new string from substring (inline if short enough)
+    return aria_string_from_bytes(string_data(str) + start, sub_length);
 }
 
 AriaResultI64 aria_string_index_of(AriaString haystack, AriaString needle) {
-    if (needle.length == 0) {
+    int64_t haystack_length = string_length(haystack);
+    int64_t needle_length = string_length(needle);
+
+    if (needle_length == 0) {
         // Empty needle always matches at position 0
         return aria_result_ok_i64(0);
     }
     
-    if (needle.length > haystack.length) {
+    if (needle_length > haystack_length) {
         // Needle longer than haystack, cannot match
         AriaError* error = aria_error_new(
             ARIA_ERR_NOT_FOUND,
@@ -187,8 +411,10 @@ AriaResultI64 aria_string_index_of(AriaString haystack, AriaString needle) {
     }
     
     // Simple string search (could be optimized with Boyer-Moore or similar)
-    for (int64_t i = 0; i <= haystack.length - needle.length; i++) {
-        if (memcmp(haystack.data + i, needle.data, needle.length) == 0) {
+    const char* haystack_data = string_data(haystack);
+    const char* needle_data = string_data(needle);
+    for (int64_t i = 0; i <= haystack_length - needle_length; i++) {
+        if (memcmp(haystack_data + i, needle_data, needle_length) == 0) {
             return aria_result_ok_i64(i);
         }
     }
@@ -208,23 +434,26 @@ bool aria_string_contains(AriaString haystack, AriaString needle) {
 }
 
 bool aria_string_starts_with(AriaString str, AriaString prefix) {
-    if (prefix.length > str.length) {
+    int64_t prefix_length = string_length(prefix);
+    if (prefix_length > string_length(str)) {
         return false;
     }
-    if (prefix.length == 0) {
+    if (prefix_length == 0) {
         return true;  // Empty prefix always matches
     }
-    return memcmp(str.data, prefix.data, prefix.length) == 0;
+    return memcmp(string_data(str), string_data(prefix), prefix_length) == 0;
 }
 
 bool aria_string_ends_with(AriaString str, AriaString suffix) {
-    if (suffix.length > str.length) {
+    int64_t length = string_length(str);
+    int64_t suffix_length = string_length(suffix);
+    if (suffix_length > length) {
         return false;
     }
-    if (suffix.length == 0) {
+    if (suffix_length == 0) {
         return true;  // Empty suffix always matches
     }
-    return memcmp(str.data + str.length - suffix.length, suffix.data, suffix.length) == 0;
+    return memcmp(string_data(str) + length - suffix_length, string_data(suffix), suffix_length) == 0;
 }
 
 // ═══════════════════════════════════════════════════════════════════════
@@ -237,24 +466,26 @@ static inline bool is_whitespace(char c) {
 }
 
 AriaResultPtr aria_string_trim(AriaString str) {
-    if (str.length == 0) {
-        { AriaString* heap_str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0); if (!heap_str) return aria_result_err_ptr(aria_error_new(ARIA_ERR_OUT_OF_MEMORY, "Failed to allocate string", __FILE__, __LINE__)); *heap_str = str; return aria_result_ok_ptr(heap_str); }
+    int64_t length = string_length(str);
+    const char* data = string_data(str);
+    if (length == 0) {
+        return alloc_string_result(str);
     }
     
     // Find first non-whitespace
     int64_t start = 0;
-    while (start < str.length && is_whitespace(str.data[start])) {
+    while (start < length && is_whitespace(data[start])) {
         start++;
     }
     
     // All whitespace
-    if (start == str.length) {
+    if (start == length) {
         return aria_result_ok_ptr(aria_string_empty());
     }
     
     // Find last non-whitespace
-    int64_t end = str.length - 1;
-    while (end >= start && is_whitespace(str.data[end])) {
+    int64_t end = length - 1;
+    while (end >= start && is_whitespace(data[end])) {
         end--;
     }
     
@@ -263,32 +494,36 @@ AriaResultPtr aria_string_trim(AriaString str) {
 }
 
 AriaResultPtr aria_string_trim_start(AriaString str) {
-    if (str.length == 0) {
-        { AriaString* heap_str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0); if (!heap_str) return aria_result_err_ptr(aria_error_new(ARIA_ERR_OUT_OF_MEMORY, "Failed to allocate string", __FILE__, __LINE__)); *heap_str = str; return aria_result_ok_ptr(heap_str); }
+    int64_t length = string_length(str);
+    const char* data = string_data(str);
+    if (length == 0) {
+        return alloc_string_result(str);
     }
     
     // Find first non-whitespace
     int64_t start = 0;
-    while (start < str.length && is_whitespace(str.data[start])) {
+    while (start < length && is_whitespace(data[start])) {
         start++;
     }
     
     // All whitespace
-    if (start == str.length) {
+    if (start == length) {
         return aria_result_ok_ptr(aria_string_empty());
     }
     
-    return aria_string_substring(str, start, str.length);
+    return aria_string_substring(str, start, length);
 }
 
 AriaResultPtr aria_string_trim_end(AriaString str) {
-    if (str.length == 0) {
-        { AriaString* heap_str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0); if (!heap_str) return aria_result_err_ptr(aria_error_new(ARIA_ERR_OUT_OF_MEMORY, "Failed to allocate string", __FILE__, __LINE__)); *heap_str = str; return aria_result_ok_ptr(heap_str); }
+    int64_t length = string_length(str);
+    const char* data = string_data(str);
+    if (length == 0) {
+        return alloc_string_result(str);
     }
     
     // Find last non-whitespace
-    int64_t end = str.length - 1;
-    while (end >= 0 && is_whitespace(str.data[end])) {
+    int64_t end = length - 1;
+    while (end >= 0 && is_whitespace(data[end])) {
         end--;
     }
     
@@ -301,12 +536,14 @@ AriaResultPtr aria_string_trim_end(AriaString str) {
 }
 
 AriaResultPtr aria_string_to_upper(AriaString str) {
-    if (str.length == 0) {
-        { AriaString* heap_str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0); if (!heap_str) return aria_result_err_ptr(aria_error_new(ARIA_ERR_OUT_OF_MEMORY, "Failed to allocate string", __FILE__, __LINE__)); *heap_str = str; return aria_result_ok_ptr(heap_str); }
+    int64_t length = string_length(str);
+    if (length == 0) {
+        return alloc_string_result(str);
     }
     
     // Allocate new string data
-    char* upper_data = (char*)aria_gc_alloc(str.length + 1, 0);
+    StringBuilder builder(length);
+    char* upper_data = builder.bytes();
     if (!upper_data) {
         AriaError* error = aria_error_new(
             ARIA_ERR_OUT_OF_MEMORY,
@@ -317,22 +554,23 @@ AriaResultPtr aria_string_to_upper(AriaString str) {
     }
     
     // Convert to uppercase (ASCII only for now)
-    for (int64_t i = 0; i < str.length; i++) {
-        upper_data[i] = toupper((unsigned char)str.data[i]);
+    const char* data = string_data(str);
+    for (int64_t i = 0; i < length; i++) {
+        upper_data[i] = toupper((unsigned char)data[i]);
     }
-    upper_data[str.length] = '\0';
     
-    AriaString result = {upper_data, str.length};
-    { AriaString* heap_str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0); if (!heap_str) return aria_result_err_ptr(aria_error_new(ARIA_ERR_OUT_OF_MEMORY, "Failed to allocate string", __FILE__, __LINE__)); *heap_str = result; return aria_result_ok_ptr(heap_str); }
+    return builder.finish();
 }
 
 AriaResultPtr aria_string_to_lower(AriaString str) {
-    if (str.length == 0) {
-        { AriaString* heap_str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0); if (!heap_str) return aria_result_err_ptr(aria_error_new(ARIA_ERR_OUT_OF_MEMORY, "Failed to allocate string", __FILE__, __LINE__)); *heap_str = str; return aria_result_ok_ptr(heap_str); }
+    int64_t length = string_length(str);
+    if (length == 0) {
+        return alloc_string_result(str);
     }
     
     // Allocate new string data
-    char* lower_data = (char*)aria_gc_alloc(str.length + 1, 0);
+    StringBuilder builder(length);
+    char* lower_data = builder.bytes();
     if (!lower_data) {
         AriaError* error = aria_error_new(
             ARIA_ERR_OUT_OF_MEMORY,
@@ -343,20 +581,22 @@ AriaResultPtr aria_string_to_lower(AriaString str) {
     }
     
     // Convert to lowercase (ASCII only for now)
-    for (int64_t i = 0; i < str.length; i++) {
-        lower_data[i] = tolower((unsigned char)str.data[i]);
+    const char* data = string_data(str);
+    for (int64_t i = 0; i < length; i++) {
+        lower_data[i] = tolower((unsigned char)data[i]);
     }
-    lower_data[str.length] = '\0';
     
-    AriaString result = {lower_data, str.length};
-    { AriaString* heap_str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0); if (!heap_str) return aria_result_err_ptr(aria_error_new(ARIA_ERR_OUT_OF_MEMORY, "Failed to allocate string", __FILE__, __LINE__)); *heap_str = result; return aria_result_ok_ptr(heap_str); }
+    return builder.finish();
 }
 
 AriaResultPtr aria_string_concat(AriaString a, AriaString b) {
-    int64_t total_length = a.length + b.length;
+    int64_t a_length = string_length(a);
+    int64_t b_length = string_length(b);
+    int64_t total_length = a_length + b_length;
     
     // Allocate new string data
-    char* concat_data = (char*)aria_gc_alloc(total_length + 1, 0);
+    StringBuilder builder(total_length);
+    char* concat_data = builder.bytes();
     if (!concat_data) {
         AriaError* error = aria_error_new(
             ARIA_ERR_OUT_OF_MEMORY,
@@ -367,16 +607,14 @@ AriaResultPtr aria_string_concat(AriaString a, AriaString b) {
     }
     
     // Copy both strings
-    if (a.length > 0) {
-        memcpy(concat_data, a.data, a.length);
+    if (a_length > 0) {
+        memcpy(concat_data, string_data(a), a_length);
     }
-    if (b.length > 0) {
-        memcpy(concat_data + a.length, b.data, b.length);
+    if (b_length > 0) {
+        memcpy(concat_data + a_length, string_data(b), b_length);
     }
-    concat_data[total_length] = '\0';
     
-    AriaString result = {concat_data, total_length};
-    { AriaString* heap_str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0); if (!heap_str) return aria_result_err_ptr(aria_error_new(ARIA_ERR_OUT_OF_MEMORY, "Failed to allocate string", __FILE__, __LINE__)); *heap_str = result; return aria_result_ok_ptr(heap_str); }
+    return builder.finish();
 }
 
 AriaResultPtr aria_string_repeat(AriaString str, int64_t count) {
@@ -389,14 +627,16 @@ AriaResultPtr aria_string_repeat(AriaString str, int64_t count) {
         return aria_result_err_ptr(error);
     }
     
-    if (count == 0 || str.length == 0) {
+    int64_t length = string_length(str);
+    if (count == 0 || length == 0) {
         return aria_result_ok_ptr(aria_string_empty());
     }
     
-    int64_t total_length = str.length * count;
+    int64_t total_length = length * count;
     
     // Allocate new string data
-    char* repeat_data = (char*)aria_gc_alloc(total_length + 1, 0);
+    StringBuilder builder(total_length);
+    char* repeat_data = builder.bytes();
     if (!repeat_data) {
         AriaError* error = aria_error_new(
             ARIA_ERR_OUT_OF_MEMORY,
@@ -407,13 +647,12 @@ AriaResultPtr aria_string_repeat(AriaString str, int64_t count) {
     }
     
     // Repeat string
+    const char* data = string_data(str);
     for (int64_t i = 0; i < count; i++) {
-        memcpy(repeat_data + (i * str.length), str.data, str.length);
+        memcpy(repeat_data + (i * length), data, length);
     }
-    repeat_data[total_length] = '\0';
     
-    AriaString result = {repeat_data, total_length};
-    { AriaString* heap_str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0); if (!heap_str) return aria_result_err_ptr(aria_error_new(ARIA_ERR_OUT_OF_MEMORY, "Failed to allocate string", __FILE__, __LINE__)); *heap_str = result; return aria_result_ok_ptr(heap_str); }
+    return builder.finish();
 }
 
 // ═══════════════════════════════════════════════════════════════════════
@@ -421,21 +660,26 @@ AriaResultPtr aria_string_repeat(AriaString str, int64_t count) {
 // ═══════════════════════════════════════════════════════════════════════
 
 AriaResultPtr aria_string_split(AriaString str, AriaString delimiter) {
+    int64_t length = string_length(str);
+    const char* data = string_data(str);
+    int64_t delimiter_length = string_length(delimiter);
+    const char* delimiter_data = string_data(delimiter);
+
     // Empty string returns empty array
-    if (str.length == 0) {
+    if (length == 0) {
         return aria_array_new(sizeof(AriaString*), 0, 0);
     }
     
     // Empty delimiter: split into individual bytes
-    if (delimiter.length == 0) {
-        AriaResultPtr array_result = aria_array_new(sizeof(AriaString*), str.length, 0);
+    if (delimiter_length == 0) {
+        AriaResultPtr array_result = aria_array_new(sizeof(AriaString*), length, 0);
         if (array_result.is_error) {
             return aria_result_err_ptr((AriaError*)array_result.error);
         }
         
         AriaArray* array = (AriaArray*)array_result.value;
-        for (int64_t i = 0; i < str.length; i++) {
-            AriaResultPtr char_str = aria_string_from_bytes(str.data + i, 1);
+        for (int64_t i = 0; i < length; i++) {
+            AriaResultPtr char_str = aria_string_from_bytes(data + i, 1);
             if (char_str.is_error) {
                 return aria_result_err_ptr((AriaError*)char_str.error);
             }
@@ -452,10 +696,10 @@ AriaResultPtr aria_string_split(AriaString str, AriaString delimiter) {
     
     // Count occurrences to pre-allocate array
     int64_t count = 1;  // At least one part
-    for (int64_t i = 0; i <= str.length - delimiter.length; i++) {
-        if (memcmp(str.data + i, delimiter.data, delimiter.length) == 0) {
+    for (int64_t i = 0; i <= length - delimiter_length; i++) {
+        if (memcmp(data + i, delimiter_data, delimiter_length) == 0) {
             count++;
-            i += delimiter.length - 1;  // Skip past delimiter
+            i += delimiter_length - 1;  // Skip past delimiter
         }
     }
     
@@ -469,10 +713,10 @@ AriaResultPtr aria_string_split(AriaString str, AriaString delimiter) {
     
     // Split string
     int64_t start = 0;
-    for (int64_t i = 0; i <= str.length - delimiter.length; i++) {
-        if (memcmp(str.data + i, delimiter.data, delimiter.length) == 0) {
+    for (int64_t i = 0; i <= length - delimiter_length; i++) {
+        if (memcmp(data + i, delimiter_data, delimiter_length) == 0) {
             // Found delimiter, add part before it
-            AriaResultPtr part = aria_string_from_bytes(str.data + start, i - start);
+            AriaResultPtr part = aria_string_from_bytes(data + start, i - start);
             if (part.is_error) {
                 return aria_result_err_ptr((AriaError*)part.error);
             }
@@ -483,13 +727,13 @@ AriaResultPtr aria_string_split(AriaString str, AriaString delimiter) {
                 return aria_result_err_ptr((AriaError*)push_result.error);
             }
             
-            start = i + delimiter.length;
-            i += delimiter.length - 1;  // Skip past delimiter
+            start = i + delimiter_length;
+            i += delimiter_length - 1;  // Skip past delimiter
         }
     }
     
     // Add final part
-    AriaResultPtr final_part = aria_string_from_bytes(str.data + start, str.length - start);
+    AriaResultPtr final_part = aria_string_from_bytes(data + start, length - start);
     if (final_part.is_error) {
         return aria_result_err_ptr((AriaError*)final_part.error);
     }
@@ -527,17 +771,21 @@ AriaResultPtr aria_string_join(const AriaArray* strings, AriaString delimiter) {
         return aria_result_ok_ptr(aria_string_empty());
     }
     
+    int64_t delimiter_length = string_length(delimiter);
+    const char* delimiter_data = string_data(delimiter);
+
     // Calculate total length
     int64_t total_length = 0;
     AriaString** parts = (AriaString**)strings->data;
     for (size_t i = 0; i < strings->length; i++) {
-        total_length += parts[i]->length;
+        total_length += string_length(*parts[i]);
     }
     // Add delimiter lengths
-    total_length += delimiter.length * (strings->length - 1);
+    total_length += delimiter_length * (strings->length - 1);
     
     // Allocate joined string
-    char* joined_data = (char*)aria_gc_alloc(total_length + 1, 0);
+    StringBuilder builder(total_length);
+    char* joined_data = builder.bytes();
     if (!joined_data) {
         AriaError* error = aria_error_new(
             ARIA_ERR_OUT_OF_MEMORY,
@@ -550,19 +798,18 @@ AriaResultPtr aria_string_join(const AriaArray* strings, AriaString delimiter) {
     // Join parts
     int64_t pos = 0;
     for (size_t i = 0; i < strings->length; i++) {
-        if (i > 0 && delimiter.length > 0) {
-            memcpy(joined_data + pos, delimiter.data, delimiter.length);
-            pos += delimiter.length;
+        if (i > 0 && delimiter_length > 0) {
+            memcpy(joined_data + pos, delimiter_data, delimiter_length);
+            pos += delimiter_length;
         }
-        if (parts[i]->length > 0) {
-            memcpy(joined_data + pos, parts[i]->data, parts[i]->length);
-            pos += parts[i]->length;
+        int64_t part_length = string_length(*parts[i]);
+        if (part_length > 0) {
+            memcpy(joined_data + pos, string_data(*parts[i]), part_length);
+            pos += part_length;
         }
     }
-    joined_data[total_length] = '\0';
     
-    AriaString result = {joined_data, total_length};
-    { AriaString* heap_str = (AriaString*)aria_gc_alloc(sizeof(AriaString), 0); if (!heap_str) return aria_result_err_ptr(aria_error_new(ARIA_ERR_OUT_OF_MEMORY, "Failed to allocate string", __FILE__, __LINE__)); *heap_str = result; return aria_result_ok_ptr(heap_str); }
+    return builder.finish();
 }
 
 // ═══════════════════════════════════════════════════════════════════════
@@ -570,7 +817,24 @@ AriaResultPtr aria_string_join(const AriaArray* strings, AriaString delimiter) {
 // ═══════════════════════════════════════════════════════════════════════
 
 AriaResultPtr aria_string_to_cstr(AriaString str) {
-    // String data is already null-terminated in aria_string_from_bytes
-    // Just return the data pointer
-    return aria_result_ok_ptr((void*)str.data);
+    if (!is_small(str)) {
+        // Heap string data is already null-terminated in aria_string_from_bytes
+        // Just return the data pointer
+        return aria_result_ok_ptr((void*)str.heap.data);
+    }
+
+    // Inline bytes live in the caller's value and have no terminator
+    int64_t length = string_length(str);
+    char* cstr = (char*)aria_gc_alloc(length + 1, 0);
+    if (!cstr) {
+        AriaError* error = aria_error_new(
+            ARIA_ERR_OUT_OF_MEMORY,
+            "Failed to allocate C string",
+            __FILE__, __LINE__
+        );
+        return aria_result_err_ptr(error);
+    }
+    memcpy(cstr, str.small, length);
+    cstr[length] = '\0';
+    return aria_result_ok_ptr(cstr);
 }
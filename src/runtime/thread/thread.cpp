@@ -5,6 +5,7 @@
 
 #include "runtime/thread.h"
 #include "runtime/io.h"
+#include "runtime/gc.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -217,7 +218,9 @@ AriaResult* aria_thread_join(AriaThread* thread, void** ret_val) {
         return aria_result_err("Thread handle is invalid");
     }
 
+    aria_gc_enter_blocking();
     DWORD wait_result = WaitForSingleObject(thread->handle, INFINITE);
+    aria_gc_leave_blocking();
     if (wait_result != WAIT_OBJECT_0) {
         return aria_result_err(get_error_message("WaitForSingleObject"));
     }
@@ -235,7 +238,9 @@ AriaResult* aria_thread_join(AriaThread* thread, void** ret_val) {
     }
 
     void* return_value = NULL;
+    aria_gc_enter_blocking();
     int result = pthread_join(thread->handle, &return_value);
+    aria_gc_leave_blocking();
     if (result != 0) {
         return aria_result_err(get_error_message("pthread_join"));
     }
@@ -318,12 +323,16 @@ void aria_thread_sleep_ns(uint64_t nanoseconds) {
     if (milliseconds == 0 && nanoseconds > 0) {
         milliseconds = 1;
     }
+    aria_gc_enter_blocking();
     Sleep(milliseconds);
+    aria_gc_leave_blocking();
 #else
     struct timespec ts;
     ts.tv_sec = nanoseconds / 1000000000ULL;
     ts.tv_nsec = nanoseconds % 1000000000ULL;
+    aria_gc_enter_blocking();
     nanosleep(&ts, NULL);
+    aria_gc_leave_blocking();
 #endif
 }
 
@@ -401,9 +410,13 @@ AriaResult* aria_mutex_lock(AriaMutex* mutex) {
     }
 
 #ifdef _WIN32
+    aria_gc_enter_blocking();
     EnterCriticalSection(&mutex->cs);
+    aria_gc_leave_blocking();
 #else
+    aria_gc_enter_blocking();
     int result = pthread_mutex_lock(&mutex->mutex);
+    aria_gc_leave_blocking();
     if (result != 0) {
         return aria_result_err(get_error_message("pthread_mutex_lock"));
     }
@@ -499,12 +512,16 @@ AriaResult* aria_condvar_wait(AriaCondVar* condvar, AriaMutex* mutex) {
     }
 
 #ifdef _WIN32
+    aria_gc_enter_blocking();
     BOOL result = SleepConditionVariableCS(&condvar->cv, &mutex->cs, INFINITE);
+    aria_gc_leave_blocking();
     if (!result) {
         return aria_result_err(get_error_message("SleepConditionVariableCS"));
     }
 #else
+    aria_gc_enter_blocking();
     int result = pthread_cond_wait(&condvar->cond, &mutex->mutex);
+    aria_gc_leave_blocking();
     if (result != 0) {
         return aria_result_err(get_error_message("pthread_cond_wait"));
     }
@@ -521,7 +538,9 @@ AriaResult* aria_condvar_timedwait(AriaCondVar* condvar, AriaMutex* mutex,
 
 #ifdef _WIN32
     DWORD timeout_ms = (DWORD)(timeout_ns / 1000000);
+    aria_gc_enter_blocking();
     BOOL result = SleepConditionVariableCS(&condvar->cv, &mutex->cs, timeout_ms);
+    aria_gc_leave_blocking();
     if (!result) {
         if (GetLastError() == ERROR_TIMEOUT) {
             return aria_result_ok((void*)0, 0); // success=false indicates timeout
@@ -541,7 +560,9 @@ AriaResult* aria_condvar_timedwait(AriaCondVar* condvar, AriaMutex* mutex,
         abstime.tv_nsec -= 1000000000;
     }
 
+    aria_gc_enter_blocking();
     int result = pthread_cond_timedwait(&condvar->cond, &mutex->mutex, &abstime);
+    aria_gc_leave_blocking();
     if (result == ETIMEDOUT) {
         return aria_result_ok((void*)0, 0); // success=false indicates timeout
     }
@@ -712,9 +733,13 @@ AriaResult* aria_rwlock_rdlock(AriaRWLock* rwlock) {
     }
 
 #ifdef _WIN32
+    aria_gc_enter_blocking();
     AcquireSRWLockShared(&rwlock->lock);
+    aria_gc_leave_blocking();
 #else
+    aria_gc_enter_blocking();
     int result = pthread_rwlock_rdlock(&rwlock->lock);
+    aria_gc_leave_blocking();
     if (result != 0) {
         return aria_result_err(get_error_message("pthread_rwlock_rdlock"));
     }
@@ -752,9 +777,13 @@ AriaResult* aria_rwlock_wrlock(AriaRWLock* rwlock) {
     }
 
 #ifdef _WIN32
+    aria_gc_enter_blocking();
     AcquireSRWLockExclusive(&rwlock->lock);
+    aria_gc_leave_blocking();
 #else
+    aria_gc_enter_blocking();
     int result = pthread_rwlock_wrlock(&rwlock->lock);
+    aria_gc_leave_blocking();
     if (result != 0) {
         return aria_result_err(get_error_message("pthread_rwlock_wrlock"));
     }
@@ -857,9 +886,13 @@ AriaResult* aria_barrier_wait(AriaBarrier* barrier) {
     }
 
 #ifdef _WIN32
+    aria_gc_enter_blocking();
     EnterSynchronizationBarrier(&barrier->barrier, 0);
+    aria_gc_leave_blocking();
 #else
+    aria_gc_enter_blocking();
     int result = pthread_barrier_wait(&barrier->barrier);
+    aria_gc_leave_blocking();
     if (result != 0 && result != PTHREAD_BARRIER_SERIAL_THREAD) {
         return aria_result_err(get_error_message("pthread_barrier_wait"));
     }
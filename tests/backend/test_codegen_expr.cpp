@@ -0,0 +1,195 @@
+/**
+ * test_codegen_expr.cpp
+ *
+ * Unit tests for expression code generation: fusion of collection
+ * stages in |> pipelines into lazy iterator passes.
+ */
+
+#include "../test_helpers.h"
+#include "backend/ir/codegen_expr.h"
+#include "backend/ir/codegen_stmt.h"
+#include "frontend/ast/expr.h"
+#include "frontend/ast/stmt.h"
+#include "frontend/token.h"
+#include "runtime/collections.h"
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace aria;
+using namespace aria::backend;
+
+namespace {
+
+// Expression and statement codegen for one module, wired to each other
+struct CodegenFixture {
+    llvm::LLVMContext context;
+    llvm::Module module{"test", context};
+    llvm::IRBuilder<> builder{context};
+    std::map<std::string, llvm::Value*> named_values;
+    ExprCodegen expr{context, builder, &module, named_values};
+    StmtCodegen stmt{context, builder, &module, named_values};
+
+    CodegenFixture() {
+        expr.setStmtCodegen(&stmt);
+        stmt.setExprCodegen(&expr);
+
+        // Source and callbacks for the pipelines below
+        llvm::Type* ptr = llvm::PointerType::get(context, 0);
+        llvm::Type* i64 = llvm::Type::getInt64Ty(context);
+        declare("make", ptr, {});
+        declare("context", ptr, {});
+        declare("keep", llvm::Type::getInt1Ty(context), {ptr, i64, ptr});
+        declare("square", llvm::Type::getVoidTy(context), {ptr, i64, ptr, ptr});
+        declare("sum", llvm::Type::getVoidTy(context), {ptr, ptr, i64, ptr});
+    }
+
+    void declare(const std::string& name, llvm::Type* ret, std::vector<llvm::Type*> params) {
+        llvm::Function::Create(llvm::FunctionType::get(ret, params, false),
+                               llvm::Function::ExternalLinkage, name, module);
+    }
+
+    // void f() { pipeline; }
+    llvm::Function* function(ASTNodePtr pipeline) {
+        std::vector<ASTNodePtr> body = {std::make_shared<ExpressionStmt>(pipeline)};
+        FuncDeclStmt decl("f", "void", {}, std::make_shared<BlockStmt>(body));
+        return stmt.codegenFuncDecl(&decl);
+    }
+};
+
+ASTNodePtr ident(const std::string& name) {
+    return std::make_shared<IdentifierExpr>(name);
+}
+
+ASTNodePtr integer(int64_t value) {
+    return std::make_shared<LiteralExpr>(value);
+}
+
+ASTNodePtr null() {
+    return std::make_shared<LiteralExpr>(std::monostate{});
+}
+
+ASTNodePtr call(const std::string& name, std::vector<ASTNodePtr> args) {
+    return std::make_shared<CallExpr>(ident(name), args);
+}
+
+ASTNodePtr filter(ASTNodePtr context = null()) {
+    return call("aria_array_filter", {ident("keep"), context});
+}
+
+ASTNodePtr transform(int64_t type_id) {
+    return call("aria_array_transform", {ident("square"), integer(8), integer(type_id), null()});
+}
+
+ASTNodePtr reduce() {
+    return call("aria_array_reduce", {ident("sum"), null(), integer(8), null()});
+}
+
+// make() |> stages[0] |> stages[1] ...
+ASTNodePtr pipeline(std::vector<ASTNodePtr> stages) {
+    ASTNodePtr value = call("make", {});
+    for (const ASTNodePtr& stage : stages) {
+        value = std::make_shared<BinaryExpr>(value, Token(TokenType::TOKEN_PIPE_RIGHT, "|>", 0, 0), stage);
+    }
+    return value;
+}
+
+// aria_iter_* calls in instruction order, without the prefix
+std::vector<std::string> callSequence(llvm::Function* func) {
+    std::vector<std::string> sequence;
+    for (llvm::BasicBlock& block : *func) {
+        for (llvm::Instruction& inst : block) {
+            auto* call = llvm::dyn_cast<llvm::CallInst>(&inst);
+            if (call && call->getCalledFunction()) {
+                std::string name = call->getCalledFunction()->getName().str();
+                if (name.rfind("aria_iter_", 0) == 0) {
+                    sequence.push_back(name.substr(10));
+                }
+            }
+        }
+    }
+    return sequence;
+}
+
+// First aria_iter_init call, or null
+llvm::CallInst* iterInit(llvm::Function* func) {
+    for (llvm::BasicBlock& block : *func) {
+        for (llvm::Instruction& inst : block) {
+            auto* call = llvm::dyn_cast<llvm::CallInst>(&inst);
+            if (call && call->getCalledFunction() &&
+                call->getCalledFunction()->getName() == "aria_iter_init") {
+                return call;
+            }
+        }
+    }
+    return nullptr;
+}
+
+std::string join(const std::vector<std::string>& parts) {
+    std::string text;
+    for (const std::string& part : parts) {
+        text += (text.empty() ? "" : " ") + part;
+    }
+    return text;
+}
+
+} // namespace
+
+// Runs longer than one iterator's stage limit are split
+TEST_CASE(codegen_pipeline_fusion_stage_limit) {
+    CodegenFixture fx;
+
+    std::vector<ASTNodePtr> stages;
+    for (int i = 0; i < ARIA_ITER_MAX_STAGES + 2; i++) {
+        stages.push_back(filter());
+    }
+    stages.push_back(reduce());
+    llvm::Function* func = fx.function(pipeline(stages));
+    ASSERT_FALSE(llvm::verifyFunction(*func, &llvm::errs()), "Function should verify");
+
+    std::vector<std::string> expected = {"init"};
+    expected.insert(expected.end(), ARIA_ITER_MAX_STAGES, "filter");
+    expected.insert(expected.end(), {"collect", "init", "filter", "filter", "reduce"});
+    ASSERT(join(callSequence(func)) == join(expected),
+           "Each iterator should hold at most ARIA_ITER_MAX_STAGES stages");
+}
+
+// Only transforms with leaf output feed further fused stages
+TEST_CASE(codegen_pipeline_fusion_reference_transform) {
+    CodegenFixture fx;
+    llvm::Function* leaf = fx.function(pipeline({filter(), transform(0), filter(), reduce()}));
+    ASSERT_FALSE(llvm::verifyFunction(*leaf, &llvm::errs()), "Function should verify");
+    ASSERT(join(callSequence(leaf)) == "init filter transform filter reduce",
+           "A leaf transform should fuse with the stages after it");
+
+    CodegenFixture fx2;
+    llvm::Function* refs = fx2.function(pipeline({filter(), transform(3), filter(), reduce()}));
+    ASSERT_FALSE(llvm::verifyFunction(*refs, &llvm::errs()), "Function should verify");
+    ASSERT(join(callSequence(refs)) == "init filter transform collect init filter reduce",
+           "A transform with references should end its run");
+}
+
+// A source computed before allocating stage arguments is rooted and reloaded
+TEST_CASE(codegen_pipeline_source_rooted) {
+    CodegenFixture fx;
+    llvm::Function* plain = fx.function(pipeline({filter(), filter()}));
+    ASSERT_FALSE(llvm::verifyFunction(*plain, &llvm::errs()), "Function should verify");
+    llvm::CallInst* init = iterInit(plain);
+    ASSERT(init != nullptr && llvm::isa<llvm::CallInst>(init->getArgOperand(1)),
+           "Literal and name arguments should leave the source unrooted");
+
+    CodegenFixture fx2;
+    llvm::Function* func = fx2.function(pipeline({filter(call("context", {})), filter()}));
+    ASSERT_FALSE(llvm::verifyFunction(*func, &llvm::errs()), "Function should verify");
+    init = iterInit(func);
+    ASSERT(init != nullptr, "The stages should be fused");
+
+    auto* load = llvm::dyn_cast<llvm::LoadInst>(init->getArgOperand(1));
+    auto* slot = load ? llvm::dyn_cast<llvm::GetElementPtrInst>(load->getPointerOperand()) : nullptr;
+    ASSERT(slot != nullptr && slot->getName().str().rfind("gc.root", 0) == 0,
+           "The iterator should start from the source reloaded from its root slot");
+}
@@ -0,0 +1,505 @@
+/**
+ * test_codegen_stmt.cpp
+ *
+ * Unit tests for statement code generation: shadow stack frames of gc
+ * locals, the reloading of locals the collector may move, stack-promoted
+ * gc locals, inline write barriers and their elision, and arena release
+ * on early exits from a region.
+ */
+
+#include "../test_helpers.h"
+#include "backend/ir/codegen_expr.h"
+#include "backend/ir/codegen_stmt.h"
+#include "frontend/ast/expr.h"
+#include "frontend/ast/stmt.h"
+#include "frontend/token.h"
+#include "runtime/gc.h"
+#include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/ExecutionEngine/MCJIT.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/DynamicLibrary.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace aria;
+using namespace aria::backend;
+
+namespace {
+
+// Expression and statement codegen for one module, wired to each other
+struct CodegenFixture {
+    llvm::LLVMContext context;
+    llvm::Module module{"test", context};
+    llvm::IRBuilder<> builder{context};
+    std::map<std::string, llvm::Value*> named_values;
+    ExprCodegen expr{context, builder, &module, named_values};
+    StmtCodegen stmt{context, builder, &module, named_values};
+
+    CodegenFixture() {
+        expr.setStmtCodegen(&stmt);
+        stmt.setExprCodegen(&expr);
+    }
+
+    llvm::PointerType* ptrType() { return llvm::PointerType::get(context, 0); }
+
+    // External function the generated code can call
+    void declare(const std::string& name, llvm::Type* ret, std::vector<llvm::Type*> params) {
+        llvm::Function::Create(llvm::FunctionType::get(ret, params, false),
+                               llvm::Function::ExternalLinkage, name, module);
+    }
+
+    llvm::Function* function(const std::string& name, const std::string& ret,
+                             std::vector<ASTNodePtr> body) {
+        FuncDeclStmt decl(name, ret, {}, std::make_shared<BlockStmt>(body));
+        return stmt.codegenFuncDecl(&decl);
+    }
+};
+
+ASTNodePtr ident(const std::string& name) {
+    return std::make_shared<IdentifierExpr>(name);
+}
+
+ASTNodePtr callStmt(const std::string& name, std::vector<ASTNodePtr> args) {
+    return std::make_shared<ExpressionStmt>(std::make_shared<CallExpr>(ident(name), args));
+}
+
+ASTNodePtr gcDecl(const std::string& type, const std::string& name, ASTNodePtr init) {
+    auto decl = std::make_shared<VarDeclStmt>(type, name, init);
+    decl->isGC = true;
+    return decl;
+}
+
+// arena { body }, released by a cleanup block as the parser builds it
+ASTNodePtr region(const std::string& arena, std::vector<ASTNodePtr> body) {
+    auto cleanup = std::make_shared<BlockStmt>(std::vector<ASTNodePtr>{
+        callStmt("aria_arena_destroy", {ident(arena)})});
+    return std::make_shared<RegionStmt>(std::make_shared<BlockStmt>(body), arena, cleanup);
+}
+
+// Calls to callee in instruction order
+std::vector<llvm::CallInst*> callsTo(llvm::Function* func, const std::string& callee) {
+    std::vector<llvm::CallInst*> calls;
+    for (llvm::BasicBlock& block : *func) {
+        for (llvm::Instruction& inst : block) {
+            auto* call = llvm::dyn_cast<llvm::CallInst>(&inst);
+            if (call && call->getCalledFunction() &&
+                call->getCalledFunction()->getName() == callee) {
+                calls.push_back(call);
+            }
+        }
+    }
+    return calls;
+}
+
+// Root slot GEP (%gc.root) a value was loaded from, or null
+llvm::Value* loadedRootSlot(llvm::Value* value) {
+    auto* load = llvm::dyn_cast<llvm::LoadInst>(value);
+    if (!load) return nullptr;
+    auto* gep = llvm::dyn_cast<llvm::GetElementPtrInst>(load->getPointerOperand());
+    return (gep && gep->getName().str().rfind("gc.root", 0) == 0) ? gep : nullptr;
+}
+
+// Run a generated bool() function; the gc runtime and keep() are
+// stubbed so both heap and stack-promoted locals execute in-process
+bool runBoolFunction(llvm::Module& module, const std::string& name) {
+    static bool initialized = false;
+    if (!initialized) {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+        initialized = true;
+    }
+    static void* shadow_stack_top = nullptr;
+    static auto gc_alloc = [](uint64_t size, uint16_t) { return std::calloc(1, size); };
+    llvm::sys::DynamicLibrary::AddSymbol("aria_shadow_stack_top", &shadow_stack_top);
+    static auto keep = [](void*) {};
+    llvm::sys::DynamicLibrary::AddSymbol(
+        "aria_gc_alloc", reinterpret_cast<void*>(+gc_alloc));
+    llvm::sys::DynamicLibrary::AddSymbol("keep", reinterpret_cast<void*>(+keep));
+
+    std::unique_ptr<llvm::Module> copy = llvm::CloneModule(module);
+    if (llvm::GlobalVariable* top = copy->getNamedGlobal("aria_shadow_stack_top")) {
+        top->setThreadLocal(false);  // The JIT links TLS globals like plain ones
+    }
+    std::unique_ptr<llvm::ExecutionEngine> engine(
+        llvm::EngineBuilder(std::move(copy)).setEngineKind(llvm::EngineKind::JIT).create());
+    auto func = reinterpret_cast<bool (*)()>(engine->getFunctionAddress(name));
+    return func();
+}
+
+// bool f() { gc i64:x = 7; gc i64:y = 7; [keep(x); keep(y);] return x == y; }
+llvm::Function* gcEqualityFunction(CodegenFixture& fx, bool escape) {
+    fx.declare("keep", llvm::Type::getVoidTy(fx.context), {fx.ptrType()});
+    std::vector<ASTNodePtr> body = {
+        gcDecl("i64", "x", std::make_shared<LiteralExpr>(int64_t(7))),
+        gcDecl("i64", "y", std::make_shared<LiteralExpr>(int64_t(7))),
+    };
+    if (escape) {
+        body.push_back(callStmt("keep", {ident("x")}));
+        body.push_back(callStmt("keep", {ident("y")}));
+    }
+    body.push_back(std::make_shared<ReturnStmt>(std::make_shared<BinaryExpr>(
+        ident("x"), Token(TokenType::TOKEN_EQUAL_EQUAL, "==", 0, 0), ident("y"))));
+    return fx.function("f", "bool", body);
+}
+
+} // namespace
+
+// gc locals get a shadow frame linked at entry and unlinked at each return
+TEST_CASE(codegen_gc_frame_prologue_epilogue) {
+    CodegenFixture fx;
+    fx.declare("use", llvm::Type::getVoidTy(fx.context), {fx.ptrType()});
+
+    llvm::Function* func = fx.function("f", "void", {
+        gcDecl("i64", "x", std::make_shared<LiteralExpr>(int64_t(1))),
+        callStmt("use", {ident("x")}),
+    });
+    ASSERT_FALSE(llvm::verifyFunction(*func, &llvm::errs()), "Function should verify");
+
+    llvm::GlobalVariable* top = fx.module.getNamedGlobal("aria_shadow_stack_top");
+    ASSERT(top != nullptr, "Shadow stack head should be declared");
+
+    // Prologue: the entry block stores the frame into the head
+    bool linked = false;
+    for (llvm::Instruction& inst : func->getEntryBlock()) {
+        auto* store = llvm::dyn_cast<llvm::StoreInst>(&inst);
+        if (store && store->getPointerOperand() == top &&
+            llvm::isa<llvm::AllocaInst>(store->getValueOperand()->stripPointerCasts())) {
+            linked = true;
+        }
+    }
+    ASSERT(linked, "Entry block should link the frame");
+
+    // Epilogue: each ret is preceded by restoring the caller's frame
+    bool unlinked = true;
+    for (llvm::BasicBlock& block : *func) {
+        if (auto* ret = llvm::dyn_cast<llvm::ReturnInst>(block.getTerminator())) {
+            auto* store = llvm::dyn_cast_or_null<llvm::StoreInst>(ret->getPrevNode());
+            unlinked = unlinked && store && store->getPointerOperand() == top;
+        }
+    }
+    ASSERT(unlinked, "Every return should unlink the frame");
+}
+
+// Uses after a call read the (possibly moved) object from its root slot
+TEST_CASE(codegen_gc_local_reloaded_after_call) {
+    CodegenFixture fx;
+    fx.declare("use", llvm::Type::getVoidTy(fx.context), {fx.ptrType()});
+    fx.declare("next", llvm::Type::getInt64Ty(fx.context), {});
+
+    llvm::Function* func = fx.function("f", "void", {
+        gcDecl("i64", "x", std::make_shared<LiteralExpr>(int64_t(1))),
+        callStmt("use", {ident("x")}),
+        callStmt("use", {ident("x")}),
+        gcDecl("i64", "y", std::make_shared<CallExpr>(ident("next"), std::vector<ASTNodePtr>{})),
+        callStmt("use", {ident("y")}),
+    });
+    ASSERT_FALSE(llvm::verifyFunction(*func, &llvm::errs()), "Function should verify");
+
+    std::vector<llvm::CallInst*> allocs = callsTo(func, "aria_gc_alloc");
+    std::vector<llvm::CallInst*> uses = callsTo(func, "use");
+    ASSERT_EQ(allocs.size(), size_t(2), "Both locals should be heap allocated");
+    ASSERT_EQ(uses.size(), size_t(3), "Every use should be a call");
+
+    llvm::Value* first = loadedRootSlot(uses[0]->getArgOperand(0));
+    llvm::Value* second = loadedRootSlot(uses[1]->getArgOperand(0));
+    ASSERT(first != nullptr && first == second, "Each use should load x from its root slot");
+
+    // x's initializer makes no call: the store may use the fresh pointer
+    bool fresh_store = false;
+    for (llvm::User* user : allocs[0]->users()) {
+        auto* store = llvm::dyn_cast<llvm::StoreInst>(user);
+        fresh_store = fresh_store || (store && store->getPointerOperand() == allocs[0]);
+    }
+    ASSERT(fresh_store, "Initializer without calls should store through the allocation");
+
+    // y's initializer calls next(): the store must reload the object
+    bool reloaded_store = false;
+    for (llvm::BasicBlock& block : *func) {
+        for (llvm::Instruction& inst : block) {
+            auto* store = llvm::dyn_cast<llvm::StoreInst>(&inst);
+            if (store && store->getValueOperand()->getType()->isIntegerTy(64) &&
+                loadedRootSlot(store->getPointerOperand())) {
+                reloaded_store = true;
+            }
+        }
+    }
+    ASSERT(reloaded_store, "Initializer after a call should store through a reload");
+}
+
+// return evaluates its value before the region's arena is released
+TEST_CASE(codegen_return_from_region) {
+    CodegenFixture fx;
+    fx.declare("read", llvm::Type::getInt64Ty(fx.context), {fx.ptrType()});
+
+    auto x = std::make_shared<VarDeclStmt>("i64", "x", std::make_shared<LiteralExpr>(int64_t(7)));
+    x->isArena = true;
+    auto read = std::make_shared<CallExpr>(ident("read"), std::vector<ASTNodePtr>{ident("x")});
+    llvm::Function* func = fx.function("f", "i64", {
+        region("__arena.0", {x, std::make_shared<ReturnStmt>(read)}),
+    });
+    ASSERT_FALSE(llvm::verifyFunction(*func, &llvm::errs()), "Function should verify");
+
+    std::vector<llvm::CallInst*> destroys = callsTo(func, "aria_arena_destroy");
+    std::vector<llvm::CallInst*> reads = callsTo(func, "read");
+    ASSERT_EQ(destroys.size(), size_t(1), "Only the return path should release the arena");
+    ASSERT_EQ(reads.size(), size_t(1), "The return value should be computed once");
+
+    auto* ret = llvm::dyn_cast<llvm::ReturnInst>(destroys[0]->getParent()->getTerminator());
+    ASSERT(ret != nullptr && ret->getReturnValue() == reads[0],
+           "The arena should be released on the return path");
+    ASSERT(reads[0]->getParent() == destroys[0]->getParent() && reads[0]->comesBefore(destroys[0]),
+           "The return value should be read before the release");
+}
+
+// A nested function does not run the enclosing region's defers or use its arena
+TEST_CASE(codegen_nested_function_in_region) {
+    CodegenFixture fx;
+    fx.declare("after", llvm::Type::getVoidTy(fx.context), {});
+
+    auto nested = std::make_shared<FuncDeclStmt>("g", "i64", std::vector<ASTNodePtr>{},
+        std::make_shared<BlockStmt>(std::vector<ASTNodePtr>{
+            std::make_shared<ReturnStmt>(std::make_shared<LiteralExpr>(int64_t(1)))}));
+    llvm::Function* func = fx.function("f", "void", {
+        region("__arena.0", {nested, callStmt("after", {})}),
+    });
+    ASSERT_FALSE(llvm::verifyFunction(*func, &llvm::errs()), "Function should verify");
+
+    llvm::Function* g = fx.module.getFunction("g");
+    ASSERT(g != nullptr, "The nested function should be generated");
+    ASSERT(callsTo(g, "aria_arena_destroy").empty(), "The nested return should not release the region");
+    ASSERT_EQ(callsTo(func, "aria_arena_destroy").size(), size_t(1), "The region should be released once");
+    ASSERT_EQ(callsTo(func, "after").size(), size_t(1), "The region body should continue in f");
+
+    auto x = std::make_shared<VarDeclStmt>("i64", "x", std::make_shared<LiteralExpr>(int64_t(7)));
+    x->isArena = true;
+    auto arena_use = std::make_shared<FuncDeclStmt>("h", "void", std::vector<ASTNodePtr>{},
+        std::make_shared<BlockStmt>(std::vector<ASTNodePtr>{x}));
+    bool rejected = false;
+    try {
+        fx.function("k", "void", {region("__arena.1", {arena_use})});
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    ASSERT(rejected, "An arena variable in a nested function should be rejected");
+}
+
+// A pointer result is rooted across the defers that run before ret
+TEST_CASE(codegen_return_rooted_across_defers) {
+    CodegenFixture fx;
+    fx.declare("make", fx.ptrType(), {});
+    fx.declare("collect", llvm::Type::getVoidTy(fx.context), {});
+
+    auto make = std::make_shared<CallExpr>(ident("make"), std::vector<ASTNodePtr>{});
+    auto returnMade = [&](bool with_defer) {
+        llvm::Function* func = llvm::Function::Create(
+            llvm::FunctionType::get(fx.ptrType(), {}, false),
+            llvm::Function::ExternalLinkage, with_defer ? "deferred" : "plain", fx.module);
+        fx.builder.SetInsertPoint(llvm::BasicBlock::Create(fx.context, "entry", func));
+        std::vector<ASTNodePtr> body = {std::make_shared<ReturnStmt>(make)};
+        if (with_defer) {
+            body.insert(body.begin(), std::make_shared<DeferStmt>(std::make_shared<BlockStmt>(
+                std::vector<ASTNodePtr>{callStmt("collect", {})})));
+        }
+        GCRootFrame enclosing = fx.stmt.beginGCRootFrame(func);
+        fx.stmt.codegenBlock(std::make_shared<BlockStmt>(body).get());
+        fx.stmt.endGCRootFrame(enclosing);
+        return func;
+    };
+
+    llvm::Function* plain = returnMade(false);
+    ASSERT_FALSE(llvm::verifyFunction(*plain, &llvm::errs()), "Function should verify");
+    std::vector<llvm::CallInst*> made = callsTo(plain, "make");
+    ASSERT(made.size() == 1 && made[0]->getParent()->getTerminator()->getOperand(0) == made[0],
+           "Without defers the result should be returned directly");
+
+    llvm::Function* func = returnMade(true);
+    ASSERT_FALSE(llvm::verifyFunction(*func, &llvm::errs()), "Function should verify");
+    made = callsTo(func, "make");
+    std::vector<llvm::CallInst*> collects = callsTo(func, "collect");
+    ASSERT(made.size() == 1 && collects.size() == 1, "Each call should be emitted once");
+
+    llvm::Value* slot = nullptr;
+    for (llvm::User* user : made[0]->users()) {
+        auto* store = llvm::dyn_cast<llvm::StoreInst>(user);
+        if (store && store->getValueOperand() == made[0] && store->comesBefore(collects[0])) {
+            slot = store->getPointerOperand();
+        }
+    }
+    ASSERT(slot != nullptr && slot->getName().str().rfind("gc.root", 0) == 0,
+           "The result should be stored in a root slot before the defer runs");
+
+    auto* ret = llvm::dyn_cast<llvm::ReturnInst>(collects[0]->getParent()->getTerminator());
+    ASSERT(ret != nullptr && loadedRootSlot(ret->getReturnValue()) == slot,
+           "The result should be reloaded from its root slot after the defer");
+}
+
+// break and continue release arenas of regions nested in the loop body
+TEST_CASE(codegen_break_from_region) {
+    CodegenFixture fx;
+    fx.declare("done", llvm::Type::getInt1Ty(fx.context), {});
+    auto done = std::make_shared<CallExpr>(ident("done"), std::vector<ASTNodePtr>{});
+
+    llvm::Function* func = fx.function("f", "void", {
+        std::make_shared<WhileStmt>(std::make_shared<LiteralExpr>(int64_t(1)),
+            std::make_shared<BlockStmt>(std::vector<ASTNodePtr>{
+                region("__arena.0", {
+                    std::make_shared<IfStmt>(done, std::make_shared<BlockStmt>(
+                        std::vector<ASTNodePtr>{std::make_shared<BreakStmt>()})),
+                    std::make_shared<IfStmt>(done, std::make_shared<BlockStmt>(
+                        std::vector<ASTNodePtr>{std::make_shared<ContinueStmt>()})),
+                }),
+            })),
+    });
+    ASSERT_FALSE(llvm::verifyFunction(*func, &llvm::errs()), "Function should verify");
+
+    // One release each on the break, continue and fallthrough paths
+    bool released_on_break = false;
+    bool released_on_continue = false;
+    std::vector<llvm::CallInst*> destroys = callsTo(func, "aria_arena_destroy");
+    for (llvm::CallInst* destroy : destroys) {
+        auto* br = llvm::dyn_cast<llvm::BranchInst>(destroy->getParent()->getTerminator());
+        if (br && br->isUnconditional()) {
+            released_on_break = released_on_break || br->getSuccessor(0)->getName() == "while.end";
+            released_on_continue = released_on_continue || br->getSuccessor(0)->getName() == "while.cond";
+        }
+    }
+    ASSERT_EQ(destroys.size(), size_t(3), "Every exit from the region should release it");
+    ASSERT(released_on_break, "break should release the arena");
+    ASSERT(released_on_continue, "continue should release the arena");
+}
+
+// Pointer stores get the inline SATB and card-marking barriers
+TEST_CASE(codegen_inline_write_barriers) {
+    CodegenFixture fx;
+    llvm::Type* i64 = llvm::Type::getInt64Ty(fx.context);
+    llvm::Function* func = llvm::Function::Create(
+        llvm::FunctionType::get(llvm::Type::getVoidTy(fx.context), {fx.ptrType(), fx.ptrType(), i64}, false),
+        llvm::Function::ExternalLinkage, "f", fx.module);
+    fx.builder.SetInsertPoint(llvm::BasicBlock::Create(fx.context, "entry", func));
+
+    llvm::Value* obj = func->getArg(0);
+    llvm::Value* slot = fx.builder.CreateConstInBoundsGEP1_64(i64, obj, 1);
+    fx.stmt.emitGCStore(obj, slot, func->getArg(1));
+    size_t blocks = func->size();
+    fx.stmt.emitGCStore(obj, slot, func->getArg(2));
+    ASSERT_EQ(func->size(), blocks, "Non-pointer stores should need no barrier");
+    fx.builder.CreateRetVoid();
+    ASSERT_FALSE(llvm::verifyFunction(*func, &llvm::errs()), "Function should verify");
+
+    std::map<std::string, llvm::BasicBlock*> by_name;
+    for (llvm::BasicBlock& block : *func) {
+        by_name[block.getName().str()] = &block;
+    }
+    ASSERT(by_name.count("satb.log") && by_name.count("satb.done") &&
+           by_name.count("card.mark") && by_name.count("card.done"), "Both barriers should be inline");
+
+    // Pre-barrier: log the slot only while marking
+    std::vector<llvm::CallInst*> logs = callsTo(func, "aria_gc_write_barrier_pre");
+    ASSERT(logs.size() == 1 && logs[0]->getParent() == by_name["satb.log"] &&
+           logs[0]->getArgOperand(0)->stripPointerCasts() == slot,
+           "The SATB log call should sit on the marking path");
+
+    // Post-barrier: dirty the card and the segment summary, old objects only
+    size_t dirty_stores = 0;
+    for (llvm::Instruction& inst : *by_name["card.mark"]) {
+        auto* store = llvm::dyn_cast<llvm::StoreInst>(&inst);
+        auto* byte = store ? llvm::dyn_cast<llvm::ConstantInt>(store->getValueOperand()) : nullptr;
+        if (byte && byte->getBitWidth() == 8 && byte->getZExtValue() == ARIA_GC_CARD_DIRTY) {
+            dirty_stores++;
+        }
+    }
+    ASSERT_EQ(dirty_stores, size_t(2), "Card marking should be two byte stores");
+    auto* young = llvm::dyn_cast<llvm::BranchInst>(by_name["satb.done"]->getTerminator());
+    ASSERT(young && young->isConditional() && young->getSuccessor(0) == by_name["card.done"],
+           "Young targets and null values should skip card marking");
+}
+
+// Barriers are elided only for fresh objects that cannot be large objects
+TEST_CASE(codegen_barrier_elision_small_objects) {
+    CodegenFixture fx;
+    fx.stmt.setElideWriteBarriers(true);
+    fx.declare("aria_gc_alloc", fx.ptrType(),
+               {llvm::Type::getInt64Ty(fx.context), llvm::Type::getInt16Ty(fx.context)});
+    fx.declare("size", llvm::Type::getInt64Ty(fx.context), {});
+
+    llvm::Function* func = llvm::Function::Create(
+        llvm::FunctionType::get(llvm::Type::getVoidTy(fx.context), {fx.ptrType()}, false),
+        llvm::Function::ExternalLinkage, "f", fx.module);
+    fx.builder.SetInsertPoint(llvm::BasicBlock::Create(fx.context, "entry", func));
+
+    llvm::Value* value = func->getArg(0);
+    llvm::Type* i16 = llvm::Type::getInt16Ty(fx.context);
+    llvm::Function* alloc = fx.module.getFunction("aria_gc_alloc");
+    auto storeIntoFresh = [&](llvm::Value* size) {
+        llvm::Value* obj = fx.builder.CreateCall(alloc, {size, llvm::ConstantInt::get(i16, 0)});
+        fx.stmt.emitGCStore(obj, obj, value);
+    };
+
+    // Small: elided. At the large-object minimum, or of unknown size: barriers
+    storeIntoFresh(fx.builder.getInt64(64));
+    ASSERT_EQ(func->size(), size_t(1), "A small fresh object should need no barrier");
+    storeIntoFresh(fx.builder.getInt64(ARIA_GC_MIN_LARGE_OBJECT_SIZE));
+    ASSERT(func->size() > 1, "A possibly large object should keep its barriers");
+    size_t blocks = func->size();
+    storeIntoFresh(fx.builder.CreateCall(fx.module.getFunction("size")));
+    ASSERT(func->size() > blocks, "An object of unknown size should keep its barriers");
+
+    fx.builder.CreateRetVoid();
+    ASSERT_FALSE(llvm::verifyFunction(*func, &llvm::errs()), "Function should verify");
+}
+
+// A stack-promoted gc local behaves like its heap form: it evaluates to
+// the object's address, and the object starts zeroed
+TEST_CASE(codegen_stack_promoted_gc_local_matches_heap) {
+    CodegenFixture heap_fx;
+    llvm::Function* heap = gcEqualityFunction(heap_fx, true);
+    ASSERT_FALSE(llvm::verifyFunction(*heap, &llvm::errs()), "Heap form should verify");
+    CodegenFixture stack_fx;
+    llvm::Function* stack = gcEqualityFunction(stack_fx, false);
+    ASSERT_FALSE(llvm::verifyFunction(*stack, &llvm::errs()), "Promoted form should verify");
+
+    ASSERT_EQ(callsTo(heap, "aria_gc_alloc").size(), size_t(2), "Escaping locals should be heap allocated");
+    ASSERT_EQ(callsTo(stack, "aria_gc_alloc").size(), size_t(0), "Local-only objects should be promoted");
+
+    // Both compare object addresses
+    auto comparison = [](llvm::Function* func) -> llvm::ICmpInst* {
+        auto* ret = llvm::dyn_cast<llvm::ReturnInst>(func->back().getTerminator());
+        return ret ? llvm::dyn_cast<llvm::ICmpInst>(ret->getReturnValue()) : nullptr;
+    };
+    llvm::ICmpInst* heap_cmp = comparison(heap);
+    llvm::ICmpInst* stack_cmp = comparison(stack);
+    ASSERT(heap_cmp && loadedRootSlot(heap_cmp->getOperand(0)) && loadedRootSlot(heap_cmp->getOperand(1)),
+           "Heap locals should compare the objects loaded from their root slots");
+    ASSERT(stack_cmp && llvm::isa<llvm::AllocaInst>(stack_cmp->getOperand(0)) &&
+           llvm::isa<llvm::AllocaInst>(stack_cmp->getOperand(1)),
+           "Promoted locals should compare the objects' addresses");
+
+    // The i32 initializer fills half of the object: it must be zeroed first
+    auto* x = llvm::cast<llvm::AllocaInst>(stack_cmp->getOperand(0));
+    std::vector<llvm::StoreInst*> stores;
+    for (llvm::User* user : x->users()) {
+        if (auto* store = llvm::dyn_cast<llvm::StoreInst>(user)) {
+            stores.push_back(store);
+        }
+    }
+    ASSERT_EQ(stores.size(), size_t(2), "Promoted x should be zeroed, then initialized");
+    llvm::StoreInst* zero = stores[0]->comesBefore(stores[1]) ? stores[0] : stores[1];
+    llvm::StoreInst* init = zero == stores[0] ? stores[1] : stores[0];
+    ASSERT(llvm::isa<llvm::Constant>(zero->getValueOperand()) &&
+           llvm::cast<llvm::Constant>(zero->getValueOperand())->isNullValue() &&
+           zero->getValueOperand()->getType()->isIntegerTy(64),
+           "The whole object should be zeroed");
+    ASSERT(init->getValueOperand()->getType()->isIntegerTy(32), "The initializer is narrower");
+
+    // Distinct objects with equal contents are not equal in either form
+    ASSERT_FALSE(runBoolFunction(heap_fx.module, "f"), "Heap objects should compare by address");
+    ASSERT_FALSE(runBoolFunction(stack_fx.module, "f"), "Promoted objects should compare by address");
+}
@@ -0,0 +1,940 @@
+/**
+ * Tests for the Aria Collections Runtime
+ *
+ * Tests the Swiss-table hash map and hash set (lookups, growth,
+ * tombstones, custom hashing, GC tracing of entries), hash-based
+ * array deduplication, the reentrant and parallel sorts, the fused
+ * lazy iterators and the parallel transform/filter/reduce.
+ */
+
+#include "../test_helpers.h"
+#include "runtime/collections.h"
+#include "runtime/gc.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Case-insensitive hashing and equality of 8-character keys
+uint64_t hash_lowercase(const void* key, size_t key_size, void*) {
+    char lowered[8];
+    const char* chars = static_cast<const char*>(key);
+    for (size_t i = 0; i < key_size; i++) {
+        lowered[i] = (chars[i] >= 'A' && chars[i] <= 'Z') ? chars[i] + 32 : chars[i];
+    }
+    return aria_hash_bytes(lowered, key_size);
+}
+
+bool equals_lowercase(const void* a, const void* b, size_t key_size, void*) {
+    const char* x = static_cast<const char*>(a);
+    const char* y = static_cast<const char*>(b);
+    for (size_t i = 0; i < key_size; i++) {
+        char cx = (x[i] >= 'A' && x[i] <= 'Z') ? x[i] + 32 : x[i];
+        char cy = (y[i] >= 'A' && y[i] <= 'Z') ? y[i] + 32 : y[i];
+        if (cx != cy) return false;
+    }
+    return true;
+}
+
+// Keys are GC references: hash the referenced value, not the address,
+// which changes when the collector moves the object
+uint64_t hash_boxed(const void* key, size_t, void*) {
+    int64_t* box;
+    std::memcpy(&box, key, sizeof(box));
+    return aria_hash_bytes(box, sizeof(*box));
+}
+
+bool equals_boxed(const void* a, const void* b, size_t, void*) {
+    int64_t* x;
+    int64_t* y;
+    std::memcpy(&x, a, sizeof(x));
+    std::memcpy(&y, b, sizeof(y));
+    return *x == *y;
+}
+
+// Count of int64 elements with the lowest bit ignored
+uint64_t hash_halved(const void* key, size_t, void*) {
+    int64_t value;
+    std::memcpy(&value, key, sizeof(value));
+    value /= 2;
+    return aria_hash_bytes(&value, sizeof(value));
+}
+
+bool equals_halved(const void* a, const void* b, size_t, void*) {
+    int64_t x, y;
+    std::memcpy(&x, a, sizeof(x));
+    std::memcpy(&y, b, sizeof(y));
+    return x / 2 == y / 2;
+}
+
+int compare_int64(const void* a, const void* b, void*) {
+    int64_t x, y;
+    std::memcpy(&x, a, sizeof(x));
+    std::memcpy(&y, b, sizeof(y));
+    return (x > y) - (x < y);
+}
+
+// Three-way int64 comparison; context (if set) counts calls
+int compare_int64_counted(const void* a, const void* b, void* context) {
+    if (context) {
+        static_cast<std::atomic<size_t>*>(context)->fetch_add(1, std::memory_order_relaxed);
+    }
+    return compare_int64(a, b, nullptr);
+}
+
+int compare_int64_descending(const void* a, const void* b, void*) {
+    return compare_int64(b, a, nullptr);
+}
+
+// Reference elements: sorted by the boxed value
+int compare_box(const void* a, const void* b, void*) {
+    int64_t* x;
+    int64_t* y;
+    std::memcpy(&x, a, sizeof(x));
+    std::memcpy(&y, b, sizeof(y));
+    return (*x > *y) - (*x < *y);
+}
+
+// 12-byte element: sorted by key, payload rides along
+struct Record {
+    int32_t key;
+    int32_t payload[2];
+};
+
+int compare_record(const void* a, const void* b, void*) {
+    int32_t x = static_cast<const Record*>(a)->key;
+    int32_t y = static_cast<const Record*>(b)->key;
+    return (x > y) - (x < y);
+}
+
+// Input shapes that defeat naive quicksort pivots
+std::vector<int64_t> sort_pattern(int pattern, size_t count) {
+    std::vector<int64_t> values(count);
+    std::mt19937_64 rng(pattern * 7919 + count);
+    for (size_t i = 0; i < count; i++) {
+        switch (pattern) {
+            case 0: values[i] = (int64_t)(rng() % 1000000); break;   // Random
+            case 1: values[i] = (int64_t)i; break;                   // Sorted
+            case 2: values[i] = (int64_t)(count - i); break;         // Reversed
+            case 3: values[i] = 42; break;                           // All equal
+            case 4: values[i] = (int64_t)std::min(i, count - i); break;  // Organ pipe
+            case 5: values[i] = (int64_t)(i % 17); break;            // Few distinct
+            default: values[i] = (int64_t)(i ^ 1); break;            // Nearly sorted
+        }
+    }
+    return values;
+}
+
+AriaArray* make_int64_array(const std::vector<int64_t>& values) {
+    AriaResultPtr result = aria_array_new(sizeof(int64_t), values.size(), 0);
+    AriaArray* array = (AriaArray*)result.value;
+    for (int64_t value : values) {
+        aria_array_push(array, &value);
+    }
+    return array;
+}
+
+std::vector<int64_t> int64_elements(const AriaArray* array) {
+    std::vector<int64_t> values(aria_array_length(array));
+    for (size_t i = 0; i < values.size(); i++) {
+        std::memcpy(&values[i], aria_array_get_unchecked(array, i), sizeof(int64_t));
+    }
+    return values;
+}
+
+// Iterator stage callbacks over int64 elements
+bool is_even(const void* element, size_t, void*) {
+    int64_t value;
+    std::memcpy(&value, element, sizeof(value));
+    return value % 2 == 0;
+}
+
+bool even_index(const void*, size_t index, void*) {
+    return index % 2 == 0;
+}
+
+void times_three(const void* element, size_t, void* out, void*) {
+    int64_t value;
+    std::memcpy(&value, element, sizeof(value));
+    value *= 3;
+    std::memcpy(out, &value, sizeof(value));
+}
+
+void narrow_plus_index(const void* element, size_t index, void* out, void*) {
+    int64_t value;
+    std::memcpy(&value, element, sizeof(value));
+    int32_t narrowed = (int32_t)(value + (int64_t)index);
+    std::memcpy(out, &narrowed, sizeof(narrowed));
+}
+
+void sum_int64(void* accumulator, const void* element, size_t, void*) {
+    int64_t value;
+    std::memcpy(&value, element, sizeof(value));
+    *(int64_t*)accumulator += value;
+}
+
+// Boxes each element in a fresh GC object, collecting now and then
+// (so objects move in the middle of the pass)
+void box_int64(const void* element, size_t index, void* out, void*) {
+    int64_t value;
+    std::memcpy(&value, element, sizeof(value));
+    if (index % 500 == 0) {
+        aria_gc_collect(false);
+    }
+    int64_t* box = (int64_t*)aria_gc_alloc(sizeof(int64_t), 0);
+    *box = value;
+    std::memcpy(out, &box, sizeof(box));
+}
+
+// Floating-point sum: not associative, so the combine order shows
+void sum_double(void* accumulator, const void* element, size_t, void*) {
+    int64_t value;
+    std::memcpy(&value, element, sizeof(value));
+    *(double*)accumulator += 1.0 / (double)(value + 1);
+}
+
+void combine_double(void* accumulator, const void* partial, void*) {
+    *(double*)accumulator += *(const double*)partial;
+}
+
+} // namespace
+
+// =============================================================================
+// Hash Map Tests
+// =============================================================================
+
+TEST_CASE(hashmap_put_get_remove) {
+    aria_gc_init(0, 0, 0, 0);
+
+    AriaResultPtr result = aria_hashmap_new(sizeof(int64_t), sizeof(int64_t), 0, 0,
+                                            nullptr, nullptr, nullptr);
+    ASSERT(!result.is_error, "Map creation should succeed");
+    AriaHashMap* map = (AriaHashMap*)result.value;
+
+    int64_t key = 42, value = 1;
+    AriaResultBool put = aria_hashmap_put(map, &key, &value);
+    ASSERT(!put.is_error && put.value, "First put should insert");
+
+    value = 2;
+    put = aria_hashmap_put(map, &key, &value);
+    ASSERT(!put.is_error && !put.value, "Second put should overwrite");
+    ASSERT_EQ(aria_hashmap_length(map), 1u, "Overwriting keeps one entry");
+
+    int64_t* found = (int64_t*)aria_hashmap_get(map, &key);
+    ASSERT(found != nullptr, "Key should be found");
+    ASSERT_EQ(*found, 2, "Value should be the latest one");
+
+    int64_t missing = 7;
+    ASSERT(aria_hashmap_get(map, &missing) == nullptr, "Absent key should not be found");
+    ASSERT(!aria_hashmap_remove(map, &missing), "Removing an absent key fails");
+    ASSERT(aria_hashmap_remove(map, &key), "Removing a present key succeeds");
+    ASSERT(!aria_hashmap_contains(map, &key), "Removed key should be gone");
+    ASSERT_EQ(aria_hashmap_length(map), 0u, "Map should be empty");
+
+    // Key zero is all zero bytes, like an unused slot
+    int64_t zero = 0;
+    ASSERT(!aria_hashmap_contains(map, &zero), "Zero key should not match unused slots");
+    aria_hashmap_put(map, &zero, &value);
+    ASSERT(aria_hashmap_contains(map, &zero), "Zero key should be storable");
+
+    result = aria_hashmap_new(0, sizeof(int64_t), 0, 0, nullptr, nullptr, nullptr);
+    ASSERT(result.is_error, "Zero key size should be rejected");
+}
+
+TEST_CASE(hashmap_growth_and_tombstones) {
+    aria_gc_init(0, 0, 0, 0);
+
+    AriaResultPtr result = aria_hashmap_new(sizeof(int64_t), sizeof(int64_t), 0, 0,
+                                            nullptr, nullptr, nullptr);
+    AriaHashMap* map = (AriaHashMap*)result.value;
+    aria_shadow_stack_push_frame();
+    aria_shadow_stack_add_root((void**)&map);
+
+    const int64_t count = 20000;
+    for (int64_t i = 0; i < count; i++) {
+        int64_t value = i * 3;
+        aria_hashmap_put(map, &i, &value);
+    }
+    ASSERT_EQ(aria_hashmap_length(map), (size_t)count, "Every key should be inserted");
+    ASSERT(map->capacity >= (size_t)count, "Table should have grown");
+
+    bool all_found = true;
+    for (int64_t i = 0; i < count; i++) {
+        int64_t* value = (int64_t*)aria_hashmap_get(map, &i);
+        all_found = all_found && value && *value == i * 3;
+    }
+    ASSERT(all_found, "Every value should survive the resizes");
+
+    // Churn: removals and inserts at a steady size must not grow the table
+    size_t capacity = map->capacity;
+    for (int64_t i = 0; i < count * 4; i++) {
+        int64_t old_key = i;
+        int64_t new_key = count + i;
+        aria_hashmap_remove(map, &old_key);
+        aria_hashmap_put(map, &new_key, &new_key);
+    }
+    ASSERT_EQ(aria_hashmap_length(map), (size_t)count, "Length should stay constant");
+    ASSERT_EQ(map->capacity, capacity, "Tombstones should be reclaimed in place");
+
+    size_t cursor = 0, visited = 0;
+    void* key;
+    void* value;
+    bool consistent = true;
+    while (aria_hashmap_next(map, &cursor, &key, &value)) {
+        consistent = consistent && *(int64_t*)key == *(int64_t*)value && *(int64_t*)key >= count * 4;
+        visited++;
+    }
+    ASSERT_EQ(visited, (size_t)count, "Iteration should visit every entry once");
+    ASSERT(consistent, "Iteration should yield the live entries");
+
+    aria_hashmap_clear(map);
+    ASSERT_EQ(aria_hashmap_length(map), 0u, "Clear should empty the map");
+    int64_t probe = count * 4;
+    ASSERT(!aria_hashmap_contains(map, &probe), "Cleared keys should be gone");
+
+    aria_shadow_stack_pop_frame();
+}
+
+TEST_CASE(hashmap_reserve) {
+    aria_gc_init(0, 0, 0, 0);
+
+    AriaResultPtr result = aria_hashmap_new(sizeof(int32_t), sizeof(int32_t), 0, 0,
+                                            nullptr, nullptr, nullptr);
+    AriaHashMap* map = (AriaHashMap*)result.value;
+
+    AriaResultVoid reserved = aria_hashmap_reserve(map, 1000);
+    ASSERT(!reserved.is_error, "Reserve should succeed");
+    size_t capacity = map->capacity;
+
+    for (int32_t i = 0; i < 1000; i++) {
+        aria_hashmap_put(map, &i, &i);
+    }
+    ASSERT_EQ(map->capacity, capacity, "Reserved map should not grow");
+    ASSERT_EQ(aria_hashmap_length(map), 1000u, "Every key should be inserted");
+}
+
+TEST_CASE(hashmap_custom_hash_and_equals) {
+    aria_gc_init(0, 0, 0, 0);
+
+    AriaResultPtr result = aria_hashmap_new(8, sizeof(int32_t), 0, 0,
+                                            hash_lowercase, equals_lowercase, nullptr);
+    AriaHashMap* map = (AriaHashMap*)result.value;
+
+    int32_t one = 1, two = 2;
+    aria_hashmap_put(map, "AbCdEfGh", &one);
+    AriaResultBool put = aria_hashmap_put(map, "abcdefgh", &two);
+    ASSERT(!put.is_error && !put.value, "Keys equal ignoring case are the same key");
+
+    int32_t* found = (int32_t*)aria_hashmap_get(map, "ABCDEFGH");
+    ASSERT(found != nullptr && *found == 2, "Lookup should use the custom equality");
+    ASSERT(!aria_hashmap_contains(map, "abcdefgx"), "Different keys stay different");
+}
+
+// =============================================================================
+// Hash Set Tests
+// =============================================================================
+
+TEST_CASE(hashset_traces_reference_elements) {
+    aria_gc_init(0, 0, 0, 0);
+
+    uint64_t bitmap = 1;
+    uint16_t ref_type = aria_gc_register_type(sizeof(void*), &bitmap);
+
+    AriaResultPtr result = aria_hashset_new(sizeof(void*), 0, ref_type,
+                                            hash_boxed, equals_boxed, nullptr);
+    ASSERT(!result.is_error, "Set creation should succeed");
+    AriaHashSet* set = (AriaHashSet*)result.value;
+    aria_shadow_stack_push_frame();
+    aria_shadow_stack_add_root((void**)&set);
+
+    // The set holds the only references to the boxes
+    const int64_t count = 500;
+    for (int64_t i = 0; i < count; i++) {
+        int64_t* box = (int64_t*)aria_gc_alloc(sizeof(int64_t), 0);
+        *box = i;
+        aria_hashset_insert(set, &box);
+        aria_hashset_insert(set, &box);
+    }
+    ASSERT_EQ(aria_hashset_length(set), (size_t)count, "Duplicates should be ignored");
+
+    aria_gc_collect(false);
+    aria_gc_collect(true);
+
+    // Boxes must have been kept alive (and updated if moved)
+    int64_t probe_value = 0;
+    int64_t* probe = &probe_value;
+    bool all_found = true;
+    for (int64_t i = 0; i < count; i++) {
+        probe_value = i;
+        all_found = all_found && aria_hashset_contains(set, &probe);
+    }
+    ASSERT(all_found, "Elements should survive collection");
+
+    size_t cursor = 0;
+    void* key;
+    int64_t sum = 0;
+    while (aria_hashmap_next(set, &cursor, &key, nullptr)) {
+        int64_t* box;
+        std::memcpy(&box, key, sizeof(box));
+        sum += *box;
+    }
+    ASSERT_EQ(sum, count * (count - 1) / 2, "Element payloads should be intact");
+
+    probe_value = 3;
+    ASSERT(aria_hashset_remove(set, &probe), "Remove should find the element");
+    ASSERT(!aria_hashset_contains(set, &probe), "Removed element should be gone");
+
+    aria_shadow_stack_pop_frame();
+}
+
+// =============================================================================
+// Array Barrier Tests
+// =============================================================================
+
+TEST_CASE(array_large_buffer_traces_young_elements) {
+    aria_gc_init(0, 0, 0, 0);
+
+    // Buffers from 32KB on live in the old-generation large-object space
+    GCPolicy policy;
+    aria_gc_get_policy(&policy);
+    GCPolicy small_threshold = policy;
+    small_threshold.large_object_size = ARIA_GC_MIN_LARGE_OBJECT_SIZE;
+    aria_gc_set_policy(&small_threshold);
+
+    uint64_t bitmap = 1;
+    uint16_t ref_type = aria_gc_register_type(sizeof(void*), &bitmap);
+    AriaArray* array = (AriaArray*)aria_array_new(sizeof(void*), 16, ref_type).value;
+    aria_shadow_stack_push_frame();
+    aria_shadow_stack_add_root((void**)&array);
+
+    // The array holds the only references to the young boxes, copied on
+    // growth, pushed into the old buffer and overwritten in it
+    const int64_t count = 8192;
+    for (int64_t i = 0; i < count; i++) {
+        int64_t* box = (int64_t*)aria_gc_alloc(sizeof(int64_t), 0);
+        *box = i;
+        aria_array_push(array, &box);
+    }
+    ASSERT_EQ(aria_gc_get_header(array->data)->is_nursery, 0u, "Buffer should be a large object");
+    for (int64_t i = 0; i < count; i += 7) {
+        int64_t* box = (int64_t*)aria_gc_alloc(sizeof(int64_t), 0);
+        *box = -i;
+        aria_array_set(array, (size_t)i, &box);
+    }
+
+    aria_gc_collect(false);
+
+    bool intact = array->length == (size_t)count;
+    for (int64_t i = 0; intact && i < count; i++) {
+        int64_t* box;
+        std::memcpy(&box, aria_array_get_unchecked(array, (size_t)i), sizeof(box));
+        intact = aria_gc_get_header(box)->is_nursery == 0 && *box == (i % 7 == 0 ? -i : i);
+    }
+    ASSERT(intact, "Young elements of a large buffer should be promoted by a minor GC");
+
+    aria_shadow_stack_pop_frame();
+    aria_gc_set_policy(&policy);
+}
+
+// =============================================================================
+// Array Unique Tests
+// =============================================================================
+
+TEST_CASE(array_unique_keeps_first_occurrences) {
+    aria_gc_init(0, 0, 0, 0);
+
+    AriaArray* array = make_int64_array({5, 3, 5, 1, 3, 3, 9, 1, 0, 0});
+    AriaResultPtr result = aria_array_unique(array, nullptr, nullptr);
+    ASSERT(!result.is_error, "Unique should succeed");
+    std::vector<int64_t> expected = {5, 3, 1, 9, 0};
+    ASSERT(int64_elements((AriaArray*)result.value) == expected, "Order of first occurrences is kept");
+
+    // Comparator path
+    result = aria_array_unique(array, compare_int64, nullptr);
+    ASSERT(!result.is_error, "Unique with comparator should succeed");
+    ASSERT(int64_elements((AriaArray*)result.value) == expected, "Comparator path agrees");
+
+    AriaArray* empty = make_int64_array({});
+    result = aria_array_unique(empty, nullptr, nullptr);
+    ASSERT(!result.is_error && aria_array_length((AriaArray*)result.value) == 0,
+           "Unique of an empty array is empty");
+
+    result = aria_array_unique(nullptr, nullptr, nullptr);
+    ASSERT(result.is_error, "NULL array should be rejected");
+}
+
+TEST_CASE(array_unique_by_custom_equality) {
+    aria_gc_init(0, 0, 0, 0);
+
+    AriaArray* array = make_int64_array({4, 5, 2, 3, 8, 9, 1});
+    AriaResultPtr result = aria_array_unique_by(array, hash_halved, equals_halved, nullptr);
+    ASSERT(!result.is_error, "Unique by should succeed");
+    std::vector<int64_t> expected = {4, 2, 8, 1};
+    ASSERT(int64_elements((AriaArray*)result.value) == expected, "Elements equal by x/2 collapse");
+}
+
+TEST_CASE(array_unique_large) {
+    aria_gc_init(0, 0, 0, 0);
+
+    std::vector<int64_t> values;
+    for (int64_t i = 0; i < 50000; i++) {
+        values.push_back(i % 1000);
+    }
+    AriaArray* array = make_int64_array(values);
+    AriaResultPtr result = aria_array_unique(array, nullptr, nullptr);
+    ASSERT(!result.is_error, "Unique should succeed");
+
+    std::vector<int64_t> unique = int64_elements((AriaArray*)result.value);
+    ASSERT_EQ(unique.size(), 1000u, "One element per distinct value");
+    bool ordered = true;
+    for (size_t i = 0; i < unique.size(); i++) {
+        ordered = ordered && unique[i] == (int64_t)i;
+    }
+    ASSERT(ordered, "First occurrences are in input order");
+}
+
+// =============================================================================
+// Sort Tests
+// =============================================================================
+
+TEST_CASE(array_sort_patterns) {
+    aria_gc_init(0, 0, 0, 0);
+
+    const size_t sizes[] = {0, 1, 2, 23, 24, 129, 1000, 20000};
+    bool all_sorted = true;
+    bool bounded = true;
+    for (int pattern = 0; pattern < 7; pattern++) {
+        for (size_t count : sizes) {
+            std::vector<int64_t> values = sort_pattern(pattern, count);
+            AriaArray* array = make_int64_array(values);
+
+            std::atomic<size_t> comparisons{0};
+            AriaResultVoid result = aria_array_sort(array, compare_int64_counted, &comparisons);
+            all_sorted = all_sorted && !result.is_error;
+
+            std::sort(values.begin(), values.end());
+            all_sorted = all_sorted && int64_elements(array) == values;
+
+            // O(n log n) on every shape, with a generous constant
+            size_t log2 = 1;
+            while ((size_t(1) << log2) < count) log2++;
+            bounded = bounded && comparisons.load() <= 4 * count * log2 + 64;
+        }
+    }
+    ASSERT(all_sorted, "Every pattern should sort correctly");
+    ASSERT(bounded, "No pattern should take quadratic comparisons");
+
+    ASSERT(aria_array_sort(nullptr, compare_int64, nullptr).is_error, "NULL array should be rejected");
+    AriaArray* array = make_int64_array({2, 1});
+    ASSERT(aria_array_sort(array, nullptr, nullptr).is_error, "NULL comparator should be rejected");
+}
+
+TEST_CASE(array_sort_element_sizes) {
+    aria_gc_init(0, 0, 0, 0);
+
+    // 4 bytes
+    std::vector<int32_t> ints(5000);
+    std::mt19937 rng(1);
+    for (int32_t& value : ints) value = (int32_t)(rng() % 100000);
+    AriaArray* array = (AriaArray*)aria_array_new(sizeof(int32_t), ints.size(), 0).value;
+    for (int32_t value : ints) aria_array_push(array, &value);
+    aria_array_sort(array, [](const void* a, const void* b, void*) {
+        return (*(const int32_t*)a > *(const int32_t*)b) - (*(const int32_t*)a < *(const int32_t*)b);
+    }, nullptr);
+    std::sort(ints.begin(), ints.end());
+    ASSERT(std::memcmp(array->data, ints.data(), ints.size() * sizeof(int32_t)) == 0,
+           "4-byte elements should sort");
+
+    // 12 bytes (generic path): payloads must move with their keys
+    array = (AriaArray*)aria_array_new(sizeof(Record), 5000, 0).value;
+    for (int32_t i = 0; i < 5000; i++) {
+        Record record = {(int32_t)(rng() % 1000), {i, -i}};
+        aria_array_push(array, &record);
+    }
+    aria_array_sort(array, compare_record, nullptr);
+    bool ordered = true;
+    for (size_t i = 0; i < array->length; i++) {
+        Record* record = (Record*)aria_array_get_unchecked(array, i);
+        ordered = ordered && record->payload[0] == -record->payload[1];
+        if (i > 0) {
+            ordered = ordered && ((Record*)aria_array_get_unchecked(array, i - 1))->key <= record->key;
+        }
+    }
+    ASSERT(ordered, "12-byte elements should sort intact");
+}
+
+TEST_CASE(array_sort_concurrent_comparators) {
+    aria_gc_init(0, 0, 0, 0);
+
+    // Each thread sorts its own array in its own order; a shared
+    // comparator slot would mix the orders up
+    const size_t threads = 8;
+    std::vector<std::vector<int64_t>> inputs(threads);
+    std::vector<std::vector<int64_t>> outputs(threads);
+    for (size_t t = 0; t < threads; t++) {
+        inputs[t] = sort_pattern(0, 20000);
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            std::vector<int64_t>& values = inputs[t];
+            AriaComparatorFn comparator = (t % 2) ? compare_int64_descending : compare_int64;
+            for (int round = 0; round < 5; round++) {
+                std::vector<int64_t> copy = values;
+                AriaArray array = {copy.data(), copy.size(), copy.size(), sizeof(int64_t), 0};
+                aria_array_sort(&array, comparator, nullptr);
+                outputs[t] = copy;
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    bool correct = true;
+    for (size_t t = 0; t < threads; t++) {
+        std::vector<int64_t> expected = inputs[t];
+        std::sort(expected.begin(), expected.end());
+        if (t % 2) std::reverse(expected.begin(), expected.end());
+        correct = correct && outputs[t] == expected;
+    }
+    ASSERT(correct, "Concurrent sorts should each use their own comparator");
+}
+
+TEST_CASE(array_sort_parallel) {
+    aria_gc_init(0, 0, 0, 0);
+
+    // Exercise the helpers and the merge rounds even on one core (read
+    // when the pool is first used)
+    setenv("ARIA_COLLECTION_THREADS", "6", 0);
+
+    bool all_sorted = true;
+    for (int pattern = 0; pattern < 7; pattern++) {
+        std::vector<int64_t> values = sort_pattern(pattern, 300000);
+        AriaArray* array = make_int64_array(values);
+        aria_shadow_stack_push_frame();
+        aria_shadow_stack_add_root((void**)&array);
+
+        AriaResultVoid result = aria_array_sort_parallel(array, compare_int64, nullptr);
+        all_sorted = all_sorted && !result.is_error;
+
+        std::sort(values.begin(), values.end());
+        all_sorted = all_sorted && int64_elements(array) == values;
+        aria_shadow_stack_pop_frame();
+    }
+    ASSERT(all_sorted, "Parallel sort should match a sequential sort");
+
+    // Small arrays take the sequential path
+    AriaArray* small = make_int64_array({3, 1, 2});
+    aria_array_sort_parallel(small, compare_int64, nullptr);
+    std::vector<int64_t> expected = {1, 2, 3};
+    ASSERT(int64_elements(small) == expected, "Small arrays should sort");
+
+    ASSERT(aria_array_sort_parallel(nullptr, compare_int64, nullptr).is_error,
+           "NULL array should be rejected");
+}
+
+TEST_CASE(array_sort_during_concurrent_mark) {
+    aria_gc_shutdown();
+    aria_gc_init(0, 0, 2, ARIA_GC_CONCURRENT_MARK);
+    setenv("ARIA_COLLECTION_THREADS", "6", 0);
+
+    // A long chain keeps the marker busy; the arrays hang off its tail,
+    // so they are scanned last
+    struct Link {
+        Link* next;
+        AriaArray* arrays[2];
+    };
+    uint64_t link_bitmap = 0x7;
+    uint16_t link_type = aria_gc_register_type(sizeof(Link), &link_bitmap);
+    uint64_t ref_bitmap = 1;
+    uint16_t ref_type = aria_gc_register_type(sizeof(void*), &ref_bitmap);
+
+    aria_shadow_stack_push_frame();
+    Link* head = nullptr;
+    aria_shadow_stack_add_root((void**)&head);
+    for (int i = 0; i < 200000; i++) {
+        Link* link = (Link*)aria_gc_alloc(sizeof(Link), link_type);
+        link->next = head;
+        head = link;
+    }
+    Link* tail = head;
+    while (tail->next) {
+        tail = tail->next;
+    }
+
+    // Boxes referenced only by the arrays; the second array is four
+    // parallel sort chunks (8192 elements each), so it is merged
+    const size_t sizes[2] = {64, 32768};
+    for (int a = 0; a < 2; a++) {
+        tail->arrays[a] = (AriaArray*)aria_array_new(sizeof(void*), sizes[a], ref_type).value;
+        for (size_t i = 0; i < sizes[a]; i++) {
+            int64_t* box = (int64_t*)aria_gc_alloc(sizeof(int64_t), 0);
+            *box = (int64_t)(sizes[a] - i);
+            aria_array_push(tail->arrays[a], &box);
+        }
+    }
+
+    // Tenured objects do not move, so the pointers stay valid
+    aria_gc_collect(false);
+    tail = head;
+    while (tail->next) {
+        tail = tail->next;
+    }
+
+    // Once marking starts, sort each array, then clear it with plain
+    // stores: the marker may reach a slot only after the sort moved its
+    // reference away, so the boxes are covered by the sort's logging alone
+    std::vector<int64_t*> boxes;
+    std::thread mutator([&]() {
+        aria_gc_register_thread();
+        GCStats stats;
+        do {
+            aria_gc_get_stats(&stats);
+        } while (!stats.marking_in_progress);
+
+        aria_array_sort(tail->arrays[0], compare_box, nullptr);
+        aria_array_sort_parallel(tail->arrays[1], compare_box, nullptr);
+        for (AriaArray* array : tail->arrays) {
+            for (size_t i = 0; i < array->length; i++) {
+                int64_t* box;
+                std::memcpy(&box, aria_array_get_unchecked(array, i), sizeof(box));
+                boxes.push_back(box);
+            }
+            std::memset(array->data, 0, array->length * array->element_size);
+        }
+
+        do {
+            aria_gc_get_stats(&stats);
+        } while (stats.marking_in_progress);
+        aria_gc_unregister_thread();
+    });
+
+    aria_gc_collect(true);
+
+    aria_gc_enter_blocking();
+    mutator.join();
+    aria_gc_leave_blocking();
+
+    bool survived = boxes.size() == sizes[0] + sizes[1];
+    for (int64_t* box : boxes) {
+        survived = survived && aria_gc_is_heap_pointer(box);
+    }
+    ASSERT(survived, "Elements reachable at the snapshot must survive a sort during marking");
+
+    aria_shadow_stack_pop_frame();
+
+    // Leave the collector in its default mode for later tests
+    aria_gc_shutdown();
+    aria_gc_init(0, 0, 0, 0);
+}
+
+// =============================================================================
+// Iterator Tests
+// =============================================================================
+
+TEST_CASE(iter_fused_matches_eager) {
+    aria_gc_init(0, 0, 0, 0);
+
+    std::vector<int64_t> values(1000);
+    for (size_t i = 0; i < values.size(); i++) values[i] = (int64_t)i;
+    AriaArray* array = make_int64_array(values);
+    aria_shadow_stack_push_frame();
+    aria_shadow_stack_add_root((void**)&array);
+
+    // filter |> transform |> filter (by index) |> collect
+    AriaArray* eager = (AriaArray*)aria_array_filter(array, is_even, nullptr).value;
+    eager = (AriaArray*)aria_array_transform(eager, times_three, sizeof(int64_t), 0, nullptr).value;
+    eager = (AriaArray*)aria_array_filter(eager, even_index, nullptr).value;
+    std::vector<int64_t> expected = int64_elements(eager);
+
+    AriaIter iter;
+    aria_iter_init(&iter, array);
+    aria_iter_filter(&iter, is_even, nullptr);
+    aria_iter_transform(&iter, times_three, sizeof(int64_t), 0, nullptr);
+    aria_iter_filter(&iter, even_index, nullptr);
+    AriaResultPtr result = aria_iter_collect(&iter);
+    ASSERT(!result.is_error, "Collect should succeed");
+    ASSERT(int64_elements((AriaArray*)result.value) == expected,
+           "Fused pipeline should match the eager chain, stage indices included");
+
+    // filter |> transform |> reduce
+    int64_t zero = 0;
+    aria_iter_init(&iter, array);
+    aria_iter_filter(&iter, is_even, nullptr);
+    aria_iter_transform(&iter, times_three, sizeof(int64_t), 0, nullptr);
+    result = aria_iter_reduce(&iter, sum_int64, &zero, sizeof(int64_t), nullptr);
+    ASSERT(!result.is_error, "Reduce should succeed");
+    ASSERT_EQ(*(int64_t*)result.value, (int64_t)3 * 249500, "Fused reduce should sum the mapped evens");
+
+    // Transforms may change the element size
+    aria_iter_init(&iter, array);
+    aria_iter_transform(&iter, narrow_plus_index, sizeof(int32_t), 0, nullptr);
+    AriaArray* narrowed = (AriaArray*)aria_iter_collect(&iter).value;
+    ASSERT_EQ(narrowed->element_size, sizeof(int32_t), "Output should use the last stage's size");
+    ASSERT_EQ(narrowed->length, values.size(), "Unfiltered output keeps every element");
+    ASSERT_EQ(((int32_t*)narrowed->data)[999], 1998, "Elements should be narrowed");
+
+    aria_shadow_stack_pop_frame();
+}
+
+TEST_CASE(iter_errors) {
+    aria_gc_init(0, 0, 0, 0);
+
+    AriaIter iter;
+    aria_iter_init(&iter, nullptr);
+    ASSERT(aria_iter_collect(&iter).is_error, "NULL source should be reported");
+
+    AriaArray* array = make_int64_array({1, 2, 3});
+    aria_iter_init(&iter, array);
+    aria_iter_filter(&iter, nullptr, nullptr);
+    aria_iter_transform(&iter, times_three, sizeof(int64_t), 0, nullptr);
+    AriaResultPtr result = aria_iter_collect(&iter);
+    ASSERT(result.is_error, "NULL predicate should be reported by the terminal");
+    ASSERT_EQ(((AriaError*)result.error)->code, ARIA_ERR_NULL_PTR, "First error should win");
+
+    aria_iter_init(&iter, array);
+    for (int i = 0; i <= ARIA_ITER_MAX_STAGES; i++) {
+        aria_iter_filter(&iter, is_even, nullptr);
+    }
+    result = aria_iter_collect(&iter);
+    ASSERT(result.is_error, "Too many stages should be reported");
+    ASSERT_EQ(((AriaError*)result.error)->code, ARIA_ERR_OVERFLOW, "Overflow error code");
+
+    int64_t zero = 0;
+    aria_iter_init(&iter, array);
+    ASSERT(aria_iter_reduce(&iter, nullptr, &zero, sizeof(zero), nullptr).is_error,
+           "NULL reducer should be rejected");
+}
+
+TEST_CASE(iter_collect_traces_references) {
+    aria_gc_init(0, 0, 0, 0);
+
+    uint64_t bitmap = 1;
+    uint16_t ref_type = aria_gc_register_type(sizeof(void*), &bitmap);
+
+    const int64_t count = 5000;
+    std::vector<int64_t> values(count);
+    for (int64_t i = 0; i < count; i++) values[i] = i;
+    AriaArray* array = make_int64_array(values);
+    aria_shadow_stack_push_frame();
+    aria_shadow_stack_add_root((void**)&array);
+
+    // Boxing allocates mid-pass: the source, the output and the boxes
+    // already collected must survive the collections it triggers
+    AriaIter iter;
+    aria_iter_init(&iter, array);
+    aria_iter_filter(&iter, is_even, nullptr);
+    aria_iter_transform(&iter, box_int64, sizeof(void*), ref_type, nullptr);
+    AriaArray* boxes = (AriaArray*)aria_iter_collect(&iter).value;
+    aria_shadow_stack_add_root((void**)&boxes);
+
+    aria_gc_collect(false);
+    aria_gc_collect(true);
+
+    bool intact = boxes->length == (size_t)count / 2;
+    for (size_t i = 0; intact && i < boxes->length; i++) {
+        int64_t* box;
+        std::memcpy(&box, aria_array_get_unchecked(boxes, i), sizeof(box));
+        intact = *box == (int64_t)(2 * i);
+    }
+    ASSERT(intact, "Boxed elements should survive collection");
+
+    aria_shadow_stack_pop_frame();
+}
+
+// =============================================================================
+// Parallel Operation Tests
+// =============================================================================
+
+TEST_CASE(array_par_operations_match_sequential) {
+    aria_gc_init(0, 0, 0, 0);
+    setenv("ARIA_COLLECTION_THREADS", "6", 0);
+
+    std::vector<int64_t> values = sort_pattern(0, 100003);
+    AriaArray* array = make_int64_array(values);
+    aria_shadow_stack_push_frame();
+    aria_shadow_stack_add_root((void**)&array);
+
+    AriaArray* expected_mapped = (AriaArray*)aria_array_transform(
+        array, times_three, sizeof(int64_t), 0, nullptr).value;
+    std::vector<int64_t> mapped = int64_elements(expected_mapped);
+    std::vector<int64_t> evens = int64_elements((AriaArray*)aria_array_filter(array, is_even, nullptr).value);
+    std::vector<int64_t> even_indices = int64_elements((AriaArray*)aria_array_filter(array, even_index, nullptr).value);
+
+    int64_t zero = 0;
+    int64_t sum = *(int64_t*)aria_array_reduce(array, sum_int64, &zero, sizeof(int64_t), nullptr).value;
+
+    bool transform_ok = true, filter_ok = true, reduce_ok = true;
+    const size_t grains[] = {0, 1, 7, 1000, 1000000};
+    for (size_t grain : grains) {
+        AriaResultPtr result = aria_array_par_transform(array, times_three, sizeof(int64_t), 0, grain, nullptr);
+        transform_ok = transform_ok && !result.is_error && int64_elements((AriaArray*)result.value) == mapped;
+
+        result = aria_array_par_filter(array, is_even, grain, nullptr);
+        filter_ok = filter_ok && !result.is_error && int64_elements((AriaArray*)result.value) == evens;
+        result = aria_array_par_filter(array, even_index, grain, nullptr);
+        filter_ok = filter_ok && int64_elements((AriaArray*)result.value) == even_indices;
+
+        result = aria_array_par_reduce(array, sum_int64, [](void* acc, const void* partial, void*) {
+            *(int64_t*)acc += *(const int64_t*)partial;
+        }, &zero, sizeof(int64_t), grain, nullptr);
+        reduce_ok = reduce_ok && !result.is_error && *(int64_t*)result.value == sum;
+    }
+    ASSERT(transform_ok, "Parallel transform should match transform at every grain size");
+    ASSERT(filter_ok, "Parallel filter should keep survivors in order with source indices");
+    ASSERT(reduce_ok, "Parallel reduce should match reduce at every grain size");
+
+    AriaArray* empty = make_int64_array({});
+    AriaResultPtr result = aria_array_par_filter(empty, is_even, 0, nullptr);
+    ASSERT(!result.is_error && ((AriaArray*)result.value)->length == 0, "Empty filter");
+    result = aria_array_par_reduce(empty, sum_int64, combine_double, &zero, sizeof(int64_t), 0, nullptr);
+    ASSERT(!result.is_error && *(int64_t*)result.value == 0, "Empty reduce yields the identity");
+
+    aria_shadow_stack_pop_frame();
+}
+
+TEST_CASE(array_par_reduce_deterministic) {
+    aria_gc_init(0, 0, 0, 0);
+
+    std::vector<int64_t> values = sort_pattern(0, 50000);
+    AriaArray* array = make_int64_array(values);
+    aria_shadow_stack_push_frame();
+    aria_shadow_stack_add_root((void**)&array);
+
+    // Expected: chunks of 333 summed left to right, then combined in order
+    double expected = 0.0;
+    for (size_t begin = 0; begin < values.size(); begin += 333) {
+        double partial = 0.0;
+        for (size_t i = begin; i < std::min(values.size(), begin + 333); i++) {
+            sum_double(&partial, &values[i], i, nullptr);
+        }
+        expected += partial;
+    }
+
+    double identity = 0.0;
+    bool identical = true;
+    for (int run = 0; run < 10; run++) {
+        AriaResultPtr result = aria_array_par_reduce(array, sum_double, combine_double,
+                                                     &identity, sizeof(double), 333, nullptr);
+        identical = identical && std::memcmp(result.value, &expected, sizeof(double)) == 0;
+    }
+    ASSERT(identical, "Reduction order should depend only on the grain size");
+
+    ASSERT(aria_array_par_reduce(array, sum_double, nullptr, &identity, sizeof(double), 0, nullptr).is_error,
+           "NULL combiner should be rejected");
+    ASSERT(aria_array_par_transform(nullptr, times_three, sizeof(int64_t), 0, 0, nullptr).is_error,
+           "NULL array should be rejected");
+    ASSERT(aria_array_par_filter(array, nullptr, 0, nullptr).is_error,
+           "NULL predicate should be rejected");
+
+    aria_shadow_stack_pop_frame();
+}
@@ -6,7 +6,11 @@
 
 #include "../test_helpers.h"
 #include "runtime/allocators.h"
+#include <cstdlib>
 #include <cstring>
+#include <cstdio>
+#include <thread>
+#include <vector>
 
 // =============================================================================
 // Wild Allocator Tests (Manual malloc/free)
@@ -105,6 +109,24 @@ TEST_CASE(wild_realloc_shrink) {
     aria_free(new_ptr);
 }
 
+TEST_CASE(wild_realloc_foreign_pointer) {
+    // Blocks from std::malloc are resized by their own allocator: only
+    // the old block's bytes may be read
+    char* ptr = static_cast<char*>(std::malloc(16));
+    ASSERT(ptr != nullptr, "Allocation should succeed");
+    std::memset(ptr, 'A', 16);
+    
+    char* grown = static_cast<char*>(aria_realloc(ptr, 4096));
+    ASSERT(grown != nullptr, "Growing a foreign block should succeed");
+    ASSERT(grown[0] == 'A' && grown[15] == 'A', "Data should be preserved");
+    
+    grown = static_cast<char*>(aria_realloc(grown, 8));
+    ASSERT(grown != nullptr, "Shrinking a foreign block should succeed");
+    ASSERT(grown[7] == 'A', "Data should be preserved");
+    
+    aria_free(grown);
+}
+
 TEST_CASE(wild_realloc_to_zero) {
     // Realloc to zero size should free
     void* ptr = aria_alloc(100);
@@ -134,11 +156,7 @@ TEST_CASE(alloc_buffer_aligned) {
     uintptr_t addr = reinterpret_cast<uintptr_t>(buf);
     ASSERT((addr % 64) == 0, "Buffer should be 64-byte aligned");
     
-#ifdef _WIN32
-    _aligned_free(buf);
-#else
-    free(buf);
-#endif
+    aria_free(buf);
 }
 
 TEST_CASE(alloc_buffer_zero_init) {
@@ -200,6 +218,51 @@ TEST_CASE(alloc_array_overflow) {
     ASSERT(ptr == nullptr, "Overflow should be detected");
 }
 
+// =============================================================================
+// Arena Allocator Tests
+// =============================================================================
+
+TEST_CASE(arena_alloc_reset_destroy) {
+    AriaArena* arena = aria_arena_create(4096);
+    ASSERT(arena != nullptr, "Arena creation should succeed");
+    
+    // Bump allocations are aligned and disjoint
+    char* a = static_cast<char*>(aria_arena_alloc(arena, 10, 0));
+    char* b = static_cast<char*>(aria_arena_alloc(arena, 100, 64));
+    ASSERT(a != nullptr && b != nullptr, "Arena allocation should succeed");
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(a) % 16, 0u, "Default alignment is 16");
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0u, "Requested alignment is honored");
+    ASSERT(b >= a + 10, "Allocations should not overlap");
+    ASSERT(aria_arena_alloc(arena, 0, 0) == nullptr, "Zero-size allocation returns NULL");
+    ASSERT(aria_arena_alloc(arena, 8, 24) == nullptr, "Non-power-of-2 alignment is rejected");
+    
+    // Grow past the first chunk and add an oversized allocation
+    for (int i = 0; i < 1000; ++i) {
+        std::memset(aria_arena_alloc(arena, 48, 0), 0xAB, 48);
+    }
+    void* big = aria_arena_alloc(arena, 100000, 0);
+    ASSERT(big != nullptr, "Oversized allocation should succeed");
+    std::memset(big, 0, 100000);
+    
+    ArenaStats stats;
+    aria_arena_get_stats(arena, &stats);
+    ASSERT_EQ(stats.bytes_allocated, 10u + 100u + 1000u * 48u + 100000u, "Requested bytes are counted");
+    ASSERT(stats.num_chunks > 2, "Arena should have grown");
+    ASSERT(stats.bytes_reserved >= stats.bytes_allocated, "Chunks cover the allocations");
+    
+    // Reset keeps one chunk; the next allocation reuses its start
+    aria_arena_reset(arena);
+    aria_arena_get_stats(arena, &stats);
+    ASSERT_EQ(stats.num_chunks, 1u, "Reset keeps the largest chunk");
+    ASSERT_EQ(stats.bytes_allocated, 0u, "Reset clears the allocation count");
+    void* first = aria_arena_alloc(arena, 16, 0);
+    ASSERT(aria_arena_alloc(arena, 16, 0) == static_cast<char*>(first) + 16,
+           "Allocation after reset bumps from the retained chunk");
+    
+    aria_arena_destroy(arena);
+    aria_arena_destroy(nullptr);  // No-op
+}
+
 // =============================================================================
 // WildX Executable Memory Tests
 // =============================================================================
@@ -301,6 +364,64 @@ TEST_CASE(wildx_multiple_allocations) {
     }
 }
 
+TEST_CASE(wildx_code_pool_batch_sealing) {
+    // Exercise both the memfd dual mapping and the mprotect fallback
+    const char* modes[] = {"1", "0"};
+    for (const char* mode : modes) {
+        setenv("ARIA_WILDX_DUAL_MAP", mode, 1);
+        AriaCodePool* pool = aria_code_pool_create(0);
+        ASSERT(pool != nullptr, "Pool creation should succeed");
+        
+        // x86-64: mov eax, imm32; ret
+        AriaCodeStub first[8];
+        for (int i = 0; i < 8; ++i) {
+            ASSERT_EQ(aria_code_pool_alloc(pool, 6, &first[i]), 0, "Stub allocation should succeed");
+            unsigned char code[6] = {0xB8, static_cast<unsigned char>(i), 0, 0, 0, 0xC3};
+            std::memcpy(first[i].write_ptr, code, sizeof(code));
+        }
+        ASSERT(reinterpret_cast<uintptr_t>(first[1].exec_ptr) % 16 == 0, "Stubs are 16-byte aligned");
+        ASSERT(static_cast<char*>(first[1].exec_ptr) - static_cast<char*>(first[0].exec_ptr) == 16,
+               "Stubs should be packed");
+        ASSERT_EQ(aria_code_pool_seal(pool), 0, "Seal should succeed");
+        
+        // A second batch after the seal, plus a stub larger than a quarter chunk
+        AriaCodeStub late, large;
+        ASSERT_EQ(aria_code_pool_alloc(pool, 6, &late), 0, "Allocation after seal should succeed");
+        unsigned char code[6] = {0xB8, 99, 0, 0, 0, 0xC3};
+        std::memcpy(late.write_ptr, code, sizeof(code));
+        ASSERT_EQ(aria_code_pool_alloc(pool, 40000, &large), 0, "Large stub should succeed");
+        std::memset(large.write_ptr, 0xC3, 40000);
+        ASSERT_EQ(aria_code_pool_seal(pool), 0, "Second seal should succeed");
+        
+        typedef int (*func_t)(void);
+        ASSERT_EQ(reinterpret_cast<func_t>(first[7].exec_ptr)(), 7, "Sealed stub should run");
+        ASSERT_EQ(reinterpret_cast<func_t>(late.exec_ptr)(), 99, "Later stub should run");
+        
+        CodePoolStats stats;
+        aria_code_pool_get_stats(pool, &stats);
+        ASSERT_EQ(stats.num_chunks, 2u, "Small stubs share one chunk; the large one has its own");
+        ASSERT_EQ(stats.num_stubs, 10u, "Live stubs are counted");
+        ASSERT_EQ(stats.num_seals, 2u, "Seals are counted");
+        if (stats.dual_mapped) {
+            ASSERT_EQ(stats.num_protect_calls, 0u, "Dual mapping never changes protection");
+            ASSERT(late.write_ptr != late.exec_ptr, "Dual mapping uses separate views");
+        } else {
+            ASSERT_EQ(stats.num_protect_calls, 3u, "One flip per chunk per seal");
+            ASSERT(static_cast<char*>(late.exec_ptr) >= static_cast<char*>(first[0].exec_ptr) + 4096,
+                   "Stubs after a seal start on a fresh page");
+        }
+        
+        // Freeing the large stub unmaps its chunk
+        aria_code_pool_free(pool, &large);
+        ASSERT(large.chunk == nullptr, "Freed stub is cleared");
+        aria_code_pool_get_stats(pool, &stats);
+        ASSERT_EQ(stats.num_chunks, 1u, "Empty dedicated chunk is unmapped");
+        
+        aria_code_pool_destroy(pool);
+    }
+    unsetenv("ARIA_WILDX_DUAL_MAP");
+}
+
 // =============================================================================
 // Statistics Tests
 // =============================================================================
@@ -344,3 +465,119 @@ TEST_CASE(allocator_stats_tracking) {
     aria_free(ptr2);
     aria_free_exec(&guard);
 }
+
+TEST_CASE(wild_heap_cross_thread_free) {
+    // Sizes spanning small classes and dedicated large spans
+    const size_t sizes[] = {1, 16, 17, 100, 129, 1000, 1025, 4096, 32768, 32769, 200000};
+    const int per_size = 64;
+
+    AllocatorStats before;
+    aria_allocator_get_stats(&before);
+
+    std::vector<unsigned char*> blocks;
+    for (size_t size : sizes) {
+        for (int i = 0; i < per_size; ++i) {
+            unsigned char* p = static_cast<unsigned char*>(aria_alloc(size));
+            if (!p) break;
+            std::memset(p, static_cast<int>(blocks.size() & 0xff), size);
+            blocks.push_back(p);
+        }
+    }
+    ASSERT_EQ(blocks.size(), sizeof(sizes) / sizeof(sizes[0]) * per_size, "All allocations should succeed");
+
+    AllocatorStats during;
+    aria_allocator_get_stats(&during);
+    ASSERT(during.num_wild_allocations == before.num_wild_allocations + blocks.size(),
+           "Every allocation should be counted");
+    ASSERT(during.total_wild_allocated > before.total_wild_allocated + 64 * 200000,
+           "Live bytes should cover the large blocks");
+
+    // Distinct, intact blocks
+    bool intact = true;
+    size_t index = 0;
+    for (size_t size : sizes) {
+        for (int i = 0; i < per_size; ++i, ++index) {
+            unsigned char* p = blocks[index];
+            unsigned char tag = static_cast<unsigned char>(index & 0xff);
+            if (p[0] != tag || p[size - 1] != tag) {
+                intact = false;
+            }
+        }
+    }
+    ASSERT(intact, "Blocks should not overlap");
+
+    // Free everything from another thread (objects land in its cache,
+    // then go back to the central lists when it exits)
+    std::thread freer([&blocks]() {
+        for (unsigned char* p : blocks) {
+            aria_free(p);
+        }
+    });
+    freer.join();
+
+    AllocatorStats after;
+    aria_allocator_get_stats(&after);
+    ASSERT_EQ(after.num_wild_allocations, before.num_wild_allocations, "Frees should be counted");
+    ASSERT_EQ(after.total_wild_allocated, before.total_wild_allocated, "Live bytes should return to baseline");
+    ASSERT(after.peak_wild_usage >= during.total_wild_allocated,
+           "Peak should cover the high-water mark");
+
+    // Freed slots are reused; realloc keeps contents across classes
+    char* s = static_cast<char*>(aria_alloc(24));
+    ASSERT(s != nullptr, "Reallocation after free should succeed");
+    std::strcpy(s, "wild heap");
+    s = static_cast<char*>(aria_realloc(s, 30));
+    s = static_cast<char*>(aria_realloc(s, 50000));
+    ASSERT(s != nullptr && std::strcmp(s, "wild heap") == 0, "Realloc should keep data");
+    aria_free(s);
+
+    // Aligned buffers are released through their interior pointer
+    void* aligned = aria_alloc_buffer(100, 4096, true);
+    ASSERT(aligned != nullptr, "Aligned allocation should succeed");
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(aligned) % 4096, 0u, "Buffer should be aligned");
+    aria_free(aligned);
+}
+
+// =============================================================================
+// Heap Profiler Tests
+// =============================================================================
+
+TEST_CASE(heap_profile_tracks_wild_allocations) {
+    ASSERT_EQ(aria_heap_profile_start(4096), 0, "Profiler should start");
+    ASSERT_EQ(aria_heap_profile_start(4096), -1, "Profiler is already running");
+    
+    std::vector<void*> blocks;
+    for (int i = 0; i < 1000; ++i) {
+        blocks.push_back(aria_alloc(1024));
+    }
+    
+    HeapProfileStats stats;
+    aria_heap_profile_get_stats(&stats);
+    ASSERT_EQ(stats.sample_interval, 4096u, "Interval should be reported");
+    ASSERT(stats.num_samples > 0 && stats.num_sites > 0, "Allocations should be sampled");
+    ASSERT(stats.live_samples == stats.num_samples, "Nothing has been freed yet");
+    ASSERT(stats.inuse_bytes > 1000 * 1024 / 4 && stats.inuse_bytes < 1000 * 1024 * 4,
+           "Estimate should be near the true volume");
+    
+    const char* path = "aria_heap_profile_test.pb";
+    ASSERT_EQ(aria_heap_profile_dump(path), 0, "Profile should be written");
+    FILE* file = std::fopen(path, "rb");
+    ASSERT(file != nullptr, "Profile file should exist");
+    std::fseek(file, 0, SEEK_END);
+    ASSERT(std::ftell(file) > 0, "Profile should not be empty");
+    std::fclose(file);
+    std::remove(path);
+    
+    for (void* block : blocks) {
+        aria_free(block);
+    }
+    aria_heap_profile_get_stats(&stats);
+    ASSERT_EQ(stats.live_samples, 0u, "Freed samples are no longer live");
+    ASSERT_EQ(stats.inuse_bytes, 0u, "Nothing should remain in use");
+    ASSERT(stats.alloc_bytes > 0, "Allocated totals are kept");
+    
+    aria_heap_profile_stop();
+    aria_heap_profile_get_stats(&stats);
+    ASSERT_EQ(stats.sample_interval, 0u, "Stopped profiler reports no interval");
+    ASSERT_EQ(aria_heap_profile_dump("/nonexistent-dir/heap.pb"), -1, "Unwritable path should fail");
+}
@@ -461,3 +461,37 @@ TEST_CASE(jit_error_unbound_label) {
     
     aria_asm_destroy(asm_ctx);
 }
+
+TEST_CASE(jit_code_pool_batch) {
+    // Emit 200 functions returning their index, seal them all at once
+    AriaCodePool* pool = aria_code_pool_create(0);
+    ASSERT(pool != nullptr, "Pool creation should succeed");
+    
+    const int count = 200;
+    AriaCodeStub stubs[count];
+    bool emitted = true;
+    for (int i = 0; i < count; ++i) {
+        Assembler* asm_ctx = aria_asm_create();
+        aria_asm_mov_r64_imm64(asm_ctx, REG_RAX, 1000 + i);
+        aria_asm_ret(asm_ctx);
+        emitted = emitted && aria_asm_finalize_to_pool(asm_ctx, pool, &stubs[i]) == 0;
+        aria_asm_destroy(asm_ctx);
+    }
+    ASSERT(emitted, "Every function should be emitted");
+    ASSERT(aria_code_pool_seal(pool) == 0, "Sealing should succeed");
+    
+    bool correct = true;
+    for (int i = 0; i < count; ++i) {
+        typedef int64_t (*func_t)(void);
+        correct = correct && reinterpret_cast<func_t>(stubs[i].exec_ptr)() == 1000 + i;
+    }
+    ASSERT(correct, "Every stub should return its index");
+    
+    // 200 stubs of 11 bytes share one chunk
+    CodePoolStats stats;
+    aria_code_pool_get_stats(pool, &stats);
+    ASSERT_EQ(stats.num_chunks, 1u, "Stubs should share a chunk");
+    ASSERT(stats.num_protect_calls <= 1, "At most one protection flip per seal");
+    
+    aria_code_pool_destroy(pool);
+}
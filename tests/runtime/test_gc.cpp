@@ -0,0 +1,1121 @@
+/**
+ * Tests for the Aria Garbage Collector
+ * 
+ * Tests nursery allocation, thread-local allocation buffers, pinning,
+ * precise tracing, and collection statistics.
+ */
+
+#include "../test_helpers.h"
+#include "runtime/gc.h"
+#include "runtime/allocators.h"
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+
+// =============================================================================
+// Allocation Tests
+// =============================================================================
+
+TEST_CASE(gc_alloc_basic) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    void* ptr = aria_gc_alloc(64, 7);
+    ASSERT(ptr != nullptr, "GC allocation should succeed");
+    ASSERT(aria_gc_is_heap_pointer(ptr), "Allocation should be in the GC heap");
+    
+    ObjHeader* header = aria_gc_get_header(ptr);
+    ASSERT_EQ(header->type_id, 7u, "Header should carry the type id");
+    ASSERT_EQ(header->is_nursery, 1u, "New objects start in the nursery");
+    
+    // Payload must be zero-initialized
+    const unsigned char* bytes = static_cast<const unsigned char*>(ptr);
+    bool all_zero = std::all_of(bytes, bytes + 64, [](unsigned char b) { return b == 0; });
+    ASSERT(all_zero, "Payload should be zero-initialized");
+}
+
+TEST_CASE(gc_alloc_tlab_sequential) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    // Consecutive small allocations from one thread come from the same
+    // TLAB and must not overlap
+    char* a = static_cast<char*>(aria_gc_alloc(24, 0));
+    char* b = static_cast<char*>(aria_gc_alloc(24, 0));
+    ASSERT(a != nullptr && b != nullptr, "Allocations should succeed");
+    ASSERT(b >= a + 24 || a >= b + 24, "TLAB allocations must not overlap");
+}
+
+TEST_CASE(gc_alloc_stats_total) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    GCStats before;
+    aria_gc_get_stats(&before);
+    
+    for (int i = 0; i < 10; ++i) {
+        aria_gc_alloc(100, 0);
+    }
+    
+    GCStats after;
+    aria_gc_get_stats(&after);
+    ASSERT_EQ(after.total_allocated - before.total_allocated, 1000u,
+              "Stats should count TLAB allocations from the calling thread");
+}
+
+TEST_CASE(gc_alloc_multithreaded) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    const int num_threads = 4;
+    const int per_thread = 2000;
+    std::vector<std::vector<uint64_t*>> results(num_threads);
+    std::vector<std::thread> threads;
+    
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([t, &results]() {
+            for (int i = 0; i < per_thread; ++i) {
+                uint64_t* obj = static_cast<uint64_t*>(aria_gc_alloc(sizeof(uint64_t) * 2, 0));
+                if (!obj) break;
+                obj[0] = static_cast<uint64_t>(t);
+                obj[1] = static_cast<uint64_t>(i);
+                results[t].push_back(obj);
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    
+    // No collection ran (4MB nursery), so every object must still hold
+    // exactly what its owning thread wrote
+    bool intact = true;
+    for (int t = 0; t < num_threads; ++t) {
+        ASSERT_EQ(results[t].size(), static_cast<size_t>(per_thread),
+                  "Every allocation should succeed");
+        for (size_t i = 0; i < results[t].size(); ++i) {
+            if (results[t][i][0] != static_cast<uint64_t>(t) || results[t][i][1] != i) {
+                intact = false;
+            }
+        }
+    }
+    ASSERT(intact, "Concurrent TLAB allocations must not overlap");
+}
+
+// =============================================================================
+// Thread Registry and Safepoint Tests
+// =============================================================================
+
+TEST_CASE(gc_threads_have_private_shadow_stacks) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    const int num_threads = 4;
+    std::vector<std::thread> threads;
+    std::vector<bool> ok(num_threads, false);
+    
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([t, &ok]() {
+            aria_shadow_stack_push_frame();
+            
+            void* obj = aria_gc_alloc(sizeof(uint64_t), 0);
+            aria_shadow_stack_add_root(&obj);
+            *static_cast<uint64_t*>(obj) = 1000 + t;
+            
+            // Churn the nursery and collect while other threads do the same;
+            // each collection must stop every thread and update every root
+            for (int i = 0; i < 20; ++i) {
+                for (int j = 0; j < 200; ++j) {
+                    aria_gc_alloc(64, 0);
+                }
+                aria_gc_collect(false);
+            }
+            
+            ok[t] = (*static_cast<uint64_t*>(obj) == static_cast<uint64_t>(1000 + t));
+            aria_shadow_stack_pop_frame();
+        });
+    }
+    
+    // std::thread::join is not a GC-aware blocking call (aria_thread_join is)
+    aria_gc_enter_blocking();
+    for (auto& th : threads) {
+        th.join();
+    }
+    aria_gc_leave_blocking();
+    
+    for (int t = 0; t < num_threads; ++t) {
+        ASSERT(ok[t], "Each thread's root must survive concurrent collections");
+    }
+}
+
+TEST_CASE(gc_pause_stats_recorded) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    GCStats before;
+    aria_gc_get_stats(&before);
+    aria_gc_collect(false);
+    GCStats after;
+    aria_gc_get_stats(&after);
+    
+    ASSERT_EQ(after.num_minor_collections, before.num_minor_collections + 1,
+              "Explicit collect should run a minor GC");
+    ASSERT(after.total_pause_ns > before.total_pause_ns, "Pause time should be recorded");
+    ASSERT(after.max_pause_ns >= after.last_pause_ns, "Max pause covers the last pause");
+    ASSERT(after.num_threads >= 1, "Calling thread should be registered");
+}
+
+TEST_CASE(gc_trace_records_collections) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    for (int i = 0; i < 20; ++i) {
+        aria_gc_collect(false);
+    }
+    aria_gc_collect(true);
+    
+    GCStats stats;
+    aria_gc_get_stats(&stats);
+    ASSERT(stats.minor_pause_p50_ns > 0, "Minor pauses should be in the histogram");
+    ASSERT(stats.minor_pause_p50_ns <= stats.minor_pause_p99_ns &&
+           stats.minor_pause_p99_ns <= stats.minor_pause_p999_ns,
+           "Percentiles should be ordered");
+    ASSERT(stats.minor_pause_p999_ns <= stats.max_pause_ns, "Percentiles stay below the max");
+    ASSERT(stats.major_pause_p50_ns > 0, "Major pauses should be in the histogram");
+    
+    const char* path = "aria_gc_trace_test.json";
+    ASSERT(aria_gc_dump_trace(path), "Trace should be written");
+    
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    in.close();
+    std::remove(path);
+    
+    std::string json = text.str();
+    ASSERT(json.find("\"traceEvents\"") != std::string::npos, "Chrome trace format");
+    ASSERT(json.find("\"minor GC\"") != std::string::npos, "Minor GCs should be traced");
+    ASSERT(json.find("\"card scan\"") != std::string::npos, "Card scans should be traced");
+    ASSERT(json.find("\"major pause\"") != std::string::npos, "Major pauses should be traced");
+    ASSERT(json.find("\"promoted_bytes\"") != std::string::npos, "Events carry promotion volume");
+    ASSERT(json.size() > 3 && json.compare(json.size() - 3, 3, "}}\n") == 0, "JSON should be complete");
+    
+    ASSERT(!aria_gc_dump_trace("/nonexistent-dir/trace.json"), "Unwritable path should fail");
+}
+
+TEST_CASE(gc_blocked_thread_does_not_stall_collection) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    std::mutex m;
+    std::condition_variable cv;
+    bool release = false;
+    
+    // A registered thread parked in a blocking region must not be
+    // waited for by the collector
+    std::thread waiter([&]() {
+        aria_gc_register_thread();
+        aria_gc_enter_blocking();
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return release; });
+        aria_gc_leave_blocking();
+    });
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    aria_gc_collect(false);  // Would hang if the waiter were waited for
+    
+    {
+        std::lock_guard<std::mutex> lock(m);
+        release = true;
+    }
+    cv.notify_all();
+    waiter.join();
+    ASSERT(true, "Collection completed while a thread was blocked");
+}
+
+// =============================================================================
+// Precise Tracing Tests
+// =============================================================================
+
+namespace {
+struct Node {
+    uint64_t value;
+    Node* next;
+};
+}
+
+TEST_CASE(gc_register_type_dedups_layouts) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    uint64_t bitmap = 0x2;  // Word 1 (Node::next) is a reference
+    uint16_t a = aria_gc_register_type(sizeof(Node), &bitmap);
+    uint16_t b = aria_gc_register_type(sizeof(Node), &bitmap);
+    ASSERT(a != ARIA_GC_TYPE_LEAF && a != ARIA_GC_TYPE_INVALID, "Layout should get a real ID");
+    ASSERT_EQ(a, b, "Identical layouts should share an ID");
+    
+    uint64_t none = 0;
+    ASSERT_EQ(aria_gc_register_type(32, &none), ARIA_GC_TYPE_LEAF,
+              "Pointer-free layouts are leaves");
+}
+
+TEST_CASE(gc_traces_registered_reference_fields) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    uint64_t bitmap = 0x2;
+    uint16_t node_type = aria_gc_register_type(sizeof(Node), &bitmap);
+    
+    aria_shadow_stack_push_frame();
+    
+    // Child is reachable only through the parent's traced field
+    Node* parent = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+    aria_shadow_stack_add_root(reinterpret_cast<void**>(&parent));
+    parent->value = 1;
+    parent->next = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+    parent->next->value = 2;
+    
+    aria_gc_collect(false);
+    ASSERT(parent->next != nullptr, "Minor GC should keep the field");
+    ASSERT_EQ(parent->next->value, 2u, "Minor GC should evacuate the child through the parent");
+    ASSERT(aria_gc_is_heap_pointer(parent->next), "Forwarded child should be in the heap");
+    
+    for (int i = 0; i < 100; ++i) {
+        aria_gc_alloc(64, 0);
+    }
+    aria_gc_collect(true);
+    ASSERT_EQ(parent->value, 1u, "Rooted parent should survive a major GC");
+    ASSERT_EQ(parent->next->value, 2u, "Major GC should mark the child through the parent");
+    
+    aria_shadow_stack_pop_frame();
+}
+
+TEST_CASE(gc_layout_repeats_for_arrays) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    uint64_t bitmap = 0x2;
+    uint16_t node_type = aria_gc_register_type(sizeof(Node), &bitmap);
+    
+    aria_shadow_stack_push_frame();
+    
+    // A four-element array of Node: every element's `next` is traced
+    const int count = 4;
+    Node* nodes = static_cast<Node*>(aria_gc_alloc(sizeof(Node) * count, node_type));
+    aria_shadow_stack_add_root(reinterpret_cast<void**>(&nodes));
+    for (int i = 0; i < count; ++i) {
+        nodes[i].next = static_cast<Node*>(aria_gc_alloc(sizeof(Node), ARIA_GC_TYPE_LEAF));
+        nodes[i].next->value = 100 + i;
+    }
+    
+    aria_gc_collect(true);
+    
+    bool intact = true;
+    for (int i = 0; i < count; ++i) {
+        intact = intact && nodes[i].next->value == static_cast<uint64_t>(100 + i);
+    }
+    ASSERT(intact, "Every array element's reference should be traced");
+    
+    aria_shadow_stack_pop_frame();
+}
+
+// =============================================================================
+// Old Generation Tests
+// =============================================================================
+
+TEST_CASE(gc_old_gen_size_classes) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    aria_shadow_stack_push_frame();
+    
+    void* small = aria_gc_alloc(40, 0);
+    void* medium = aria_gc_alloc(3000, 0);
+    void* large = aria_gc_alloc(100 * 1024, 0);
+    aria_shadow_stack_add_root(&small);
+    aria_shadow_stack_add_root(&medium);
+    aria_shadow_stack_add_root(&large);
+    
+    aria_gc_collect(false);  // Promote all three
+    
+    ASSERT_EQ(aria_gc_get_header(small)->is_nursery, 0u, "Small object should be tenured");
+    ASSERT(aria_gc_get_header(small)->size_class != 0, "Small objects get a size class");
+    ASSERT(aria_gc_get_header(medium)->size_class > aria_gc_get_header(small)->size_class,
+           "Larger objects get larger classes");
+    ASSERT_EQ(aria_gc_get_header(large)->size_class, 0u, "Large objects get their own segment");
+    
+    ASSERT(aria_gc_is_heap_pointer(small), "Tenured objects are heap pointers");
+    ASSERT(aria_gc_is_heap_pointer(large), "Large tenured objects are heap pointers");
+    ASSERT(!aria_gc_is_heap_pointer((char*)small + 8), "Interior pointers are not objects");
+    
+    int on_stack = 0;
+    ASSERT(!aria_gc_is_heap_pointer(&on_stack), "Stack addresses are not heap pointers");
+    
+    aria_shadow_stack_pop_frame();
+}
+
+TEST_CASE(gc_major_sweep_reclaims_unreachable) {
+    aria_gc_init(0, 0, 0, 0);
+    aria_gc_collect(true);
+    
+    GCStats baseline;
+    aria_gc_get_stats(&baseline);
+    
+    aria_shadow_stack_push_frame();
+    
+    // Tenure a batch of objects, then drop every other one
+    const int count = 1000;
+    uint64_t bitmap = 0x1;
+    uint16_t ref_array = aria_gc_register_type(sizeof(void*), &bitmap);
+    void** keep = static_cast<void**>(aria_gc_alloc(sizeof(void*) * count, ref_array));
+    aria_shadow_stack_add_root(reinterpret_cast<void**>(&keep));
+    
+    for (int i = 0; i < count; ++i) {
+        void* obj = aria_gc_alloc(48, 0);
+        *static_cast<uint64_t*>(obj) = i;
+        keep[i] = obj;
+    }
+    aria_gc_collect(false);
+    for (int i = 1; i < count; i += 2) {
+        keep[i] = nullptr;
+    }
+    
+    GCStats promoted;
+    aria_gc_get_stats(&promoted);
+    
+    aria_gc_collect(true);
+    
+    GCStats swept;
+    aria_gc_get_stats(&swept);
+    ASSERT(swept.old_gen_used < promoted.old_gen_used, "Sweep should free unreachable objects");
+    
+    bool intact = true;
+    for (int i = 0; i < count; i += 2) {
+        intact = intact && aria_gc_is_heap_pointer(keep[i]) &&
+                 *static_cast<uint64_t*>(keep[i]) == static_cast<uint64_t>(i);
+    }
+    ASSERT(intact, "Reachable objects should survive the sweep");
+    
+    aria_shadow_stack_pop_frame();
+    aria_gc_collect(true);
+    
+    GCStats released;
+    aria_gc_get_stats(&released);
+    ASSERT_EQ(released.old_gen_used, baseline.old_gen_used,
+              "Dropping the last root should reclaim everything");
+}
+
+TEST_CASE(gc_large_objects_bypass_nursery) {
+    aria_gc_init(0, 0, 0, 0);
+    aria_gc_collect(true);
+    
+    GCPolicy policy;
+    aria_gc_get_policy(&policy);
+    ASSERT_EQ(policy.large_object_size, 128u * 1024, "Default large-object threshold");
+    
+    uint64_t bitmap = 0x1;
+    uint16_t ref_array = aria_gc_register_type(sizeof(void*), &bitmap);
+    
+    GCStats before;
+    aria_gc_get_stats(&before);
+    
+    aria_shadow_stack_push_frame();
+    
+    // A 1MB reference array lands in its own span, not the nursery
+    const size_t count = 128 * 1024;
+    void** big = static_cast<void**>(aria_gc_alloc(count * sizeof(void*), ref_array));
+    aria_shadow_stack_add_root(reinterpret_cast<void**>(&big));
+    ASSERT(big != nullptr, "Large allocation should succeed");
+    ASSERT_EQ(aria_gc_get_header(big)->is_nursery, 0u, "Large objects skip the nursery");
+    ASSERT_EQ(aria_gc_get_header(big)->size_class, 0u, "Large objects get a dedicated span");
+    
+    GCStats stats;
+    aria_gc_get_stats(&stats);
+    ASSERT_EQ(stats.nursery_used, before.nursery_used, "Nursery should not be touched");
+    ASSERT_EQ(stats.large_objects, before.large_objects + 1, "One more large object");
+    ASSERT(stats.large_object_bytes >= before.large_object_bytes + count * sizeof(void*),
+           "Span covers the object");
+    
+    // Young referents are found through the card table and the array
+    // itself is never copied
+    void* young = aria_gc_alloc(32, ARIA_GC_TYPE_LEAF);
+    *static_cast<uint64_t*>(young) = 42;
+    big[count - 1] = young;
+    aria_gc_write_barrier(big, young);
+    void** original = big;
+    aria_gc_collect(false);
+    ASSERT(big == original, "Large objects are never copied");
+    ASSERT_EQ(aria_gc_get_header(big[count - 1])->is_nursery, 0u, "Referent should be promoted");
+    ASSERT_EQ(*static_cast<uint64_t*>(big[count - 1]), 42u, "Referent contents should survive");
+    
+    // The sweep frees the span once unreachable
+    aria_shadow_stack_pop_frame();
+    aria_gc_collect(true);
+    aria_gc_get_stats(&stats);
+    ASSERT_EQ(stats.large_objects, before.large_objects, "Unreachable large object is freed");
+    
+    // Threshold 0 sends everything through the nursery
+    GCPolicy nursery_only = policy;
+    nursery_only.large_object_size = 0;
+    aria_gc_set_policy(&nursery_only);
+    void* small_big = aria_gc_alloc(256 * 1024, ARIA_GC_TYPE_LEAF);
+    ASSERT_EQ(aria_gc_get_header(small_big)->is_nursery, 1u, "Disabled space uses the nursery");
+    
+    nursery_only.large_object_size = 1;
+    aria_gc_set_policy(&nursery_only);
+    aria_gc_get_policy(&nursery_only);
+    ASSERT_EQ(nursery_only.large_object_size, 32u * 1024, "Threshold is clamped");
+    
+    aria_gc_set_policy(&policy);
+}
+
+// =============================================================================
+// Parallel Collection Tests
+// =============================================================================
+
+TEST_CASE(gc_parallel_major_gc) {
+    // Restart the collector with an explicit worker count
+    aria_gc_shutdown();
+    aria_gc_init(0, 0, 4, 0);
+    
+    uint64_t bitmap = 0x2;
+    uint16_t node_type = aria_gc_register_type(sizeof(Node), &bitmap);
+    
+    aria_shadow_stack_push_frame();
+    
+    // Several long chains, so markers have to share and steal work
+    const int num_chains = 8;
+    const int chain_length = 2000;
+    Node* heads[num_chains] = {};
+    for (int c = 0; c < num_chains; ++c) {
+        aria_shadow_stack_add_root(reinterpret_cast<void**>(&heads[c]));
+        for (int i = 0; i < chain_length; ++i) {
+            Node* node = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+            node->value = static_cast<uint64_t>(c * chain_length + i);
+            node->next = heads[c];
+            heads[c] = node;
+        }
+    }
+    
+    // Garbage to sweep alongside
+    for (int i = 0; i < 5000; ++i) {
+        aria_gc_alloc(32, 0);
+    }
+    
+    aria_gc_collect(true);
+    
+    GCStats stats;
+    aria_gc_get_stats(&stats);
+    ASSERT_EQ(stats.num_gc_threads, 4u, "Worker count should follow aria_gc_init");
+    ASSERT(stats.last_mark_ns > 0, "Mark phase time should be recorded");
+    ASSERT(stats.last_sweep_ns > 0, "Sweep phase time should be recorded");
+    ASSERT(stats.total_evacuate_ns > 0, "Evacuation time should be recorded");
+    
+    bool intact = true;
+    for (int c = 0; c < num_chains; ++c) {
+        int i = chain_length - 1;
+        for (Node* node = heads[c]; node; node = node->next, --i) {
+            intact = intact && node->value == static_cast<uint64_t>(c * chain_length + i);
+        }
+        intact = intact && i == -1;
+    }
+    ASSERT(intact, "Parallel marking should retain every reachable node");
+    
+    aria_shadow_stack_pop_frame();
+}
+
+// =============================================================================
+// Concurrent Marking Tests
+// =============================================================================
+
+namespace {
+// Reference store as emitted by the compiler (SATB barrier, store, card mark)
+void store_ref(void* obj, Node** slot, Node* value) {
+    aria_gc_write_barrier_pre(reinterpret_cast<void**>(slot));
+    __atomic_store_n(slot, value, __ATOMIC_RELAXED);
+    aria_gc_write_barrier(obj, value);
+}
+}
+
+TEST_CASE(gc_concurrent_mark_survives_mutation) {
+    aria_gc_shutdown();
+    aria_gc_init(0, 0, 2, ARIA_GC_CONCURRENT_MARK);
+    
+    uint64_t bitmap = 0x2;
+    uint16_t node_type = aria_gc_register_type(sizeof(Node), &bitmap);
+    
+    aria_shadow_stack_push_frame();
+    
+    // Two sentinel-headed lists in the old generation
+    const int count = 4000;
+    Node* lists[2] = {};
+    for (int l = 0; l < 2; ++l) {
+        lists[l] = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+        aria_shadow_stack_add_root(reinterpret_cast<void**>(&lists[l]));
+    }
+    for (int i = 0; i < count; ++i) {
+        Node* node = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+        node->value = 1;
+        node->next = lists[0]->next;
+        lists[0]->next = node;
+    }
+    aria_gc_collect(false);
+    
+    // A mutator moves nodes between the lists while cycles run. Between
+    // the two stores a moved node is reachable only from a local, which
+    // is exactly what the SATB barrier must cover.
+    std::atomic<bool> done{false};
+    std::thread mutator([&]() {
+        aria_gc_register_thread();
+        size_t moves = 0;
+        while (!done.load()) {
+            Node* from = lists[moves % 2];
+            Node* to = lists[(moves + 1) % 2];
+            Node* node = from->next;
+            if (node) {
+                store_ref(from, &from->next, node->next);
+                store_ref(node, &node->next, to->next);
+                store_ref(to, &to->next, node);
+            }
+            if (++moves % 64 == 0) {
+                aria_gc_safepoint();
+            }
+        }
+        aria_gc_unregister_thread();
+    });
+    
+    for (int i = 0; i < 5; ++i) {
+        aria_gc_collect(true);
+    }
+    done.store(true);
+    
+    aria_gc_enter_blocking();
+    mutator.join();
+    aria_gc_leave_blocking();
+    
+    GCStats stats;
+    aria_gc_get_stats(&stats);
+    ASSERT(stats.num_major_collections >= 5, "Each full collect should complete a cycle");
+    
+    size_t total = 0;
+    for (int l = 0; l < 2; ++l) {
+        for (Node* node = lists[l]->next; node; node = node->next) {
+            total += node->value;
+        }
+    }
+    ASSERT_EQ(total, static_cast<size_t>(count), "No node may be lost during concurrent marking");
+    
+    aria_shadow_stack_pop_frame();
+    
+}
+
+TEST_CASE(gc_satb_barrier_keeps_hidden_object) {
+    aria_gc_init(0, 0, 2, ARIA_GC_CONCURRENT_MARK);  // Still concurrent from above
+    
+    uint64_t bitmap = 0x2;
+    uint16_t node_type = aria_gc_register_type(sizeof(Node), &bitmap);
+    
+    aria_shadow_stack_push_frame();
+    
+    // A long chain takes the marker a while; its tail is marked last
+    const int count = 200000;
+    Node* head = nullptr;
+    Node* before_tail = nullptr;
+    aria_shadow_stack_add_root(reinterpret_cast<void**>(&head));
+    for (int i = 0; i < count; ++i) {
+        Node* node = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+        node->next = head;
+        head = node;
+        if (i == 1) {
+            before_tail = node;
+        }
+    }
+    
+    // Not a root (that would get the tail marked right away); tenured
+    // objects do not move, so the pointer stays valid after promotion
+    aria_gc_collect(false);
+    before_tail = head;
+    while (before_tail->next->next) {
+        before_tail = before_tail->next;
+    }
+    
+    // Once marking starts, unlink the tail and keep it only in a local
+    // until the cycle is over, then link it back in
+    Node* hidden = nullptr;
+    std::thread mutator([&]() {
+        aria_gc_register_thread();
+        GCStats stats;
+        do {
+            aria_gc_get_stats(&stats);
+        } while (!stats.marking_in_progress);
+        
+        hidden = before_tail->next;
+        store_ref(before_tail, &before_tail->next, nullptr);
+        
+        do {
+            aria_gc_get_stats(&stats);
+        } while (stats.marking_in_progress);
+        
+        store_ref(before_tail, &before_tail->next, hidden);
+        aria_gc_unregister_thread();
+    });
+    
+    aria_gc_collect(true);
+    
+    aria_gc_enter_blocking();
+    mutator.join();
+    aria_gc_leave_blocking();
+    
+    ASSERT(hidden != nullptr, "Mutator should have unlinked the tail");
+    ASSERT(aria_gc_is_heap_pointer(hidden), "An object reachable at the snapshot must survive");
+    
+    aria_shadow_stack_pop_frame();
+    
+    // Leave the collector in its default mode for later tests
+    aria_gc_shutdown();
+    aria_gc_init(0, 0, 0, 0);
+}
+
+// =============================================================================
+// Card Table Tests
+// =============================================================================
+
+TEST_CASE(gc_dirty_card_keeps_young_child) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    uint64_t bitmap = 0x2;
+    uint16_t node_type = aria_gc_register_type(sizeof(Node), &bitmap);
+    
+    aria_shadow_stack_push_frame();
+    
+    Node* parent = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+    aria_shadow_stack_add_root(reinterpret_cast<void**>(&parent));
+    aria_gc_collect(false);
+    ASSERT_EQ(aria_gc_get_header(parent)->is_nursery, 0u, "Parent should be tenured");
+    
+    // The child is reachable only through the tenured parent
+    Node* child = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+    child->value = 42;
+    parent->next = child;
+    aria_gc_write_barrier(parent, child);
+    
+    aria_gc_collect(false);
+    
+    GCStats stats;
+    aria_gc_get_stats(&stats);
+    ASSERT(stats.last_dirty_cards >= 1, "The barrier should have dirtied a card");
+    ASSERT(parent->next != child, "Child should have been evacuated");
+    ASSERT(aria_gc_is_heap_pointer(parent->next), "Parent's field should be forwarded");
+    ASSERT_EQ(parent->next->value, 42u, "Child contents should survive");
+    
+    // The card was cleared by the scan; nothing young remains
+    aria_gc_collect(false);
+    aria_gc_get_stats(&stats);
+    ASSERT_EQ(stats.last_dirty_cards, 0u, "Scanned cards should be clean again");
+    
+    aria_shadow_stack_pop_frame();
+}
+
+TEST_CASE(gc_dirty_card_tracks_pinned_child) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    uint64_t bitmap = 0x2;
+    uint16_t node_type = aria_gc_register_type(sizeof(Node), &bitmap);
+    
+    aria_shadow_stack_push_frame();
+    
+    Node* parent = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+    aria_shadow_stack_add_root(reinterpret_cast<void**>(&parent));
+    aria_gc_collect(false);
+    
+    Node* child = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+    child->value = 7;
+    parent->next = child;
+    aria_gc_write_barrier(parent, child);
+    aria_gc_pin(child);
+    
+    // While pinned the child stays put and the card must stay dirty
+    aria_gc_collect(false);
+    aria_gc_collect(false);
+    ASSERT(parent->next == child, "Pinned child must not move");
+    
+    aria_gc_unpin(child);
+    aria_gc_collect(false);
+    ASSERT(parent->next != child, "Unpinned child should be evacuated");
+    ASSERT_EQ(aria_gc_get_header(parent->next)->is_nursery, 0u, "Child should be tenured");
+    ASSERT_EQ(parent->next->value, 7u, "Child contents should survive");
+    
+    aria_shadow_stack_pop_frame();
+}
+
+namespace {
+// Card-marking half of the inline barrier ariac emits (see gc.h)
+void inline_card_mark(void* obj, void* value) {
+    uint64_t header;
+    memcpy(&header, static_cast<char*>(obj) - 8, sizeof(header));
+    if (!(header & ARIA_GC_HEADER_NURSERY_BIT) && value) {
+        uintptr_t addr = reinterpret_cast<uintptr_t>(obj);
+        uint8_t* cards = reinterpret_cast<uint8_t*>(addr & ~(ARIA_GC_SEGMENT_SIZE - 1));
+        cards[(addr & (ARIA_GC_SEGMENT_SIZE - 1)) >> ARIA_GC_CARD_SHIFT] = ARIA_GC_CARD_DIRTY;
+        cards[0] = ARIA_GC_CARD_DIRTY;
+    }
+}
+}
+
+TEST_CASE(gc_inline_barrier_protocol) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    uint64_t bitmap = 0x2;
+    uint16_t node_type = aria_gc_register_type(sizeof(Node), &bitmap);
+    
+    aria_shadow_stack_push_frame();
+    
+    Node* young = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+    ASSERT(aria_gc_get_header(young)->is_nursery, "Fresh objects start in the nursery");
+    inline_card_mark(young, young);  // Must not touch memory outside the nursery
+    
+    Node* parent = young;
+    aria_shadow_stack_add_root(reinterpret_cast<void**>(&parent));
+    aria_gc_collect(false);
+    ASSERT_EQ(aria_gc_get_header(parent)->is_nursery, 0u, "Parent should be tenured");
+    ASSERT_EQ(aria_gc_satb_active, 0, "SATB barrier is off outside concurrent marking");
+    
+    Node* child = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+    child->value = 7;
+    parent->next = child;
+    inline_card_mark(parent, child);
+    
+    aria_gc_collect(false);
+    
+    GCStats stats;
+    aria_gc_get_stats(&stats);
+    ASSERT(stats.last_dirty_cards >= 1, "The inline barrier should dirty the card");
+    ASSERT(parent->next != child, "Child should have been evacuated");
+    ASSERT_EQ(parent->next->value, 7u, "Child contents should survive");
+    
+    aria_shadow_stack_pop_frame();
+}
+
+TEST_CASE(gc_compiled_shadow_frame_walked_in_place) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    uint64_t bitmap = 0x2;
+    uint16_t node_type = aria_gc_register_type(sizeof(Node), &bitmap);
+    
+    // Frame layout and prologue as emitted by the compiler (see gc.h)
+    struct {
+        AriaShadowFrame header;
+        void* roots[2];
+    } frame;
+    frame.header.prev = aria_shadow_stack_top;
+    frame.header.num_roots = 2;
+    frame.header.flags = 0;
+    memset(frame.roots, 0, sizeof(frame.roots));
+    aria_shadow_stack_top = &frame.header;
+    
+    Node* list = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+    list->value = 1;
+    frame.roots[0] = list;
+    Node* tail = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+    tail->value = 2;
+    static_cast<Node*>(frame.roots[0])->next = tail;
+    frame.roots[1] = aria_gc_alloc(sizeof(Node), node_type);
+    
+    // A runtime-API frame nested inside the compiled one
+    aria_shadow_stack_push_frame();
+    void* inner = aria_gc_alloc(sizeof(Node), node_type);
+    aria_shadow_stack_add_root(&inner);
+    
+    aria_gc_collect(false);
+    
+    ASSERT(frame.roots[0] != list, "Root slot should be updated in place");
+    Node* moved = static_cast<Node*>(frame.roots[0]);
+    ASSERT_EQ(moved->value, 1u, "Root contents should survive");
+    ASSERT_EQ(moved->next->value, 2u, "Objects reachable from the frame should survive");
+    ASSERT(aria_gc_is_heap_pointer(frame.roots[1]), "Second slot should be scanned");
+    ASSERT_EQ(aria_gc_get_header(inner)->is_nursery, 0u, "Nested runtime frame should be scanned");
+    
+    aria_shadow_stack_pop_frame();
+    ASSERT(aria_shadow_stack_top == &frame.header, "Pop should unlink only the runtime frame");
+    
+    aria_shadow_stack_top = frame.header.prev;  // Epilogue
+}
+
+TEST_CASE(gc_pinned_objects_keep_nursery_usable) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    aria_shadow_stack_push_frame();
+    
+    // Pin every 16th object across a stretch of the nursery
+    std::vector<uint64_t*> pinned;
+    for (int i = 0; i < 4096; ++i) {
+        uint64_t* obj = static_cast<uint64_t*>(aria_gc_alloc(48, ARIA_GC_TYPE_LEAF));
+        if (i % 16 == 0) {
+            *obj = static_cast<uint64_t>(i);
+            aria_gc_pin(obj);
+            pinned.push_back(obj);
+        }
+    }
+    aria_gc_pin(pinned[0]);  // Pinning twice is harmless
+    
+    GCStats stats;
+    aria_gc_get_stats(&stats);
+    ASSERT_EQ(stats.num_pinned_objects, pinned.size(), "Each object counts once");
+    
+    aria_gc_collect(false);
+    aria_gc_get_stats(&stats);
+    ASSERT(stats.nursery_used < pinned.size() * 128, "Only pinned objects should remain");
+    
+    // Fill the gaps between pinned objects several times over
+    int failed = 0;
+    for (int i = 0; i < 100000; ++i) {
+        failed += aria_gc_alloc(48, ARIA_GC_TYPE_LEAF) == nullptr;
+    }
+    ASSERT_EQ(failed, 0, "Allocation should succeed");
+    
+    for (size_t i = 0; i < pinned.size(); ++i) {
+        ASSERT_EQ(*pinned[i], i * 16, "Pinned objects must not be overwritten");
+        ASSERT(aria_gc_get_header(pinned[i])->is_nursery, "Pinned objects stay in place");
+        aria_gc_unpin(pinned[i]);
+    }
+    
+    aria_gc_get_stats(&stats);
+    ASSERT_EQ(stats.num_pinned_objects, 0u, "Unpinning should clear the count");
+    aria_gc_collect(false);
+    aria_gc_get_stats(&stats);
+    ASSERT_EQ(stats.nursery_used, 0u, "Unpinned garbage should be reclaimed");
+    
+    aria_shadow_stack_pop_frame();
+}
+
+TEST_CASE(gc_numa_partitions_share_nursery) {
+    // Four partitions regardless of the machine's node count
+    aria_gc_shutdown();
+    setenv("ARIA_GC_NUMA_NODES", "4", 1);
+    aria_gc_init(8 * 1024 * 1024, 0, 0, ARIA_GC_HUGE_PAGES | ARIA_GC_NUMA_LOCAL);
+    unsetenv("ARIA_GC_NUMA_NODES");
+    
+    GCStats stats;
+    aria_gc_get_stats(&stats);
+    ASSERT_EQ(stats.nursery_partitions, 4u, "One partition per node");
+    ASSERT(!stats.nursery_hugetlb, "Transparent huge pages only");
+    
+    aria_shadow_stack_push_frame();
+    
+    // Spill over every partition, pinning objects along the way
+    std::vector<uint64_t*> pinned;
+    int spilled_failures = 0;
+    for (int i = 0; i < 120000; ++i) {
+        uint64_t* obj = static_cast<uint64_t*>(aria_gc_alloc(48, ARIA_GC_TYPE_LEAF));
+        if (!obj) {
+            spilled_failures++;
+        } else if (i % 1000 == 0) {
+            *obj = static_cast<uint64_t>(i);
+            aria_gc_pin(obj);
+            pinned.push_back(obj);
+        }
+    }
+    ASSERT_EQ(spilled_failures, 0, "Allocation should spill to other partitions");
+    
+    // Gaps around pins in every partition are reused
+    aria_gc_collect(false);
+    int failed = 0;
+    for (int i = 0; i < 300000; ++i) {
+        failed += aria_gc_alloc(48, ARIA_GC_TYPE_LEAF) == nullptr;
+    }
+    ASSERT_EQ(failed, 0, "Allocation should succeed");
+    
+    for (size_t i = 0; i < pinned.size(); ++i) {
+        ASSERT_EQ(*pinned[i], i * 1000, "Pinned objects must not be overwritten");
+        ASSERT(aria_gc_get_header(pinned[i])->is_nursery, "Pinned objects stay in place");
+        aria_gc_unpin(pinned[i]);
+    }
+    
+    aria_shadow_stack_pop_frame();
+    aria_gc_shutdown();
+    aria_gc_init(0, 0, 0, 0);
+}
+
+// =============================================================================
+// Compaction Tests
+// =============================================================================
+
+TEST_CASE(gc_compaction_moves_unpinned_objects) {
+    aria_gc_shutdown();
+    aria_gc_init(0, 0, 4, ARIA_GC_COMPACT);
+    
+    uint64_t node_bitmap = 0x2;
+    uint16_t node_type = aria_gc_register_type(sizeof(Node), &node_bitmap);
+    uint64_t array_bitmap = 0x1;
+    uint16_t ref_array = aria_gc_register_type(sizeof(void*), &array_bitmap);
+    
+    aria_shadow_stack_push_frame();
+    
+    // Tenure several segments' worth of nodes, then keep one in 16, each
+    // linked to the previous survivor
+    const int count = 60000;
+    Node** nodes = static_cast<Node**>(aria_gc_alloc(sizeof(Node*) * count, ref_array));
+    aria_shadow_stack_add_root(reinterpret_cast<void**>(&nodes));
+    for (int i = 0; i < count; ++i) {
+        nodes[i] = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+        nodes[i]->value = static_cast<uint64_t>(i);
+        aria_gc_write_barrier(nodes, nodes[i]);
+    }
+    aria_gc_collect(false);
+    
+    Node* pinned = nodes[count - 16];
+    aria_gc_pin(pinned);
+    
+    Node* previous = nullptr;
+    for (int i = 0; i < count; ++i) {
+        if (i % 16 == 0) {
+            nodes[i]->next = previous;
+            aria_gc_write_barrier(nodes[i], previous);
+            previous = nodes[i];
+        } else {
+            nodes[i] = nullptr;
+        }
+    }
+    
+    GCStats before;
+    aria_gc_get_stats(&before);
+    aria_gc_collect(true);
+    GCStats after;
+    aria_gc_get_stats(&after);
+    
+    ASSERT(after.last_compacted > 0, "Sparse segments should be evacuated");
+    ASSERT(after.segments_released > before.segments_released,
+           "Emptied segments should be released");
+    ASSERT(after.old_gen_size < before.old_gen_size, "Old generation should shrink");
+    ASSERT(nodes[count - 16] == pinned, "Pinned object must not move");
+    
+    bool intact = true;
+    for (int i = 0; i < count; i += 16) {
+        Node* node = nodes[i];
+        intact = intact && aria_gc_is_heap_pointer(node) &&
+                 node->value == static_cast<uint64_t>(i) &&
+                 node->next == (i == 0 ? nullptr : nodes[i - 16]);
+    }
+    ASSERT(intact, "Roots and fields should follow moved objects");
+    
+    // The compacted heap keeps working
+    for (int i = 0; i < count; i += 16) {
+        nodes[i + 1] = static_cast<Node*>(aria_gc_alloc(sizeof(Node), node_type));
+        nodes[i + 1]->next = nodes[i];
+        aria_gc_write_barrier(nodes, nodes[i + 1]);
+    }
+    aria_gc_collect(true);
+    intact = true;
+    for (int i = 0; i < count; i += 16) {
+        intact = intact && nodes[i + 1]->next == nodes[i] &&
+                 nodes[i]->value == static_cast<uint64_t>(i);
+    }
+    ASSERT(intact, "Objects should survive a second compacting collection");
+    
+    aria_gc_unpin(nodes[count - 16]);
+    aria_shadow_stack_pop_frame();
+    aria_gc_collect(true);
+    
+    GCStats released;
+    aria_gc_get_stats(&released);
+    ASSERT_EQ(released.old_gen_used, 0u, "Dropping the last root should reclaim everything");
+    
+    aria_gc_shutdown();
+    aria_gc_init(0, 0, 0, 0);
+}
+
+TEST_CASE(gc_policy_resizes_nursery) {
+    aria_gc_init(0, 0, 0, 0);
+    
+    GCPolicy saved;
+    aria_gc_get_policy(&saved);
+    
+    // Out-of-range values are clamped
+    GCPolicy policy = saved;
+    policy.min_nursery_size = 1;
+    policy.max_nursery_size = 0;
+    policy.survival_target = 2.0;
+    policy.major_growth_factor = 0.5;
+    aria_gc_set_policy(&policy);
+    aria_gc_get_policy(&policy);
+    ASSERT(policy.min_nursery_size > 1, "Minimum should be at least one block");
+    ASSERT_EQ(policy.max_nursery_size, policy.min_nursery_size, "Maximum should not be below minimum");
+    ASSERT(policy.survival_target == 1.0, "Survival target is a fraction");
+    ASSERT(policy.major_growth_factor == 1.0, "Growth factor should be at least 1");
+    
+    // Every survivor grows a full nursery (up to the maximum)
+    GCStats stats;
+    aria_gc_get_stats(&stats);
+    size_t initial = stats.nursery_size;
+    policy = saved;
+    policy.min_nursery_size = initial;
+    policy.max_nursery_size = initial * 2;
+    policy.pause_target_ns = 0;
+    policy.survival_target = 0.0;
+    aria_gc_set_policy(&policy);
+    
+    aria_shadow_stack_push_frame();
+    void* survivor = aria_gc_alloc(64, ARIA_GC_TYPE_LEAF);
+    aria_shadow_stack_add_root(&survivor);
+    
+    aria_gc_collect(false);
+    for (size_t used = 0; used < initial * 3 / 4; used += 4096) {
+        aria_gc_alloc(4096 - sizeof(ObjHeader), ARIA_GC_TYPE_LEAF);
+    }
+    survivor = aria_gc_alloc(64, ARIA_GC_TYPE_LEAF);
+    aria_gc_collect(false);
+    aria_gc_get_stats(&stats);
+    ASSERT_EQ(stats.nursery_size, initial * 2, "Nursery should grow when objects survive");
+    ASSERT(stats.last_promoted >= 64, "Survivor should count as promoted");
+    ASSERT(stats.last_survival_rate > 0.0 && stats.last_survival_rate < 0.01,
+           "Survival rate is relative to the bytes allocated");
+    
+    // Fixing the size shrinks it back
+    policy.max_nursery_size = initial;
+    aria_gc_set_policy(&policy);
+    aria_gc_collect(false);
+    aria_gc_get_stats(&stats);
+    ASSERT_EQ(stats.nursery_size, initial, "Nursery should respect the maximum");
+    
+    aria_shadow_stack_pop_frame();
+    aria_gc_set_policy(&saved);
+}
+
+TEST_CASE(gc_heap_profile_follows_promotion) {
+    aria_gc_init(0, 0, 0, 0);
+    aria_gc_collect(false);
+    ASSERT_EQ(aria_heap_profile_start(256), 0, "Profiler should start");
+    
+    aria_shadow_stack_push_frame();
+    
+    // Every object is large enough to be sampled; only the rooted ones
+    // survive the collection
+    void* kept[8] = {};
+    for (int i = 0; i < 8; ++i) {
+        kept[i] = aria_gc_alloc(4096, ARIA_GC_TYPE_LEAF);
+        aria_shadow_stack_add_root(&kept[i]);
+    }
+    for (int i = 0; i < 8; ++i) {
+        aria_gc_alloc(4096, ARIA_GC_TYPE_LEAF);
+    }
+    
+    HeapProfileStats stats;
+    aria_heap_profile_get_stats(&stats);
+    ASSERT_EQ(stats.live_samples, 16u, "Each large allocation should be sampled");
+    
+    aria_gc_collect(false);
+    aria_heap_profile_get_stats(&stats);
+    ASSERT_EQ(stats.live_samples, 8u, "Unreachable samples die in the minor GC");
+    
+    // Promoted samples are followed into the old generation
+    for (int i = 0; i < 4; ++i) {
+        kept[i] = nullptr;
+    }
+    aria_gc_collect(true);
+    aria_heap_profile_get_stats(&stats);
+    ASSERT_EQ(stats.live_samples, 4u, "Samples freed by the major GC die");
+    
+    aria_shadow_stack_pop_frame();
+    aria_heap_profile_stop();
+    aria_gc_collect(true);
+    aria_heap_profile_get_stats(&stats);
+    ASSERT_EQ(stats.live_samples, 0u, "Stopping keeps tracking frees");
+}
@@ -0,0 +1,123 @@
+/**
+ * Tests for the Aria String Runtime
+ *
+ * Tests the inline small-string representation across creation and
+ * manipulation, the inline/heap boundary, C string conversion and the
+ * concurrent intern table with its pointer-equality comparison.
+ */
+
+#include "../test_helpers.h"
+#include "runtime/strings.h"
+#include "runtime/gc.h"
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+AriaString make_string(const std::string& text) {
+    AriaResultPtr result = aria_string_from_bytes(text.data(), (int64_t)text.size());
+    return *(AriaString*)result.value;
+}
+
+std::string to_std(const AriaString& str) {
+    return std::string(aria_string_data(&str), (size_t)aria_string_length(str));
+}
+
+} // namespace
+
+TEST_CASE(string_inline_and_heap_forms) {
+    aria_gc_init(0, 0, 0, 0);
+
+    // Lengths around the inline capacity round-trip through every operation
+    for (int64_t length = 0; length <= 2 * ARIA_STRING_INLINE_CAPACITY; length++) {
+        std::string text(length, 'k');
+        for (int64_t i = 0; i < length; i++) text[i] = (char)('a' + i % 26);
+
+        AriaString str = make_string(text);
+        ASSERT_EQ(aria_string_length(str), length, "Length should survive creation");
+        ASSERT(to_std(str) == text, "Bytes should survive creation");
+
+        AriaString upper = *(AriaString*)aria_string_to_upper(str).value;
+        AriaString lower = *(AriaString*)aria_string_to_lower(upper).value;
+        ASSERT(aria_string_equals(lower, str), "Case round trip should be equal");
+
+        const char* cstr = (const char*)aria_string_to_cstr(str).value;
+        ASSERT(std::strlen(cstr) == (size_t)length && text == cstr,
+               "C string should be null-terminated");
+    }
+
+    AriaString left = make_string("config.");
+    AriaString right = make_string("key");
+    AriaString joined = *(AriaString*)aria_string_concat(left, right).value;
+    ASSERT(to_std(joined) == "config.key", "Inline concat should join bytes");
+    AriaString longer = *(AriaString*)aria_string_concat(joined, joined).value;
+    ASSERT(to_std(longer) == "config.keyconfig.key", "Concat should cross into heap form");
+
+    AriaString padded = make_string("  request_id \n");
+    AriaString trimmed = *(AriaString*)aria_string_trim(padded).value;
+    ASSERT(aria_string_equals(trimmed, make_string("request_id")), "Trim should produce inline string");
+
+    AriaString sub = *(AriaString*)aria_string_substring(longer, 7, 10).value;
+    ASSERT(to_std(sub) == "key", "Substring of heap string should be inline");
+    ASSERT(aria_string_starts_with(longer, left), "starts_with should read inline prefix");
+    ASSERT(aria_string_ends_with(longer, right), "ends_with should read inline suffix");
+    ASSERT_EQ(aria_string_index_of(longer, right).value, (int64_t)7, "index_of should find inline needle");
+
+    // Hand-built {data, length} strings remain valid values
+    AriaString plain;
+    plain.heap.data = "key";
+    plain.heap.length = 3;
+    ASSERT(aria_string_equals(plain, right), "Plain heap form should equal inline form");
+    ASSERT(aria_string_is_empty(*aria_string_empty()), "Empty string should be empty");
+}
+
+TEST_CASE(string_intern_pointer_equality) {
+    aria_gc_init(0, 0, 0, 0);
+
+    const std::string short_key = "user_id";
+    const std::string long_key = "request.headers.content-type";
+
+    AriaString* a = (AriaString*)aria_string_intern(make_string(short_key)).value;
+    AriaString* b = (AriaString*)aria_string_intern(make_string(short_key)).value;
+    AriaString* c = (AriaString*)aria_string_intern(make_string(long_key)).value;
+    AriaString* d = (AriaString*)aria_string_intern(make_string(long_key)).value;
+
+    ASSERT(a == b && c == d, "Interning equal strings should return the same pointer");
+    ASSERT(a != c, "Different strings should intern separately");
+    ASSERT(aria_string_is_interned(*a) && aria_string_is_interned(*c), "Interned strings should be flagged");
+    ASSERT_FALSE(aria_string_is_interned(make_string(long_key)), "Plain strings should not be flagged");
+
+    ASSERT(aria_string_equals(*a, make_string(short_key)), "Interned inline should equal plain inline");
+    ASSERT(aria_string_equals(*c, make_string(long_key)), "Interned heap should equal plain heap");
+    ASSERT_FALSE(aria_string_equals(*a, *c), "Distinct interned strings should differ");
+    ASSERT(std::strcmp((const char*)aria_string_to_cstr(*c).value, long_key.c_str()) == 0,
+           "Interned heap string should be null-terminated");
+
+    // Concurrent interning of overlapping keys converges on one copy each
+    const int num_threads = 8;
+    const int num_keys = 200;
+    std::vector<std::vector<AriaString*>> seen(num_threads, std::vector<AriaString*>(num_keys));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            for (int k = 0; k < num_keys; k++) {
+                std::string key = "field_" + std::to_string((k * 7 + t) % num_keys) + "_name_suffix";
+                AriaString value;
+                value.heap.data = key.data();
+                value.heap.length = key.size();
+                seen[t][(k * 7 + t) % num_keys] = (AriaString*)aria_string_intern(value).value;
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    bool converged = true;
+    for (int k = 0; k < num_keys; k++) {
+        for (int t = 1; t < num_threads; t++) {
+            converged = converged && seen[t][k] == seen[0][k];
+        }
+    }
+    ASSERT(converged, "Every thread should get the same canonical string per key");
+}
@@ -0,0 +1,143 @@
+#include "test_helpers.h"
+#include "frontend/sema/escape_analyzer.h"
+#include "frontend/parser/parser.h"
+#include "frontend/lexer/lexer.h"
+#include "frontend/ast/stmt.h"
+
+using namespace aria;
+using namespace aria::sema;
+using namespace aria::frontend;
+
+// ============================================================================
+// Escape Analyzer Tests
+// ============================================================================
+
+namespace {
+
+// Parse a single function declaration
+std::shared_ptr<FuncDeclStmt> parseFunc(const std::string& source) {
+    Lexer lexer(source);
+    auto tokens = lexer.tokenize();
+    Parser parser(tokens);
+    auto program = std::dynamic_pointer_cast<ProgramNode>(parser.parse());
+    if (!program || program->declarations.empty()) {
+        return nullptr;
+    }
+    return std::dynamic_pointer_cast<FuncDeclStmt>(program->declarations[0]);
+}
+
+// First declaration of name anywhere in the function body
+VarDeclStmt* findVar(ASTNode* node, const std::string& name) {
+    if (!node) return nullptr;
+    switch (node->type) {
+        case ASTNode::NodeType::VAR_DECL: {
+            auto decl = static_cast<VarDeclStmt*>(node);
+            return decl->varName == name ? decl : nullptr;
+        }
+        case ASTNode::NodeType::BLOCK:
+            for (auto& stmt : static_cast<BlockStmt*>(node)->statements) {
+                if (VarDeclStmt* decl = findVar(stmt.get(), name)) return decl;
+            }
+            return nullptr;
+        case ASTNode::NodeType::WHILE:
+            return findVar(static_cast<WhileStmt*>(node)->body.get(), name);
+        case ASTNode::NodeType::IF:
+            return findVar(static_cast<IfStmt*>(node)->thenBranch.get(), name);
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace
+
+TEST_CASE(escape_local_arithmetic_does_not_escape) {
+    auto func = parseFunc(
+        "func:sum = int64(int64:n) {"
+        "  gc int64:acc = 0;"
+        "  int64:i = 0;"
+        "  while (i < n) { acc = acc + i * 2; i = i + 1; }"
+        "  int64:result = acc;"
+        "  return result;"
+        "};");
+    ASSERT(func != nullptr, "Function should parse");
+
+    EscapeAnalyzer analyzer;
+    ASSERT_EQ(analyzer.analyzeFuncDecl(func.get()), 1u, "One gc local should be promoted");
+    ASSERT(findVar(func->body.get(), "acc")->noEscape, "acc is only read and written in place");
+    ASSERT(!findVar(func->body.get(), "i")->noEscape, "Only gc locals are candidates");
+}
+
+TEST_CASE(escape_returned_or_passed_escapes) {
+    auto func = parseFunc(
+        "func:f = int64() {"
+        "  gc int64:kept = 1;"
+        "  gc int64:passed = 2;"
+        "  gc int64:returned = 3;"
+        "  gc int64:stored = 4;"
+        "  int64:copy = 0;"
+        "  kept = kept + 1;"
+        "  consume(passed);"
+        "  copy = stored;"
+        "  return returned;"
+        "};");
+    ASSERT(func != nullptr, "Function should parse");
+
+    EscapeAnalyzer analyzer;
+    analyzer.analyzeFuncDecl(func.get());
+    ASSERT(findVar(func->body.get(), "kept")->noEscape, "kept stays local");
+    ASSERT(!findVar(func->body.get(), "passed")->noEscape, "Call arguments escape");
+    ASSERT(!findVar(func->body.get(), "stored")->noEscape, "Stored references escape");
+    ASSERT(!findVar(func->body.get(), "returned")->noEscape, "Returned references escape");
+}
+
+TEST_CASE(escape_address_taken_escapes) {
+    auto func = parseFunc(
+        "func:f = int64() {"
+        "  gc int64:pinned = 1;"
+        "  gc int64:addressed = 2;"
+        "  gc int64:compared = 3;"
+        "  wild int64:p = #pinned;"
+        "  wild int64:q = @addressed;"
+        "  if (compared > 2) { compared = 0; }"
+        "  return 0;"
+        "};");
+    ASSERT(func != nullptr, "Function should parse");
+
+    EscapeAnalyzer analyzer;
+    analyzer.analyzeFuncDecl(func.get());
+    ASSERT(!findVar(func->body.get(), "pinned")->noEscape, "Pinned objects escape");
+    ASSERT(!findVar(func->body.get(), "addressed")->noEscape, "Address-of escapes");
+    ASSERT(findVar(func->body.get(), "compared")->noEscape, "Conditions do not escape");
+}
+
+TEST_CASE(escape_nested_function_capture_escapes) {
+    auto func = parseFunc(
+        "func:f = int64() {"
+        "  gc int64:captured = 1;"
+        "  gc int64:local = 2;"
+        "  local = local * 2;"
+        "  func:inner = int64(int64:y) { return y + captured; };"
+        "  return 0;"
+        "};");
+    ASSERT(func != nullptr, "Function should parse");
+
+    EscapeAnalyzer analyzer;
+    analyzer.analyzeFuncDecl(func.get());
+    ASSERT(!findVar(func->body.get(), "captured")->noEscape, "Locals used by a nested function escape");
+    ASSERT(findVar(func->body.get(), "local")->noEscape, "Uncaptured locals do not");
+}
+
+TEST_CASE(escape_shadowed_name_is_conservative) {
+    auto func = parseFunc(
+        "func:f = int64() {"
+        "  gc int64:x = 1;"
+        "  x = x + 1;"
+        "  if (x > 0) { gc int64:x = 2; consume(x); }"
+        "  return 0;"
+        "};");
+    ASSERT(func != nullptr, "Function should parse");
+
+    EscapeAnalyzer analyzer;
+    ASSERT_EQ(analyzer.analyzeFuncDecl(func.get()), 0u, "Both declarations of x escape");
+    ASSERT(!findVar(func->body.get(), "x")->noEscape, "The outer x shares the inner x's fate");
+}
@@ -1516,6 +1516,60 @@ TEST_CASE(parser_defer_nested_blocks) {
     ASSERT(outerBlock->statements.size() > 0, "Outer block should have statements");
 }
 
+TEST_CASE(parser_arena_region) {
+    auto program = parseStmt("arena { arena int64:x = 5; defer { done(); } }");
+    auto prog = getProgram(program);
+    ASSERT(prog != nullptr, "Program should not be null");
+    auto stmt = prog->declarations[0];
+    ASSERT(stmt->type == ASTNode::NodeType::REGION, "Should be REGION statement");
+    
+    auto region = std::static_pointer_cast<RegionStmt>(stmt);
+    auto body = std::static_pointer_cast<BlockStmt>(region->body);
+    ASSERT(body->statements.size() == 2, "Region body should have 2 statements");
+    auto varDecl = std::static_pointer_cast<VarDeclStmt>(body->statements[0]);
+    ASSERT(varDecl->isArena, "Variable should carry the arena qualifier");
+    
+    // Cleanup: a defer block destroying the hidden arena local
+    auto cleanup = std::static_pointer_cast<BlockStmt>(region->cleanup);
+    ASSERT(cleanup->statements.size() == 1, "Cleanup should be one call");
+    auto call = std::static_pointer_cast<CallExpr>(
+        std::static_pointer_cast<ExpressionStmt>(cleanup->statements[0])->expression);
+    ASSERT(std::static_pointer_cast<IdentifierExpr>(call->callee)->name == "aria_arena_destroy",
+           "Cleanup should call aria_arena_destroy");
+    ASSERT(std::static_pointer_cast<IdentifierExpr>(call->arguments[0])->name == region->arenaName,
+           "Cleanup should destroy the region's arena");
+}
+
+TEST_CASE(parser_arena_variable_outside_region) {
+    Lexer lexer("arena int64:x = 5;");
+    auto tokens = lexer.tokenize();
+    Parser parser(tokens);
+    parser.parse();
+    ASSERT(parser.hasErrors(), "arena variable outside a region should be an error");
+}
+
+TEST_CASE(parser_arena_variable_in_nested_function) {
+    // A nested function or lambda body is outside the enclosing region
+    const char* sources[] = {
+        "arena { func:g = int64() { arena int64:x = 5; return x; }; }",
+        "arena { int64:y = int64() { arena int64:x = 5; return x; }(); }",
+    };
+    for (const char* source : sources) {
+        Lexer lexer(source);
+        auto tokens = lexer.tokenize();
+        Parser parser(tokens);
+        parser.parse();
+        ASSERT(parser.hasErrors(), "arena variable in a nested body should be an error");
+    }
+    
+    // The region continues after the nested function
+    Lexer lexer("arena { func:g = int64() { return 1; }; arena int64:x = 5; }");
+    auto tokens = lexer.tokenize();
+    Parser parser(tokens);
+    parser.parse();
+    ASSERT_FALSE(parser.hasErrors(), "arena variable after a nested function should be allowed");
+}
+
 TEST_CASE(parser_defer_with_return) {
     auto program = parseStmt("{ defer { cleanup(); } return value; }");
     auto prog = getProgram(program);